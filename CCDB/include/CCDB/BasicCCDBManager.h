@@ -20,10 +20,13 @@
 #include "CommonUtils/NameConf.h"
 #include "Framework/DataTakingContext.h"
 #include "Framework/DefaultsHelpers.h"
+#include <TBufferFile.h>
+#include <TClass.h>
 #include <string>
 #include <chrono>
 #include <map>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <cstdlib>
 
@@ -54,6 +57,8 @@ class CCDBManagerInstance
     long cacheValidUntil = -1; // object is guaranteed to be valid till this time (modulo new updates)
     size_t minSize = -1ULL;
     size_t maxSize = 0;
+    size_t size = 0;  // size of the blob of the cached version
+    long lastUse = 0; // tick of the last use, for LRU eviction of older versions
     int queries = 0;
     int fetches = 0;
     int failures = 0;
@@ -70,6 +75,20 @@ class CCDBManagerInstance
       uuid = "";
       startvalidity = 0;
       endvalidity = -1;
+      size = 0;
+    }
+    /// exchange the cached version (object and its validity) with other, keeping the statistics
+    void swapVersion(CachedObject& other)
+    {
+      std::swap(objPtr, other.objPtr);
+      std::swap(noCleanupPtr, other.noCleanupPtr);
+      std::swap(uuid, other.uuid);
+      std::swap(startvalidity, other.startvalidity);
+      std::swap(endvalidity, other.endvalidity);
+      std::swap(cacheValidFrom, other.cacheValidFrom);
+      std::swap(cacheValidUntil, other.cacheValidUntil);
+      std::swap(size, other.size);
+      std::swap(lastUse, other.lastUse);
     }
   };
 
@@ -132,10 +151,15 @@ class CCDBManagerInstance
   bool isHostReachable() const { return mCCDBAccessor.isHostReachable(); }
 
   /// clear all entries in the cache
-  void clearCache() { mCache.clear(); }
+  void clearCache()
+  {
+    mCache.clear();
+    mOlderVersions.clear();
+    mOlderVersionsSize = 0;
+  }
 
   /// clear particular entry in the cache
-  void clearCache(std::string const& path) { mCache.erase(path); }
+  void clearCache(std::string const& path);
 
   /// check if caching is enabled
   bool isCachingEnabled() const { return mCachingEnabled; }
@@ -155,8 +179,22 @@ class CCDBManagerInstance
     if (!isCachingEnabled()) {
       return false;
     }
-    return (mCheckObjValidityEnabled && mCache[path].isValid(timestamp)) || mCache[path].isCacheValid(timestamp); // use stricter check
+    return (mCheckObjValidityEnabled && mCache[path].isValid(timestamp)) || mCache[path].isCacheValid(timestamp) || findOlderVersion(path, timestamp) >= 0; // use stricter check
+  }
+
+  /// set the max total size in bytes of the older versions (validity intervals) of the cached objects which are kept
+  /// in addition to the current ones, least recently used versions are evicted when it is exceeded. 0: keep only the current versions
+  void setCacheBudget(size_t bytes)
+  {
+    mCacheBudget = bytes;
+    evictOlderVersions();
   }
+  size_t getCacheBudget() const { return mCacheBudget; }
+
+  size_t getCacheHits() const { return mCacheHits; }
+  size_t getCacheMisses() const { return mCacheMisses; }
+  size_t getCacheEvicted() const { return mCacheEvicted; }
+  size_t getOlderVersionsSize() const { return mOlderVersionsSize; }
 
   /// check if checks of object validity before CCDB query is enabled
   bool isLocalObjectValidityCheckingEnabled() const { return mCheckObjValidityEnabled; }
@@ -206,9 +244,23 @@ class CCDBManagerInstance
  private:
   // method to print (fatal) error
   void reportFatal(std::string_view s);
+  // check if the cached version can be used for the timestamp w/o querying the CCDB
+  bool isUsable(CachedObject& cached, long timestamp) { return (!isOnline() && cached.isCacheValid(timestamp)) || (mCheckObjValidityEnabled && cached.isValid(timestamp)); }
+  // index of the older version of the path usable for the timestamp, -1 if none
+  int findOlderVersion(std::string const& path, long timestamp);
+  // make the older version of the path usable for the timestamp current, return false if there is none
+  bool restoreOlderVersion(std::string const& path, CachedObject& cached, long timestamp);
+  // keep the current version of the path among the older ones before it is replaced by the new version with given uuid
+  void archiveCurrentVersion(std::string const& path, CachedObject& cached, std::string const& newUUID);
+  // evict least recently used older versions until their size fits to the budget
+  void evictOlderVersions();
+  // size of the fetched object: from the reply headers or, if they do not provide it, from its serialization
+  template <typename T>
+  size_t getFetchedSize(T const* ptr);
   // we access the CCDB via the CURL based C++ API
   o2::ccdb::CcdbApi mCCDBAccessor;
   std::unordered_map<std::string, CachedObject> mCache; //! map for {path, CachedObject} associations
+  std::unordered_map<std::string, std::vector<CachedObject>> mOlderVersions; //! older versions of cached objects (different validity intervals)
   MD mMetaData;                                         // some dummy object needed to talk to CCDB API
   MD mHeaders;                                          // headers to retrieve tags
   long mTimestamp{o2::ccdb::getCurrentTimestamp()};     // timestamp to be used for query (by default "now")
@@ -220,6 +272,13 @@ class CCDBManagerInstance
   long mCreatedNotBefore = 0;                           // lower limit for object creation timestamp (TimeMachine mode) - If-Not-Before HTTP header
   long mTimerMS = 0;                                    // timer for queries
   size_t mFetchedSize = 0;                              // total fetched size
+  size_t mCacheBudget = 0;                              // max size of the older versions of the cached objects
+  size_t mOlderVersionsSize = 0;                        // current size of the older versions of the cached objects
+  size_t mCacheHits = 0;                                // number of queries served from the cache
+  size_t mCacheMisses = 0;                              // number of queries sent to the CCDB while caching
+  size_t mCacheEvicted = 0;                             // number of evicted older versions
+  size_t mCacheEvictedSize = 0;                         // size of evicted older versions
+  long mCacheTick = 0;                                  // counter for LRU bookkeeping
   int mQueries = 0;                                     // total number of object queries
   int mFetches = 0;                                     // total number of succesful fetches from CCDB
   int mFailures = 0;                                    // total number of failed fetches
@@ -227,6 +286,22 @@ class CCDBManagerInstance
   ClassDefNV(CCDBManagerInstance, 1);
 };
 
+template <typename T>
+size_t CCDBManagerInstance::getFetchedSize(T const* ptr)
+{
+  auto sh = mHeaders.find("fileSize");
+  if (sh != mHeaders.end()) {
+    return atol(sh->second.c_str());
+  }
+  if constexpr (std::is_same<TGeoManager, T>::value || std::is_base_of<o2::conf::ConfigurableParam, T>::value) {
+    return 0; // not managed by the cache budget
+  } else {
+    TBufferFile buff(TBuffer::kWrite);
+    buff.WriteObjectAny(ptr, TClass::GetClass(typeid(T)));
+    return buff.Length();
+  }
+}
+
 template <typename T>
 T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
 {
@@ -253,15 +328,18 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
   } else {
     auto& cached = mCache[path];
     cached.queries++;
-    if ((!isOnline() && cached.isCacheValid(timestamp)) || (mCheckObjValidityEnabled && cached.isValid(timestamp))) {
+    if (isUsable(cached, timestamp) || restoreOlderVersion(path, cached, timestamp)) {
+      mCacheHits++;
       return reinterpret_cast<T*>(cached.noCleanupPtr ? cached.noCleanupPtr : cached.objPtr.get());
     }
+    mCacheMisses++;
     ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached.uuid,
                                                 mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
                                                 mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
     if (ptr) { // new object was shipped, old one (if any) is not valid anymore
       cached.fetches++;
       mFetches++;
+      archiveCurrentVersion(path, cached, mHeaders["ETag"]);
       if constexpr (std::is_same<TGeoManager, T>::value || std::is_base_of<o2::conf::ConfigurableParam, T>::value) {
         // some special objects cannot be cached to shared_ptr since root may delete their raw global pointer
         cached.noCleanupPtr = ptr;
@@ -287,13 +365,11 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
       } catch (std::exception const& e) {
         reportFatal("Failed to read validity from CCDB response (Valid-From :  " + mHeaders["Valid-From"] + std::string(" Valid-Until: ") + mHeaders["Valid-Until"] + std::string(")"));
       }
-      auto sh = mHeaders.find("fileSize");
-      if (sh != mHeaders.end()) {
-        size_t s = atol(sh->second.c_str());
-        mFetchedSize += s;
-        cached.minSize = std::min(s, cached.minSize);
-        cached.maxSize = std::max(s, cached.minSize);
-      }
+      size_t s = getFetchedSize(ptr);
+      mFetchedSize += s;
+      cached.minSize = std::min(s, cached.minSize);
+      cached.maxSize = std::max(s, cached.maxSize);
+      cached.size = s;
     } else if (mHeaders.count("Error")) { // in case of errors the pointer is 0 and headers["Error"] should be set
       cached.failures++;
       cached.clear(); // in case of any error clear cache for this object
@@ -362,6 +438,14 @@ class BasicCCDBManager : public CCDBManagerInstance
         setCreatedNotAfter(timeaslong);
       }
     }
+    const char* b = getenv("ALICEO2_CCDB_CACHE_BUDGET");
+    if (b) {
+      auto budget = strtoull(b, nullptr, 10);
+      if (budget != 0ULL) {
+        LOG(info) << "Older versions of cached CCDB objects will be kept up to " << budget << " bytes";
+        setCacheBudget(budget);
+      }
+    }
   }
 };
 
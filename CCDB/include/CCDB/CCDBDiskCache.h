@@ -0,0 +1,126 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CCDBDiskCache.h
+/// \brief Node-local disk cache of CCDB blobs shared between processes
+
+#ifndef O2_CCDB_DISKCACHE_H
+#define O2_CCDB_DISKCACHE_H
+
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <fstream>
+#include <filesystem>
+#include <mutex>
+#include <chrono>
+
+namespace o2::ccdb
+{
+
+/// Blobs downloaded from the CCDB are stored in the cache directory together with the response headers.
+/// The entries are grouped per query (path, metadata and time-machine limits), each entry being addressed by the hash
+/// of the query, the validity interval and the ETag/MD5 of the object, so that concurrent writers of the same object produce
+/// the same files. The files are written under temporary names and atomically renamed, so that readers never see partially
+/// written entries. Once the total size of the blobs exceeds the limit, the least recently used ones are removed.
+/// The total size is tracked incrementally between the scans of the directory, which are done on excess of the size
+/// known to this instance or at most every RescanInterval seconds, to account for the blobs stored by other processes.
+/// The parsed headers of each query are kept in memory and the header files are read again only when the modification
+/// time of the query directory changes, i.e. when an entry is stored, updated or evicted by any process.
+class CCDBDiskCache
+{
+ public:
+  static constexpr size_t DefaultMaxSize = 0x1UL << 32;
+  static constexpr int RescanInterval = 60; // max time in s between the scans of the cache directory for the eviction
+
+  struct Entry {
+    std::string blobFile{};
+    std::map<std::string, std::string> headers{};
+    std::string etag{};
+    long validFrom = 0;
+    long validUntil = -1;
+    long created = 0;
+    long cacheValidFrom = 0;   // timestamp of the query which fetched the object
+    long cacheValidUntil = -1; // the server guarantees to serve this object for the query till this time (modulo new updates)
+    bool isValid(long ts) const { return ts >= validFrom && ts < validUntil; }
+    bool isCacheValid(long ts) const { return ts >= cacheValidFrom && ts < cacheValidUntil; }
+  };
+
+  CCDBDiskCache(const std::string& dir, size_t maxSize = DefaultMaxSize);
+
+  /// key identifying the query: path, metadata filter and creation time limits
+  static std::string getQueryKey(const std::string& path, const std::map<std::string, std::string>& metadata,
+                                 const std::string& createdNotAfter = "", const std::string& createdNotBefore = "");
+
+  /// find the most recent cached object of the query valid for the timestamp
+  std::optional<Entry> find(const std::string& queryKey, long timestamp) const;
+
+  /// store the blob fetched for the query at the timestamp with the response headers, objects w/o ETag are not stored
+  bool store(const std::string& queryKey, long timestamp, const char* data, size_t size, const std::map<std::string, std::string>& headers);
+
+  /// load the blob of the entry to the vector, false if it is not available anymore
+  template <typename V>
+  bool load(const Entry& entry, V& dest) const;
+
+  /// scan the cache directory and remove least recently used blobs until the total size fits to the limit
+  void evict() const;
+
+  /// total size of stored blobs
+  size_t getTotalSize() const;
+
+  const std::string& getDir() const { return mDir; }
+  size_t getMaxSize() const { return mMaxSize; }
+
+ private:
+  /// parsed header files of a query directory, per file name
+  struct QueryIndex {
+    std::filesystem::file_time_type dirTime{};
+    std::map<std::string, std::pair<std::filesystem::file_time_type, Entry>> entries{};
+  };
+
+  static std::string hash(const std::string& str);
+  static bool readHeader(const std::filesystem::path& fileName, Entry& entry);
+  static void updateIndex(const std::filesystem::path& queryDir, QueryIndex& index);
+  static void touch(const std::string& fileName);
+  static bool writeAtomically(const std::string& fileName, const char* data, size_t size);
+  void evictIfNeeded(size_t addedSize) const;
+
+  std::string mDir{};
+  size_t mMaxSize = DefaultMaxSize;
+  mutable std::mutex mSizeMutex;
+  mutable size_t mKnownSize = 0;                              // size at the last scan + size stored by this instance since then
+  mutable std::chrono::steady_clock::time_point mLastScan{}; // time of the last scan, never scanned if default
+  mutable std::mutex mIndexMutex;
+  mutable std::unordered_map<std::string, QueryIndex> mIndex; // per query key
+};
+
+template <typename V>
+bool CCDBDiskCache::load(const Entry& entry, V& dest) const
+{
+  std::ifstream inp(entry.blobFile, std::ios::binary | std::ios::ate); // the blob stays readable even if it is evicted concurrently
+  if (!inp.is_open()) {
+    return false;
+  }
+  size_t size = inp.tellg();
+  inp.seekg(0);
+  dest.resize(size);
+  if (!inp.read(dest.data(), size)) {
+    dest.clear();
+    return false;
+  }
+  touch(entry.blobFile);
+  return true;
+}
+
+} // namespace o2::ccdb
+
+#endif
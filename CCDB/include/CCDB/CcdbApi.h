@@ -27,6 +27,7 @@
 #include <CommonUtils/ConfigurableParam.h>
 #include <type_traits>
 #include <vector>
+#include <functional>
 
 #if !defined(__CINT__) && !defined(__MAKECINT__) && !defined(__ROOTCLING__) && !defined(__CLING__)
 #include "MemoryResources/MemoryResources.h"
@@ -47,6 +48,7 @@ namespace ccdb
 {
 
 class CCDBQuery;
+class CCDBDiskCache;
 
 /**
  * Interface to the CCDB.
@@ -92,6 +94,17 @@ class CcdbApi //: public DatabaseInterface
    */
   bool isSnapshotMode() const { return mInSnapshotMode; }
 
+  /**
+   * Use node-local disk cache of the blobs, shared between processes, before querying the server.
+   * Can be also enabled by ALICEO2_CCDB_DISKCACHE=<dir> (and optionally ALICEO2_CCDB_DISKCACHE_SIZE=<bytes>) env.vars.
+   * Ignored if the local snapshot cache (ALICEO2_CCDB_LOCALCACHE) or snapshot mode is used.
+   *
+   * @param dir cache directory
+   * @param maxSize max size of the stored blobs in bytes, least recently used ones are evicted above it
+   */
+  void setDiskCache(std::string const& dir, size_t maxSize);
+  bool isDiskCacheEnabled() const { return mDiskCache != nullptr; }
+
   /**
    * Create a binary image of the arbitrary type object, if CcdbObjectInfo pointer is provided, register there
    *
@@ -358,6 +371,7 @@ class CcdbApi //: public DatabaseInterface
     std::string etag;
     std::string createdNotAfter;
     std::string createdNotBefore;
+    std::string diskCacheETag; // ETag of the object available in the disk cache, used for the conditional request
     bool considerSnapshot;
 
     RequestContext(o2::pmr::vector<char>& d,
@@ -409,15 +423,29 @@ class CcdbApi //: public DatabaseInterface
     return obj;
   }
 
+  /// source of the file provided by navigateSourcesAndLoadFile, FromServer if it was scheduled for download
+  enum FileSource : int { FromServer = 0,
+                          FromSnapshotMode = 1,
+                          FromSnapshotCache = 2,
+                          FromDiskCache = 3 };
+
   /**
    * Retrieves files either as snapshot or schedules them to be downloaded via CCDBDownloader.
    *
    * @param requestContext Structure giving details about the transfer.
-   * @param fromSnapshot After navigateSourcesAndLoadFile returns signals whether file was retrieved from snapshot.
+   * @param fromSnapshot After navigateSourcesAndLoadFile returns signals whether file was retrieved from snapshot or disk cache, see FileSource.
    * @param requestCounter Pointer to the variable storing the number of requests to be done.
    */
   void navigateSourcesAndLoadFile(RequestContext& requestContext, int& fromSnapshot, size_t* requestCounter) const;
 
+  /**
+   * Serves the request from the disk cache if the cached object is guaranteed to be valid, otherwise prepares the conditional request
+   * for the object available in the cache.
+   *
+   * @return true if the request was served
+   */
+  bool loadFromDiskCache(RequestContext& requestContext, int& fromSnapshot) const;
+
   /**
    * Retrieves files described via RequestContexts into memory. Downloads are performed in parallel via CCDBDownloader.
    *
@@ -558,7 +586,10 @@ class CcdbApi //: public DatabaseInterface
 
   /// Queries the CCDB server and navigates through possible redirects until binary content is found; Retrieves content as instance
   /// given by tinfo if that is possible. Returns nullptr if something fails...
-  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers) const;
+  /// The optional onBlob is called with the downloaded binary content before its interpretation,
+  /// together with the headers of the response which provided it (i.e. w/o those of the redirections)
+  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers,
+                                       std::function<void(const char*, size_t, std::map<std::string, std::string> const&)> const& onBlob = {}) const;
 
   // helper that interprets a content chunk as TMemFile and extracts the object therefrom
   static void* interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo);
@@ -637,6 +668,8 @@ class CcdbApi //: public DatabaseInterface
   std::string mSnapshotCachePath{};  // root of the local snapshot (to fill or impose, even if not in the snapshot backend mode)
   bool mPreferSnapshotCache = false; // if snapshot is available, don't try to query its validity even in non-snapshot backend mode
   bool mInSnapshotMode = false;
+  std::shared_ptr<CCDBDiskCache> mDiskCache; //! node-local disk cache of the blobs
+  bool mTrustDiskCache = true;               // serve objects guaranteed to be valid from the disk cache w/o query (not in online modes)
   mutable TGrid* mAlienInstance = nullptr;                       // a cached connection to TGrid (needed for Alien locations)
   bool mNeedAlienToken = true;                                   // On EPN and FLP we use a local cache and don't need the alien token
   static std::unique_ptr<TJAlienCredentials> mJAlienCredentials; // access JAliEn credentials
@@ -32,6 +32,97 @@ void CCDBManagerInstance::reportFatal(std::string_view err)
   LOG(fatal) << err;
 }
 
+void CCDBManagerInstance::clearCache(std::string const& path)
+{
+  mCache.erase(path);
+  auto older = mOlderVersions.find(path);
+  if (older != mOlderVersions.end()) {
+    for (const auto& v : older->second) {
+      mOlderVersionsSize -= v.size;
+    }
+    mOlderVersions.erase(older);
+  }
+}
+
+int CCDBManagerInstance::findOlderVersion(std::string const& path, long timestamp)
+{
+  auto older = mOlderVersions.find(path);
+  if (older != mOlderVersions.end()) {
+    for (size_t i = 0; i < older->second.size(); i++) {
+      if (isUsable(older->second[i], timestamp)) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+bool CCDBManagerInstance::restoreOlderVersion(std::string const& path, CachedObject& cached, long timestamp)
+{
+  int id = findOlderVersion(path, timestamp);
+  if (id < 0) {
+    return false;
+  }
+  auto& versions = mOlderVersions[path];
+  auto& version = versions[id];
+  mOlderVersionsSize -= version.size;
+  cached.swapVersion(version);
+  cached.lastUse = ++mCacheTick;
+  if (version.objPtr) { // previously current version becomes an older one
+    mOlderVersionsSize += version.size;
+  } else {
+    versions.erase(versions.begin() + id);
+  }
+  LOGP(debug, "Restored cached version {} of {} valid for {}", cached.uuid, path, timestamp);
+  evictOlderVersions();
+  return true;
+}
+
+void CCDBManagerInstance::archiveCurrentVersion(std::string const& path, CachedObject& cached, std::string const& newUUID)
+{
+  if (!mCacheBudget || !cached.objPtr || cached.noCleanupPtr) { // objects which are not owned by the cache cannot be kept
+    return;
+  }
+  auto& versions = mOlderVersions[path];
+  for (size_t i = 0; i < versions.size(); i++) { // the new version may be already kept, e.g. for different cache validity
+    if (versions[i].uuid == newUUID) {
+      mOlderVersionsSize -= versions[i].size;
+      versions.erase(versions.begin() + i);
+      break;
+    }
+  }
+  auto& version = versions.emplace_back();
+  cached.swapVersion(version);
+  version.lastUse = ++mCacheTick;
+  mOlderVersionsSize += version.size;
+  evictOlderVersions();
+}
+
+void CCDBManagerInstance::evictOlderVersions()
+{
+  while (mOlderVersionsSize > mCacheBudget || (!mCacheBudget && !mOlderVersions.empty())) {
+    std::vector<CachedObject>* lruVersions = nullptr;
+    size_t lruID = 0;
+    for (auto& [path, versions] : mOlderVersions) {
+      for (size_t i = 0; i < versions.size(); i++) {
+        if (!lruVersions || versions[i].lastUse < (*lruVersions)[lruID].lastUse) {
+          lruVersions = &versions;
+          lruID = i;
+        }
+      }
+    }
+    if (!lruVersions) {
+      mOlderVersions.clear();
+      mOlderVersionsSize = 0;
+      break;
+    }
+    mOlderVersionsSize -= (*lruVersions)[lruID].size;
+    mCacheEvictedSize += (*lruVersions)[lruID].size;
+    mCacheEvicted++;
+    lruVersions->erase(lruVersions->begin() + lruID);
+  }
+}
+
 std::pair<int64_t, int64_t> CCDBManagerInstance::getRunDuration(const std::map<std::string, std::string>& headers)
 {
   if (headers.size() != 0) {
@@ -113,7 +204,16 @@ std::string CCDBManagerInstance::getSummaryString() const
     }
     res += fmt::format(" for {} objects", nfailObj);
   }
-  res += fmt::format(") in {} ms, instance: {}", fmt::group_digits(mTimerMS), mCCDBAccessor.getUniqueAgentID());
+  res += fmt::format(") in {} ms", fmt::group_digits(mTimerMS));
+  if (mCachingEnabled) {
+    size_t nOlder = 0;
+    for (const auto& older : mOlderVersions) {
+      nOlder += older.second.size();
+    }
+    res += fmt::format(", cache: {} hits, {} misses, {} older versions of {} bytes kept (budget {}), {} evicted ({} bytes)",
+                       mCacheHits, mCacheMisses, nOlder, fmt::group_digits(mOlderVersionsSize), fmt::group_digits(mCacheBudget), mCacheEvicted, fmt::group_digits(mCacheEvictedSize));
+  }
+  res += fmt::format(", instance: {}", mCCDBAccessor.getUniqueAgentID());
   return res;
 }
 
@@ -123,7 +223,9 @@ void CCDBManagerInstance::report(bool longrep)
   if (longrep && mCachingEnabled) {
     LOGP(info, "CCDB cache miss/hit/failures");
     for (const auto& obj : mCache) {
-      LOGP(info, "  {}: {}/{}/{} ({}-{} bytes)", obj.first, obj.second.fetches, obj.second.queries - obj.second.fetches - obj.second.failures, obj.second.failures, obj.second.minSize, obj.second.maxSize);
+      auto older = mOlderVersions.find(obj.first);
+      LOGP(info, "  {}: {}/{}/{} ({}-{} bytes), {} older versions kept", obj.first, obj.second.fetches, obj.second.queries - obj.second.fetches - obj.second.failures, obj.second.failures, obj.second.minSize, obj.second.maxSize,
+           older == mOlderVersions.end() ? 0 : older->second.size());
     }
   }
 }
@@ -0,0 +1,315 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CCDBDiskCache.cxx
+/// \brief Node-local disk cache of CCDB blobs shared between processes
+
+#include "CCDB/CCDBDiskCache.h"
+#include <fairlogger/Logger.h>
+#include <TMD5.h>
+#include <fmt/format.h>
+#include <filesystem>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace o2::ccdb
+{
+
+namespace
+{
+constexpr std::string_view BlobExt = ".blob";
+constexpr std::string_view HeaderExt = ".hdr";
+constexpr char QueryTimestampKey[] = "O2-Cache-Query-Timestamp"; // timestamp of the query which fetched the object
+
+long getLong(const std::map<std::string, std::string>& headers, const std::string& key, long defVal)
+{
+  auto it = headers.find(key);
+  if (it != headers.end()) {
+    try {
+      return std::stol(it->second);
+    } catch (...) {
+    }
+  }
+  return defVal;
+}
+} // namespace
+
+CCDBDiskCache::CCDBDiskCache(const std::string& dir, size_t maxSize) : mMaxSize(maxSize)
+{
+  mDir = fs::weakly_canonical(fs::absolute(dir.empty() ? "." : dir));
+  std::error_code ec;
+  fs::create_directories(mDir, ec);
+  if (ec) {
+    LOGP(error, "Failed to create CCDB disk cache directory {}: {}", mDir, ec.message());
+  }
+}
+
+std::string CCDBDiskCache::hash(const std::string& str)
+{
+  TMD5 md5;
+  md5.Update(reinterpret_cast<const UChar_t*>(str.data()), str.size());
+  md5.Final();
+  return md5.AsString();
+}
+
+std::string CCDBDiskCache::getQueryKey(const std::string& path, const std::map<std::string, std::string>& metadata,
+                                       const std::string& createdNotAfter, const std::string& createdNotBefore)
+{
+  std::string query = path;
+  for (const auto& [key, value] : metadata) {
+    query += '/' + key + '=' + value;
+  }
+  query += "/NotAfter=" + createdNotAfter + "/NotBefore=" + createdNotBefore;
+  return hash(query);
+}
+
+void CCDBDiskCache::touch(const std::string& fileName)
+{
+  std::error_code ec; // last use time for the LRU eviction
+  fs::last_write_time(fileName, fs::file_time_type::clock::now(), ec);
+}
+
+bool CCDBDiskCache::writeAtomically(const std::string& fileName, const char* data, size_t size)
+{
+  std::stringstream tmpName;
+  tmpName << fileName << '.' << getpid() << '.' << std::this_thread::get_id() << ".tmp";
+  {
+    std::ofstream out(tmpName.str(), std::ios::binary | std::ios::trunc);
+    if (!out.write(data, size) || !out.flush()) {
+      out.close();
+      std::error_code ec;
+      fs::remove(tmpName.str(), ec);
+      return false;
+    }
+  }
+  std::error_code ec;
+  fs::rename(tmpName.str(), fileName, ec); // concurrent writers of the same entry write identical content
+  if (ec) {
+    fs::remove(tmpName.str(), ec);
+    return false;
+  }
+  return true;
+}
+
+bool CCDBDiskCache::readHeader(const fs::path& fileName, Entry& entry)
+{
+  std::ifstream inp(fileName);
+  if (!inp.is_open()) { // could be evicted meanwhile
+    return false;
+  }
+  std::string line;
+  while (std::getline(inp, line)) {
+    auto sep = line.find('\t');
+    if (sep != std::string::npos) {
+      entry.headers[line.substr(0, sep)] = line.substr(sep + 1);
+    }
+  }
+  entry.blobFile = (fs::path(fileName).replace_extension(BlobExt)).string();
+  entry.validFrom = getLong(entry.headers, "Valid-From", 0);
+  entry.validUntil = getLong(entry.headers, "Valid-Until", -1);
+  entry.etag = entry.headers["ETag"];
+  entry.created = getLong(entry.headers, "Created", 0);
+  entry.cacheValidFrom = getLong(entry.headers, QueryTimestampKey, 0);
+  entry.cacheValidUntil = getLong(entry.headers, "Cache-Valid-Until", -1);
+  entry.headers.erase(QueryTimestampKey);
+  return true;
+}
+
+void CCDBDiskCache::updateIndex(const fs::path& queryDir, QueryIndex& index)
+{
+  // only the new or rewritten header files are parsed, those which disappeared are dropped
+  std::map<std::string, std::pair<fs::file_time_type, Entry>> entries;
+  std::error_code ec;
+  for (fs::directory_iterator it(queryDir, ec), end; !ec && it != end; it.increment(ec)) {
+    const auto& fpath = it->path();
+    if (fpath.extension() != HeaderExt) {
+      continue;
+    }
+    std::error_code fec;
+    auto time = it->last_write_time(fec);
+    if (fec) {
+      continue;
+    }
+    auto name = fpath.filename().string();
+    auto old = index.entries.find(name);
+    if (old != index.entries.end() && old->second.first == time) {
+      entries.emplace(name, std::move(old->second));
+      continue;
+    }
+    Entry entry;
+    if (readHeader(fpath, entry)) {
+      entries.emplace(name, std::make_pair(time, std::move(entry)));
+    }
+  }
+  index.entries = std::move(entries);
+}
+
+std::optional<CCDBDiskCache::Entry> CCDBDiskCache::find(const std::string& queryKey, long timestamp) const
+{
+  std::optional<Entry> best;
+  auto queryDir = fs::path(mDir) / queryKey;
+  std::error_code ec;
+  auto dirTime = fs::last_write_time(queryDir, ec); // taken before the scan, so that the files added during it are seen next time
+  if (ec) {
+    return best;
+  }
+  std::lock_guard<std::mutex> lock(mIndexMutex);
+  auto& index = mIndex[queryKey];
+  // the modification times have the granularity of the kernel tick, a directory modified very recently may be modified again w/o change
+  if (index.dirTime != dirTime || fs::file_time_type::clock::now() - dirTime < std::chrono::seconds(1)) {
+    updateIndex(queryDir, index);
+    index.dirTime = dirTime;
+  }
+  for (const auto& [name, timeEntry] : index.entries) {
+    const auto& entry = timeEntry.second;
+    if (!entry.isValid(timestamp)) {
+      continue;
+    }
+    if (best && (entry.created < best->created || (entry.created == best->created && (!entry.isCacheValid(timestamp) || best->isCacheValid(timestamp))))) {
+      continue;
+    }
+    if (!fs::exists(entry.blobFile, ec)) {
+      continue;
+    }
+    best = entry;
+  }
+  return best;
+}
+
+bool CCDBDiskCache::store(const std::string& queryKey, long timestamp, const char* data, size_t size, const std::map<std::string, std::string>& headers)
+{
+  auto etagIt = headers.find("ETag");
+  if (etagIt == headers.end() || etagIt->second.empty() || headers.find("Error") != headers.end()) {
+    return false;
+  }
+  auto md5It = headers.find("Content-MD5");
+  auto key = hash(fmt::format("{}/{}-{}/{}/{}", queryKey, getLong(headers, "Valid-From", 0), getLong(headers, "Valid-Until", -1),
+                              etagIt->second, md5It == headers.end() ? std::string{} : md5It->second));
+  auto qdir = fs::path(mDir) / queryKey;
+  std::error_code ec;
+  fs::create_directories(qdir, ec);
+  auto blobFile = (qdir / (key + std::string(BlobExt))).string();
+  size_t addedSize = 0;
+  if (!fs::exists(blobFile, ec)) {
+    if (!writeAtomically(blobFile, data, size)) {
+      LOGP(warn, "Failed to store CCDB blob of {} bytes to disk cache as {}", size, blobFile);
+      return false;
+    }
+    addedSize = size;
+  }
+  std::string hdr;
+  for (const auto& [hkey, value] : headers) {
+    if (hkey.find_first_of("\t\n") == std::string::npos && value.find('\n') == std::string::npos) {
+      hdr += hkey + '\t' + value + '\n';
+    }
+  }
+  hdr += fmt::format("{}\t{}\n", QueryTimestampKey, timestamp);
+  // the header is written after the blob, so that the entry is visible only once complete
+  if (!writeAtomically((qdir / (key + std::string(HeaderExt))).string(), hdr.data(), hdr.size())) {
+    return false;
+  }
+  touch(blobFile);
+  evictIfNeeded(addedSize);
+  return true;
+}
+
+size_t CCDBDiskCache::getTotalSize() const
+{
+  size_t tot = 0;
+  std::error_code ec;
+  for (fs::recursive_directory_iterator it(mDir, ec), end; !ec && it != end; it.increment(ec)) {
+    std::error_code fec; // the file may be evicted concurrently
+    if (it->path().extension() == BlobExt) {
+      auto sz = it->file_size(fec);
+      tot += fec ? 0 : sz;
+    }
+  }
+  return tot;
+}
+
+void CCDBDiskCache::evictIfNeeded(size_t addedSize) const
+{
+  {
+    std::lock_guard<std::mutex> lock(mSizeMutex);
+    mKnownSize += addedSize;
+    bool scanned = mLastScan != std::chrono::steady_clock::time_point{};
+    if (scanned && mKnownSize <= mMaxSize && std::chrono::steady_clock::now() - mLastScan < std::chrono::seconds(RescanInterval)) {
+      return;
+    }
+  }
+  evict();
+}
+
+void CCDBDiskCache::evict() const
+{
+  struct BlobInfo {
+    fs::path path;
+    size_t size = 0;
+    fs::file_time_type lastUse;
+  };
+  std::vector<BlobInfo> blobs;
+  size_t tot = 0;
+  std::error_code ec;
+  for (fs::recursive_directory_iterator it(mDir, ec), end; !ec && it != end; it.increment(ec)) {
+    if (it->path().extension() == BlobExt) {
+      std::error_code fec1, fec2; // the file may be evicted concurrently
+      BlobInfo blob{it->path(), it->file_size(fec1), it->last_write_time(fec2)};
+      if (!fec1 && !fec2) {
+        tot += blob.size;
+        blobs.push_back(blob);
+      }
+    }
+  }
+  auto setKnownSize = [this](size_t sz) {
+    std::lock_guard<std::mutex> lock(mSizeMutex);
+    mKnownSize = sz;
+    mLastScan = std::chrono::steady_clock::now();
+  };
+  setKnownSize(tot);
+  if (tot <= mMaxSize) {
+    return;
+  }
+  // only one process evicts at a time, others skip the eviction
+  auto lockName = (fs::path(mDir) / ".evict.lock").string();
+  int fd = open(lockName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+  if (fd < 0 || flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return;
+  }
+  std::sort(blobs.begin(), blobs.end(), [](const BlobInfo& a, const BlobInfo& b) { return a.lastUse < b.lastUse; });
+  size_t nEvicted = 0, szEvicted = 0;
+  for (const auto& blob : blobs) {
+    if (tot <= mMaxSize) {
+      break;
+    }
+    fs::remove(fs::path(blob.path).replace_extension(HeaderExt), ec); // header 1st to hide the entry
+    if (fs::remove(blob.path, ec)) {
+      tot -= blob.size;
+      szEvicted += blob.size;
+      nEvicted++;
+    }
+  }
+  flock(fd, LOCK_UN);
+  close(fd);
+  setKnownSize(tot);
+  LOGP(info, "Evicted {} blobs of {} bytes from CCDB disk cache {}, {} bytes left", nEvicted, szEvicted, mDir, tot);
+}
+
+} // namespace o2::ccdb
@@ -16,6 +16,7 @@
 
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CCDBQuery.h"
+#include "CCDB/CCDBDiskCache.h"
 
 #include "CommonUtils/StringUtils.h"
 #include "CommonUtils/FileSystemUtils.h"
@@ -24,6 +25,7 @@
 #include "Framework/DataTakingContext.h"
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <TFile.h>
 #include <TGrid.h>
@@ -213,6 +215,20 @@ void CcdbApi::init(std::string const& host)
   if (!snapshotReport.empty()) {
     snapshotReport += ')';
   }
+  // The environment option ALICEO2_CCDB_DISKCACHE enables the node-local cache of downloaded blobs, shared by all processes
+  // using the same directory. Contrary to the snapshot cache above, multiple versions (validity intervals) of the objects are kept and
+  // served only if they are valid for the query, objects are validated by the server (w/o download) when needed.
+  const char* diskCacheDir = getenv("ALICEO2_CCDB_DISKCACHE");
+  if (diskCacheDir && !mInSnapshotMode && mSnapshotCachePath.empty()) {
+    size_t maxSize = CCDBDiskCache::DefaultMaxSize;
+    if (getenv("ALICEO2_CCDB_DISKCACHE_SIZE")) {
+      maxSize = std::strtoull(getenv("ALICEO2_CCDB_DISKCACHE_SIZE"), nullptr, 10);
+    }
+    setDiskCache(diskCacheDir, maxSize);
+  }
+  if (mDiskCache) {
+    snapshotReport += fmt::format("(disk cache dir={}, max size={}{})", mDiskCache->getDir(), mDiskCache->getMaxSize(), mTrustDiskCache ? "" : ", validate");
+  }
 
   mNeedAlienToken = (host.find("https://") != std::string::npos) || (host.find("alice-ccdb.cern.ch") != std::string::npos);
 
@@ -264,6 +280,20 @@ void CcdbApi::init(std::string const& host)
        mInSnapshotMode ? "(snapshot readonly mode)" : snapshotReport.c_str(), mCurlTimeoutUpload, mCurlTimeoutDownload);
 }
 
+void CcdbApi::setDiskCache(std::string const& dir, size_t maxSize)
+{
+  if (mInSnapshotMode || !mSnapshotCachePath.empty()) {
+    LOGP(warn, "CCDB disk cache {} is ignored in the snapshot mode or with the local snapshot cache", dir);
+    return;
+  }
+  mDiskCache = std::make_shared<CCDBDiskCache>(dir, maxSize);
+  // objects may be updated during online processing, always validate them with the server
+  auto deploymentMode = o2::framework::DefaultsHelpers::deploymentMode();
+  mTrustDiskCache = !(deploymentMode == o2::framework::DeploymentMode::OnlineDDS ||
+                      deploymentMode == o2::framework::DeploymentMode::OnlineAUX ||
+                      deploymentMode == o2::framework::DeploymentMode::OnlineECS);
+}
+
 void CcdbApi::runDownloaderLoop(bool noWait)
 {
   mDownloader->runLoop(noWait);
@@ -999,7 +1029,8 @@ void* CcdbApi::interpretAsTMemFileAndExtract(char* contentptr, size_t contentsiz
 }
 
 // navigate sequence of URLs until TFile content is found; object is extracted and returned
-void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers) const
+void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers,
+                                               std::function<void(const char*, size_t, std::map<std::string, std::string> const&)> const& onBlob) const
 {
   // a global internal data structure that can be filled with HTTP header information
   // static --> to avoid frequent alloc/dealloc as optimization
@@ -1038,6 +1069,9 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
     }
     if (200 <= response_code && response_code < 300) {
       // good response and the content is directly provided and should have been dumped into "chunk"
+      if (onBlob) {
+        onBlob(chunk.memory, chunk.size, std::map<std::string, std::string>(headerData.begin(), headerData.end()));
+      }
       content = interpretAsTMemFileAndExtract(chunk.memory, chunk.size, tinfo);
       if (headers && headers->find("fileSize") == headers->end()) {
         (*headers)["fileSize"] = fmt::format("{}", chunk.size);
@@ -1082,7 +1116,7 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
       for (auto& l : locs) {
         if (l.size() > 0) {
           LOG(debug) << "Trying content location " << l;
-          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, headers);
+          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, headers, onBlob);
           if (content /* or other success marker in future */) {
             break;
           }
@@ -1145,6 +1179,52 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
 
   // normal mode follows
 
+  // check the node-local disk cache first
+  std::map<std::string, std::string> localHeaders;
+  std::optional<CCDBDiskCache::Entry> diskEntry;
+  std::string diskQueryKey, requestETag = etag;
+  auto loadFromDisk = [this, &tinfo](const CCDBDiskCache::Entry& entry, std::map<std::string, std::string>* hdr) -> void* {
+    std::vector<char> blob;
+    if (!mDiskCache->load(entry, blob)) {
+      return nullptr;
+    }
+    for (const auto& h : entry.headers) { // keep fresh headers of the server reply, if any
+      hdr->emplace(h.first, h.second);
+    }
+    hdr->emplace("fileSize", std::to_string(blob.size()));
+    return interpretAsTMemFileAndExtract(blob.data(), blob.size(), tinfo);
+  };
+  if (mDiskCache && !mInSnapshotMode) {
+    if (!headers) {
+      headers = &localHeaders; // needed to store the object and to detect the errors
+    }
+    diskQueryKey = CCDBDiskCache::getQueryKey(path, metadata, createdNotAfter, createdNotBefore);
+    diskEntry = mDiskCache->find(diskQueryKey, timestamp);
+    if (diskEntry && mTrustDiskCache && diskEntry->isCacheValid(timestamp)) {
+      if (!etag.empty() && etag == diskEntry->etag) { // the caller has this object already
+        for (const auto& h : diskEntry->headers) {
+          (*headers)[h.first] = h.second;
+        }
+        return nullptr;
+      }
+      if (auto res = loadFromDisk(*diskEntry, headers)) {
+        logReading(path, timestamp, headers, "retrieve from disk cache");
+        return res;
+      }
+      diskEntry.reset(); // evicted meanwhile
+    }
+    if (diskEntry && requestETag.empty()) {
+      requestETag = diskEntry->etag; // conditional request, the object will be read from the disk if not modified
+    }
+  }
+  std::function<void(const char*, size_t, std::map<std::string, std::string> const&)> storeBlob;
+  if (!diskQueryKey.empty()) {
+    // only the headers of the final response describe the stored blob, those accumulated in *headers may come from the redirections
+    storeBlob = [this, &diskQueryKey, timestamp](const char* data, size_t size, std::map<std::string, std::string> const& blobHeaders) {
+      mDiskCache->store(diskQueryKey, timestamp, data, size, blobHeaders);
+    };
+  }
+
   CURL* curl_handle = curl_easy_init();
   curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, mUniqueAgentID.c_str());
   string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp); // todo check if function still works correctly in case mInSnapshotMode
@@ -1158,15 +1238,31 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
   }
 
   curl_slist* option_list = nullptr;
-  initCurlHTTPHeaderOptionsForRetrieve(curl_handle, option_list, timestamp, headers, etag, createdNotAfter, createdNotBefore);
-  auto content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers);
+  initCurlHTTPHeaderOptionsForRetrieve(curl_handle, option_list, timestamp, headers, requestETag, createdNotAfter, createdNotBefore);
+  auto content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers, storeBlob);
 
   for (size_t hostIndex = 1; hostIndex < hostsPool.size() && !(content); hostIndex++) {
     fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp, hostIndex);
-    content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers);
+    content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers, storeBlob);
   }
   if (content) {
     logReading(path, timestamp, headers, "retrieve");
+  } else if (diskEntry) {
+    long responseCode = 0; // 0 if no response was received
+    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (responseCode == 304 && requestETag != etag) { // not modified, use the disk cache
+      content = loadFromDisk(*diskEntry, headers);
+      if (content) {
+        logReading(path, timestamp, headers, "retrieve from validated disk cache");
+      }
+    } else if (responseCode == 0) { // the server could not be reached, use the disk cache w/o validation
+      content = loadFromDisk(*diskEntry, headers);
+      if (content) {
+        LOGP(warn, "CCDB server not reachable for {} at {}, serving the object {} from the disk cache w/o validation", path, timestamp, diskEntry->etag);
+        headers->erase("Error");
+        logReading(path, timestamp, headers, "retrieve from non-validated disk cache");
+      }
+    }
   }
   curl_slist_free_all(option_list);
   curl_easy_cleanup(curl_handle);
@@ -1834,13 +1930,13 @@ void CcdbApi::getFromSnapshot(bool createSnapshot, std::string const& path,
     if (etag.empty()) {
       loadFileToMemory(dest, getSnapshotFile(mSnapshotTopPath, path), &headers);
     }
-    fromSnapshot = 1;
+    fromSnapshot = FromSnapshotMode;
   } else if (mPreferSnapshotCache && std::filesystem::exists(snapshotpath)) {
     // if file is available, use it, otherwise cache it below from the server. Do this only when etag is empty since otherwise the object was already fetched and cached
     if (etag.empty()) {
       loadFileToMemory(dest, snapshotpath, &headers);
     }
-    fromSnapshot = 2;
+    fromSnapshot = FromSnapshotCache;
   }
 }
 
@@ -1918,11 +2014,34 @@ void CcdbApi::navigateSourcesAndLoadFile(RequestContext& requestContext, int& fr
     // if we are in snapshot mode we can simply open the file, unless the etag is non-empty:
     // this would mean that the object was is already fetched and in this mode we don't to validity checks!
     getFromSnapshot(createSnapshot, requestContext.path, requestContext.timestamp, requestContext.headers, snapshotpath, requestContext.dest, fromSnapshot, requestContext.etag);
-  } else { // look on the server
+  } else if (!mDiskCache || !loadFromDiskCache(requestContext, fromSnapshot)) { // look on the server
     scheduleDownload(requestContext, requestCounter);
   }
 }
 
+bool CcdbApi::loadFromDiskCache(RequestContext& requestContext, int& fromSnapshot) const
+{
+  auto entry = mDiskCache->find(CCDBDiskCache::getQueryKey(requestContext.path, requestContext.metadata, requestContext.createdNotAfter, requestContext.createdNotBefore),
+                                requestContext.timestamp);
+  if (!entry) {
+    return false;
+  }
+  if (mTrustDiskCache && entry->isCacheValid(requestContext.timestamp)) {
+    if (requestContext.etag != entry->etag && !mDiskCache->load(*entry, requestContext.dest)) { // otherwise the caller has this object already
+      return false;
+    }
+    requestContext.headers = entry->headers;
+    requestContext.headers.emplace("fileSize", std::to_string(requestContext.dest.size()));
+    fromSnapshot = FromDiskCache;
+    return true;
+  }
+  if (requestContext.etag.empty()) { // conditional request, the object will be read from the disk if not modified
+    requestContext.etag = entry->etag;
+    requestContext.diskCacheETag = entry->etag;
+  }
+  return false;
+}
+
 void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requestContexts) const
 {
   std::vector<int> fromSnapshots(requestContexts.size());
@@ -1943,10 +2062,24 @@ void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requestConte
   // Save snapshots
   for (int i = 0; i < requestContexts.size(); i++) {
     auto& requestContext = requestContexts.at(i);
+    if (mDiskCache && fromSnapshots.at(i) == FromServer && requestContext.headers.find("Error") == requestContext.headers.end()) {
+      auto queryKey = CCDBDiskCache::getQueryKey(requestContext.path, requestContext.metadata, requestContext.createdNotAfter, requestContext.createdNotBefore);
+      if (!requestContext.dest.empty()) {
+        mDiskCache->store(queryKey, requestContext.timestamp, requestContext.dest.data(), requestContext.dest.size(), requestContext.headers);
+      } else if (!requestContext.diskCacheETag.empty()) { // not modified, use the disk cache
+        auto entry = mDiskCache->find(queryKey, requestContext.timestamp);
+        if (entry && entry->etag == requestContext.diskCacheETag && mDiskCache->load(*entry, requestContext.dest)) {
+          for (const auto& h : entry->headers) {
+            requestContext.headers.emplace(h.first, h.second);
+          }
+          fromSnapshots.at(i) = FromDiskCache;
+        }
+      }
+    }
     if (!requestContext.dest.empty()) {
       logReading(requestContext.path, requestContext.timestamp, &requestContext.headers,
-                 fmt::format("{}{}", requestContext.considerSnapshot ? "load to memory" : "retrieve", fromSnapshots.at(i) ? " from snapshot" : ""));
-      if (requestContext.considerSnapshot && fromSnapshots.at(i) != 2) {
+                 fmt::format("{}{}", requestContext.considerSnapshot ? "load to memory" : "retrieve", fromSnapshots.at(i) == FromDiskCache ? " from disk cache" : (fromSnapshots.at(i) != FromServer ? " from snapshot" : "")));
+      if (requestContext.considerSnapshot && fromSnapshots.at(i) != FromSnapshotCache && fromSnapshots.at(i) != FromDiskCache) {
         saveSnapshot(requestContext);
       }
     }
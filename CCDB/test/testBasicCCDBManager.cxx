@@ -23,6 +23,8 @@
 #include "CCDB/BasicCCDBManager.h"
 #include "Framework/Logger.h"
 #include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <fstream>
 
 using namespace o2::ccdb;
 
@@ -157,3 +159,67 @@ BOOST_AUTO_TEST_CASE(TestBasicCCDBManager)
   LOG(info) << "Reading A again, it should not be cached: " << *objA;
   BOOST_CHECK(objA && (*objA) != hack); // make sure correct object is loaded
 }
+
+// write the object with given validity and ETag as the snapshot of the path in the local CCDB directory
+void writeSnapshot(std::string const& dir, std::string const& path, std::string const& obj, long start, long stop, std::string const& etag)
+{
+  auto image = CcdbApi::createObjectImage(&obj);
+  auto snapdir = dir + "/" + path;
+  std::filesystem::create_directories(snapdir);
+  auto snapfile = snapdir + "/snapshot.root";
+  {
+    std::ofstream out(snapfile, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(image->data(), image->size());
+  }
+  std::map<std::string, std::string> headers{{"ETag", etag}, {"Valid-From", std::to_string(start)}, {"Valid-Until", std::to_string(stop)}};
+  CcdbApi::updateMetaInformationInLocalFile(snapfile, &headers);
+}
+
+BOOST_AUTO_TEST_CASE(TestBasicCCDBManagerOlderVersions)
+{
+  // served from a local snapshot directory, no CCDB server is needed
+  auto snapdir = std::filesystem::temp_directory_path() / ("testBasicCCDBManager_" + std::to_string(getpid()));
+  std::string pathC = "Test/CachingC";
+  std::string ccdbObjO = "testObjectO";
+  std::string ccdbObjN = "testObjectN";
+  long start = 1000, stop = 2000;
+  writeSnapshot(snapdir, pathC, ccdbObjO, start, stop, "O");
+
+  auto& cdb = o2::ccdb::BasicCCDBManager::instance();
+  cdb.setURL("file://" + snapdir.string());
+  cdb.setCaching(true);
+  cdb.setLocalObjectValidityChecking(true);
+  cdb.setCacheBudget(1 << 20);
+  std::string hack = "Cached";
+
+  auto* objO = cdb.getForTimeStamp<std::string>(pathC, (start + stop) / 2);
+  BOOST_CHECK(objO && (*objO) == ccdbObjO);
+  (*objO) = hack;
+  writeSnapshot(snapdir, pathC, ccdbObjN, stop, stop + (stop - start), "N");
+  auto* objN = cdb.getForTimeStamp<std::string>(pathC, stop + (stop - start) / 2); // new validity interval, previous one is kept
+  BOOST_CHECK(objN && (*objN) == ccdbObjN);
+  BOOST_CHECK(cdb.getOlderVersionsSize() > 0);
+
+  auto misses = cdb.getCacheMisses();
+  objO = cdb.getForTimeStamp<std::string>(pathC, start + 1); // should get the older cached and hacked version w/o query
+  LOG(info) << "Reading C for 1st time slot again, expect cached and modified value: " << *objO;
+  BOOST_CHECK(objO && (*objO) == hack);
+  BOOST_CHECK(cdb.getCacheMisses() == misses);
+  objN = cdb.getForTimeStamp<std::string>(pathC, stop + 1);
+  BOOST_CHECK(objN && (*objN) == ccdbObjN);
+  BOOST_CHECK(cdb.getCacheMisses() == misses);
+
+  // with the budget exhausted the older versions are evicted
+  auto evicted = cdb.getCacheEvicted();
+  cdb.setCacheBudget(0);
+  BOOST_CHECK(cdb.getCacheEvicted() == evicted + 1);
+  BOOST_CHECK(cdb.getOlderVersionsSize() == 0);
+  writeSnapshot(snapdir, pathC, ccdbObjO, start, stop, "O");
+  objO = cdb.getForTimeStamp<std::string>(pathC, start + 1);
+  BOOST_CHECK(objO && (*objO) == ccdbObjO);
+  BOOST_CHECK(cdb.getCacheMisses() == misses + 1);
+  cdb.report(true);
+  cdb.setLocalObjectValidityChecking(false);
+  cdb.clearCache();
+  std::filesystem::remove_all(snapdir);
+}
@@ -0,0 +1,257 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBDiskCache.cxx
+/// \brief  Test of the node-local disk cache of CCDB blobs, the server is emulated by a local directory
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "CCDB/CCDBDiskCache.h"
+#include "CCDB/CcdbApi.h"
+#include <fmt/format.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+namespace fs = std::filesystem;
+
+namespace
+{
+/// local directory standing in for the CCDB server: one object per validity interval
+struct LocalServer {
+  fs::path dir;
+
+  explicit LocalServer(const fs::path& d) : dir(d) { fs::create_directories(dir); }
+
+  void put(const std::string& path, long validFrom, long validUntil, const std::string& content)
+  {
+    auto image = CcdbApi::createObjectImage(&content);
+    auto fname = dir / fmt::format("{}_{}_{}", fs::path(path).filename().string(), validFrom, validUntil);
+    std::ofstream out(fname, std::ios::binary);
+    out.write(image->data(), image->size());
+  }
+
+  /// emulate the query: return the blob and the response headers
+  bool get(const std::string& path, long timestamp, std::vector<char>& blob, std::map<std::string, std::string>& headers) const
+  {
+    for (const auto& file : fs::directory_iterator(dir)) {
+      long from = 0, until = 0;
+      auto name = file.path().filename().string();
+      auto pos = name.rfind('_');
+      auto pos0 = name.rfind('_', pos - 1);
+      if (name.substr(0, pos0) != fs::path(path).filename().string()) {
+        continue;
+      }
+      from = std::stol(name.substr(pos0 + 1, pos - pos0 - 1));
+      until = std::stol(name.substr(pos + 1));
+      if (timestamp < from || timestamp >= until) {
+        continue;
+      }
+      std::ifstream inp(file.path(), std::ios::binary | std::ios::ate);
+      blob.resize(inp.tellg());
+      inp.seekg(0);
+      inp.read(blob.data(), blob.size());
+      headers["Valid-From"] = std::to_string(from);
+      headers["Valid-Until"] = std::to_string(until);
+      headers["Created"] = std::to_string(from);
+      headers["ETag"] = fmt::format("\"{}\"", name);
+      headers["Cache-Valid-Until"] = std::to_string(until);
+      return true;
+    }
+    return false;
+  }
+};
+
+std::string extract(const std::vector<char>& blob)
+{
+  o2::pmr::vector<char> v(blob.begin(), blob.end());
+  auto* obj = CcdbApi::extractFromMemoryBlob<std::string>(v);
+  std::string res = obj ? *obj : std::string{};
+  delete obj;
+  return res;
+}
+
+struct Fixture {
+  fs::path base;
+  Fixture()
+  {
+    base = fs::temp_directory_path() / fmt::format("testCCDBDiskCache_{}", getpid());
+    fs::remove_all(base);
+  }
+  ~Fixture() { fs::remove_all(base); }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(DiskCache_store_find_load, Fixture)
+{
+  LocalServer server(base / "server");
+  server.put("Test/Object", 100, 200, "first");
+  server.put("Test/Object", 200, 300, "second");
+
+  CCDBDiskCache cache((base / "cache").string());
+  auto key = CCDBDiskCache::getQueryKey("Test/Object", {});
+  BOOST_CHECK(!cache.find(key, 150));
+
+  for (long ts : {150, 250}) {
+    std::vector<char> blob;
+    std::map<std::string, std::string> headers;
+    BOOST_REQUIRE(server.get("Test/Object", ts, blob, headers));
+    BOOST_CHECK(cache.store(key, ts, blob.data(), blob.size(), headers));
+  }
+
+  auto entry = cache.find(key, 170);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->validFrom == 100 && entry->validUntil == 200);
+  BOOST_CHECK(entry->isCacheValid(170) == false); // fetched at 150
+  BOOST_CHECK(entry->isCacheValid(150));
+  std::vector<char> blob;
+  BOOST_REQUIRE(cache.load(*entry, blob));
+  BOOST_CHECK_EQUAL(extract(blob), "first");
+
+  entry = cache.find(key, 299);
+  BOOST_REQUIRE(entry);
+  BOOST_REQUIRE(cache.load(*entry, blob));
+  BOOST_CHECK_EQUAL(extract(blob), "second");
+  BOOST_CHECK(!cache.find(key, 300));
+
+  // different metadata or time-machine limits must not see these objects
+  BOOST_CHECK(!cache.find(CCDBDiskCache::getQueryKey("Test/Object", {{"key", "value"}}), 150));
+  BOOST_CHECK(!cache.find(CCDBDiskCache::getQueryKey("Test/Object", {}, "1000"), 150));
+
+  // objects w/o ETag or with errors are not stored
+  std::map<std::string, std::string> headers{{"Valid-From", "0"}, {"Valid-Until", "10"}};
+  BOOST_CHECK(!cache.store(key, 5, blob.data(), blob.size(), headers));
+  headers["ETag"] = "\"x\"";
+  headers["Error"] = "An error occurred during retrieval";
+  BOOST_CHECK(!cache.store(key, 5, blob.data(), blob.size(), headers));
+}
+
+BOOST_FIXTURE_TEST_CASE(DiskCache_index_update, Fixture)
+{
+  LocalServer server(base / "server");
+  server.put("Test/Object", 100, 200, "first");
+  server.put("Test/Object", 200, 300, "second");
+
+  // two instances on the same directory stand for two processes
+  CCDBDiskCache cache1((base / "cache").string()), cache2((base / "cache").string());
+  auto key = CCDBDiskCache::getQueryKey("Test/Object", {});
+  auto store = [&](CCDBDiskCache& cache, long ts) {
+    std::vector<char> blob;
+    std::map<std::string, std::string> headers;
+    BOOST_REQUIRE(server.get("Test/Object", ts, blob, headers));
+    BOOST_REQUIRE(cache.store(key, ts, blob.data(), blob.size(), headers));
+  };
+  store(cache1, 150);
+  BOOST_REQUIRE(cache1.find(key, 150));
+  BOOST_CHECK(!cache1.find(key, 250));
+
+  // the entries stored or updated by the other instance are seen by the indexed lookup
+  store(cache2, 250);
+  auto entry = cache1.find(key, 250);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->validFrom == 200 && entry->validUntil == 300);
+  BOOST_CHECK(!entry->isCacheValid(210)); // fetched at 250
+  store(cache2, 210);
+  entry = cache1.find(key, 210);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->isCacheValid(210));
+
+  // and so are the evicted ones
+  for (const auto& file : fs::directory_iterator(base / "cache" / key)) {
+    if (file.path().extension() == ".hdr" && cache1.find(key, 150)->blobFile == fs::path(file.path()).replace_extension(".blob").string()) {
+      fs::remove(file.path());
+      break;
+    }
+  }
+  BOOST_CHECK(!cache1.find(key, 150));
+  BOOST_CHECK(cache1.find(key, 250));
+}
+
+BOOST_FIXTURE_TEST_CASE(DiskCache_concurrent_writers, Fixture)
+{
+  constexpr int NObjects = 8, NThreads = 4;
+  LocalServer server(base / "server");
+  for (int i = 0; i < NObjects; i++) {
+    server.put("Test/Concurrent", i * 10, (i + 1) * 10, fmt::format("object{}", i));
+  }
+  auto key = CCDBDiskCache::getQueryKey("Test/Concurrent", {});
+  // several caches (as in different processes) sharing the same directory fetch the same objects
+  std::vector<std::thread> threads;
+  for (int it = 0; it < NThreads; it++) {
+    threads.emplace_back([&server, &key, this]() {
+      CCDBDiskCache cache((base / "cache").string());
+      for (int i = 0; i < NObjects; i++) {
+        long ts = i * 10 + 5;
+        std::vector<char> blob;
+        std::map<std::string, std::string> headers;
+        if (!cache.find(key, ts) && server.get("Test/Concurrent", ts, blob, headers)) {
+          cache.store(key, ts, blob.data(), blob.size(), headers);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  CCDBDiskCache cache((base / "cache").string());
+  size_t nBlobs = 0;
+  for (const auto& file : fs::recursive_directory_iterator(base / "cache")) {
+    BOOST_CHECK(file.path().extension() != ".tmp");
+    nBlobs += file.path().extension() == ".blob";
+  }
+  BOOST_CHECK_EQUAL(nBlobs, NObjects); // one entry per object irrespective of the number of writers
+  for (int i = 0; i < NObjects; i++) {
+    auto entry = cache.find(key, i * 10 + 5);
+    BOOST_REQUIRE(entry);
+    std::vector<char> blob;
+    BOOST_REQUIRE(cache.load(*entry, blob));
+    BOOST_CHECK_EQUAL(extract(blob), fmt::format("object{}", i));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(DiskCache_eviction, Fixture)
+{
+  constexpr int NObjects = 10;
+  LocalServer server(base / "server");
+  for (int i = 0; i < NObjects; i++) {
+    server.put("Test/Evict", i * 10, (i + 1) * 10, std::string(1000, 'a' + i));
+  }
+  auto key = CCDBDiskCache::getQueryKey("Test/Evict", {});
+  std::vector<char> blob;
+  std::map<std::string, std::string> headers;
+  BOOST_REQUIRE(server.get("Test/Evict", 5, blob, headers));
+  size_t blobSize = blob.size();
+
+  // room for 3 objects only
+  CCDBDiskCache cache((base / "cache").string(), 3 * blobSize + blobSize / 2);
+  for (int i = 0; i < NObjects; i++) {
+    headers.clear();
+    BOOST_REQUIRE(server.get("Test/Evict", i * 10 + 5, blob, headers));
+    BOOST_CHECK(cache.store(key, i * 10 + 5, blob.data(), blob.size(), headers));
+    // keep using the 1st object, so that it is not evicted
+    auto entry = cache.find(key, 5);
+    BOOST_REQUIRE(entry);
+    std::vector<char> tmp;
+    BOOST_REQUIRE(cache.load(*entry, tmp));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_CHECK(cache.getTotalSize() <= cache.getMaxSize());
+  BOOST_CHECK(cache.find(key, 5));                           // recently used
+  BOOST_CHECK(cache.find(key, (NObjects - 1) * 10 + 5));     // just stored
+  BOOST_CHECK(!cache.find(key, 15) && !cache.find(key, 25)); // least recently used
+}
@@ -20,6 +20,7 @@
 #define BOOST_TEST_DYN_LINK
 
 #include "CCDB/CcdbApi.h"
+#include "CCDB/CCDBDiskCache.h"
 #include "CCDB/IdPath.h"    // just as test object
 #include "CommonUtils/RootChain.h" // just as test object
 #include "CCDB/CCDBTimeStampUtils.h"
@@ -28,6 +29,7 @@
 #include <iostream>
 #include <TH1F.h>
 #include <chrono>
+#include <thread>
 #include <CommonUtils/StringUtils.h>
 #include <TStreamerInfo.h>
 #include <TGraph.h>
@@ -589,4 +591,76 @@ BOOST_AUTO_TEST_CASE(vectored)
   for (auto context : contexts) {
     BOOST_CHECK(context.dest.size() != 0);
   }
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(TestDiskCache)
+{
+  // hit, miss and eviction of the node-local disk cache, populated from a local directory, with no server behind
+  namespace fs = std::filesystem;
+  auto dir = fs::temp_directory_path() / ("testCcdbApi_diskcache_" + std::to_string(getpid()));
+  fs::remove_all(dir);
+  std::string path = "Test/DiskCache";
+  auto key = CCDBDiskCache::getQueryKey(path, {});
+  auto put = [&](CCDBDiskCache& cache, long from, long until, std::string const& content) {
+    auto image = CcdbApi::createObjectImage(&content);
+    std::map<std::string, std::string> headers{{"Valid-From", std::to_string(from)}, {"Valid-Until", std::to_string(until)}, {"Created", std::to_string(from)},
+                                               {"ETag", "\"" + content + "\""}, {"Cache-Valid-Until", std::to_string(until)}};
+    BOOST_REQUIRE(cache.store(key, from, image->data(), image->size(), headers));
+    return image->size();
+  };
+  size_t blobSize = 0;
+  {
+    CCDBDiskCache cache(dir.string());
+    blobSize = put(cache, 100, 200, std::string(1000, 'a'));
+    put(cache, 200, 300, std::string(1000, 'b'));
+  }
+
+  CcdbApi api;
+  api.init("http://localhost:1"); // nothing listens there
+  api.setDiskCache(dir.string(), 2 * blobSize + blobSize / 2);
+  BOOST_REQUIRE(api.isDiskCacheEnabled());
+
+  // hit
+  std::map<std::string, std::string> headers;
+  std::unique_ptr<std::string> obj{api.retrieveFromTFileAny<std::string>(path, {}, 150, &headers)};
+  BOOST_REQUIRE(obj);
+  BOOST_CHECK(*obj == std::string(1000, 'a'));
+  BOOST_CHECK(headers["ETag"] == "\"" + std::string(1000, 'a') + "\"");
+
+  // same via the vectored path
+  o2::pmr::vector<char> dest;
+  std::map<std::string, std::string> metadata, vheaders;
+  std::vector<CcdbApi::RequestContext> contexts;
+  contexts.emplace_back(dest, metadata, vheaders);
+  contexts.back().path = path;
+  contexts.back().timestamp = 250;
+  contexts.back().considerSnapshot = false;
+  api.vectoredLoadFileToMemory(contexts);
+  BOOST_REQUIRE(!dest.empty());
+  std::unique_ptr<std::string> vobj{CcdbApi::extractFromMemoryBlob<std::string>(dest)};
+  BOOST_REQUIRE(vobj);
+  BOOST_CHECK(*vobj == std::string(1000, 'b'));
+
+  // miss: no cached object for this timestamp and the server is not reachable
+  headers.clear();
+  obj.reset(api.retrieveFromTFileAny<std::string>(path, {}, 350, &headers));
+  BOOST_CHECK(!obj);
+
+  // eviction: a 3rd object does not fit, the least recently used one is removed
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  obj.reset(api.retrieveFromTFileAny<std::string>(path, {}, 250)); // use the 2nd object again
+  BOOST_REQUIRE(obj);
+  {
+    CCDBDiskCache cache(dir.string(), 2 * blobSize + blobSize / 2);
+    put(cache, 300, 400, std::string(1000, 'c'));
+    BOOST_CHECK(cache.getTotalSize() <= cache.getMaxSize());
+  }
+  obj.reset(api.retrieveFromTFileAny<std::string>(path, {}, 150));
+  BOOST_CHECK(!obj);
+  obj.reset(api.retrieveFromTFileAny<std::string>(path, {}, 250));
+  BOOST_REQUIRE(obj);
+  BOOST_CHECK(*obj == std::string(1000, 'b'));
+  obj.reset(api.retrieveFromTFileAny<std::string>(path, {}, 350));
+  BOOST_REQUIRE(obj);
+  BOOST_CHECK(*obj == std::string(1000, 'c'));
+  fs::remove_all(dir);
+}
@@ -92,6 +92,9 @@ struct LogLogThrottler {
   GPUdi() void clear() { evCount = evCountPrev = logCount = 0; }
 };
 
+template <typename Fitter>
+class DCAFitterNPreFilter;
+
 template <int N, typename... Args>
 class DCAFitterN
 {
@@ -328,6 +331,17 @@ class DCAFitterN
   BadCovPolicy getBadCovPolicy() const { return mBadCovPolicy; }
 
  private:
+  template <typename Fitter>
+  friend class DCAFitterNPreFilter;
+  ///< account for the tracks rejected by the pre-filter, leaving the fitter as process() without crossing
+  template <class... Tr>
+  GPUd() void processRejected(const Tr&... args)
+  {
+    mCallID++;
+    assign(0, args...);
+    clear();
+  }
+
   // vectors of 1st derivatives of track local residuals over X parameters
   o2::gpu::gpustd::array<o2::gpu::gpustd::array<Vec3D, N>, N> mDResidDx;
   // vectors of 1nd derivatives of track local residuals over X parameters
@@ -0,0 +1,168 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DCAFitterNPreFilter.h
+/// \brief Batched SIMD crossing pre-filter in front of the scalar DCAFitterN (CPU only)
+
+#ifndef _ALICEO2_DCA_FITTERN_PREFILTER_
+#define _ALICEO2_DCA_FITTERN_PREFILTER_
+
+#include "DCAFitter/DCAFitterN.h"
+#include <Vc/Vc>
+#include <gsl/span>
+#include <array>
+#include <tuple>
+#include <stdexcept>
+
+namespace o2
+{
+namespace vertexing
+{
+
+///__________________________________________________________________________________
+///< Pre-filters many candidates before fitting them with the same DCAFitterN settings. The candidate i is formed by
+///  the i-th entries of the N prong spans. Only the crossing test is batched: the tracks of W = Vc::float_v::Size
+///  candidates are transposed to SoA lane blocks and the circle parameters of the 1st two prongs together with the test
+///  of their XY separation are evaluated in lock-step, the lanes whose circles are certainly farther apart than the
+///  fitter MaxDXYIni being masked out. The surviving candidates are fitted one by one by the scalar DCAFitterN::process,
+///  the rejected ones only increment the fitter call ID, so that it follows the scalar processing.
+///  Since the rejection uses a safety margin w.r.t. the scalar test, the results are identical to those of processing
+///  every candidate by the scalar fitter.
+template <typename Fitter>
+class DCAFitterNPreFilter
+{
+ public:
+  using Track = typename Fitter::Track;
+  using float_v = Vc::float_v;
+  static constexpr int W = float_v::Size;
+  static constexpr float RelTolerance = 1e-5; // relative margin of the SIMD rejection w.r.t. the scalar one
+  static constexpr float AbsTolerance = 1e-4; // absolute margin of the SIMD rejection w.r.t. the scalar one
+
+  DCAFitterNPreFilter(Fitter& fitter) : mFitter(fitter) {}
+
+  ///< filter and fit candidates formed by the prongs spans (of equal size), for every candidate with at least 1 PCA found
+  ///  the callback(int icand, Fitter& fitter) is called before the next candidate is processed.
+  ///  Returns the number of candidates with at least 1 PCA found
+  template <typename F, typename... Tr>
+  size_t process(F&& callback, gsl::span<const Tr>... prongs);
+
+  Fitter& getFitter() { return mFitter; }
+  size_t getNProcessed() const { return mNProcessed; }
+  size_t getNRejectedSIMD() const { return mNRejectedSIMD; }
+  size_t getNFitted() const { return mNFitted; }
+  void clearCounters() { mNProcessed = mNRejectedSIMD = mNFitted = 0; }
+
+ private:
+  ///< SoA block of the track parameters needed for the crossing test
+  struct alignas(Vc::VectorAlignment) LaneBlock {
+    std::array<float, W> x, y, snp, alpha, curv;
+  };
+
+  template <typename T>
+  static void fill(LaneBlock& blk, int lane, const T& trc, float bz)
+  {
+    blk.x[lane] = trc.getX();
+    blk.y[lane] = trc.getY();
+    blk.snp[lane] = trc.getSnp();
+    blk.alpha[lane] = trc.getAlpha();
+    blk.curv[lane] = trc.getCurvature(bz);
+  }
+
+  static void circles(const LaneBlock& blk, float_v& xC, float_v& yC, float_v& rC, Vc::float_m& straight);
+  int testLanes(int nLanes) const;
+
+  Fitter& mFitter;
+  std::array<LaneBlock, 2> mBlocks;
+  size_t mNProcessed = 0;
+  size_t mNRejectedSIMD = 0;
+  size_t mNFitted = 0;
+};
+
+///_________________________________________________________________________
+template <typename Fitter>
+void DCAFitterNPreFilter<Fitter>::circles(const LaneBlock& blk, float_v& xC, float_v& yC, float_v& rC, Vc::float_m& straight)
+{
+  // lane-wise version of the TrackParametrization::getCircleParams, straight lines are only flagged
+  constexpr float MinSagitta = 0.01f, TPCMidR = 160.f, MinCurv = 8 * MinSagitta / (TPCMidR * TPCMidR);
+  float_v curv(blk.curv.data(), Vc::Aligned), snp(blk.snp.data(), Vc::Aligned), alpha(blk.alpha.data(), Vc::Aligned);
+  straight = Vc::abs(curv) <= MinCurv;
+  float_v r = float_v::One() / Vc::iif(straight, float_v::One(), curv);
+  float_v cs = Vc::sqrt((float_v::One() - snp) * (float_v::One() + snp));
+  float_v xL = float_v(blk.x.data(), Vc::Aligned) - snp * r, yL = float_v(blk.y.data(), Vc::Aligned) + cs * r;
+  float_v sna, csa;
+  Vc::sincos(alpha, &sna, &csa);
+  xC = xL * csa - yL * sna;
+  yC = xL * sna + yL * csa;
+  rC = Vc::abs(r);
+}
+
+///_________________________________________________________________________
+template <typename Fitter>
+int DCAFitterNPreFilter<Fitter>::testLanes(int nLanes) const
+{
+  // return bit mask of the lanes which may have a crossing of the 1st 2 prongs, see CrossInfo::circlesCrossInfo
+  float_v xC0, yC0, rC0, xC1, yC1, rC1;
+  Vc::float_m straight0, straight1;
+  circles(mBlocks[0], xC0, yC0, rC0, straight0);
+  circles(mBlocks[1], xC1, yC1, rC1, straight1);
+  float_v dx = xC1 - xC0, dy = yC1 - yC0;
+  float_v dist = Vc::sqrt(dx * dx + dy * dy), rsum = rC0 + rC1;
+  float_v margin = RelTolerance * (dist + rsum) + AbsTolerance;
+  auto reject = (dist - rsum > mFitter.getMaxDXYIni() + margin) && !(straight0 || straight1); // lines are left to the scalar fitter
+  return (~reject.toInt()) & ((1 << nLanes) - 1);
+}
+
+///_________________________________________________________________________
+template <typename Fitter>
+template <typename F, typename... Tr>
+size_t DCAFitterNPreFilter<Fitter>::process(F&& callback, gsl::span<const Tr>... prongs)
+{
+  static_assert(sizeof...(prongs) == Fitter::getNProngs(), "incorrect number of prong spans");
+  const auto& tr0 = std::get<0>(std::forward_as_tuple(prongs...));
+  const auto& tr1 = std::get<1>(std::forward_as_tuple(prongs...));
+  int nCand = tr0.size();
+  if (((prongs.size() != tr0.size()) || ...)) {
+    throw std::runtime_error("prong spans of different sizes are provided");
+  }
+  float bz = mFitter.getBz();
+  size_t nFound = 0;
+  for (int start = 0; start < nCand; start += W) {
+    int nLanes = nCand - start < W ? nCand - start : W;
+    for (int il = 0; il < nLanes; il++) {
+      fill(mBlocks[0], il, tr0[start + il], bz);
+      fill(mBlocks[1], il, tr1[start + il], bz);
+    }
+    for (int il = nLanes; il < W; il++) { // pad with the 1st lane to avoid garbage in the unused lanes
+      fill(mBlocks[0], il, tr0[start], bz);
+      fill(mBlocks[1], il, tr1[start], bz);
+    }
+    int lanes = testLanes(nLanes);
+    mNProcessed += nLanes;
+    for (int il = 0; il < nLanes; il++) {
+      int icand = start + il;
+      if (!(lanes & (1 << il))) {
+        mNRejectedSIMD++;
+        mFitter.processRejected(prongs[icand]...);
+        continue;
+      }
+      mNFitted++;
+      if (mFitter.process(prongs[icand]...)) {
+        nFound++;
+        callback(icand, mFitter);
+      }
+    }
+  }
+  return nFound;
+}
+
+} // namespace vertexing
+} // namespace o2
+#endif // _ALICEO2_DCA_FITTERN_PREFILTER_
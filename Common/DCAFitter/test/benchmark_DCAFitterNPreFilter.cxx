@@ -0,0 +1,95 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmark_DCAFitterNPreFilter.cxx
+/// \brief Candidates/s of the scalar 2-prong DCAFitterN processing without and with the batched pre-filter
+
+#include "benchmark/benchmark.h"
+#include "DCAFitter/DCAFitterN.h"
+#include "DCAFitter/DCAFitterNPreFilter.h"
+#include <random>
+#include <vector>
+
+using Track = o2::track::TrackParCov;
+using Fitter = o2::vertexing::DCAFitterN<2>;
+
+constexpr float Bz = 5.f;
+
+/// pairs of tracks from the same decay point at R<20 cm, mixed with the fraction of combinatorial pairs
+void generatePairs(size_t nPairs, float fracTrue, std::vector<Track>& prong0, std::vector<Track>& prong1)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> uni(0.f, 1.f);
+  std::array<float, 15> cov = {1e-4, 0., 1e-4, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  auto makeTrack = [&](float x, float y, float z, float q) {
+    float phi = (uni(gen) - 0.5f) * 2.f * o2::constants::math::PI, pt = 0.2f + 3.f * uni(gen);
+    float sn, cs, xl, yl;
+    o2::math_utils::sincos(phi, sn, cs);
+    o2::math_utils::rotateZInv(x, y, xl, yl, sn, cs);
+    std::array<float, 5> par{yl, z, 0.f, uni(gen) - 0.5f, q / pt};
+    Track trc(xl, phi, par, cov);
+    trc.propagateTo(xl + 2.f * (uni(gen) - 0.5f), Bz);
+    return trc;
+  };
+  prong0.clear();
+  prong1.clear();
+  for (size_t i = 0; i < nPairs; i++) {
+    float r = 20.f * uni(gen), phi = 2.f * o2::constants::math::PI * uni(gen), z = 20.f * (uni(gen) - 0.5f);
+    float x = r * std::cos(phi), y = r * std::sin(phi);
+    prong0.push_back(makeTrack(x, y, z, 1.f));
+    if (uni(gen) < fracTrue) {
+      prong1.push_back(makeTrack(x, y, z, -1.f));
+    } else {
+      float r1 = 20.f * uni(gen), phi1 = 2.f * o2::constants::math::PI * uni(gen);
+      prong1.push_back(makeTrack(r1 * std::cos(phi1), r1 * std::sin(phi1), 20.f * (uni(gen) - 0.5f), -1.f));
+    }
+  }
+}
+
+static void BM_DCAFitterScalar(benchmark::State& state)
+{
+  std::vector<Track> prong0, prong1;
+  generatePairs(state.range(0), state.range(1) * 0.01f, prong0, prong1);
+  Fitter ft;
+  ft.setBz(Bz);
+  size_t nFound = 0;
+  for (auto _ : state) {
+    for (size_t ic = 0; ic < prong0.size(); ic++) {
+      if (ft.process(prong0[ic], prong1[ic])) {
+        nFound++;
+      }
+    }
+  }
+  benchmark::DoNotOptimize(nFound);
+  state.counters["candidates"] = benchmark::Counter(state.iterations() * prong0.size(), benchmark::Counter::kIsRate);
+}
+
+static void BM_DCAFitterPreFilter(benchmark::State& state)
+{
+  std::vector<Track> prong0, prong1;
+  generatePairs(state.range(0), state.range(1) * 0.01f, prong0, prong1);
+  Fitter ft;
+  ft.setBz(Bz);
+  o2::vertexing::DCAFitterNPreFilter<Fitter> preFilter(ft);
+  size_t nFound = 0;
+  for (auto _ : state) {
+    nFound += preFilter.process([](int, Fitter&) {}, gsl::span<const Track>(prong0), gsl::span<const Track>(prong1));
+  }
+  benchmark::DoNotOptimize(nFound);
+  state.counters["candidates"] = benchmark::Counter(state.iterations() * prong0.size(), benchmark::Counter::kIsRate);
+  state.counters["rejectedSIMD"] = double(preFilter.getNRejectedSIMD()) / preFilter.getNProcessed();
+}
+
+// number of pairs, percentage of the pairs from the same decay point
+BENCHMARK(BM_DCAFitterScalar)->Args({10000, 100})->Args({10000, 20})->Args({10000, 5})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DCAFitterPreFilter)->Args({10000, 100})->Args({10000, 20})->Args({10000, 5})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "DCAFitter/DCAFitterN.h"
+#include "DCAFitter/DCAFitterNPreFilter.h"
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <TRandom.h>
 #include <TGenPhaseSpace.h>
@@ -552,5 +553,65 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+BOOST_AUTO_TEST_CASE(DCAFitterNPreFilterVsScalar)
+{
+  // the pre-filtered processing must give the same results and call IDs as the scalar one
+  constexpr int NTest = 2000;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<int> forceQ{1, 1};
+  TGenPhaseSpace genPHS;
+  Vec3D vtxGen;
+  double bz = 5.0;
+  std::vector<o2::track::TrackParCov> vctracks, pos, neg;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, k0, k0dec, forceQ);
+    pos.push_back(vctracks[0]);
+    neg.push_back(vctracks[1]);
+  }
+  std::vector<o2::track::TrackParCov> prong0, prong1;
+  for (int i = 0; i < NTest; i++) { // true V0s + combinatorial pairs, most of which have no crossing
+    for (int j = i; j < i + 5; j++) {
+      prong0.push_back(pos[i]);
+      prong1.push_back(neg[j % NTest]);
+    }
+  }
+  o2::vertexing::DCAFitterN<2> ft, ftPre;
+  ft.setBz(bz);
+  ftPre.setBz(bz);
+  std::vector<int> ncScalar(prong0.size());
+  std::vector<size_t> callIDScalar(prong0.size());
+  std::vector<float> chi2Scalar(prong0.size());
+  std::vector<Vec3D> pcaScalar(prong0.size());
+  for (size_t ic = 0; ic < prong0.size(); ic++) {
+    ncScalar[ic] = ft.process(prong0[ic], prong1[ic]);
+    callIDScalar[ic] = ft.getCallID();
+    if (ncScalar[ic]) {
+      chi2Scalar[ic] = ft.getChi2AtPCACandidate();
+      pcaScalar[ic] = ft.getPCACandidate();
+    }
+  }
+  o2::vertexing::DCAFitterNPreFilter<o2::vertexing::DCAFitterN<2>> preFilter(ftPre);
+  std::vector<int> ncPre(prong0.size());
+  int nDiff = 0, nDiffCallID = 0;
+  auto nFound = preFilter.process(
+    [&](int ic, o2::vertexing::DCAFitterN<2>& fitter) {
+      ncPre[ic] = fitter.getNCandidates();
+      nDiff += fitter.getChi2AtPCACandidate() != chi2Scalar[ic] || !(fitter.getPCACandidate() == pcaScalar[ic]);
+      nDiffCallID += fitter.getCallID() != callIDScalar[ic];
+    },
+    gsl::span<const o2::track::TrackParCov>(prong0), gsl::span<const o2::track::TrackParCov>(prong1));
+  LOG(info) << "Pre-filter of " << preFilter.getNProcessed() << " candidates: " << preFilter.getNRejectedSIMD() << " rejected in SIMD lanes, "
+            << preFilter.getNFitted() << " fitted, " << nFound << " with PCA";
+  BOOST_CHECK(ncPre == ncScalar);
+  BOOST_CHECK(nDiff == 0);
+  BOOST_CHECK(nDiffCallID == 0);
+  BOOST_CHECK(ftPre.getCallID() == ft.getCallID());
+  BOOST_CHECK(ftPre.getNCandidates() == ft.getNCandidates());
+  BOOST_CHECK(preFilter.getNRejectedSIMD() > 0);
+  BOOST_CHECK(preFilter.getNRejectedSIMD() + preFilter.getNFitted() == prong0.size());
+}
+
 } // namespace vertexing
 } // namespace o2
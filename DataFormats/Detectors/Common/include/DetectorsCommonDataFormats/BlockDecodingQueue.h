@@ -0,0 +1,81 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file BlockDecodingQueue.h
+/// \brief Per-thread queue for the concurrent decoding of the blocks of an EncodedBlocks image
+
+#ifndef ALICEO2_BLOCK_DECODING_QUEUE_H
+#define ALICEO2_BLOCK_DECODING_QUEUE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace o2
+{
+namespace ctf
+{
+
+/// When enabled (more than 1 thread requested) for the calling thread, EncodedBlocks::decode does not decode the
+/// requested block immediately but queues it. Once all non-empty blocks of an image were requested, the queued blocks
+/// are decoded concurrently on a bounded pool and the last decode call returns when all of them are done.
+/// This relies on the decoded blocks not being accessed before all blocks of the image were requested, which is the
+/// case for the detectors CTFCoder::decode methods: they first decode all blocks and then convert them.
+/// The decode methods wrap the block requests in a CTFCoderBase::BlockDecodingScope, which flushes the queue explicitly
+/// after the last block and discards the tasks still queued if the decoding is abandoned (exception, skipped block).
+class BlockDecodingQueue
+{
+ public:
+  using Task = std::function<void()>;
+
+  /// queue of the calling thread
+  static BlockDecodingQueue& instance();
+
+  ~BlockDecodingQueue();
+
+  /// set max number of threads for concurrent decoding, <2 means immediate sequential decoding
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+  bool isEnabled() const { return mNThreads > 1; }
+
+  /// queue decoding task for the block slot of the image, which has in total nBlocks non-empty blocks.
+  /// Sizes are used to start with the largest blocks. Executes all queued tasks once all blocks of the image are queued
+  void add(const void* image, int slot, int nBlocks, size_t size, Task&& task);
+
+  /// decode all queued blocks, rethrowing the 1st encountered exception
+  void flush();
+
+  /// drop all queued blocks without decoding them (their destination buffers may be gone)
+  void discard();
+
+  size_t getNQueued() const { return mTasks.size(); }
+
+ private:
+  BlockDecodingQueue() = default;
+
+  struct Arena;
+  struct Entry {
+    Task task;
+    size_t size = 0;
+  };
+
+  int mNThreads = 1;
+  const void* mImage = nullptr;  // image whose blocks are queued
+  std::vector<int> mSlots;       // queued slots of current image
+  std::vector<Entry> mTasks;     // queued tasks
+  std::unique_ptr<Arena> mArena; // bounded thread pool
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
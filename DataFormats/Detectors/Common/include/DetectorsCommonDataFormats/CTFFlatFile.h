@@ -0,0 +1,144 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.h
+/// \brief Flat, memory-mappable container of CTFs
+
+#ifndef ALICEO2_CTF_FLAT_FILE_H
+#define ALICEO2_CTF_FLAT_FILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gsl/span>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// The detector CTFs (flat EncodedBlocks buffers, as exchanged between DPL devices) are stored as they are,
+/// so that the reader can map the file and pass the detectors buffers to the decoders without deserialization.
+/// Layout: FileHeader followed by the CTF entries, each entry being an EntryHeader, the table of DetectorRecords
+/// and the detectors payloads. All offsets are aligned to PayloadAlignment bytes.
+struct CTFFlatFile {
+  static constexpr char Magic[8] = {'O', '2', 'C', 'T', 'F', 'F', 'L', 'T'};
+  static constexpr uint32_t EntryMagic = 0x45465443; // "CTFE"
+  static constexpr uint32_t Version = 1;
+  static constexpr size_t PayloadAlignment = 64;
+  static constexpr std::string_view Extension = ".ctf";
+
+  struct FileHeader {
+    char magic[8];
+    uint32_t version = Version;
+    uint32_t reserved = 0;
+  };
+
+  struct EntryHeader {
+    uint32_t magic = EntryMagic;
+    uint32_t nDetectors = 0; // number of DetectorRecords following the header
+    uint64_t entrySize = 0;  // total size of the entry in bytes, including this header
+    uint64_t run = 0;
+    uint64_t creationTime = 0;
+    uint32_t firstTForbit = 0;
+    uint32_t tfCounter = 0;
+    uint32_t detectors = 0; // mask of stored detectors
+    uint32_t reserved = 0;
+  };
+
+  struct DetectorRecord {
+    uint32_t det = 0;
+    uint32_t reserved = 0;
+    uint64_t offset = 0; // offset of the payload wrt the entry start
+    uint64_t size = 0;   // payload size in bytes
+  };
+
+  static size_t align(size_t sz) { return (sz + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment; }
+
+  /// check if the file starts with the flat CTF file signature
+  static bool isFlatFile(const std::string& fileName);
+
+  /// name of the flat CTF file accompanying the ROOT CTF file
+  static std::string getFileName(const std::string& rootFileName);
+};
+
+/// Writes CTFs entries to the flat file: the detectors buffers are registered by addDetector and written with the CTF header by writeEntry
+class CTFFlatFileWriter
+{
+ public:
+  explicit CTFFlatFileWriter(const std::string& fileName);
+  ~CTFFlatFileWriter();
+
+  /// register the buffer of the detector for the next entry, the buffer must stay valid until writeEntry call
+  void addDetector(o2::detectors::DetID det, const void* data, size_t size);
+
+  /// write the entry with registered detector buffers, return number of bytes written
+  size_t writeEntry(const CTFHeader& header);
+
+  void close();
+  const std::string& getFileName() const { return mFileName; }
+  size_t getNEntries() const { return mNEntries; }
+  size_t getSize() const { return mSize; }
+
+ private:
+  struct Part {
+    o2::detectors::DetID det;
+    const char* data = nullptr;
+    size_t size = 0;
+  };
+  void writePadding(size_t n);
+
+  std::string mFileName{};
+  std::ofstream mFile;
+  std::vector<Part> mParts{};
+  size_t mNEntries = 0;
+  size_t mSize = 0;
+};
+
+/// Maps the flat CTF file to memory and provides zero-copy access to the stored CTF headers and detectors buffers
+class CTFFlatFileReader
+{
+ public:
+  explicit CTFFlatFileReader(const std::string& fileName);
+  ~CTFFlatFileReader();
+  CTFFlatFileReader(const CTFFlatFileReader&) = delete;
+  CTFFlatFileReader& operator=(const CTFFlatFileReader&) = delete;
+
+  size_t getNEntries() const { return mEntries.size(); }
+  const std::string& getFileName() const { return mFileName; }
+  size_t getSize() const { return mSize; }
+
+  /// CTF header of the entry, with mask of detectors stored in the entry
+  CTFHeader getHeader(size_t entry) const;
+
+  /// buffer of the detector in the entry, empty if the detector is not stored
+  gsl::span<const char> getDetectorData(size_t entry, o2::detectors::DetID det) const;
+
+  /// advise the kernel that the entry will be accessed soon
+  void prefetch(size_t entry) const;
+
+ private:
+  const CTFFlatFile::EntryHeader& getEntryHeader(size_t entry) const;
+
+  std::string mFileName{};
+  const char* mData = nullptr;
+  size_t mSize = 0;
+  std::vector<size_t> mEntries{}; // entries offsets
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
@@ -31,6 +31,7 @@
 #include "DetectorsCommonDataFormats/ANSHeader.h"
 #include "DetectorsCommonDataFormats/internal/Packer.h"
 #include "DetectorsCommonDataFormats/Metadata.h"
+#include "DetectorsCommonDataFormats/BlockDecodingQueue.h"
 #ifndef __CLING__
 #include "DetectorsCommonDataFormats/internal/ExternalEntropyCoder.h"
 #include "DetectorsCommonDataFormats/internal/InplaceEntropyCoder.h"
@@ -507,7 +508,8 @@ class EncodedBlocks
   template <class container_T, class container_IT = typename container_T::iterator>
   o2::ctf::CTFIOSize decode(container_T& dest, int slot, const std::any& decoderExt = {}) const;
 
-  /// decode block at provided slot to destination pointer, the needed space assumed to be available
+  /// decode block at provided slot to destination pointer, the needed space assumed to be available.
+  /// If BlockDecodingQueue is enabled for the calling thread, the decoding is deferred until all non-empty blocks are requested
   template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
   o2::ctf::CTFIOSize decode(D_IT dest, int slot, const std::any& decoderExt = {}) const;
 
@@ -631,6 +633,9 @@ class EncodedBlocks
   o2::ctf::CTFIOSize store(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr);
 
   // decode
+  template <typename dst_IT>
+  CTFIOSize decodeImpl(dst_IT dest, int slot, const std::any& decoderExt) const;
+
   template <typename dst_IT>
   CTFIOSize decodeCompatImpl(dst_IT dest, int slot, const std::any& decoderExt) const;
 
@@ -921,6 +926,31 @@ template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
 CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,                        // iterator to destination
                                          int slot,                         // slot of the block to decode
                                          const std::any& decoderExt) const // optional externally provided decoder
+{
+  const auto& md = mMetadata[slot];
+  auto& queue = BlockDecodingQueue::instance();
+  if (!queue.isEnabled() || !md.messageLength) {
+    return decodeImpl(dest, slot, decoderExt);
+  }
+  // deferred decoding: output is preallocated by the caller, the decoder is owned by the caller (e.g. CTFCoderBase::mCoders)
+  // while the default empty decoderExt is a temporary, so it is not captured
+  int nBlocks = 0;
+  for (int i = 0; i < N; i++) {
+    nBlocks += mMetadata[i].messageLength > 0;
+  }
+  const std::any* decoderPtr = decoderExt.has_value() ? &decoderExt : nullptr;
+  queue.add(this, slot, nBlocks, md.messageLength * md.messageWordSize, [this, dest, slot, decoderPtr]() {
+    decodeImpl(dest, slot, decoderPtr ? *decoderPtr : std::any{});
+  });
+  // the sizes returned by decodeImpl depend on the block metadata only, so they are known before the decoding is done.
+  // The block is decoded by the BlockDecodingQueue::flush of the caller scope (CTFCoderBase::BlockDecodingScope)
+  return {0, md.getUncompressedSize(), md.getCompressedSize()};
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename dst_IT>
+CTFIOSize EncodedBlocks<H, N, W>::decodeImpl(dst_IT dest, int slot, const std::any& decoderExt) const
 {
 
   // get references to the right data
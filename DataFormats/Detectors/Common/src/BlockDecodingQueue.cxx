@@ -0,0 +1,107 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file BlockDecodingQueue.cxx
+/// \brief Per-thread queue for the concurrent decoding of the blocks of an EncodedBlocks image
+
+#include "DetectorsCommonDataFormats/BlockDecodingQueue.h"
+#include "Framework/Logger.h"
+#include <algorithm>
+#include <tbb/task_arena.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+using namespace o2::ctf;
+
+struct BlockDecodingQueue::Arena {
+  explicit Arena(int n) : arena(n) {}
+  tbb::task_arena arena;
+};
+
+///_____________________________________________________________________________
+BlockDecodingQueue& BlockDecodingQueue::instance()
+{
+  static thread_local BlockDecodingQueue queue;
+  return queue;
+}
+
+///_____________________________________________________________________________
+BlockDecodingQueue::~BlockDecodingQueue() = default;
+
+///_____________________________________________________________________________
+void BlockDecodingQueue::setNThreads(int n)
+{
+  n = std::max(n, 1);
+  if (n != mNThreads) {
+    if (!mTasks.empty()) {
+      LOGP(warning, "Discarding {} queued CTF blocks decoding tasks on change of the number of threads", mTasks.size());
+      discard();
+    }
+    mNThreads = n;
+    mArena.reset();
+    LOGP(debug, "Decoding of CTF blocks will use {} thread(s)", mNThreads);
+  }
+}
+
+///_____________________________________________________________________________
+void BlockDecodingQueue::add(const void* image, int slot, int nBlocks, size_t size, Task&& task)
+{
+  if (image != mImage || std::find(mSlots.begin(), mSlots.end(), slot) != mSlots.end()) {
+    if (!mTasks.empty()) { // should not happen with proper usage: the previous image was not fully requested and its buffers may be gone
+      LOGP(warning, "Only {} blocks of previous CTF image were requested and not flushed, discarding them", mSlots.size());
+      discard();
+    }
+    mImage = image;
+  }
+  mSlots.push_back(slot);
+  mTasks.push_back({std::move(task), size});
+  if (int(mSlots.size()) >= nBlocks) {
+    flush();
+  }
+}
+
+///_____________________________________________________________________________
+void BlockDecodingQueue::discard()
+{
+  mTasks.clear();
+  mSlots.clear();
+  mImage = nullptr;
+}
+
+///_____________________________________________________________________________
+void BlockDecodingQueue::flush()
+{
+  auto tasks = std::move(mTasks);
+  mTasks.clear();
+  mSlots.clear();
+  mImage = nullptr;
+  if (tasks.size() < 2 || mNThreads < 2) {
+    for (auto& t : tasks) {
+      t.task();
+    }
+    return;
+  }
+  // start from the largest blocks to balance the load
+  std::stable_sort(tasks.begin(), tasks.end(), [](const Entry& a, const Entry& b) { return a.size > b.size; });
+  if (!mArena) {
+    mArena = std::make_unique<Arena>(mNThreads);
+  }
+  // exceptions thrown by the tasks are propagated to the caller once all running tasks are finished
+  mArena->arena.execute([&tasks]() {
+    tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, tasks.size(), 1), [&tasks](const tbb::blocked_range<size_t>& r) {
+        for (auto i = r.begin(); i != r.end(); i++) {
+          tasks[i].task();
+        }
+      },
+      tbb::simple_partitioner{});
+  });
+}
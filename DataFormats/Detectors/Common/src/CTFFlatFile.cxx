@@ -0,0 +1,222 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.cxx
+/// \brief Flat, memory-mappable container of CTFs
+
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "Framework/Logger.h"
+#include <cstring>
+#include <stdexcept>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+///_____________________________________________________________________________
+bool CTFFlatFile::isFlatFile(const std::string& fileName)
+{
+  std::ifstream inp(fileName, std::ios::binary);
+  char magic[sizeof(Magic)] = {0};
+  if (!inp.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+///_____________________________________________________________________________
+std::string CTFFlatFile::getFileName(const std::string& rootFileName)
+{
+  constexpr std::string_view RootExt = ".root";
+  std::string_view base(rootFileName);
+  if (base.size() > RootExt.size() && base.substr(base.size() - RootExt.size()) == RootExt) {
+    base.remove_suffix(RootExt.size());
+  }
+  return std::string(base) + std::string(Extension);
+}
+
+//=============================================================================
+
+///_____________________________________________________________________________
+CTFFlatFileWriter::CTFFlatFileWriter(const std::string& fileName) : mFileName(fileName)
+{
+  mFile.open(mFileName, std::ios::binary | std::ios::trunc);
+  if (!mFile.good()) {
+    throw std::runtime_error(fmt::format("failed to open flat CTF file {} for writing", mFileName));
+  }
+  CTFFlatFile::FileHeader fh;
+  std::memcpy(fh.magic, CTFFlatFile::Magic, sizeof(fh.magic));
+  mFile.write(reinterpret_cast<const char*>(&fh), sizeof(fh));
+  mSize = sizeof(fh);
+  writePadding(CTFFlatFile::align(mSize) - mSize);
+}
+
+///_____________________________________________________________________________
+CTFFlatFileWriter::~CTFFlatFileWriter()
+{
+  close();
+}
+
+///_____________________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (mFile.is_open()) {
+    mFile.close();
+    LOGP(info, "Closed flat CTF file {} with {} entries, {} bytes", mFileName, mNEntries, mSize);
+  }
+}
+
+///_____________________________________________________________________________
+void CTFFlatFileWriter::addDetector(DetID det, const void* data, size_t size)
+{
+  mParts.push_back({det, reinterpret_cast<const char*>(data), size});
+}
+
+///_____________________________________________________________________________
+void CTFFlatFileWriter::writePadding(size_t n)
+{
+  static const char zeros[CTFFlatFile::PayloadAlignment] = {0};
+  if (n) {
+    mFile.write(zeros, n);
+    mSize += n;
+  }
+}
+
+///_____________________________________________________________________________
+size_t CTFFlatFileWriter::writeEntry(const CTFHeader& header)
+{
+  CTFFlatFile::EntryHeader eh;
+  eh.nDetectors = mParts.size();
+  eh.run = header.run;
+  eh.creationTime = header.creationTime;
+  eh.firstTForbit = header.firstTForbit;
+  eh.tfCounter = header.tfCounter;
+  std::vector<CTFFlatFile::DetectorRecord> records(mParts.size());
+  size_t offset = CTFFlatFile::align(sizeof(eh) + records.size() * sizeof(CTFFlatFile::DetectorRecord));
+  for (size_t i = 0; i < mParts.size(); i++) {
+    records[i].det = mParts[i].det;
+    records[i].offset = offset;
+    records[i].size = mParts[i].size;
+    offset += CTFFlatFile::align(mParts[i].size);
+    eh.detectors |= 0x1u << mParts[i].det;
+  }
+  eh.entrySize = offset;
+
+  auto entryStart = mSize;
+  mFile.write(reinterpret_cast<const char*>(&eh), sizeof(eh));
+  mFile.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CTFFlatFile::DetectorRecord));
+  mSize += sizeof(eh) + records.size() * sizeof(CTFFlatFile::DetectorRecord);
+  for (const auto& part : mParts) {
+    writePadding(CTFFlatFile::align(mSize - entryStart) - (mSize - entryStart));
+    mFile.write(part.data, part.size);
+    mSize += part.size;
+  }
+  writePadding(entryStart + eh.entrySize - mSize);
+  mParts.clear();
+  if (!mFile.good()) {
+    throw std::runtime_error(fmt::format("failed to write CTF entry {} to flat file {}", mNEntries, mFileName));
+  }
+  mNEntries++;
+  return eh.entrySize;
+}
+
+//=============================================================================
+
+///_____________________________________________________________________________
+CTFFlatFileReader::CTFFlatFileReader(const std::string& fileName) : mFileName(fileName)
+{
+  int fd = open(mFileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::runtime_error(fmt::format("failed to open flat CTF file {}", mFileName));
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1 || size_t(st.st_size) < sizeof(CTFFlatFile::FileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("flat CTF file {} is too short", mFileName));
+  }
+  mSize = st.st_size;
+  void* ptr = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("failed to map flat CTF file {}", mFileName));
+  }
+  mData = reinterpret_cast<const char*>(ptr);
+  madvise(ptr, mSize, MADV_SEQUENTIAL);
+
+  const auto& fh = *reinterpret_cast<const CTFFlatFile::FileHeader*>(mData);
+  if (std::memcmp(fh.magic, CTFFlatFile::Magic, sizeof(fh.magic)) != 0 || fh.version != CTFFlatFile::Version) {
+    munmap(ptr, mSize);
+    throw std::runtime_error(fmt::format("{} is not a flat CTF file of version {}", mFileName, CTFFlatFile::Version));
+  }
+  // build the index of entries, a truncated last entry (e.g. from unfinished writing) is ignored
+  size_t offset = CTFFlatFile::align(sizeof(CTFFlatFile::FileHeader));
+  while (offset + sizeof(CTFFlatFile::EntryHeader) <= mSize) {
+    const auto& eh = *reinterpret_cast<const CTFFlatFile::EntryHeader*>(mData + offset);
+    if (eh.magic != CTFFlatFile::EntryMagic || eh.entrySize < sizeof(eh) || offset + eh.entrySize > mSize) {
+      LOGP(error, "Corrupted or truncated entry {} at offset {} in flat CTF file {}, ignoring the rest of the file", mEntries.size(), offset, mFileName);
+      break;
+    }
+    mEntries.push_back(offset);
+    offset += eh.entrySize;
+  }
+}
+
+///_____________________________________________________________________________
+CTFFlatFileReader::~CTFFlatFileReader()
+{
+  if (mData) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+}
+
+///_____________________________________________________________________________
+const CTFFlatFile::EntryHeader& CTFFlatFileReader::getEntryHeader(size_t entry) const
+{
+  if (entry >= mEntries.size()) {
+    throw std::out_of_range(fmt::format("entry {} is out of range for flat CTF file {} with {} entries", entry, mFileName, mEntries.size()));
+  }
+  return *reinterpret_cast<const CTFFlatFile::EntryHeader*>(mData + mEntries[entry]);
+}
+
+///_____________________________________________________________________________
+CTFHeader CTFFlatFileReader::getHeader(size_t entry) const
+{
+  const auto& eh = getEntryHeader(entry);
+  CTFHeader h{eh.run, eh.creationTime, eh.firstTForbit, eh.tfCounter};
+  h.detectors = DetID::mask_t(eh.detectors);
+  return h;
+}
+
+///_____________________________________________________________________________
+gsl::span<const char> CTFFlatFileReader::getDetectorData(size_t entry, DetID det) const
+{
+  const auto& eh = getEntryHeader(entry);
+  const auto* records = reinterpret_cast<const CTFFlatFile::DetectorRecord*>(&eh + 1);
+  for (uint32_t i = 0; i < eh.nDetectors; i++) {
+    if (records[i].det == uint32_t(det)) {
+      return {reinterpret_cast<const char*>(&eh) + records[i].offset, size_t(records[i].size)};
+    }
+  }
+  return {};
+}
+
+///_____________________________________________________________________________
+void CTFFlatFileReader::prefetch(size_t entry) const
+{
+  const auto& eh = getEntryHeader(entry);
+  auto pageSize = size_t(sysconf(_SC_PAGESIZE));
+  auto start = mEntries[entry] / pageSize * pageSize;
+  madvise(const_cast<char*>(mData) + start, mEntries[entry] + eh.entrySize - start, MADV_WILLNEED);
+}
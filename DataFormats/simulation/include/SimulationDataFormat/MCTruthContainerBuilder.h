@@ -0,0 +1,254 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MCTruthContainerBuilder.h
+/// \brief Builder of the flat MC truth container from labels collected in chunked arena storage
+
+#ifndef O2_MCTRUTHCONTAINERBUILDER_H
+#define O2_MCTRUTHCONTAINERBUILDER_H
+
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include <memory_resource>
+#include <deque>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+namespace o2
+{
+namespace dataformats
+{
+
+/// @class MCTruthContainerBuilder
+/// @brief Collects labels in a number of independent slots and flattens them to the ConstMCTruthContainer format
+///
+/// Each slot (e.g. per thread, sector or chip) appends the labels with the same interface as the MCTruthContainer,
+/// with the data indices local to the slot. The headers and the labels are stored in fixed size chunks allocated
+/// from the slot's monotonic arena, so the already added labels are never moved or copied when the slot grows.
+/// Different slots can be filled concurrently, one thread per slot.
+/// The flattened container is the concatenation of the slots in their order, the data indices of the slot i
+/// following those of the slot i-1. It is written directly to the target buffer, e.g. the one obtained by
+/// DataAllocator::make<ConstMCTruthContainer<TruthElement>>, with a single copy of the labels.
+template <typename TruthElement>
+class MCTruthContainerBuilder
+{
+ public:
+  using FlatHeader = typename MCTruthContainer<TruthElement>::FlatHeader;
+  static constexpr size_t DefaultChunkSize = 16384; // number of elements per chunk
+
+  class Slot
+  {
+   public:
+    Slot(size_t chunkSize = DefaultChunkSize) : mHeaders(&mArena, chunkSize), mLabels(&mArena, chunkSize) {}
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+    // return the number of data indexed in this slot
+    size_t getIndexedSize() const { return mHeaders.size(); }
+    // return the number of labels in this slot
+    size_t getNElements() const { return mLabels.size(); }
+
+    // add element for a particular dataindex, same semantics as MCTruthContainer::addElement
+    void addElement(uint32_t dataindex, TruthElement const& element, bool noElement = false)
+    {
+      if (dataindex < mHeaders.size()) {
+        if (dataindex != (mHeaders.size() - 1)) {
+          throw std::runtime_error("MCTruthContainerBuilder: unsupported code path");
+        }
+      } else {
+        while (mHeaders.size() <= dataindex) { // add empty holes and a new one
+          mHeaders.push_back(MCTruthHeaderElement(mLabels.size()));
+        }
+      }
+      if (!noElement) {
+        mLabels.push_back(element);
+      }
+    }
+
+    /// adds a data index that has no label
+    void addNoLabelIndex(uint32_t dataindex)
+    {
+      addElement(dataindex, TruthElement(), true);
+    }
+
+    template <typename CompatibleLabel>
+    void addElements(uint32_t dataindex, gsl::span<CompatibleLabel> elements)
+    {
+      addNoLabelIndex(dataindex);
+      for (auto& e : elements) {
+        mLabels.push_back(e);
+      }
+    }
+
+    /// append the content of the container, its data indices following those already in the slot
+    void append(MCTruthContainer<TruthElement> const& other)
+    {
+      const auto offset = mLabels.size();
+      for (uint32_t i = 0; i < other.getIndexedSize(); i++) {
+        mHeaders.push_back(MCTruthHeaderElement(other.getMCTruthHeader(i).index + offset));
+      }
+      for (const auto& e : other.getTruthArray()) {
+        mLabels.push_back(e);
+      }
+    }
+
+    /// drop the content and release the arena memory
+    void clear()
+    {
+      mHeaders.clear();
+      mLabels.clear();
+      mArena.release();
+    }
+
+   private:
+    friend class MCTruthContainerBuilder;
+
+    /// append-only storage in chunks of fixed size allocated from the arena
+    template <typename T>
+    class ChunkedArray
+    {
+     public:
+      ChunkedArray(std::pmr::memory_resource* arena, size_t chunkSize) : mArena(arena), mChunkSize(chunkSize) {}
+      size_t size() const { return mSize; }
+      void push_back(T const& v)
+      {
+        if (mSize == mChunks.size() * mChunkSize) {
+          mChunks.push_back(static_cast<T*>(mArena->allocate(mChunkSize * sizeof(T), alignof(T))));
+        }
+        new (&mChunks[mSize / mChunkSize][mSize % mChunkSize]) T(v);
+        mSize++;
+      }
+      void clear()
+      {
+        mChunks.clear();
+        mSize = 0;
+      }
+      /// call f(const T* data, size_t n) for the consecutive chunks
+      template <typename F>
+      void forEachChunk(F&& f) const
+      {
+        for (size_t ic = 0; ic < mChunks.size(); ic++) {
+          f(mChunks[ic], ic + 1 < mChunks.size() ? mChunkSize : mSize - ic * mChunkSize);
+        }
+      }
+
+     private:
+      std::pmr::memory_resource* mArena = nullptr;
+      size_t mChunkSize = 0;
+      size_t mSize = 0;
+      std::vector<T*> mChunks;
+    };
+
+    std::pmr::monotonic_buffer_resource mArena;
+    ChunkedArray<MCTruthHeaderElement> mHeaders;
+    ChunkedArray<TruthElement> mLabels;
+  };
+
+  MCTruthContainerBuilder(size_t nSlots = 1, size_t chunkSize = DefaultChunkSize)
+  {
+    for (size_t i = 0; i < nSlots; i++) {
+      mSlots.emplace_back(chunkSize);
+    }
+  }
+
+  size_t getNSlots() const { return mSlots.size(); }
+  Slot& getSlot(size_t i) { return mSlots[i]; }
+  const Slot& getSlot(size_t i) const { return mSlots[i]; }
+
+  // return the number of data indexed in all slots
+  size_t getIndexedSize() const
+  {
+    size_t n = 0;
+    for (const auto& s : mSlots) {
+      n += s.getIndexedSize();
+    }
+    return n;
+  }
+
+  // return the number of labels in all slots
+  size_t getNElements() const
+  {
+    size_t n = 0;
+    for (const auto& s : mSlots) {
+      n += s.getNElements();
+    }
+    return n;
+  }
+
+  // size in bytes of the flattened container
+  size_t getFlatSize() const
+  {
+    return sizeof(FlatHeader) + sizeof(MCTruthHeaderElement) * getIndexedSize() + sizeof(TruthElement) * getNElements();
+  }
+
+  /// Flatten the slots to the provided container, in the same format as MCTruthContainer::flatten_to
+  template <typename ContainerType>
+  size_t flatten_to(ContainerType& container) const
+  {
+    size_t bufferSize = getFlatSize();
+    container.resize((bufferSize / sizeof(typename ContainerType::value_type)) + ((bufferSize % sizeof(typename ContainerType::value_type)) > 0 ? 1 : 0));
+    return flatten_to(gsl::span<char>(reinterpret_cast<char*>(container.data()), bufferSize));
+  }
+
+  /// Flatten the slots to the preallocated buffer of at least getFlatSize() bytes
+  size_t flatten_to(gsl::span<char> buffer) const
+  {
+    size_t bufferSize = getFlatSize();
+    if (buffer.size() < bufferSize) {
+      throw std::runtime_error("MCTruthContainerBuilder: buffer is too small");
+    }
+    char* target = buffer.data();
+    auto& flatheader = *reinterpret_cast<FlatHeader*>(target);
+    target += sizeof(FlatHeader);
+    flatheader.version = 1;
+    flatheader.sizeofHeaderElement = sizeof(MCTruthHeaderElement);
+    flatheader.sizeofTruthElement = sizeof(TruthElement);
+    flatheader.reserved = 0;
+    flatheader.nofHeaderElements = getIndexedSize();
+    flatheader.nofTruthElements = getNElements();
+    auto* header = reinterpret_cast<MCTruthHeaderElement*>(target);
+    uint32_t offset = 0;
+    for (const auto& s : mSlots) { // the label indices of the slot are shifted by the labels of the previous slots
+      s.mHeaders.forEachChunk([&header, offset](const MCTruthHeaderElement* h, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+          (header++)->index = h[i].index + offset;
+        }
+      });
+      offset += s.getNElements();
+    }
+    target += sizeof(MCTruthHeaderElement) * flatheader.nofHeaderElements;
+    for (const auto& s : mSlots) {
+      s.mLabels.forEachChunk([&target](const TruthElement* l, size_t n) {
+        memcpy(target, l, n * sizeof(TruthElement));
+        target += n * sizeof(TruthElement);
+      });
+    }
+    return bufferSize;
+  }
+
+  /// drop the content of all slots and release their memory
+  void clear()
+  {
+    for (auto& s : mSlots) {
+      s.clear();
+    }
+  }
+
+ private:
+  std::deque<Slot> mSlots; // deque since the slots are neither copyable nor movable
+};
+
+using MCLabelContainerBuilder = MCTruthContainerBuilder<o2::MCCompLabel>;
+
+} // namespace dataformats
+} // namespace o2
+
+#endif // O2_MCTRUTHCONTAINERBUILDER_H
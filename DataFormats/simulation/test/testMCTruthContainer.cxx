@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 #include "SimulationDataFormat/MCCompLabel.h"
 #include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/MCTruthContainerBuilder.h"
 #include "SimulationDataFormat/LabelContainer.h"
 #include "SimulationDataFormat/IOMCTruthContainerView.h"
 #include <algorithm>
@@ -212,6 +213,68 @@ BOOST_AUTO_TEST_CASE(MCTruthContainer_flatten)
   BOOST_CHECK(cc.getLabels(2)[0] == 10);
 }
 
+BOOST_AUTO_TEST_CASE(MCTruthContainerBuilder_flatten)
+{
+  using TruthElement = long;
+  using TruthContainer = dataformats::MCTruthContainer<TruthElement>;
+  // small chunks to exercise the chunk boundaries
+  dataformats::MCTruthContainerBuilder<TruthElement> builder(3, 4);
+  TruthContainer reference;
+
+  // slot 0: filled label by label, with holes
+  auto& slot0 = builder.getSlot(0);
+  int refIndex = 0;
+  for (int i = 0; i < 10; i++) {
+    if (i % 3 == 2) {
+      slot0.addNoLabelIndex(i);
+      reference.addNoLabelIndex(refIndex + i);
+      continue;
+    }
+    for (int j = 0; j <= i % 3; j++) {
+      slot0.addElement(i, TruthElement(100 * i + j));
+      reference.addElement(refIndex + i, TruthElement(100 * i + j));
+    }
+  }
+  refIndex += slot0.getIndexedSize();
+
+  // slot 1 stays empty, slot 2 is filled from containers of consecutive events
+  auto& slot2 = builder.getSlot(2);
+  for (int ev = 0; ev < 3; ev++) {
+    TruthContainer evLabels;
+    for (int i = 0; i < 5; i++) {
+      evLabels.addElement(i, TruthElement(1000 * ev + i));
+      evLabels.addElement(i, TruthElement(1000 * ev + i + 500));
+    }
+    slot2.append(evLabels);
+    reference.mergeAtBack(evLabels);
+  }
+
+  BOOST_CHECK(builder.getIndexedSize() == reference.getIndexedSize());
+  BOOST_CHECK(builder.getNElements() == reference.getNElements());
+
+  std::vector<char> refBuffer, buffer;
+  reference.flatten_to(refBuffer);
+  builder.flatten_to(buffer);
+  BOOST_REQUIRE(buffer.size() == refBuffer.size());
+  BOOST_CHECK(std::equal(buffer.begin(), buffer.end(), refBuffer.begin()));
+
+  dataformats::ConstMCTruthContainer<TruthElement> cc;
+  builder.flatten_to(cc);
+  BOOST_REQUIRE(cc.getIndexedSize() == reference.getIndexedSize());
+  for (uint32_t i = 0; i < reference.getIndexedSize(); i++) {
+    auto labels = cc.getLabels(i), refLabels = reference.getLabels(i);
+    BOOST_REQUIRE(labels.size() == refLabels.size());
+    BOOST_CHECK(std::equal(labels.begin(), labels.end(), refLabels.begin()));
+  }
+
+  std::vector<char> small(buffer.size() - 1);
+  BOOST_CHECK_THROW(builder.flatten_to(gsl::span<char>(small)), std::runtime_error);
+
+  builder.clear();
+  BOOST_CHECK(builder.getIndexedSize() == 0);
+  BOOST_CHECK(builder.getNElements() == 0);
+}
+
 BOOST_AUTO_TEST_CASE(LabelContainer_noncont)
 {
   using TruthElement = long;
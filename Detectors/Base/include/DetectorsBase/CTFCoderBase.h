@@ -27,6 +27,7 @@
 #include "DetectorsCommonDataFormats/CTFIOSize.h"
 #include "DataFormatsCTP/TriggerOffsetsParam.h"
 #include "DetectorsCommonDataFormats/ANSHeader.h"
+#include "DetectorsCommonDataFormats/BlockDecodingQueue.h"
 #include "rANS/factory.h"
 #include "rANS/compat.h"
 #include "rANS/histogram.h"
@@ -57,6 +58,19 @@ class CTFCoderBase
   enum class OpType : int { Encoder,
                             Decoder };
 
+  /// Scope of the block requests of a detector decode: flush() decodes the blocks queued for concurrent decoding,
+  /// the destructor drops the ones still queued, e.g. when the decoding throws or returns before requesting all blocks,
+  /// so that they are never executed later on the buffers of the abandoned decoding
+  class BlockDecodingScope
+  {
+   public:
+    BlockDecodingScope() = default;
+    BlockDecodingScope(const BlockDecodingScope&) = delete;
+    BlockDecodingScope& operator=(const BlockDecodingScope&) = delete;
+    ~BlockDecodingScope() { BlockDecodingQueue::instance().discard(); }
+    void flush() { BlockDecodingQueue::instance().flush(); }
+  };
+
   CTFCoderBase() = delete;
   CTFCoderBase(int n, DetID det, float memFactor = 1.f) : mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
   CTFCoderBase(OpType op, int n, DetID det, float memFactor = 1.f) : mOpType(op), mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
@@ -121,6 +135,11 @@ class CTFCoderBase
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
+  /// max number of threads to decode concurrently the blocks of the CTF, <2 means sequential decoding.
+  /// Applied to the calling thread in updateTimeDependentParams
+  void setNDecodingThreads(int n) { mNDecodingThreads = n > 1 ? n : 1; }
+  int getNDecodingThreads() const { return mNDecodingThreads; }
+
   const CTFDictHeader& getExtDictHeader() const { return mExtHeader; }
 
   template <typename T>
@@ -203,6 +222,7 @@ class CTFCoderBase
   size_t mIRFrameSelMarginBwd = 0; // margin in BC to add to the IRFrame lower boundary when selection is requested
   size_t mIRFrameSelMarginFwd = 0; // margin in BC to add to the IRFrame upper boundary when selection is requested
   long mIRFrameSelShift = 0;       // Global shift of the IRFrames, to account for e.g. detector latency
+  int mNDecodingThreads = 1;       // number of threads for concurrent decoding of the CTF blocks
   int mVerbosity = 0;
 };
 
@@ -313,6 +333,9 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("irframe-shift")) {
     mIRFrameSelShift = (long)ic.options().get<int32_t>("irframe-shift");
   }
+  if (ic.options().hasOption("decoding-threads")) {
+    setNDecodingThreads(ic.options().get<int>("decoding-threads"));
+  }
   if (ic.options().hasOption("ans-version")) {
     if (ic.options().isSet("ans-version")) {
       const std::string ansVersionString = ic.options().get<std::string>("ans-version");
@@ -23,6 +23,9 @@
 #ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
 #include "MathUtils/Cartesian.h"
 #endif // !GPUCA_ALIGPUCODE
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+#include <gsl/span>
+#endif
 
 /**********************************************************************
  *                                                                    *
@@ -64,6 +67,7 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   GPUd() const MatLayerCyl& getLayer(int i) const { return get()->mLayers[i]; }
 
   GPUd() bool getLayersRange(const Ray& ray, short& lmin, short& lmax) const;
+  GPUd() bool getLayersRange(float rmin2, float rmax2, short& lmin, short& lmax) const;
   GPUd() float getRMin() const { return get()->mRMin; }
   GPUd() float getRMax() const { return get()->mRMax; }
   GPUd() float getZMax() const { return get()->mZMax; }
@@ -101,6 +105,28 @@ class MatLayerCylSet : public o2::gpu::FlatObject
 #endif // !GPUCA_ALIGPUCODE
   GPUd() MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const;
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  /// budget of the last ray queried with this cache, reused when the next ray has the same end points within the tolerance
+  struct RayCache {
+    float p0[3] = {0.f};
+    float p1[3] = {0.f};
+    MatBudget budget;
+    bool valid = false;
+
+    bool matches(float x0, float y0, float z0, float x1, float y1, float z1, float tolerance) const;
+    void fill(float x0, float y0, float z0, float x1, float y1, float z1, const MatBudget& mb);
+    MatBudget reuse(float dist) const;
+  };
+  static constexpr float RayCacheTolerance = 1e-4; // max difference of the end points coordinates for the cache reuse
+
+  MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1, RayCache& cache, float tolerance = RayCacheTolerance) const;
+
+  /// get material budgets of the rays between points p0[i] and p1[i], optionally reusing the budgets of caches[i]
+  void getMatBudget(gsl::span<const math_utils::Point3D<float>> p0, gsl::span<const math_utils::Point3D<float>> p1, gsl::span<MatBudget> budgets,
+                    gsl::span<RayCache> caches = {}, float tolerance = RayCacheTolerance) const;
+  static constexpr int RayBlockSize = 64; // number of rays traversed together layer by layer in the batched lookup
+#endif
+
   GPUd() int searchSegment(float val, int low = -1, int high = -1) const;
 
   /// searches a layer based on r2 input, using a lookup table
@@ -134,6 +160,9 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   uint16_t mLayerVoxelLU[2 * NumVoxels]; //! helper structure to lookup a layer based on known radius (static dimension for easy copy to GPU)
   bool mInitializedLayerVoxelLU = false; //! if the voxels have been initialized
 
+ private:
+  GPUd() void accountLayer(Ray& ray, int lrID, MatBudget& rval) const;
+
   ClassDefNV(MatLayerCylSet, 1);
 };
 
@@ -27,6 +27,9 @@
 #ifndef GPUCA_GPUCODE
 #include <string>
 #endif
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+#include <gsl/span>
+#endif
 
 namespace o2
 {
@@ -119,6 +122,70 @@ class PropagatorImpl
                                    gpu::gpustd::array<value_type, 2>* dca = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
                                    int signCorr = 0, value_type maxD = 999.f) const;
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  // Batch propagation of many tracks to a common X or to the per-track X (xs of the same size as tracks).
+  // The tracks are propagated in lock-step: at every step the field and the material lookups are done for all
+  // active tracks in one pass and, for the constant field propagation, the helix steps of the tracks are
+  // evaluated in SIMD lanes. Each track follows the same path as with the single-track method with the same
+  // settings. Returns the number of successfully propagated tracks, the status of each track is stored in the
+  // optional ok span, the optional tofInfo span must have the size of tracks.
+  int propagateToX(gsl::span<TrackParCov_t> tracks, value_type x, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, gsl::span<const value_type>(&x, 1), true, bZ, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int propagateToX(gsl::span<TrackParCov_t> tracks, gsl::span<const value_type> xs, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, xs, true, bZ, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int propagateToX(gsl::span<TrackPar_t> tracks, value_type x, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, gsl::span<const value_type>(&x, 1), true, bZ, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int propagateToX(gsl::span<TrackPar_t> tracks, gsl::span<const value_type> xs, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, xs, true, bZ, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, value_type x,
+                         value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                         gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, gsl::span<const value_type>(&x, 1), false, 0, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, gsl::span<const value_type> xs,
+                         value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                         gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, xs, false, 0, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int PropagateToXBxByBz(gsl::span<TrackPar_t> tracks, value_type x,
+                         value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                         gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, gsl::span<const value_type>(&x, 1), false, 0, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+
+  int PropagateToXBxByBz(gsl::span<TrackPar_t> tracks, gsl::span<const value_type> xs,
+                         value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                         gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0, gsl::span<bool> ok = {}) const
+  {
+    return propagateBatch(tracks, xs, false, 0, maxSnp, maxStep, matCorr, tofInfo, signCorr, ok);
+  }
+#endif
+
   PropagatorImpl(PropagatorImpl const&) = delete;
   PropagatorImpl(PropagatorImpl&&) = delete;
   PropagatorImpl& operator=(PropagatorImpl const&) = delete;
@@ -165,6 +232,11 @@ class PropagatorImpl
   static constexpr value_type Epsilon = 0.00001; // precision of propagation to X
   template <typename T>
   GPUd() void getFieldXYZImpl(const math_utils::Point3D<T> xyz, T* bxyz) const;
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  template <typename track_T>
+  int propagateBatch(gsl::span<track_T> tracks, gsl::span<const value_type> xs, bool bzOnly, value_type bZ, value_type maxSnp, value_type maxStep,
+                     MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr, gsl::span<bool> ok) const;
+#endif
 
   const o2::field::MagFieldFast* mFieldFast = nullptr; ///< External fast field map (barrel only for the moment)
   o2::field::MagneticField* mField = nullptr;          ///< External nominal field map
@@ -288,118 +288,125 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
   }
   short lrID = lmax;
   while (lrID >= lmin) { // go from outside to inside
-    const auto& lr = getLayer(lrID);
-    int nphiSlices = lr.getNPhiSlices();
-    int nc = ray.crossLayer(lr); // determines how many crossings this ray has with this tubular layer
-    for (int ic = nc; ic--;) {
-      float cross1, cross2;
-      ray.getCrossParams(ic, cross1, cross2); // tmax,tmin of crossing the layer
-
-      auto phi0 = ray.getPhi(cross1), phi1 = ray.getPhi(cross2), dPhi = phi0 - phi1;
-      auto phiID = lr.getPhiSliceID(phi0), phiIDLast = lr.getPhiSliceID(phi1);
-      // account for eventual wrapping around 0
-      if (dPhi > 0.f) {
-        if (dPhi > o2::constants::math::PI) { // wraps around phi=0
-          phiIDLast += nphiSlices;
-        }
-      } else {
-        if (dPhi < -o2::constants::math::PI) { // wraps around phi=0
-          phiID += nphiSlices;
-        }
-      }
+    accountLayer(ray, lrID, rval);
+    lrID--;
+  } // loop over layers
 
-      int stepPhiID = phiID > phiIDLast ? -1 : 1;
-      bool checkMorePhi = true;
-      auto tStartPhi = cross1, tEndPhi = 0.f;
-      do {
-        // get the path in the current phi slice
-        if (phiID == phiIDLast) {
-          tEndPhi = cross2;
-          checkMorePhi = false;
-        } else { // last phi slice still not reached
-          tEndPhi = ray.crossRadial(lr, (stepPhiID > 0 ? phiID + 1 : phiID) % nphiSlices);
-          if (tEndPhi == Ray::InvalidT) {
-            break; // ray parallel to radial line, abandon check for phi bin change
-          }
-        }
-        auto zID = lr.getZBinID(ray.getZ(tStartPhi));
-        auto zIDLast = lr.getZBinID(ray.getZ(tEndPhi));
-        // check if Zbins are crossed
+  if (rval.length != 0.f) {
+    rval.meanRho /= rval.length;                                       // average
+    rval.meanX2X0 *= ray.getDist();                                    // normalize
+  }
+  rval.length = ray.getDist();
 
 #ifdef _DBG_LOC_
-        printf("-- Zdiff (%3d : %3d) mode: t: %+e %+e\n", zID, zIDLast, tStartPhi, tEndPhi);
+  printf("<rho> = %e, x2X0 = %e  | step = %e\n", rval.meanRho, rval.meanX2X0, rval.length);
 #endif
+  return rval;
+}
 
-        if (zID != zIDLast) {
-          auto stepZID = zID < zIDLast ? 1 : -1;
-          bool checkMoreZ = true;
-          auto tStartZ = tStartPhi, tEndZ = 0.f;
-          do {
-            if (zID == zIDLast) {
-              tEndZ = tEndPhi;
-              checkMoreZ = false;
-            } else {
-              tEndZ = ray.crossZ(lr.getZBinMin(stepZID > 0 ? zID + 1 : zID));
-              if (tEndZ == Ray::InvalidT) { // track normal to Z axis, abandon Zbin change test
-                break;
-              }
-            }
-            // account materials of this step
-            float step = tEndZ > tStartZ ? tEndZ - tStartZ : tStartZ - tEndZ; // the real step is ray.getDist(tEnd-tStart), will rescale all later
-            const auto& cell = lr.getCell(phiID % nphiSlices, zID);
-            rval.meanRho += cell.meanRho * step;
-            rval.meanX2X0 += cell.meanX2X0 * step;
-            rval.length += step;
+//_________________________________________________________________________________________________
+GPUd() void MatLayerCylSet::accountLayer(Ray& ray, int lrID, MatBudget& rval) const
+{
+  // add to rval the material of the layer lrID traversed by the ray, with the steps in units of the ray parameter t
+  const auto& lr = getLayer(lrID);
+  int nphiSlices = lr.getNPhiSlices();
+  int nc = ray.crossLayer(lr); // determines how many crossings this ray has with this tubular layer
+  for (int ic = nc; ic--;) {
+    float cross1, cross2;
+    ray.getCrossParams(ic, cross1, cross2); // tmax,tmin of crossing the layer
+
+    auto phi0 = ray.getPhi(cross1), phi1 = ray.getPhi(cross2), dPhi = phi0 - phi1;
+    auto phiID = lr.getPhiSliceID(phi0), phiIDLast = lr.getPhiSliceID(phi1);
+    // account for eventual wrapping around 0
+    if (dPhi > 0.f) {
+      if (dPhi > o2::constants::math::PI) { // wraps around phi=0
+        phiIDLast += nphiSlices;
+      }
+    } else {
+      if (dPhi < -o2::constants::math::PI) { // wraps around phi=0
+        phiID += nphiSlices;
+      }
+    }
+
+    int stepPhiID = phiID > phiIDLast ? -1 : 1;
+    bool checkMorePhi = true;
+    auto tStartPhi = cross1, tEndPhi = 0.f;
+    do {
+      // get the path in the current phi slice
+      if (phiID == phiIDLast) {
+        tEndPhi = cross2;
+        checkMorePhi = false;
+      } else { // last phi slice still not reached
+        tEndPhi = ray.crossRadial(lr, (stepPhiID > 0 ? phiID + 1 : phiID) % nphiSlices);
+        if (tEndPhi == Ray::InvalidT) {
+          break; // ray parallel to radial line, abandon check for phi bin change
+        }
+      }
+      auto zID = lr.getZBinID(ray.getZ(tStartPhi));
+      auto zIDLast = lr.getZBinID(ray.getZ(tEndPhi));
+      // check if Zbins are crossed
 
 #ifdef _DBG_LOC_
-            float pos0[3] = {ray.getPos(tStartZ, 0), ray.getPos(tStartZ, 1), ray.getPos(tStartZ, 2)};
-            float pos1[3] = {ray.getPos(tEndZ, 0), ray.getPos(tEndZ, 1), ray.getPos(tEndZ, 2)};
-            printf(
-              "Lr#%3d / cross#%d : account %f<t<%f at phiSlice %d | Zbin: %3d (%3d) |[%+e %+e +%e]:[%+e %+e %+e] "
-              "Step: %.3e StrpCor: %.3e\n",
-              lrID, ic, tEndZ, tStartZ, phiID % nphiSlices, zID, zIDLast,
-              pos0[0], pos0[1], pos0[2], pos1[0], pos1[1], pos1[2], step, ray.getDist(step));
+      printf("-- Zdiff (%3d : %3d) mode: t: %+e %+e\n", zID, zIDLast, tStartPhi, tEndPhi);
 #endif
 
-            tStartZ = tEndZ;
-            zID += stepZID;
-          } while (checkMoreZ);
-        } else {
-          float step = tEndPhi > tStartPhi ? tEndPhi - tStartPhi : tStartPhi - tEndPhi; // the real step is |ray.getDist(tEnd-tStart)|, will rescale all later
+      if (zID != zIDLast) {
+        auto stepZID = zID < zIDLast ? 1 : -1;
+        bool checkMoreZ = true;
+        auto tStartZ = tStartPhi, tEndZ = 0.f;
+        do {
+          if (zID == zIDLast) {
+            tEndZ = tEndPhi;
+            checkMoreZ = false;
+          } else {
+            tEndZ = ray.crossZ(lr.getZBinMin(stepZID > 0 ? zID + 1 : zID));
+            if (tEndZ == Ray::InvalidT) { // track normal to Z axis, abandon Zbin change test
+              break;
+            }
+          }
+          // account materials of this step
+          float step = tEndZ > tStartZ ? tEndZ - tStartZ : tStartZ - tEndZ; // the real step is ray.getDist(tEnd-tStart), will rescale all later
           const auto& cell = lr.getCell(phiID % nphiSlices, zID);
           rval.meanRho += cell.meanRho * step;
           rval.meanX2X0 += cell.meanX2X0 * step;
           rval.length += step;
 
 #ifdef _DBG_LOC_
-          float pos0[3] = {ray.getPos(tStartPhi, 0), ray.getPos(tStartPhi, 1), ray.getPos(tStartPhi, 2)};
-          float pos1[3] = {ray.getPos(tEndPhi, 0), ray.getPos(tEndPhi, 1), ray.getPos(tEndPhi, 2)};
+          float pos0[3] = {ray.getPos(tStartZ, 0), ray.getPos(tStartZ, 1), ray.getPos(tStartZ, 2)};
+          float pos1[3] = {ray.getPos(tEndZ, 0), ray.getPos(tEndZ, 1), ray.getPos(tEndZ, 2)};
           printf(
-            "Lr#%3d / cross#%d : account %f<t<%f at phiSlice %d | Zbin: %3d ----- |[%+e %+e +%e]:[%+e %+e %+e]"
+            "Lr#%3d / cross#%d : account %f<t<%f at phiSlice %d | Zbin: %3d (%3d) |[%+e %+e +%e]:[%+e %+e %+e] "
             "Step: %.3e StrpCor: %.3e\n",
-            lrID, ic, tEndPhi, tStartPhi, phiID % nphiSlices, zID,
+            lrID, ic, tEndZ, tStartZ, phiID % nphiSlices, zID, zIDLast,
             pos0[0], pos0[1], pos0[2], pos1[0], pos1[1], pos1[2], step, ray.getDist(step));
 #endif
-        }
-        //
-        tStartPhi = tEndPhi;
-        phiID += stepPhiID;
 
-      } while (checkMorePhi);
-    }
-    lrID--;
-  } // loop over layers
-
-  if (rval.length != 0.f) {
-    rval.meanRho /= rval.length;                                       // average
-    rval.meanX2X0 *= ray.getDist();                                    // normalize
-  }
-  rval.length = ray.getDist();
+          tStartZ = tEndZ;
+          zID += stepZID;
+        } while (checkMoreZ);
+      } else {
+        float step = tEndPhi > tStartPhi ? tEndPhi - tStartPhi : tStartPhi - tEndPhi; // the real step is |ray.getDist(tEnd-tStart)|, will rescale all later
+        const auto& cell = lr.getCell(phiID % nphiSlices, zID);
+        rval.meanRho += cell.meanRho * step;
+        rval.meanX2X0 += cell.meanX2X0 * step;
+        rval.length += step;
 
 #ifdef _DBG_LOC_
-  printf("<rho> = %e, x2X0 = %e  | step = %e\n", rval.meanRho, rval.meanX2X0, rval.length);
+        float pos0[3] = {ray.getPos(tStartPhi, 0), ray.getPos(tStartPhi, 1), ray.getPos(tStartPhi, 2)};
+        float pos1[3] = {ray.getPos(tEndPhi, 0), ray.getPos(tEndPhi, 1), ray.getPos(tEndPhi, 2)};
+        printf(
+          "Lr#%3d / cross#%d : account %f<t<%f at phiSlice %d | Zbin: %3d ----- |[%+e %+e +%e]:[%+e %+e %+e]"
+          "Step: %.3e StrpCor: %.3e\n",
+          lrID, ic, tEndPhi, tStartPhi, phiID % nphiSlices, zID,
+          pos0[0], pos0[1], pos0[2], pos1[0], pos1[1], pos1[2], step, ray.getDist(step));
 #endif
-  return rval;
+      }
+      //
+      tStartPhi = tEndPhi;
+      phiID += stepPhiID;
+
+    } while (checkMorePhi);
+  }
 }
 
 //_________________________________________________________________________________________________
@@ -407,10 +414,17 @@ GPUd() bool MatLayerCylSet::getLayersRange(const Ray& ray, short& lmin, short& l
 {
   // get range of layers corresponding to rmin/rmax
   //
-  lmin = lmax = -1;
   float rmin2, rmax2;
   ray.getMinMaxR2(rmin2, rmax2);
+  return getLayersRange(rmin2, rmax2, lmin, lmax);
+}
 
+//_________________________________________________________________________________________________
+GPUd() bool MatLayerCylSet::getLayersRange(float rmin2, float rmax2, short& lmin, short& lmax) const
+{
+  // get range of layers corresponding to the range rmin2:rmax2 of squared radii
+  //
+  lmin = lmax = -1;
   if (rmin2 >= getRMax2() || rmax2 <= getRMin2()) {
     return false;
   }
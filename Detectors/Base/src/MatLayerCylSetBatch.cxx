@@ -0,0 +1,178 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MatLayerCylSetBatch.cxx
+/// \brief Batched and cached material budget lookups in the set of cylindrical material layers, CPU only
+
+#include "DetectorsBase/MatLayerCylSet.h"
+#include <Vc/Vc>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+using namespace o2::base;
+
+namespace
+{
+using float_v = Vc::float_v;
+constexpr int W = float_v::Size;
+constexpr float RelR2Margin = 1e-5; // relative widening of the SIMD estimate of the rays R2 range
+
+///< SoA block of the ray end points
+struct alignas(Vc::VectorAlignment) RayLanes {
+  std::array<float, W> x0, y0, x1, y1, rmin2, rmax2;
+
+  /// lane-wise version of the Ray::getMinMaxR2
+  void getMinMaxR2()
+  {
+    float_v vx0(x0.data(), Vc::Aligned), vy0(y0.data(), Vc::Aligned), vx1(x1.data(), Vc::Aligned), vy1(y1.data(), Vc::Aligned);
+    float_v dx = vx1 - vx0, dy = vy1 - vy0, distXY2 = dx * dx + dy * dy;
+    float_v distXY2i = Vc::iif(distXY2 > Ray::Tiny, float_v::One() / Vc::iif(distXY2 > Ray::Tiny, distXY2, float_v::One()), float_v::Zero());
+    float_v red = -(vx0 * dx + vy0 * dy) * distXY2i;
+    float_v r02 = vx0 * vx0 + vy0 * vy0, r12 = vx1 * vx1 + vy1 * vy1;
+    float_v vrmin2 = Vc::min(r02, r12), vrmax2 = Vc::max(r02, r12);
+    float_v xMin = vx0 + red * dx, yMin = vy0 + red * dy; // point of closest approach to the origin
+    vrmin2(red > 0.f && red < 1.f) = xMin * xMin + yMin * yMin;
+    (vrmin2 * (1.f - RelR2Margin)).store(rmin2.data(), Vc::Aligned);
+    (vrmax2 * (1.f + RelR2Margin)).store(rmax2.data(), Vc::Aligned);
+  }
+};
+
+} // namespace
+
+//_________________________________________________________________________________________________
+bool MatLayerCylSet::RayCache::matches(float x0, float y0, float z0, float x1, float y1, float z1, float tolerance) const
+{
+  return valid && std::abs(p0[0] - x0) <= tolerance && std::abs(p0[1] - y0) <= tolerance && std::abs(p0[2] - z0) <= tolerance &&
+         std::abs(p1[0] - x1) <= tolerance && std::abs(p1[1] - y1) <= tolerance && std::abs(p1[2] - z1) <= tolerance;
+}
+
+//_________________________________________________________________________________________________
+void MatLayerCylSet::RayCache::fill(float x0, float y0, float z0, float x1, float y1, float z1, const MatBudget& mb)
+{
+  p0[0] = x0;
+  p0[1] = y0;
+  p0[2] = z0;
+  p1[0] = x1;
+  p1[1] = y1;
+  p1[2] = z1;
+  budget = mb;
+  valid = true;
+}
+
+//_________________________________________________________________________________________________
+MatBudget MatLayerCylSet::RayCache::reuse(float dist) const
+{
+  // cached budget rescaled to the length of the new ray: the mean density is kept, the X/X0 is proportional to the length
+  MatBudget mb = budget;
+  if (budget.length > 0.f) {
+    mb.meanX2X0 *= dist / budget.length;
+  }
+  mb.length = dist;
+  return mb;
+}
+
+//_________________________________________________________________________________________________
+MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1, RayCache& cache, float tolerance) const
+{
+  // get material budget traversed on the line between point0 and point1, reusing the cached one if the end points
+  // differ from the cached ones by less than the tolerance. Typically used in iterative propagation along the same path.
+  if (cache.matches(x0, y0, z0, x1, y1, z1, tolerance)) {
+    float dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
+    return cache.reuse(std::sqrt(dx * dx + dy * dy + dz * dz));
+  }
+  auto mb = getMatBudget(x0, y0, z0, x1, y1, z1);
+  cache.fill(x0, y0, z0, x1, y1, z1, mb);
+  return mb;
+}
+
+//_________________________________________________________________________________________________
+void MatLayerCylSet::getMatBudget(gsl::span<const math_utils::Point3D<float>> p0, gsl::span<const math_utils::Point3D<float>> p1, gsl::span<MatBudget> budgets,
+                                  gsl::span<RayCache> caches, float tolerance) const
+{
+  // Get material budgets of the rays between p0[i] and p1[i]. If the caches are provided (one per ray), the budget
+  // of the cache matching the ray is reused, otherwise the cache is refilled.
+  // The rays are processed in blocks of RayBlockSize: the range of layers of each ray is estimated in SIMD lanes
+  // (slightly widened, the layers not crossed do not contribute), then the block is traversed layer by layer from
+  // outside to inside, so that the cells of a layer are reused by all rays of the block while they are in the cache.
+  // The material of each ray is accumulated in the same order as by the single ray getMatBudget.
+  const int nRays = p0.size();
+  if (int(p1.size()) != nRays || int(budgets.size()) != nRays || (!caches.empty() && int(caches.size()) != nRays)) {
+    throw std::runtime_error("the sizes of the end points, budgets and caches spans differ");
+  }
+  std::array<Ray, RayBlockSize> rays;
+  std::array<short, RayBlockSize> lmin, lmax;
+  std::array<int, RayBlockSize> rayIDs;
+  RayLanes lanes;
+
+  for (int start = 0; start < nRays; start += RayBlockSize) {
+    int end = start + RayBlockSize < nRays ? start + RayBlockSize : nRays, nb = 0;
+    for (int i = start; i < end; i++) {
+      if (!caches.empty() && caches[i].matches(p0[i].X(), p0[i].Y(), p0[i].Z(), p1[i].X(), p1[i].Y(), p1[i].Z(), tolerance)) {
+        budgets[i] = caches[i].reuse(std::sqrt((p1[i] - p0[i]).Mag2()));
+        continue;
+      }
+      rayIDs[nb++] = i;
+    }
+
+    // ranges of layers to check
+    for (int k0 = 0; k0 < nb; k0 += W) {
+      int nLanes = nb - k0 < W ? nb - k0 : W;
+      for (int il = 0; il < W; il++) {
+        int i = rayIDs[k0 + (il < nLanes ? il : 0)]; // pad with the 1st lane to avoid garbage in the unused lanes
+        lanes.x0[il] = p0[i].X();
+        lanes.y0[il] = p0[i].Y();
+        lanes.x1[il] = p1[i].X();
+        lanes.y1[il] = p1[i].Y();
+      }
+      lanes.getMinMaxR2();
+      for (int il = 0; il < nLanes; il++) {
+        int k = k0 + il, i = rayIDs[k];
+        rays[k] = Ray(p0[i], p1[i]);
+        budgets[i] = MatBudget();
+        if (rays[k].isTooShort() || !getLayersRange(lanes.rmin2[il], lanes.rmax2[il], lmin[k], lmax[k])) {
+          lmin[k] = 0;
+          lmax[k] = -1;
+        }
+      }
+    }
+    short lrMin = getNLayers(), lrMax = -1;
+    for (int k = 0; k < nb; k++) {
+      if (lmax[k] < 0) {
+        continue;
+      }
+      lrMin = lmin[k] < lrMin ? lmin[k] : lrMin;
+      lrMax = lmax[k] > lrMax ? lmax[k] : lrMax;
+    }
+
+    // layer-major traversal of the block
+    for (short lrID = lrMax; lrID >= lrMin; lrID--) {
+      for (int k = 0; k < nb; k++) {
+        if (lrID <= lmax[k] && lrID >= lmin[k]) {
+          accountLayer(rays[k], lrID, budgets[rayIDs[k]]);
+        }
+      }
+    }
+
+    for (int k = 0; k < nb; k++) {
+      int i = rayIDs[k];
+      auto& rval = budgets[i];
+      if (rval.length != 0.f) {
+        rval.meanRho /= rval.length;        // average
+        rval.meanX2X0 *= rays[k].getDist(); // normalize
+      }
+      rval.length = rays[k].getDist();
+      if (!caches.empty()) {
+        caches[i].fill(p0[i].X(), p0[i].Y(), p0[i].Z(), p1[i].X(), p1[i].Y(), p1[i].Z(), rval);
+      }
+    }
+  }
+}
@@ -0,0 +1,330 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PropagatorBatch.cxx
+/// \brief Batch (lock-step) propagation of many tracks, CPU only
+
+#include "DetectorsBase/Propagator.h"
+#include "CommonConstants/MathConstants.h"
+#include <Vc/Vc>
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace o2::base;
+
+namespace
+{
+
+///< SoA block of the tracks to propagate by a helix step in the constant field
+template <typename value_T, bool WithCov>
+struct HelixLanes {
+  using vec_t = Vc::Vector<value_T>;
+  using mask_t = typename vec_t::MaskType;
+  static constexpr int W = vec_t::Size;
+
+  alignas(Vc::VectorAlignment) std::array<value_T, W> dx, crv, y, z, snp, tgl;
+  alignas(Vc::VectorAlignment) std::array<std::array<value_T, W>, WithCov ? o2::track::kCovMatSize : 1> cov;
+
+  vec_t load(const std::array<value_T, W>& a) const { return vec_t(a.data(), Vc::Aligned); }
+  static void store(const vec_t& v, std::array<value_T, W>& a) { v.store(a.data(), Vc::Aligned); }
+
+  /// lane-wise version of the TrackParametrization(WithError)::propagate(Param)To(x, b), returns the bit mask of the lanes
+  /// propagated successfully. The y, z, snp and cov arrays are updated in place.
+  int propagate(value_T b);
+};
+
+template <typename value_T, bool WithCov>
+int HelixLanes<value_T, WithCov>::propagate(value_T b)
+{
+  using namespace o2::track;
+  namespace cst = o2::constants::math;
+  const vec_t one = vec_t::One(), half(value_T(0.5)), vdx = load(dx), vcrv = load(crv);
+  mask_t noStep = Vc::abs(vdx) < value_T(cst::Almost0);
+  vec_t x2r = vcrv * vdx, f1 = load(snp), f2 = f1 + x2r;
+  mask_t bad = (Vc::abs(f1) > value_T(cst::Almost1)) || (Vc::abs(f2) > value_T(cst::Almost1));
+  vec_t r1 = Vc::sqrt(Vc::max((one - f1) * (one + f1), vec_t::Zero()));
+  vec_t r2 = Vc::sqrt(Vc::max((one - f2) * (one + f2), vec_t::Zero()));
+  bad = bad || (Vc::abs(r1) < value_T(cst::Almost0)) || (Vc::abs(r2) < value_T(cst::Almost0));
+  vec_t dy2dx = (f1 + f2) / Vc::iif(bad, one, r1 + r2);
+  mask_t arcz = Vc::abs(x2r) > value_T(0.05);
+  vec_t arg = r1 * f2 - r2 * f1;
+  bad = bad || (arcz && (Vc::abs(arg) > value_T(cst::Almost1)));
+  bad = bad && !noStep;
+  mask_t done = !bad && !noStep;
+  if (done.isEmpty()) {
+    return (~bad.toInt()) & ((1 << W) - 1);
+  }
+  vec_t tgl = load(this->tgl), dz = vdx * (r2 + f2 * dy2dx) * tgl;
+  if (!(arcz && done).isEmpty()) {
+    vec_t rot = Vc::asin(Vc::iif(arcz && done, arg, vec_t::Zero()));
+    mask_t large = (f1 * f1 + f2 * f2 > one) && (f1 * f2 < vec_t::Zero()); // special cases of large rotations or large abs angles
+    rot = Vc::iif(large, Vc::iif(f2 > vec_t::Zero(), vec_t(value_T(cst::PI)) - rot, vec_t(value_T(-cst::PI)) - rot), rot);
+    dz(arcz) = tgl / Vc::iif(arcz, vcrv, one) * rot;
+  }
+  vec_t vy = load(y), vz = load(z), vsnp = load(snp);
+  vy(done) += vdx * dy2dx;
+  vz(done) += dz;
+  vsnp(done) += x2r;
+  store(vy, y);
+  store(vz, z);
+  store(vsnp, snp);
+
+  if constexpr (WithCov) {
+    auto c = [this](int i) { return load(cov[i]); };
+    vec_t c00 = c(kSigY2), c10 = c(kSigZY), c11 = c(kSigZ2), c20 = c(kSigSnpY), c21 = c(kSigSnpZ), c22 = c(kSigSnp2),
+          c30 = c(kSigTglY), c31 = c(kSigTglZ), c32 = c(kSigTglSnp), c33 = c(kSigTgl2),
+          c40 = c(kSigQ2PtY), c41 = c(kSigQ2PtZ), c42 = c(kSigQ2PtSnp), c43 = c(kSigQ2PtTgl), c44 = c(kSigQ2Pt2);
+
+    vec_t rinv = one / Vc::iif(done, r1, one), r3inv = rinv * rinv * rinv;
+    vec_t f24 = vdx * (b * value_T(cst::B2C)), f02 = vdx * r3inv, f04 = half * f24 * f02;
+    vec_t f12 = f02 * tgl * f1, f14 = half * f24 * f12, f13 = vdx * rinv;
+
+    // b = C*ft
+    vec_t b00 = f02 * c20 + f04 * c40, b01 = f12 * c20 + f14 * c40 + f13 * c30, b02 = f24 * c40;
+    vec_t b10 = f02 * c21 + f04 * c41, b11 = f12 * c21 + f14 * c41 + f13 * c31, b12 = f24 * c41;
+    vec_t b20 = f02 * c22 + f04 * c42, b21 = f12 * c22 + f14 * c42 + f13 * c32, b22 = f24 * c42;
+    vec_t b40 = f02 * c42 + f04 * c44, b41 = f12 * c42 + f14 * c44 + f13 * c43, b42 = f24 * c44;
+    vec_t b30 = f02 * c32 + f04 * c43, b31 = f12 * c32 + f14 * c43 + f13 * c33, b32 = f24 * c43;
+
+    // a = f*b = f*C*ft
+    vec_t a00 = f02 * b20 + f04 * b40, a01 = f02 * b21 + f04 * b41, a02 = f02 * b22 + f04 * b42;
+    vec_t a11 = f12 * b21 + f14 * b41 + f13 * b31, a12 = f12 * b22 + f14 * b42 + f13 * b32, a22 = f24 * b42;
+
+    // F*C*Ft = C + (b + bt + a)
+    auto upd = [this, &done](int i, const vec_t& v, const vec_t& d) { store(Vc::iif(done, v + d, v), cov[i]); };
+    upd(kSigY2, c00, b00 + b00 + a00);
+    upd(kSigZY, c10, b10 + b01 + a01);
+    upd(kSigSnpY, c20, b20 + b02 + a02);
+    upd(kSigTglY, c30, b30);
+    upd(kSigQ2PtY, c40, b40);
+    upd(kSigZ2, c11, b11 + b11 + a11);
+    upd(kSigSnpZ, c21, b21 + b12 + a12);
+    upd(kSigTglZ, c31, b31);
+    upd(kSigQ2PtZ, c41, b41);
+    upd(kSigSnp2, c22, b22 + b22 + a22);
+    upd(kSigTglSnp, c32, b32);
+    upd(kSigQ2PtSnp, c42, b42);
+  }
+  return (~bad.toInt()) & ((1 << W) - 1);
+}
+
+} // namespace
+
+//_______________________________________________________________________
+template <typename value_T>
+template <typename track_T>
+int PropagatorImpl<value_T>::propagateBatch(gsl::span<track_T> tracks, gsl::span<const value_type> xs, bool bzOnly, value_type bZ, value_type maxSnp,
+                                            value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr,
+                                            gsl::span<bool> ok) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the tracks in lock-step to the common X (xs.size()==1) or to
+  // their own X (xs.size()==tracks.size()), see propagateToX / PropagateToXBxByBz
+  // for the meaning of the parameters.
+  // At every step, the field lookups (BxByBz mode), the helix steps and the material
+  // lookups (batched in the LUT case) are done in separate passes over all still active
+  // tracks. In the constant field mode the helix steps are evaluated in SIMD lanes, with
+  // the covariance matrix updated in value_type precision rather than in the double one
+  // of the single-track method.
+  //----------------------------------------------------------------
+  constexpr bool WithCov = std::is_same_v<track_T, TrackParCov_t>;
+  using Lanes = HelixLanes<value_type, WithCov>;
+  constexpr int W = Lanes::W;
+  const int nTr = tracks.size();
+  if (xs.size() != 1 && int(xs.size()) != nTr) {
+    throw std::runtime_error("the size of the X span must be 1 or the number of tracks");
+  }
+  if ((!tofInfo.empty() && int(tofInfo.size()) != nTr) || (!ok.empty() && int(ok.size()) != nTr)) {
+    throw std::runtime_error("the size of the tofInfo and status spans must be 0 or the number of tracks");
+  }
+  auto xTarget = [&xs](int i) { return xs.size() == 1 ? xs[0] : xs[i]; };
+
+  std::vector<int> active;
+  std::vector<int8_t> dirs(nTr), signs(nTr);
+  active.reserve(nTr);
+  int nOK = 0;
+  for (int i = 0; i < nTr; i++) {
+    auto dx = xTarget(i) - tracks[i].getX();
+    dirs[i] = dx > 0.f ? 1 : -1;
+    signs[i] = signCorr ? signCorr : -dirs[i]; // sign of eloss correction is not imposed
+    if (!ok.empty()) {
+      ok[i] = false;
+    }
+    if (math_utils::detail::abs<value_type>(dx) > Epsilon) {
+      active.push_back(i);
+    } else {
+      tracks[i].setX(xTarget(i));
+      nOK++;
+      if (!ok.empty()) {
+        ok[i] = true;
+      }
+    }
+  }
+
+  std::vector<value_type> xStep;
+  std::vector<math_utils::Point3D<value_type>> xyz0;
+  std::vector<gpu::gpustd::array<value_type, 3>> bxyz;
+  std::vector<MatBudget> mb;
+  std::vector<uint8_t> stepOK;
+  std::vector<math_utils::Point3D<float>> lutP0, lutP1;
+  std::vector<MatBudget> lutMB;
+  std::vector<int> lutIDs;
+  Lanes lanes;
+  while (!active.empty()) {
+    const int nAct = active.size();
+    xStep.resize(nAct);
+    xyz0.resize(nAct);
+    stepOK.resize(nAct);
+    for (int k = 0; k < nAct; k++) {
+      const auto& trc = tracks[active[k]];
+      auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(xTarget(active[k]) - trc.getX()), maxStep);
+      xStep[k] = trc.getX() + (dirs[active[k]] < 0 ? -step : step);
+      xyz0[k] = trc.getXYZGlo();
+    }
+
+    if (bzOnly) { // helix steps in SIMD lanes
+      for (int k0 = 0; k0 < nAct; k0 += W) {
+        int nLanes = nAct - k0 < W ? nAct - k0 : W;
+        for (int il = 0; il < W; il++) {
+          const int k = k0 + (il < nLanes ? il : 0); // pad with the 1st lane to avoid garbage in the unused lanes
+          const auto& trc = tracks[active[k]];
+          lanes.dx[il] = xStep[k] - trc.getX();
+          lanes.crv[il] = (WithCov || math_utils::detail::abs<value_type>(bZ) >= o2::constants::math::Almost0) ? trc.getCurvature(bZ) : 0.f;
+          lanes.y[il] = trc.getY();
+          lanes.z[il] = trc.getZ();
+          lanes.snp[il] = trc.getSnp();
+          lanes.tgl[il] = trc.getTgl();
+          if constexpr (WithCov) {
+            for (int ic = 0; ic < track::kCovMatSize; ic++) {
+              lanes.cov[ic][il] = trc.getCov()[ic];
+            }
+          }
+        }
+        int laneOK = lanes.propagate(bZ);
+        for (int il = 0; il < nLanes; il++) {
+          const int k = k0 + il;
+          stepOK[k] = (laneOK >> il) & 0x1;
+          if (!stepOK[k] || math_utils::detail::abs<value_type>(lanes.dx[il]) < o2::constants::math::Almost0) {
+            continue;
+          }
+          auto& trc = tracks[active[k]];
+          trc.setX(xStep[k]);
+          trc.setY(lanes.y[il]);
+          trc.setZ(lanes.z[il]);
+          trc.setSnp(lanes.snp[il]);
+          if constexpr (WithCov) {
+            for (int ic = 0; ic < track::kCovMatSize; ic++) {
+              trc.setCov(lanes.cov[ic][il], ic);
+            }
+            trc.checkCovariance();
+          }
+        }
+      }
+    } else { // grouped field lookups followed by the helix steps in the local field
+      bxyz.resize(nAct);
+      for (int k = 0; k < nAct; k++) {
+        getFieldXYZ(xyz0[k], bxyz[k].data());
+      }
+      for (int k = 0; k < nAct; k++) {
+        auto& trc = tracks[active[k]];
+        if constexpr (WithCov) {
+          stepOK[k] = trc.propagateTo(xStep[k], bxyz[k]);
+        } else {
+          stepOK[k] = trc.propagateParamTo(xStep[k], bxyz[k]);
+        }
+      }
+    }
+
+    // grouped material lookups
+    if (matCorr != MatCorrType::USEMatCorrNONE) {
+      mb.resize(nAct);
+      if (matCorr == MatCorrType::USEMatCorrLUT && mMatLUT) { // batched lookup of all rays in the LUT
+        lutP0.clear();
+        lutP1.clear();
+        lutIDs.clear();
+        for (int k = 0; k < nAct; k++) {
+          if (stepOK[k]) {
+            auto xyz1 = tracks[active[k]].getXYZGlo();
+            lutP0.emplace_back(xyz0[k].X(), xyz0[k].Y(), xyz0[k].Z());
+            lutP1.emplace_back(xyz1.X(), xyz1.Y(), xyz1.Z());
+            lutIDs.push_back(k);
+          }
+        }
+        lutMB.resize(lutIDs.size());
+        mMatLUT->getMatBudget(lutP0, lutP1, lutMB);
+        for (size_t j = 0; j < lutIDs.size(); j++) {
+          mb[lutIDs[j]] = lutMB[j];
+        }
+      } else {
+        for (int k = 0; k < nAct; k++) {
+          if (stepOK[k]) {
+            mb[k] = getMatBudget(matCorr, xyz0[k], tracks[active[k]].getXYZGlo());
+          }
+        }
+      }
+    }
+
+    int nKeep = 0;
+    for (int k = 0; k < nAct; k++) {
+      const int i = active[k];
+      if (!stepOK[k]) {
+        continue;
+      }
+      auto& trc = tracks[i];
+      bool res = true;
+      if (matCorr != MatCorrType::USEMatCorrNONE) {
+        if constexpr (WithCov) {
+          res = trc.correctForMaterial(mb[k].meanX2X0, mb[k].getXRho(signs[i]));
+        } else {
+          res = trc.correctForELoss(mb[k].getXRho(signs[i]));
+        }
+        if (!tofInfo.empty()) {
+          tofInfo[i].addStep(mb[k].length, trc.getP2Inv()); // fill L,ToF info using already calculated step length
+          tofInfo[i].addX2X0(mb[k].meanX2X0);
+          tofInfo[i].addXRho(mb[k].getXRho(signs[i]));
+        }
+      } else if (!tofInfo.empty()) { // if tofInfo filling was requested w/o material correction, we need to calculate the step lenght
+        auto xyz1 = trc.getXYZGlo();
+        math_utils::Vector3D<value_type> stepV(xyz1.X() - xyz0[k].X(), xyz1.Y() - xyz0[k].Y(), xyz1.Z() - xyz0[k].Z());
+        tofInfo[i].addStep(stepV.R(), trc.getP2Inv());
+      }
+      if ((maxSnp > 0 && math_utils::detail::abs<value_type>(trc.getSnp()) >= maxSnp) || !res) {
+        continue;
+      }
+      if (math_utils::detail::abs<value_type>(xTarget(i) - trc.getX()) > Epsilon) {
+        active[nKeep++] = i;
+        continue;
+      }
+      trc.setX(xTarget(i));
+      nOK++;
+      if (!ok.empty()) {
+        ok[i] = true;
+      }
+    }
+    active.resize(nKeep);
+  }
+  return nOK;
+}
+
+namespace o2::base
+{
+template int PropagatorImpl<float>::propagateBatch<PropagatorImpl<float>::TrackPar_t>(gsl::span<PropagatorImpl<float>::TrackPar_t>, gsl::span<const float>, bool, float, float, float,
+                                                                                      PropagatorImpl<float>::MatCorrType, gsl::span<track::TrackLTIntegral>, int, gsl::span<bool>) const;
+template int PropagatorImpl<float>::propagateBatch<PropagatorImpl<float>::TrackParCov_t>(gsl::span<PropagatorImpl<float>::TrackParCov_t>, gsl::span<const float>, bool, float, float, float,
+                                                                                         PropagatorImpl<float>::MatCorrType, gsl::span<track::TrackLTIntegral>, int, gsl::span<bool>) const;
+template int PropagatorImpl<double>::propagateBatch<PropagatorImpl<double>::TrackPar_t>(gsl::span<PropagatorImpl<double>::TrackPar_t>, gsl::span<const double>, bool, double, double, double,
+                                                                                        PropagatorImpl<double>::MatCorrType, gsl::span<track::TrackLTIntegral>, int, gsl::span<bool>) const;
+template int PropagatorImpl<double>::propagateBatch<PropagatorImpl<double>::TrackParCov_t>(gsl::span<PropagatorImpl<double>::TrackParCov_t>, gsl::span<const double>, bool, double, double, double,
+                                                                                           PropagatorImpl<double>::MatCorrType, gsl::span<track::TrackLTIntegral>, int, gsl::span<bool>) const;
+} // namespace o2::base
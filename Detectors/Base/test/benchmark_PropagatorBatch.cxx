@@ -0,0 +1,77 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmark_PropagatorBatch.cxx
+/// \brief Tracks/s of the per-track and batched propagation in the constant field
+
+#include "benchmark/benchmark.h"
+#include "DetectorsBase/Propagator.h"
+#include "MathUtils/Utils.h"
+#include <random>
+#include <vector>
+
+using Track = o2::track::TrackParCov;
+using MatCorrType = o2::base::Propagator::MatCorrType;
+
+constexpr float Bz = 5.f;
+
+/// ITS-like tracks at the innermost layers with the pT spectrum falling as 1/pT^2 above 0.15 GeV
+std::vector<Track> generateTracks(size_t n)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> uni(0.f, 1.f);
+  std::array<float, 15> cov = {1e-5, 0., 1e-5, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  std::vector<Track> tracks;
+  for (size_t i = 0; i < n; i++) {
+    float pt = 0.15f / (1.f - 0.97f * uni(gen)), q = uni(gen) > 0.5f ? 1.f : -1.f;
+    std::array<float, 5> par{0.1f * (uni(gen) - 0.5f), 20.f * (uni(gen) - 0.5f), 0.1f * (uni(gen) - 0.5f), 2.f * (uni(gen) - 0.5f), q / pt};
+    tracks.emplace_back(2.3f + 2.f * uni(gen), 2.f * o2::constants::math::PI * uni(gen), par, cov);
+  }
+  return tracks;
+}
+
+static void BM_PropagatorScalar(benchmark::State& state)
+{
+  auto prop = o2::base::Propagator::Instance(true);
+  prop->setNominalBz(Bz);
+  const auto tracks = generateTracks(state.range(0));
+  float xTo = state.range(1);
+  int nOK = 0;
+  for (auto _ : state) {
+    auto work = tracks;
+    for (auto& trc : work) {
+      nOK += prop->propagateToX(trc, xTo, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE);
+    }
+  }
+  benchmark::DoNotOptimize(nOK);
+  state.counters["tracks"] = benchmark::Counter(state.iterations() * tracks.size(), benchmark::Counter::kIsRate);
+}
+
+static void BM_PropagatorBatch(benchmark::State& state)
+{
+  auto prop = o2::base::Propagator::Instance(true);
+  prop->setNominalBz(Bz);
+  const auto tracks = generateTracks(state.range(0));
+  float xTo = state.range(1);
+  int nOK = 0;
+  for (auto _ : state) {
+    auto work = tracks;
+    nOK += prop->propagateToX(work, xTo, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE);
+  }
+  benchmark::DoNotOptimize(nOK);
+  state.counters["tracks"] = benchmark::Counter(state.iterations() * tracks.size(), benchmark::Counter::kIsRate);
+}
+
+// number of tracks, target X
+BENCHMARK(BM_PropagatorScalar)->Args({100000, 20})->Args({100000, 70})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PropagatorBatch)->Args({100000, 20})->Args({100000, 70})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,173 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MatLayerCylSet batched lookup
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "CommonConstants/MathConstants.h"
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TGeoVolume.h>
+#include <TGeoMatrix.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+/// world with a few tubes of different materials and an off-axis box breaking the phi symmetry
+void buildGeometry()
+{
+  auto geom = new TGeoManager("testMatLayerCylSet", "test geometry");
+  auto vac = new TGeoMedium("Vacuum", 1, new TGeoMaterial("Vacuum", 0., 0., 0.));
+  auto si = new TGeoMedium("Si", 2, new TGeoMaterial("Si", 28.09, 14., 2.33));
+  auto al = new TGeoMedium("Al", 3, new TGeoMaterial("Al", 26.98, 13., 2.7));
+  auto c = new TGeoMedium("C", 4, new TGeoMaterial("C", 12.01, 6., 1.8));
+  auto top = geom->MakeBox("World", vac, 100., 100., 100.);
+  geom->SetTopVolume(top);
+  top->AddNode(geom->MakeTube("Tube1", si, 3., 3.5, 30.), 1);
+  top->AddNode(geom->MakeTube("Tube2", al, 10., 10.5, 40.), 1);
+  top->AddNode(geom->MakeTube("Tube3", c, 20., 22., 50.), 1);
+  top->AddNode(geom->MakeBox("Box", al, 1., 2., 10.), 1, new TGeoTranslation(15., 0., 0.));
+  geom->CloseGeometry();
+}
+
+/// LUT of the test geometry, built once
+const o2::base::MatLayerCylSet& getLUT()
+{
+  static std::unique_ptr<o2::base::MatLayerCylSet> lut;
+  if (!lut) {
+    buildGeometry();
+    lut = std::make_unique<o2::base::MatLayerCylSet>();
+    lut->addLayer(2., 5., 30., 2., 0.5);
+    lut->addLayer(8., 17., 40., 2., 1.);
+    lut->addLayer(19., 24., 50., 4., 2.);
+    lut->populateFromTGeo(2);
+    lut->flatten();
+  }
+  return *lut;
+}
+
+/// random rays within the LUT
+void generateRays(int nRays, std::vector<o2::math_utils::Point3D<float>>& p0, std::vector<o2::math_utils::Point3D<float>>& p1)
+{
+  const auto& lut = getLUT();
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> uni(0.f, 1.f);
+  for (int i = 0; i < nRays; i++) {
+    float r0 = uni(gen) * lut.getRMax(), phi0 = uni(gen) * o2::constants::math::TwoPI, z0 = (uni(gen) - 0.5f) * lut.getZMax();
+    float r1 = uni(gen) * lut.getRMax(), phi1 = phi0 + (uni(gen) - 0.5f), z1 = z0 + (uni(gen) - 0.5f) * 20.f;
+    p0.emplace_back(r0 * std::cos(phi0), r0 * std::sin(phi0), z0);
+    p1.emplace_back(r1 * std::cos(phi1), r1 * std::sin(phi1), z1);
+  }
+}
+
+/// the budget of a ray reused from the cache must match the exact one of the slightly different ray
+void checkReused(const o2::base::MatBudget& reused, const o2::base::MatBudget& exact)
+{
+  // moving the end points by less than the tolerance changes the crossed material by at most ~2 x tolerance x sqrt(3),
+  // i.e. X/X0 by < 5e-5 for X0 > 8 cm and the mean density by < 1e-3 g/cm3 for rays longer than 1 cm
+  BOOST_CHECK_SMALL(reused.meanX2X0 - exact.meanX2X0, 1e-3f * exact.meanX2X0 + 5e-5f);
+  BOOST_CHECK_SMALL(reused.meanRho - exact.meanRho, 1e-3f * exact.meanRho + 1e-3f);
+  BOOST_CHECK_SMALL(reused.length - exact.length, 1e-5f * exact.length);
+}
+} // namespace
+
+// the batched lookup must reproduce the single ray one
+BOOST_AUTO_TEST_CASE(MatLayerCylSet_batch)
+{
+  const auto& lut = getLUT();
+  const int nRays = 1000; // not a multiple of the block size or of the SIMD width
+  std::vector<o2::math_utils::Point3D<float>> p0, p1;
+  generateRays(nRays, p0, p1);
+  p1[0] = p0[0]; // too short ray
+
+  std::vector<o2::base::MatBudget> budgets(nRays);
+  lut.getMatBudget(p0, p1, budgets);
+  int nCrossing = 0;
+  for (int i = 0; i < nRays; i++) {
+    auto mb = lut.getMatBudget(p0[i], p1[i]);
+    nCrossing += mb.meanX2X0 > 0.f;
+    BOOST_CHECK_SMALL(mb.meanX2X0 - budgets[i].meanX2X0, 1e-5f * (std::abs(mb.meanX2X0) + 1e-6f));
+    BOOST_CHECK_SMALL(mb.meanRho - budgets[i].meanRho, 1e-5f * (mb.meanRho + 1e-6f));
+    BOOST_CHECK_EQUAL(mb.length, budgets[i].length);
+  }
+  BOOST_CHECK(nCrossing > nRays / 10); // make sure the material is seen
+
+  std::vector<o2::base::MatBudget> wrongSize(nRays - 1);
+  BOOST_CHECK_THROW(lut.getMatBudget(p0, p1, wrongSize), std::runtime_error);
+}
+
+// the budgets of nearly identical rays are reused from the caches, the others are recomputed
+BOOST_AUTO_TEST_CASE(MatLayerCylSet_rayCache)
+{
+  using RayCache = o2::base::MatLayerCylSet::RayCache;
+  const auto& lut = getLUT();
+  const int nRays = 300;
+  const float shift = 0.5f * o2::base::MatLayerCylSet::RayCacheTolerance;
+  std::vector<o2::math_utils::Point3D<float>> p0, p1, p0Near, p1Near, p0Far;
+  generateRays(nRays, p0, p1);
+  int nLong = 0;
+  for (int i = 0; i < nRays; i++) {
+    p0Near.emplace_back(p0[i].X() + shift, p0[i].Y() - shift, p0[i].Z() + shift);
+    p1Near.emplace_back(p1[i].X() - shift, p1[i].Y() + shift, p1[i].Z());
+    p0Far.emplace_back(p0[i].X() + 100.f * shift, p0[i].Y(), p0[i].Z());
+  }
+
+  // single ray
+  for (int i = 0; i < nRays; i++) {
+    if ((p1[i] - p0[i]).Mag2() < 1.f) {
+      continue; // the relative change of the material of very short rays may exceed the checked precision
+    }
+    nLong++;
+    RayCache cache;
+    auto exact = lut.getMatBudget(p0[i], p1[i]);
+    auto mb = lut.getMatBudget(p0[i].X(), p0[i].Y(), p0[i].Z(), p1[i].X(), p1[i].Y(), p1[i].Z(), cache);
+    BOOST_CHECK(cache.valid);
+    BOOST_CHECK_EQUAL(mb.meanX2X0, exact.meanX2X0);
+    BOOST_CHECK_EQUAL(mb.meanRho, exact.meanRho);
+    BOOST_CHECK_EQUAL(mb.length, exact.length);
+
+    mb = lut.getMatBudget(p0Near[i].X(), p0Near[i].Y(), p0Near[i].Z(), p1Near[i].X(), p1Near[i].Y(), p1Near[i].Z(), cache);
+    BOOST_CHECK_EQUAL(cache.p0[0], p0[i].X()); // reused, the cache still holds the 1st ray
+    checkReused(mb, lut.getMatBudget(p0Near[i], p1Near[i]));
+
+    mb = lut.getMatBudget(p0Far[i].X(), p0Far[i].Y(), p0Far[i].Z(), p1[i].X(), p1[i].Y(), p1[i].Z(), cache);
+    BOOST_CHECK_EQUAL(cache.p0[0], p0Far[i].X()); // beyond the tolerance, recomputed and cached
+    exact = lut.getMatBudget(p0Far[i], p1[i]);
+    BOOST_CHECK_EQUAL(mb.meanX2X0, exact.meanX2X0);
+    BOOST_CHECK_EQUAL(mb.length, exact.length);
+  }
+  BOOST_CHECK(nLong > nRays / 2);
+
+  // batched, the caches are filled by the 1st call and reused by the 2nd one
+  std::vector<RayCache> caches(nRays);
+  std::vector<o2::base::MatBudget> budgets(nRays), budgetsNear(nRays), exactNear(nRays);
+  lut.getMatBudget(p0, p1, budgets, caches);
+  for (int i = 0; i < nRays; i++) {
+    BOOST_CHECK(caches[i].valid);
+    BOOST_CHECK_EQUAL(caches[i].budget.meanX2X0, budgets[i].meanX2X0);
+  }
+  lut.getMatBudget(p0Near, p1Near, budgetsNear, caches);
+  lut.getMatBudget(p0Near, p1Near, exactNear);
+  for (int i = 0; i < nRays; i++) {
+    BOOST_CHECK_EQUAL(caches[i].p0[0], p0[i].X());
+    if ((p1[i] - p0[i]).Mag2() >= 1.f) {
+      checkReused(budgetsNear[i], exactNear[i]);
+    }
+  }
+  std::vector<RayCache> wrongSize(nRays - 1);
+  BOOST_CHECK_THROW(lut.getMatBudget(p0, p1, budgets, wrongSize), std::runtime_error);
+}
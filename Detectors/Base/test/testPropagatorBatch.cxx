@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Propagator batch propagation
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsBase/Propagator.h"
+#include "MathUtils/Utils.h"
+#include <random>
+#include <vector>
+#include <cmath>
+#include <memory>
+
+using namespace o2;
+using Track = o2::track::TrackParCov;
+using MatCorrType = o2::base::Propagator::MatCorrType;
+
+constexpr float Bz = 5.f;
+
+std::vector<Track> generateTracks(size_t n)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> uni(0.f, 1.f);
+  std::array<float, 15> cov = {1e-4, 0., 1e-4, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  std::vector<Track> tracks;
+  for (size_t i = 0; i < n; i++) {
+    float pt = 0.1f + 5.f * uni(gen), q = uni(gen) > 0.5f ? 1.f : -1.f;
+    std::array<float, 5> par{10.f * (uni(gen) - 0.5f), 20.f * (uni(gen) - 0.5f), 0.6f * (uni(gen) - 0.5f), 2.f * (uni(gen) - 0.5f), q / pt};
+    tracks.emplace_back(3.f * uni(gen), o2::constants::math::PI * (uni(gen) - 0.5f), par, cov);
+  }
+  return tracks;
+}
+
+// the batch propagation must follow the single track one
+BOOST_AUTO_TEST_CASE(PropagatorBatch_test)
+{
+  auto prop = o2::base::Propagator::Instance(true);
+  prop->setNominalBz(Bz);
+  auto tracks = generateTracks(1001);
+  std::vector<o2::track::TrackPar> tracksPar(tracks.begin(), tracks.end());
+  std::vector<float> xs;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    xs.push_back(20.f + 0.1f * i);
+  }
+  for (bool commonX : {true, false}) {
+    auto trScalar = tracks, trBatch = tracks;
+    auto trParScalar = tracksPar, trParBatch = tracksPar;
+    std::vector<char> okScalar(tracks.size()), okParScalar(tracks.size());
+    int nOKScalar = 0, nOKParScalar = 0;
+    for (size_t i = 0; i < tracks.size(); i++) {
+      float x = commonX ? 60.f : xs[i];
+      nOKScalar += (okScalar[i] = prop->propagateToX(trScalar[i], x, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE));
+      nOKParScalar += (okParScalar[i] = prop->propagateToX(trParScalar[i], x, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE));
+    }
+    std::unique_ptr<bool[]> ok(new bool[tracks.size()]), okPar(new bool[tracks.size()]);
+    int nOK = commonX ? prop->propagateToX(trBatch, 60.f, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE, {}, 0, {ok.get(), tracks.size()})
+                      : prop->propagateToX(trBatch, xs, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE, {}, 0, {ok.get(), tracks.size()});
+    int nOKPar = commonX ? prop->propagateToX(trParBatch, 60.f, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE, {}, 0, {okPar.get(), tracks.size()})
+                         : prop->propagateToX(trParBatch, xs, Bz, 0.85f, 2.f, MatCorrType::USEMatCorrNONE, {}, 0, {okPar.get(), tracks.size()});
+    BOOST_CHECK(nOKScalar > 0 && nOKScalar < int(tracks.size())); // some of the tracks must exceed the maxSnp
+    BOOST_CHECK_EQUAL(nOK, nOKScalar);
+    BOOST_CHECK_EQUAL(nOKPar, nOKParScalar);
+    for (size_t i = 0; i < tracks.size(); i++) {
+      BOOST_CHECK_EQUAL(ok[i], bool(okScalar[i]));
+      BOOST_CHECK_EQUAL(okPar[i], bool(okParScalar[i]));
+      if (!ok[i]) {
+        continue;
+      }
+      BOOST_CHECK_EQUAL(trBatch[i].getX(), trScalar[i].getX());
+      BOOST_CHECK_EQUAL(trParBatch[i].getX(), trParScalar[i].getX());
+      for (int ip = 0; ip < o2::track::kNParams; ip++) {
+        BOOST_CHECK_SMALL(trBatch[i].getParam(ip) - trScalar[i].getParam(ip), 1e-3f * (1.f + std::abs(trScalar[i].getParam(ip))));
+        BOOST_CHECK_SMALL(trParBatch[i].getParam(ip) - trParScalar[i].getParam(ip), 1e-3f * (1.f + std::abs(trParScalar[i].getParam(ip))));
+      }
+      for (int ic = 0; ic < o2::track::kCovMatSize; ic++) {
+        BOOST_CHECK_SMALL(trBatch[i].getCov()[ic] - trScalar[i].getCov()[ic], 1e-3f * (1e-6f + std::abs(trScalar[i].getCov()[ic])));
+      }
+    }
+  }
+}
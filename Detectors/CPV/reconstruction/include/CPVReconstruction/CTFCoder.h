@@ -138,6 +138,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCLUSTER
   std::vector<uint8_t> energy, status;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODECPV(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODECPV(bcInc,       CTF::BLC_bcIncTrig);
@@ -147,6 +148,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCLUSTER
   iosize += DECODECPV(posZ,        CTF::BLC_posZ);
   iosize += DECODECPV(energy,      CTF::BLC_energy);
   iosize += DECODECPV(status,      CTF::BLC_status);
+  blockDecoding.flush();
   // clang-format on
   //
   trigVec.clear();
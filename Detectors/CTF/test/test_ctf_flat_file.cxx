@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFFlatFile
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#undef NDEBUG
+#include <cassert>
+
+#include <boost/test/unit_test.hpp>
+#include "DataFormatsTOF/CTF.h"
+#include "TOFBase/Geo.h"
+#include "TOFBase/Digit.h"
+#include "TOFReconstruction/CTFCoder.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "Framework/Logger.h"
+#include <TRandom.h>
+#include <filesystem>
+
+using namespace o2::tof;
+using DetID = o2::detectors::DetID;
+
+BOOST_AUTO_TEST_CASE(FlatFileTest)
+{
+  constexpr int NTF = 3;
+  const std::string flName = "test_ctf_flat.ctf";
+  std::array<std::vector<Digit>, NTF> digits;
+  std::array<std::vector<ReadoutWindowData>, NTF> rows;
+  std::array<std::vector<uint8_t>, NTF> patterns;
+  std::array<std::vector<o2::ctf::BufferType>, NTF> buffers;
+
+  for (int itf = 0; itf < NTF; itf++) {
+    for (int irof = 0; irof < 10; irof++) {
+      auto& rofr = rows[itf].emplace_back();
+      rofr.SetOrbit(itf * 128 + irof / 3);
+      rofr.SetBC(Geo::BC_IN_ORBIT / Geo::NWINDOW_IN_ORBIT * (irof % 3));
+      int ndig = gRandom->Poisson(20);
+      rofr.setFirstEntry(digits[itf].size());
+      rofr.setNEntries(ndig);
+      rofr.setFirstEntryDia(0);
+      rofr.setNEntriesDia(0);
+      for (int i = 0; i < ndig; i++) {
+        uint64_t bc = Geo::BC_IN_ORBIT * rofr.getBCData().orbit + rofr.getBCData().bc + gRandom->Integer(Geo::BC_IN_ORBIT / Geo::NWINDOW_IN_ORBIT);
+        digits[itf].emplace_back((irof * 100 + i) * Geo::NPADS, gRandom->Integer(1024), gRandom->Integer(2048), bc);
+      }
+    }
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(buffers[itf], rows[itf], digits[itf], patterns[itf]);
+  }
+
+  {
+    o2::ctf::CTFFlatFileWriter writer(flName);
+    for (int itf = 0; itf < NTF; itf++) {
+      o2::ctf::CTFHeader header{123456, 1000ul + itf, uint32_t(itf * 128), uint32_t(itf)};
+      header.detectors.set(DetID::TOF);
+      writer.addDetector(DetID::TOF, buffers[itf].data(), buffers[itf].size());
+      writer.writeEntry(header);
+    }
+  }
+  BOOST_CHECK(o2::ctf::CTFFlatFile::isFlatFile(flName));
+
+  o2::ctf::CTFFlatFileReader reader(flName);
+  BOOST_REQUIRE(reader.getNEntries() == NTF);
+  for (int itf = 0; itf < NTF; itf++) {
+    auto header = reader.getHeader(itf);
+    BOOST_CHECK(header.run == 123456);
+    BOOST_CHECK(header.tfCounter == uint32_t(itf));
+    BOOST_CHECK(header.firstTForbit == uint32_t(itf * 128));
+    BOOST_CHECK(header.detectors[DetID::TOF] && !header.detectors[DetID::ITS]);
+    BOOST_CHECK(reader.getDetectorData(itf, DetID::ITS).empty());
+    auto data = reader.getDetectorData(itf, DetID::TOF);
+    BOOST_REQUIRE(data.size() == buffers[itf].size());
+    BOOST_CHECK(std::equal(data.begin(), data.end(), reinterpret_cast<const char*>(buffers[itf].data())));
+
+    // decoding directly from the mapped memory must give the same result as decoding the original buffer
+    std::vector<Digit> digitsD, digitsRef;
+    std::vector<ReadoutWindowData> rowsD, rowsRef;
+    std::vector<uint8_t> pattVecD, pattVecRef;
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.decode(CTF::getImage(data.data()), rowsD, digitsD, pattVecD);
+    coder.decode(CTF::getImage(buffers[itf].data()), rowsRef, digitsRef, pattVecRef);
+    BOOST_CHECK(rowsD.size() == rows[itf].size());
+    BOOST_CHECK(rowsD.size() == rowsRef.size());
+    BOOST_CHECK(pattVecD == pattVecRef);
+    BOOST_REQUIRE(digitsD.size() == digits[itf].size());
+    BOOST_REQUIRE(digitsD.size() == digitsRef.size());
+    for (size_t i = 0; i < digitsD.size(); i++) {
+      BOOST_CHECK(digitsD[i].getChannel() == digitsRef[i].getChannel());
+      BOOST_CHECK(digitsD[i].getTDC() == digitsRef[i].getTDC());
+      BOOST_CHECK(digitsD[i].getTOT() == digitsRef[i].getTOT());
+      BOOST_CHECK(digitsD[i].getBC() == digitsRef[i].getBC());
+    }
+  }
+  std::filesystem::remove(flName);
+}
@@ -25,10 +25,12 @@
 #include "CommonUtils/NameConf.h"
 #include "TOFReconstruction/CTFCoder.h"
 #include "Framework/Logger.h"
+#include "DetectorsCommonDataFormats/BlockDecodingQueue.h"
 #include <TFile.h>
 #include <TRandom.h>
 #include <TStopwatch.h>
 #include <cstring>
+#include <stdexcept>
 
 using namespace o2::tof;
 namespace boost_data = boost::unit_test::data;
@@ -151,4 +153,63 @@ BOOST_DATA_TEST_CASE(CompressedClustersTest, boost_data::make(ANSVersions), ansV
   for (int i = 0; i < npatt; i += 100) {
     BOOST_CHECK(pattVecD[i] == pattVec[i]);
   }
+
+  // concurrent decoding of the blocks must give identical results
+  std::vector<Digit> digitsDMT;
+  std::vector<ReadoutWindowData> rowsDMT;
+  std::vector<uint8_t> pattVecDMT;
+  sw.Start();
+  {
+    auto& queue = o2::ctf::BlockDecodingQueue::instance();
+    queue.setNThreads(4);
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.decode(ctfImage, rowsDMT, digitsDMT, pattVecDMT); // decompress
+    BOOST_CHECK(queue.getNQueued() == 0);
+    queue.setNThreads(1);
+  }
+  sw.Stop();
+  LOG(info) << "Decompressed with concurrent blocks decoding in " << sw.CpuTime() << " s";
+  BOOST_CHECK(rowsDMT.size() == rowsD.size());
+  BOOST_CHECK(pattVecDMT == pattVecD);
+  BOOST_REQUIRE(digitsDMT.size() == digitsD.size());
+  for (size_t i = 0; i < digitsD.size(); i++) {
+    BOOST_CHECK(digitsDMT[i].getChannel() == digitsD[i].getChannel());
+    BOOST_CHECK(digitsDMT[i].getTDC() == digitsD[i].getTDC());
+    BOOST_CHECK(digitsDMT[i].getTOT() == digitsD[i].getTOT());
+    BOOST_CHECK(digitsDMT[i].getBC() == digitsD[i].getBC());
+  }
+
+  // decoding abandoned after some blocks were queued must not leave the tasks for the next decoding
+  {
+    auto& queue = o2::ctf::BlockDecodingQueue::instance();
+    queue.setNThreads(4);
+    bool thrown = false;
+    try {
+      CompressedInfos cc; // destination buffers released on unwind
+      o2::ctf::CTFCoderBase::BlockDecodingScope blockDecoding;
+      ctfImage.decode(cc.bcIncROF, CTF::BLCbcIncROF);
+      ctfImage.decode(cc.orbitIncROF, CTF::BLCorbitIncROF);
+      BOOST_CHECK(queue.getNQueued() == 2);
+      throw std::runtime_error("abandoned decoding");
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    BOOST_CHECK(thrown);
+    BOOST_CHECK(queue.getNQueued() == 0);
+    std::vector<Digit> digitsDAb;
+    std::vector<ReadoutWindowData> rowsDAb;
+    std::vector<uint8_t> pattVecDAb;
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.decode(ctfImage, rowsDAb, digitsDAb, pattVecDAb);
+    BOOST_CHECK(queue.getNQueued() == 0);
+    queue.setNThreads(1);
+    BOOST_CHECK(rowsDAb.size() == rowsD.size());
+    BOOST_CHECK(pattVecDAb == pattVecD);
+    BOOST_REQUIRE(digitsDAb.size() == digitsD.size());
+    for (size_t i = 0; i < digitsD.size(); i++) {
+      BOOST_CHECK(digitsDAb[i].getChannel() == digitsD[i].getChannel());
+      BOOST_CHECK(digitsDAb[i].getTDC() == digitsD[i].getTDC());
+      BOOST_CHECK(digitsDAb[i].getBC() == digitsD[i].getBC());
+    }
+  }
 }
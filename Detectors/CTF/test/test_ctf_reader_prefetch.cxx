@@ -0,0 +1,151 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file test_ctf_reader_prefetch.cxx
+/// \brief Workflow reading the same multi-TF CTF file with and without prefetching and checking that the same messages are sent
+
+#include "Framework/ConfigParamSpec.h"
+#include "Framework/ControlService.h"
+#include "Framework/CallbackService.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/DataRefUtils.h"
+#include "Framework/Logger.h"
+#include "CTFWorkflow/CTFReaderSpec.h"
+#include "CommonUtils/NameConf.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DataFormatsTOF/CTF.h"
+#include "TOFBase/Geo.h"
+#include "TOFBase/Digit.h"
+#include "TOFReconstruction/CTFCoder.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <TRandom3.h>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace o2::framework;
+using DetID = o2::detectors::DetID;
+
+#include "Framework/runDataProcessing.h"
+
+namespace
+{
+constexpr int NTF = 10;
+const std::string CTFFileName = "test_ctf_reader_prefetch.root";
+
+/// write NTF TOF CTFs with deterministic content to the tree of a CTF file, unless it exists already
+void makeCTFFile()
+{
+  if (std::filesystem::exists(CTFFileName)) {
+    return;
+  }
+  // every process of the workflow defines it, write to a temporary file to not expose a partial one
+  const std::string tmpName = CTFFileName + "." + std::to_string(getpid());
+  TRandom3 rnd(12345);
+  TFile file(tmpName.c_str(), "RECREATE");
+  TTree tree(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+  for (int itf = 0; itf < NTF; itf++) {
+    std::vector<o2::tof::Digit> digits;
+    std::vector<o2::tof::ReadoutWindowData> rows;
+    std::vector<uint8_t> patterns;
+    std::vector<o2::ctf::BufferType> buffer;
+    for (int irof = 0; irof < 10; irof++) {
+      auto& rofr = rows.emplace_back();
+      rofr.SetOrbit(itf * 128 + irof / 3);
+      rofr.SetBC(o2::tof::Geo::BC_IN_ORBIT / o2::tof::Geo::NWINDOW_IN_ORBIT * (irof % 3));
+      int ndig = rnd.Poisson(20);
+      rofr.setFirstEntry(digits.size());
+      rofr.setNEntries(ndig);
+      rofr.setFirstEntryDia(0);
+      rofr.setNEntriesDia(0);
+      for (int i = 0; i < ndig; i++) {
+        uint64_t bc = o2::tof::Geo::BC_IN_ORBIT * rofr.getBCData().orbit + rofr.getBCData().bc + rnd.Integer(o2::tof::Geo::BC_IN_ORBIT / o2::tof::Geo::NWINDOW_IN_ORBIT);
+        digits.emplace_back((irof * 100 + i) * o2::tof::Geo::NPADS, rnd.Integer(1024), rnd.Integer(2048), bc);
+      }
+    }
+    o2::tof::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(buffer, rows, digits, patterns);
+    o2::tof::CTF::get(buffer.data())->appendToTree(tree, DetID::getName(DetID::TOF));
+
+    o2::ctf::CTFHeader header{123456, 1000ul + itf, uint32_t(itf * 128), uint32_t(itf)};
+    header.detectors.set(DetID::TOF);
+    auto* headerPtr = &header;
+    auto* br = tree.GetBranch("CTFHeader");
+    if (br) {
+      br->SetAddress(&headerPtr);
+    } else {
+      br = tree.Branch("CTFHeader", &headerPtr);
+    }
+    br->Fill();
+    br->ResetAddress();
+    tree.SetEntries(itf + 1);
+  }
+  tree.Write();
+  file.Close();
+  std::filesystem::rename(tmpName, CTFFileName);
+}
+
+DataProcessorSpec makeReader(unsigned int subspec, int prefetchTFs, const char* name)
+{
+  o2::ctf::CTFReaderInp inp;
+  inp.inpdata = CTFFileName;
+  inp.detMask = DetID::getMask(DetID::TOF);
+  inp.sup0xccdb = true;
+  inp.tfRateLimit = 0;
+  inp.prefetchTFs = prefetchTFs;
+  inp.subspec = subspec;
+  auto spec = o2::ctf::getCTFReaderSpec(inp);
+  spec.name = name;
+  return spec;
+}
+
+/// the payloads of the inputs from the synchronous and prefetching readers must be identical
+void checkSame(InputRecord& inputs, const char* lbl0, const char* lbl1, int tf)
+{
+  auto ref0 = inputs.get(lbl0);
+  auto ref1 = inputs.get(lbl1);
+  auto size0 = DataRefUtils::getPayloadSize(ref0);
+  auto size1 = DataRefUtils::getPayloadSize(ref1);
+  if (size0 != size1 || std::memcmp(ref0.payload, ref1.payload, size0) != 0) {
+    LOGP(fatal, "TF {}: {} ({} bytes) differs from {} ({} bytes)", tf, lbl0, size0, lbl1, size1);
+  }
+}
+} // namespace
+
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  makeCTFFile();
+
+  DataProcessorSpec checker{
+    .name = "prefetch-checker",
+    .inputs = {
+      InputSpec{"header0", "CTF", "HEADER", 0, Lifetime::Timeframe},
+      InputSpec{"tof0", "TOF", "CTFDATA", 0, Lifetime::Timeframe},
+      InputSpec{"header1", "CTF", "HEADER", 1, Lifetime::Timeframe},
+      InputSpec{"tof1", "TOF", "CTFDATA", 1, Lifetime::Timeframe}},
+    .algorithm = adaptStateful([](CallbackService& callbacks) {
+      static int count = 0;
+      callbacks.set<CallbackService::Id::EndOfStream>([](EndOfStreamContext& ctx) {
+        if (count != NTF) {
+          LOGP(fatal, "Wrong number of CTFs seen: {} != {}", count, NTF);
+        }
+        ctx.services().get<ControlService>().readyToQuit(QuitRequest::All);
+      });
+      return adaptStateless([](InputRecord& inputs) {
+        checkSame(inputs, "header0", "header1", count);
+        checkSame(inputs, "tof0", "tof1", count);
+        count++;
+      });
+    })};
+
+  return WorkflowSpec{makeReader(0, 0, "ctf-reader-sync"), makeReader(1, 3, "ctf-reader-prefetch"), checker};
+}
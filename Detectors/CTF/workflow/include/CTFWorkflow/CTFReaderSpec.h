@@ -39,6 +39,7 @@ struct CTFReaderInp {
   bool checkTFLimitBeforeReading = false;
   bool sup0xccdb = false;
   int maxFileCache = 1;
+  int prefetchTFs = 0; // number of TFs to read ahead in a separate thread, 0: read synchronously
   int64_t delay_us = 0;
   int maxLoops = 0;
   int maxTFs = -1;
@@ -12,8 +12,16 @@
 /// @file   CTFReaderSpec.cxx
 
 #include <vector>
+#include <array>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 
 #include "Framework/Logger.h"
 #include "Framework/ControlService.h"
@@ -29,6 +37,7 @@
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "Headers/STFHeader.h"
 #include "DataFormatsITSMFT/CTF.h"
 #include "DataFormatsTPC/CTF.h"
@@ -51,6 +60,7 @@
 #include "Algorithm/RangeTokenizer.h"
 #include <TStopwatch.h>
 #include <fairmq/Device.h>
+#include <Monitoring/Monitoring.h>
 
 using namespace o2::framework;
 
@@ -75,6 +85,17 @@ bool readFromTree(TTree& tree, const std::string brname, T& dest, int ev = 0)
 
 using DetID = o2::detectors::DetID;
 
+/// CTF entry read ahead by the prefetching thread
+struct PrefetchedTF {
+  CTFHeader header;
+  std::array<std::vector<o2::ctf::BufferType>, DetID::nDetectors> buffers{}; // detectors buffers read from the tree
+  std::shared_ptr<CTFFlatFileReader> flat;                                    // or the mapped flat file containing the entry
+  std::string fileName{};
+  long entry = 0;
+  long nEntries = 0;
+  int ctfID = 0;
+};
+
 class CTFReaderSpec : public o2::framework::Task
 {
  public:
@@ -87,11 +108,23 @@ class CTFReaderSpec : public o2::framework::Task
   void runTimeRangesToIRFrameSelector(const o2::framework::TimingInfo& timingInfo);
   void loadRunTimeSpans(const std::string& flname);
   void openCTFFile(const std::string& flname);
-  bool processTF(ProcessingContext& pc);
+  bool processTF(ProcessingContext& pc, PrefetchedTF* tf = nullptr);
   void checkTreeEntries();
+  bool hasOpenInput() const { return mCTFTree || mCTFFlat; }
+  long getNEntries() const { return mCTFFlat ? long(mCTFFlat->getNEntries()) : mCTFTree->GetEntries(); }
+  const char* getInputName() const { return mCTFFlat ? mCTFFlat->getFileName().c_str() : mCTFFile->GetName(); }
   void stopReader();
+  void startFileFetcher();
+  void prefetchTFs();
+  void stopPrefetching();
+  bool pushPrefetched(std::unique_ptr<PrefetchedTF> tf);
+  std::unique_ptr<PrefetchedTF> popPrefetched(ProcessingContext& pc);
+  bool isPrefetchingDone();
+  std::unique_ptr<PrefetchedTF> readTF(int ctfID);
+  template <typename C>
+  void readDetector(DetID det, PrefetchedTF& tf) const;
   template <typename C>
-  void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const;
+  void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc, PrefetchedTF* tf) const;
   void setMessageHeader(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& lbl, unsigned subspec) const; // keep just for the reference
   void tryToFixCTFHeader(CTFHeader& ctfHeader) const;
   CTFReaderInp mInput{};
@@ -100,6 +133,7 @@ class CTFReaderSpec : public o2::framework::Task
   std::unique_ptr<o2::utils::FileFetcher> mFileFetcher;
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  std::shared_ptr<CTFFlatFileReader> mCTFFlat; // mapped flat CTF file, shared with the messages sent from it
   bool mRunning = false;
   bool mUseLocalTFCounter = false;
   int mConvRunTimeRangesToOrbits = -1; // not defined yet
@@ -108,14 +142,29 @@ class CTFReaderSpec : public o2::framework::Task
   int mNFailedFiles = 0;
   int mFilesRead = 0;
   int mTFLength = 128;
-  int mNWaits = 0;
+  std::atomic<int> mNWaits{0};
   int mRunNumberPrev = -1;
-  long mTotalWaitTime = 0;
+  std::atomic<long> mTotalWaitTime{0}; // time spent waiting for the input files, in microseconds
   long mLastSendTime = 0L;
   long mCurrTreeEntry = 0L;
   long mImposeRunStartMS = 0L;
   size_t mSelIDEntry = 0; // next CTFID to select from the mInput.ctfIDs (if non-empty)
+  size_t mNLoops = 0;     // loops done by the file fetcher of the prefetching thread
+  float mFetchFailThreshold = 0.f;
   TStopwatch mTimer;
+  // read-ahead of TFs: when enabled, the file fetcher, files and trees above are created, used and released
+  // by the prefetching thread only, run() just pops the TFs from the queue
+  std::thread mPrefetchThread;
+  std::mutex mPrefetchMutex;
+  std::condition_variable mPrefetchCV;
+  std::deque<std::unique_ptr<PrefetchedTF>> mPrefetchQueue;
+  std::exception_ptr mPrefetchError;
+  std::atomic<bool> mPrefetchStop{false};
+  bool mPrefetchDone = false;
+  int mNPrefetched = 0;
+  int mNStalls = 0;
+  long mTotalStallTime = 0; // time spent by run() waiting for the prefetched TFs, in microseconds
+  TStopwatch mPrefetchTimer;
 };
 
 ///_______________________________________
@@ -123,6 +172,8 @@ CTFReaderSpec::CTFReaderSpec(const CTFReaderInp& inp) : mInput(inp)
 {
   mTimer.Stop();
   mTimer.Reset();
+  mPrefetchTimer.Stop();
+  mPrefetchTimer.Reset();
 }
 
 ///_______________________________________
@@ -134,20 +185,24 @@ CTFReaderSpec::~CTFReaderSpec()
 ///_______________________________________
 void CTFReaderSpec::stopReader()
 {
-  if (!mFileFetcher) {
+  if (!mPrefetchThread.joinable() && !mFileFetcher) {
     return;
   }
+  stopPrefetching(); // once joined, the prefetching thread has released its file fetcher
   LOGP(info, "CTFReader stops processing, {} files read, {} files failed", mFilesRead - mNFailedFiles, mNFailedFiles);
   LOGP(info, "CTF reading total timing: Cpu: {:.3f} Real: {:.3f} s for {} TFs ({} accepted) in {} loops, spent {:.2} s in {} data waiting states",
-       mTimer.CpuTime(), mTimer.RealTime(), mCTFCounter, mCTFCounterAcc, mFileFetcher->getNLoops(), 1e-6 * mTotalWaitTime, mNWaits);
+       mTimer.CpuTime(), mTimer.RealTime(), mCTFCounter, mCTFCounterAcc, mFileFetcher ? mFileFetcher->getNLoops() : mNLoops, 1e-6 * mTotalWaitTime.load(), mNWaits.load());
   mRunning = false;
-  mFileFetcher->stop();
-  mFileFetcher.reset();
+  if (mFileFetcher) {
+    mFileFetcher->stop();
+    mFileFetcher.reset();
+  }
   mCTFTree.reset();
   if (mCTFFile) {
     mCTFFile->Close();
   }
   mCTFFile.reset();
+  mCTFFlat.reset();
 }
 
 ///_______________________________________
@@ -161,12 +216,15 @@ void CTFReaderSpec::init(InitContext& ic)
   mInput.maxTFs = mInput.maxTFs > 0 ? mInput.maxTFs : 0x7fffffff;
   mInput.maxTFsPerFile = ic.options().get<int>("max-tf-per-file");
   mInput.maxTFsPerFile = mInput.maxTFsPerFile > 0 ? mInput.maxTFsPerFile : 0x7fffffff;
+  mFetchFailThreshold = ic.options().get<float>("fetch-failure-threshold");
   mRunning = true;
-  mFileFetcher = std::make_unique<o2::utils::FileFetcher>(mInput.inpdata, mInput.tffileRegex, mInput.remoteRegex, mInput.copyCmd);
-  mFileFetcher->setMaxFilesInQueue(mInput.maxFileCache);
-  mFileFetcher->setMaxLoops(mInput.maxLoops);
-  mFileFetcher->setFailThreshold(ic.options().get<float>("fetch-failure-threshold"));
-  mFileFetcher->start();
+  if (mInput.prefetchTFs > 0) {
+    ROOT::EnableThreadSafety();
+    LOGP(info, "Up to {} TFs will be read ahead by the prefetching thread", mInput.prefetchTFs);
+    mPrefetchThread = std::thread(&CTFReaderSpec::prefetchTFs, this);
+  } else {
+    startFileFetcher();
+  }
   if (!mInput.fileIRFrames.empty()) {
     mIRFrameSelector.loadIRFrames(mInput.fileIRFrames);
     const auto& hbfu = o2::raw::HBFUtils::Instance();
@@ -178,6 +236,16 @@ void CTFReaderSpec::init(InitContext& ic)
   }
 }
 
+///_______________________________________
+void CTFReaderSpec::startFileFetcher()
+{
+  mFileFetcher = std::make_unique<o2::utils::FileFetcher>(mInput.inpdata, mInput.tffileRegex, mInput.remoteRegex, mInput.copyCmd);
+  mFileFetcher->setMaxFilesInQueue(mInput.maxFileCache);
+  mFileFetcher->setMaxLoops(mInput.maxLoops);
+  mFileFetcher->setFailThreshold(mFetchFailThreshold);
+  mFileFetcher->start();
+}
+
 void CTFReaderSpec::runTimeRangesToIRFrameSelector(const o2::framework::TimingInfo& timingInfo)
 {
   // convert entries in the runTimeRanges to IRFrameSelector, if needed, convert time to orbit
@@ -285,6 +353,14 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
   try {
     mFilesRead++;
+    if (CTFFlatFile::isFlatFile(flname)) { // local flat file, will be memory-mapped
+      mCTFFlat = std::make_shared<CTFFlatFileReader>(flname);
+      if (mCTFFlat->getNEntries() < 1) {
+        throw std::runtime_error(fmt::format("flat CTF file {} has 0 entries, skipping", flname));
+      }
+      mCurrTreeEntry = 0;
+      return;
+    }
     mCTFFile.reset(TFile::Open(flname.c_str()));
     if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
       throw std::runtime_error(fmt::format("failed to open CTF file {}, skipping", flname));
@@ -300,6 +376,7 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
     LOG(error) << "Cannot process " << flname << ", reason: " << e.what();
     mCTFTree.reset();
     mCTFFile.reset();
+    mCTFFlat.reset();
     mNFailedFiles++;
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
@@ -318,8 +395,23 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   bool waitAcknowledged = false;
   long startWait = 0;
 
-  while (mRunning) {
-    if (mCTFTree) { // there is a tree open with multiple CTF
+  while (mRunning && mInput.prefetchTFs > 0) { // TFs are read by the prefetching thread, just dispatch them
+    auto tf = popPrefetched(pc);
+    if (!tf) {
+      mRunning = false;
+      break;
+    }
+    mCTFCounter = tf->ctfID;
+    mSelIDEntry++;
+    if (processTF(pc, tf.get())) {
+      break;
+    }
+    LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, tf->entry, tf->nEntries, tf->fileName);
+    mCTFCounter++;
+  }
+
+  while (mRunning && mInput.prefetchTFs < 1) {
+    if (hasOpenInput()) { // there is a tree or flat file open with multiple CTF
       if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mCTFCounter) { // no selection requested or matching CTF ID is found
         LOG(debug) << "TF " << mCTFCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
         mSelIDEntry++;
@@ -328,7 +420,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
         }
       }
       // explict CTF ID selection list or IRFrame was provided and current entry is not selected
-      LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+      LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, getNEntries(), getInputName());
       checkTreeEntries();
       mCTFCounter++;
       continue;
@@ -351,7 +443,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
       long waitTime = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count() - startWait;
       mTotalWaitTime += waitTime;
       if (++mNWaits > 1) {
-        LOGP(warn, "Resuming reading after waiting for data {:.2} s (accumulated {:.2} s delay in {} waits)", 1e-6 * waitTime, 1e-6 * mTotalWaitTime, mNWaits);
+        LOGP(warn, "Resuming reading after waiting for data {:.2} s (accumulated {:.2} s delay in {} waits)", 1e-6 * waitTime, 1e-6 * mTotalWaitTime.load(), mNWaits.load());
       }
       waitAcknowledged = false;
     }
@@ -362,7 +454,9 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   if (mCTFCounter >= mInput.maxTFs || (!mInput.ctfIDs.empty() && mSelIDEntry >= mInput.ctfIDs.size())) { // done
     LOGP(info, "All CTFs from selected range were injected, stopping");
     mRunning = false;
-  } else if (mRunning && !mCTFTree && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
+  } else if (mRunning && mInput.prefetchTFs > 0) {
+    mRunning = !isPrefetchingDone();
+  } else if (mRunning && !hasOpenInput() && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
     mRunning = false;
   }
 
@@ -385,14 +479,21 @@ void CTFReaderSpec::run(ProcessingContext& pc)
 }
 
 ///_______________________________________
-bool CTFReaderSpec::processTF(ProcessingContext& pc)
+bool CTFReaderSpec::processTF(ProcessingContext& pc, PrefetchedTF* tf)
 {
   auto cput = mTimer.CpuTime();
   mTimer.Start(false);
 
   static RateLimiter limiter;
   CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
+  if (tf) {
+    ctfHeader = tf->header;
+  } else if (mCTFFlat) {
+    ctfHeader = mCTFFlat->getHeader(mCurrTreeEntry);
+    if (mCurrTreeEntry + 1 < getNEntries()) {
+      mCTFFlat->prefetch(mCurrTreeEntry + 1);
+    }
+  } else if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
     throw std::runtime_error("did not find CTFHeader");
   }
   if (mImposeRunStartMS > 0) {
@@ -445,34 +546,39 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
   // send CTF Header
   pc.outputs().snapshot({"header", mInput.subspec}, ctfHeader);
 
-  processDetector<o2::itsmft::CTF>(DetID::ITS, ctfHeader, pc);
-  processDetector<o2::itsmft::CTF>(DetID::MFT, ctfHeader, pc);
-  processDetector<o2::emcal::CTF>(DetID::EMC, ctfHeader, pc);
-  processDetector<o2::hmpid::CTF>(DetID::HMP, ctfHeader, pc);
-  processDetector<o2::phos::CTF>(DetID::PHS, ctfHeader, pc);
-  processDetector<o2::tpc::CTF>(DetID::TPC, ctfHeader, pc);
-  processDetector<o2::trd::CTF>(DetID::TRD, ctfHeader, pc);
-  processDetector<o2::ft0::CTF>(DetID::FT0, ctfHeader, pc);
-  processDetector<o2::fv0::CTF>(DetID::FV0, ctfHeader, pc);
-  processDetector<o2::fdd::CTF>(DetID::FDD, ctfHeader, pc);
-  processDetector<o2::tof::CTF>(DetID::TOF, ctfHeader, pc);
-  processDetector<o2::mid::CTF>(DetID::MID, ctfHeader, pc);
-  processDetector<o2::mch::CTF>(DetID::MCH, ctfHeader, pc);
-  processDetector<o2::cpv::CTF>(DetID::CPV, ctfHeader, pc);
-  processDetector<o2::zdc::CTF>(DetID::ZDC, ctfHeader, pc);
-  processDetector<o2::ctp::CTF>(DetID::CTP, ctfHeader, pc);
+  processDetector<o2::itsmft::CTF>(DetID::ITS, ctfHeader, pc, tf);
+  processDetector<o2::itsmft::CTF>(DetID::MFT, ctfHeader, pc, tf);
+  processDetector<o2::emcal::CTF>(DetID::EMC, ctfHeader, pc, tf);
+  processDetector<o2::hmpid::CTF>(DetID::HMP, ctfHeader, pc, tf);
+  processDetector<o2::phos::CTF>(DetID::PHS, ctfHeader, pc, tf);
+  processDetector<o2::tpc::CTF>(DetID::TPC, ctfHeader, pc, tf);
+  processDetector<o2::trd::CTF>(DetID::TRD, ctfHeader, pc, tf);
+  processDetector<o2::ft0::CTF>(DetID::FT0, ctfHeader, pc, tf);
+  processDetector<o2::fv0::CTF>(DetID::FV0, ctfHeader, pc, tf);
+  processDetector<o2::fdd::CTF>(DetID::FDD, ctfHeader, pc, tf);
+  processDetector<o2::tof::CTF>(DetID::TOF, ctfHeader, pc, tf);
+  processDetector<o2::mid::CTF>(DetID::MID, ctfHeader, pc, tf);
+  processDetector<o2::mch::CTF>(DetID::MCH, ctfHeader, pc, tf);
+  processDetector<o2::cpv::CTF>(DetID::CPV, ctfHeader, pc, tf);
+  processDetector<o2::zdc::CTF>(DetID::ZDC, ctfHeader, pc, tf);
+  processDetector<o2::ctp::CTF>(DetID::CTP, ctfHeader, pc, tf);
   mCTFCounterAcc++;
 
   // send sTF acknowledge message
   if (!mInput.sup0xccdb) {
     auto& stfDist = pc.outputs().make<o2::header::STFHeader>(OutputRef{"TFDist", 0xccdb});
-    stfDist.id = uint64_t(mCurrTreeEntry);
+    stfDist.id = uint64_t(tf ? tf->entry : mCurrTreeEntry);
     stfDist.firstOrbit = ctfHeader.firstTForbit;
     stfDist.runNumber = uint32_t(ctfHeader.run);
   }
 
-  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
-  checkTreeEntries();
+  std::string entryStr;
+  if (tf) {
+    entryStr = fmt::format("({} of {} in {})", tf->entry, tf->nEntries, tf->fileName);
+  } else {
+    entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, getNEntries(), getInputName());
+    checkTreeEntries();
+  }
   mTimer.Stop();
 
   // do we need to wait to respect the delay ?
@@ -497,10 +603,13 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
 void CTFReaderSpec::checkTreeEntries()
 {
   // check if the tree has entries left, if needed, close current tree/file
-  if (++mCurrTreeEntry >= mCTFTree->GetEntries() || (mInput.maxTFsPerFile > 0 && mCurrTreeEntry >= mInput.maxTFsPerFile)) { // this file is done, check if there are other files
+  if (++mCurrTreeEntry >= getNEntries() || (mInput.maxTFsPerFile > 0 && mCurrTreeEntry >= mInput.maxTFsPerFile)) { // this file is done, check if there are other files
     mCTFTree.reset();
-    mCTFFile->Close();
+    if (mCTFFile) {
+      mCTFFile->Close();
+    }
     mCTFFile.reset();
+    mCTFFlat.reset(); // the mapping is kept alive by the messages still in flight
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
     }
@@ -524,10 +633,25 @@ void CTFReaderSpec::setMessageHeader(ProcessingContext& pc, const CTFHeader& ctf
 
 ///_______________________________________
 template <typename C>
-void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const
+void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc, PrefetchedTF* tf) const
 {
   if (mInput.detMask[det]) {
     const auto lbl = det.getName();
+    const auto& flat = tf ? tf->flat : mCTFFlat;
+    if (flat && ctfHeader.detectors[det]) { // send the mapped buffer w/o copying, the message keeps the file mapped
+      auto data = flat->getDetectorData(tf ? tf->entry : mCurrTreeEntry, det);
+      auto releaseFlat = [](void*, void* hint) { delete static_cast<std::shared_ptr<CTFFlatFileReader>*>(hint); };
+      pc.outputs().adoptChunk(Output{det.getDataOrigin(), "CTFDATA", mInput.subspec}, const_cast<char*>(data.data()), data.size(),
+                              releaseFlat, new std::shared_ptr<CTFFlatFileReader>(flat));
+      return;
+    }
+    if (tf && ctfHeader.detectors[det]) { // send the buffer read by the prefetching thread w/o copying
+      auto* buf = new std::vector<o2::ctf::BufferType>(std::move(tf->buffers[det]));
+      auto releaseBuffer = [](void*, void* hint) { delete static_cast<std::vector<o2::ctf::BufferType>*>(hint); };
+      pc.outputs().adoptChunk(Output{det.getDataOrigin(), "CTFDATA", mInput.subspec}, reinterpret_cast<char*>(buf->data()), buf->size() * sizeof(o2::ctf::BufferType),
+                              releaseBuffer, buf);
+      return;
+    }
     auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({lbl, mInput.subspec}, ctfHeader.detectors[det] ? sizeof(C) : 0);
     if (ctfHeader.detectors[det]) {
       C::readFromTree(bufVec, *(mCTFTree.get()), lbl, mCurrTreeEntry);
@@ -538,6 +662,194 @@ void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, Proce
   }
 }
 
+///_______________________________________
+void CTFReaderSpec::prefetchTFs()
+{
+  // loop over input files and their entries, reading the selected TFs into the bounded queue
+  int ctfCounter = 0;
+  size_t selIDEntry = 0;
+  bool waitAcknowledged = false;
+  long startWait = 0;
+  try {
+    startFileFetcher();
+    while (!mPrefetchStop && ctfCounter < mInput.maxTFs && (mInput.ctfIDs.empty() || selIDEntry < mInput.ctfIDs.size())) {
+      if (hasOpenInput()) {
+        if (mInput.ctfIDs.empty() || mInput.ctfIDs[selIDEntry] == ctfCounter) {
+          selIDEntry++;
+          mPrefetchTimer.Start(false);
+          auto tf = readTF(ctfCounter);
+          mPrefetchTimer.Stop();
+          if (!pushPrefetched(std::move(tf))) {
+            break;
+          }
+        }
+        checkTreeEntries();
+        ctfCounter++;
+        continue;
+      }
+      auto tfFileName = mFileFetcher->getNextFileInQueue();
+      if (tfFileName.empty()) {
+        if (!mFileFetcher->isRunning()) { // nothing expected in the queue
+          break;
+        }
+        if (!waitAcknowledged) {
+          startWait = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
+          waitAcknowledged = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        continue;
+      }
+      if (waitAcknowledged) {
+        long waitTime = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count() - startWait;
+        mTotalWaitTime += waitTime;
+        if (++mNWaits > 1) {
+          LOGP(warn, "Resuming prefetching after waiting for data {:.2} s (accumulated {:.2} s delay in {} waits)", 1e-6 * waitTime, 1e-6 * mTotalWaitTime.load(), mNWaits.load());
+        }
+        waitAcknowledged = false;
+      }
+      LOG(info) << "Prefetching CTF input " << ' ' << tfFileName;
+      openCTFFile(tfFileName);
+    }
+  } catch (...) { // will be rethrown by the run() once the already prefetched TFs are dispatched
+    mPrefetchTimer.Stop();
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    mPrefetchError = std::current_exception();
+  }
+  if (mFileFetcher) { // release the input in the thread which used it
+    mNLoops = mFileFetcher->getNLoops();
+    mFileFetcher->stop();
+    mFileFetcher.reset();
+  }
+  mCTFTree.reset();
+  if (mCTFFile) {
+    mCTFFile->Close();
+  }
+  mCTFFile.reset();
+  mCTFFlat.reset(); // the mapping is kept alive by the prefetched TFs and the messages still in flight
+  {
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    mPrefetchDone = true;
+  }
+  mPrefetchCV.notify_all();
+}
+
+///_______________________________________
+std::unique_ptr<PrefetchedTF> CTFReaderSpec::readTF(int ctfID)
+{
+  auto tf = std::make_unique<PrefetchedTF>();
+  tf->ctfID = ctfID;
+  tf->entry = mCurrTreeEntry;
+  tf->nEntries = getNEntries();
+  tf->fileName = getInputName();
+  if (mCTFFlat) { // nothing to read, ask the kernel to load the mapped entry
+    tf->header = mCTFFlat->getHeader(mCurrTreeEntry);
+    tf->flat = mCTFFlat;
+    mCTFFlat->prefetch(mCurrTreeEntry);
+    return tf;
+  }
+  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", tf->header, mCurrTreeEntry)) {
+    throw std::runtime_error("did not find CTFHeader");
+  }
+  readDetector<o2::itsmft::CTF>(DetID::ITS, *tf);
+  readDetector<o2::itsmft::CTF>(DetID::MFT, *tf);
+  readDetector<o2::emcal::CTF>(DetID::EMC, *tf);
+  readDetector<o2::hmpid::CTF>(DetID::HMP, *tf);
+  readDetector<o2::phos::CTF>(DetID::PHS, *tf);
+  readDetector<o2::tpc::CTF>(DetID::TPC, *tf);
+  readDetector<o2::trd::CTF>(DetID::TRD, *tf);
+  readDetector<o2::ft0::CTF>(DetID::FT0, *tf);
+  readDetector<o2::fv0::CTF>(DetID::FV0, *tf);
+  readDetector<o2::fdd::CTF>(DetID::FDD, *tf);
+  readDetector<o2::tof::CTF>(DetID::TOF, *tf);
+  readDetector<o2::mid::CTF>(DetID::MID, *tf);
+  readDetector<o2::mch::CTF>(DetID::MCH, *tf);
+  readDetector<o2::cpv::CTF>(DetID::CPV, *tf);
+  readDetector<o2::zdc::CTF>(DetID::ZDC, *tf);
+  readDetector<o2::ctp::CTF>(DetID::CTP, *tf);
+  return tf;
+}
+
+///_______________________________________
+template <typename C>
+void CTFReaderSpec::readDetector(DetID det, PrefetchedTF& tf) const
+{
+  if (mInput.detMask[det] && tf.header.detectors[det]) {
+    C::readFromTree(tf.buffers[det], *(mCTFTree.get()), det.getName(), tf.entry);
+  }
+}
+
+///_______________________________________
+bool CTFReaderSpec::pushPrefetched(std::unique_ptr<PrefetchedTF> tf)
+{
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  mPrefetchCV.wait(lock, [this]() { return mPrefetchStop || int(mPrefetchQueue.size()) < mInput.prefetchTFs; });
+  if (mPrefetchStop) {
+    return false;
+  }
+  mPrefetchQueue.push_back(std::move(tf));
+  mNPrefetched++;
+  lock.unlock();
+  mPrefetchCV.notify_all();
+  return true;
+}
+
+///_______________________________________
+std::unique_ptr<PrefetchedTF> CTFReaderSpec::popPrefetched(ProcessingContext& pc)
+{
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  long stallTime = 0;
+  if (mPrefetchQueue.empty() && !mPrefetchDone) {
+    auto start = std::chrono::steady_clock::now();
+    mPrefetchCV.wait(lock, [this]() { return !mPrefetchQueue.empty() || mPrefetchDone; });
+    stallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    mTotalStallTime += stallTime;
+    mNStalls++;
+  }
+  if (mPrefetchQueue.empty()) {
+    if (mPrefetchError) {
+      std::rethrow_exception(mPrefetchError);
+    }
+    return nullptr;
+  }
+  auto tf = std::move(mPrefetchQueue.front());
+  mPrefetchQueue.pop_front();
+  size_t depth = mPrefetchQueue.size();
+  lock.unlock();
+  mPrefetchCV.notify_all();
+
+  auto& monitoring = pc.services().get<o2::monitoring::Monitoring>();
+  monitoring.send(o2::monitoring::Metric{(uint64_t)depth, "ctf-reader-prefetch-queue-depth"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+  monitoring.send(o2::monitoring::Metric{1e-3 * stallTime, "ctf-reader-prefetch-stall-ms"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+  if (stallTime) {
+    LOGP(debug, "Waited {:.3f} ms for the prefetched CTF#{}", 1e-3 * stallTime, tf->ctfID);
+  }
+  return tf;
+}
+
+///_______________________________________
+bool CTFReaderSpec::isPrefetchingDone()
+{
+  std::lock_guard<std::mutex> lock(mPrefetchMutex);
+  return mPrefetchDone && mPrefetchQueue.empty() && !mPrefetchError;
+}
+
+///_______________________________________
+void CTFReaderSpec::stopPrefetching()
+{
+  if (!mPrefetchThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    mPrefetchStop = true;
+  }
+  mPrefetchCV.notify_all();
+  mPrefetchThread.join();
+  LOGP(info, "CTF prefetching: {} TFs read in {:.3f} s, {} left undispatched, dispatching waited {:.3f} s in {} stalls",
+       mNPrefetched, mPrefetchTimer.RealTime(), mPrefetchQueue.size(), 1e-6 * mTotalStallTime, mNStalls);
+  mPrefetchQueue.clear();
+}
+
 ///_______________________________________
 void CTFReaderSpec::tryToFixCTFHeader(CTFHeader& ctfHeader) const
 {
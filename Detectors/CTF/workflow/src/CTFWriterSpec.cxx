@@ -27,6 +27,7 @@
 #include "CommonUtils/NameConf.h"
 #include "CommonUtils/FileSystemUtils.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DetectorsCommonDataFormats/FileMetaData.h"
 #include "CommonUtils/StringUtils.h"
 #include "DataFormatsITSMFT/CTF.h"
@@ -124,6 +125,7 @@ class CTFWriterSpec : public o2::framework::Task
   DetID::mask_t mDets; // detectors
   bool mFinalized = false;
   bool mWriteCTF = true;
+  bool mWriteFlatCTF = false; // write also flat (memory-mappable) CTF files
   bool mCreateDict = false;
   bool mCreateRunEnvDir = true;
   bool mStoreMetaFile = false;
@@ -170,6 +172,7 @@ class CTFWriterSpec : public o2::framework::Task
   int mLockFD = -1;
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<CTFFlatFileWriter> mCTFFlatOut; // optional flat CTF file written alongside the ROOT one
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -222,6 +225,7 @@ void CTFWriterSpec::init(InitContext& ic)
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
   mCTFAutoSave = ic.options().get<long>("save-ctf-after");
   mCTFFileCompression = ic.options().get<int>("ctf-file-compression");
+  mWriteFlatCTF = ic.options().get<bool>("flat-output");
   mCTFMetaFileDir = ic.options().get<std::string>("meta-output-dir");
   if (mCTFMetaFileDir != "/dev/null") {
     mCTFMetaFileDir = o2::utils::Str::rectifyDirectory(mCTFMetaFileDir);
@@ -316,6 +320,9 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
     if (mWriteCTF && !mRejectCurrentTF) {
       sz = ctfImage.appendToTree(*tree, det.getName());
       header.detectors.set(det);
+      if (mCTFFlatOut) {
+        mCTFFlatOut->addDetector(det, bdata, ctfBuffer.size());
+      }
     } else {
       sz = ctfBuffer.size();
     }
@@ -504,6 +511,9 @@ void CTFWriterSpec::run(ProcessingContext& pc)
 
   if (mWriteCTF && !mRejectCurrentTF) {
     szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+    if (mCTFFlatOut) {
+      mCTFFlatOut->writeEntry(header);
+    }
     size_t prevSizeMB = mAccCTFSize / (1 << 20);
     mAccCTFSize += szCTF;
     mCTFTreeOut->SetEntries(++mNAccCTF);
@@ -602,6 +612,9 @@ void CTFWriterSpec::prepareTFTreeAndFile()
       mCTFFileOut->SetCompressionLevel(mCTFFileCompression);
     }
     mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mWriteFlatCTF) {
+      mCTFFlatOut = std::make_unique<CTFFlatFileWriter>(fmt::format("{}{}", CTFFlatFile::getFileName(mCurrentCTFFileNameFull), TMPFileEnding));
+    }
 
     mNCTFFiles++;
   }
@@ -617,6 +630,14 @@ void CTFWriterSpec::closeTFTreeAndFile()
       mCTFTreeOut.reset();
       mCTFFileOut->Close();
       mCTFFileOut.reset();
+      if (mCTFFlatOut) {
+        mCTFFlatOut->close();
+        mCTFFlatOut.reset();
+        auto flatFileName = CTFFlatFile::getFileName(mCurrentCTFFileNameFull);
+        if (!TMPFileEnding.empty()) {
+          std::filesystem::rename(o2::utils::Str::concat_string(flatFileName, TMPFileEnding), flatFileName);
+        }
+      }
       // write CTF file metaFile data
       auto actualFileName = TMPFileEnding.empty() ? mCurrentCTFFileNameFull : o2::utils::Str::concat_string(mCurrentCTFFileNameFull, TMPFileEnding);
       if (mStoreMetaFile) {
@@ -817,6 +838,7 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, const std::string& outTyp
             {"max-ctf-per-file", VariantType::Int, 0, {"if > 0, avoid storing more than requested CTFs per file"}},
             {"ctf-rejection", VariantType::Int, 0, {">0: percentage to reject randomly, <0: reject if timeslice%|value|!=0"}},
             {"ctf-file-compression", VariantType::Int, 0, {"if >= 0: impose CTF file compression level"}},
+            {"flat-output", VariantType::Bool, false, {"write in addition flat CTF files (.ctf) for zero-copy memory-mapped reading"}},
             {"require-free-disk", VariantType::Float, 0.f, {"pause writing op. if available disk space is below this margin, in bytes if >0, as a fraction of total if <0"}},
             {"wait-for-free-disk", VariantType::Float, 10.f, {"if paused due to the low disk space, recheck after this time (in s)"}},
             {"max-wait-for-free-disk", VariantType::Float, 60.f, {"produce fatal if paused due to the low disk space for more than this amount in s."}},
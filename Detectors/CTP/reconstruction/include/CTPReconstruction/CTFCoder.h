@@ -138,12 +138,14 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& data, LumiInfo& l
   std::vector<uint8_t> bytesInput, bytesClass;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODECTP(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODECTP(bcInc,       CTF::BLC_bcIncTrig);
   iosize += DECODECTP(orbitInc,    CTF::BLC_orbitIncTrig);
   iosize += DECODECTP(bytesInput,  CTF::BLC_bytesInput);
   iosize += DECODECTP(bytesClass,  CTF::BLC_bytesClass);
+  blockDecoding.flush();
   // clang-format on
   //
   data.clear();
@@ -109,7 +109,8 @@ DataProcessorSpec getEntropyDecoderSpec(int verbosity, unsigned int sspec)
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(verbosity)},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
             {"ignore-ctpinputs-decoding-ctf", VariantType::Bool, false, {"Inputs alignment: false - CTF decoder - has to be compatible with reco: allowed options: 10,01,00"}},
-            {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
+            {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}},
+            {"decoding-threads", VariantType::Int, 1, {"number of threads for concurrent decoding of the CTF blocks, <2: sequential"}}}};
 }
 
 } // namespace ctp
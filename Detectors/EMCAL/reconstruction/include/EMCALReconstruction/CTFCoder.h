@@ -142,6 +142,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   std::vector<uint8_t> status;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEEMCAL(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEEMCAL(bcInc,       CTF::BLC_bcIncTrig);
@@ -154,6 +155,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   iosize += DECODEEMCAL(status,      CTF::BLC_status);
   // extra slot was added in the end
   iosize += DECODEEMCAL(trigger,     CTF::BLC_trigger);
+  blockDecoding.flush();
   // triggers were added later, in old data they are absent:
   if (trigger.empty()) {
     trigger.resize(header.nTriggers);
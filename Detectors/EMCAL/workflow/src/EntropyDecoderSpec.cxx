@@ -92,7 +92,8 @@ DataProcessorSpec getEntropyDecoderSpec(int verbosity, unsigned int sspecInp, un
     outputs,
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(verbosity, sspecOut)},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
-            {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
+            {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}},
+            {"decoding-threads", VariantType::Int, 1, {"number of threads for concurrent decoding of the CTF blocks, <2: sequential"}}}};
 }
 
 } // namespace emcal
@@ -132,6 +132,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEFDD(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEFDD(cd.trigger,   CTF::BLC_trigger);
@@ -143,6 +144,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   iosize += DECODEFDD(cd.time,      CTF::BLC_time);
   iosize += DECODEFDD(cd.charge,    CTF::BLC_charge);
   iosize += DECODEFDD(cd.feeBits,   CTF::BLC_feeBits);
+  blockDecoding.flush();
   // clang-format on
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
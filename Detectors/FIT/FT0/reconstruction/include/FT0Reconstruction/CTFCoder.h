@@ -132,6 +132,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEFT0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEFT0(cd.trigger,     CTF::BLC_trigger);
@@ -143,6 +144,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   iosize += DECODEFT0(cd.qtcChain,    CTF::BLC_qtcChain);
   iosize += DECODEFT0(cd.cfdTime,     CTF::BLC_cfdTime);
   iosize += DECODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl);
+  blockDecoding.flush();
   // clang-format on
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
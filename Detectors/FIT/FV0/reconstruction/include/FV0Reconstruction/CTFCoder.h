@@ -128,6 +128,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEFV0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEFV0(cd.bcInc,     CTF::BLC_bcInc);
@@ -139,6 +140,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   // extra slot was added in the end
   iosize += DECODEFV0(cd.trigger,   CTF::BLC_trigger);
   iosize += DECODEFV0(cd.qtcChain,  CTF::BLC_qtcChain);
+  blockDecoding.flush();
   // triggers and qtcChain were added later, in old data they are absent:
   if (cd.trigger.empty()) {
     cd.trigger.resize(cd.header.nTriggers);
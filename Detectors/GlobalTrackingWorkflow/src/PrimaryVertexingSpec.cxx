@@ -82,6 +82,7 @@ void PrimaryVertexingSpec::init(InitContext& ic)
   }
   mVertexer.setPoolDumpDirectory(dumpDir);
   mVertexer.setTrackSources(mTrackSrc);
+  mVertexer.setNThreads(ic.options().get<int>("threads"));
 }
 
 void PrimaryVertexingSpec::run(ProcessingContext& pc)
@@ -284,7 +285,8 @@ DataProcessorSpec getPrimaryVertexingSpec(GTrackID::mask_t src, bool skip, bool
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<PrimaryVertexingSpec>(dataRequest, ggRequest, src, skip, validateWithFT0, useMC)},
-    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}}}};
+    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}},
+            {"threads", VariantType::Int, 1, {"Number of threads for the time-Z clusters processing"}}}};
 }
 
 } // namespace vertexing
@@ -141,6 +141,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VDIG& di
   std::vector<uint8_t> chID, ph, x, y;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEHMP(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEHMP(bcInc,       CTF::BLC_bcIncTrig);
@@ -152,6 +153,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VDIG& di
   iosize += DECODEHMP(ph,          CTF::BLC_Ph);
   iosize += DECODEHMP(x,           CTF::BLC_X);
   iosize += DECODEHMP(y,           CTF::BLC_Y);
+  blockDecoding.flush();
   // clang-format on
   //
   trigVec.clear();
@@ -74,6 +74,7 @@ class Tracker
   bool isMatLUT() const;
   void setNThreads(int n);
   int getNThreads() const;
+  void setTaskScheduling(bool v);
   std::uint32_t mTimeFrameCounter = 0;
 
  private:
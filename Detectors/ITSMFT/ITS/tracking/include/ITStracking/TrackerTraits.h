@@ -26,6 +26,8 @@
 #include <utility>
 #include <functional>
 
+#include <tbb/task_arena.h>
+
 #include "DetectorsBase/Propagator.h"
 #include "DetectorsBase/MatLayerCylSet.h"
 #include "ITStracking/Configuration.h"
@@ -87,6 +89,8 @@ class TrackerTraits
   bool getSmoothing() const { return mApplySmoothing; }
   void setNThreads(int n);
   int getNThreads() const { return mNThreads; }
+  void setTaskScheduling(bool v) { mUseTaskScheduling = v; }
+  bool getTaskScheduling() const { return mUseTaskScheduling; }
 
   o2::gpu::GPUChainITS* getChain() const { return mChain; }
 
@@ -103,6 +107,8 @@ class TrackerTraits
 
   int mNThreads = 1;
   bool mApplySmoothing = false;
+  bool mUseTaskScheduling = false; // split the work in (ROF, layer, phi slice) tasks balanced by work stealing instead of OpenMP loops
+  std::unique_ptr<tbb::task_arena> mTaskArena; // arena of mNThreads threads running the tasks, reused for all the TFs
 
  protected:
   o2::base::PropagatorImpl<float>::MatCorrType mCorrType = o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrNONE;
@@ -78,6 +78,7 @@ struct TrackerParamConfig : public o2::conf::ConfigurableParamHelper<TrackerPara
   float trackletsPerClusterLimit = -1.f;
   int findShortTracks = -1;
   int nThreads = 1;                        // number of threads to perform the operations in parallel.
+  bool useTaskScheduling = false;          // use task-based scheduling with work stealing (TBB) instead of OpenMP parallel loops
   int nROFsPerIterations = 0;              // size of the slice of ROFs to be processed at a time, preferably integer divisors of nROFs per TF, to balance the iterations.
   int nOrbitsPerIterations = 0;            // not implemented: size of the slice of ROFs to be processed at a time, computed using the number of ROFs per orbit.
   bool perPrimaryVertexProcessing = false; // perform the full tracking considering the vertex hypotheses one at the time.
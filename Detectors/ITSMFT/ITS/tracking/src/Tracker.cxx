@@ -489,6 +489,7 @@ void Tracker::getGlobalConfiguration()
   } else {
     mTraits->setCorrType(o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrLUT);
   }
+  setTaskScheduling(tc.useTaskScheduling);
   setNThreads(tc.nThreads);
   int nROFsPerIterations = tc.nROFsPerIterations > 0 ? tc.nROFsPerIterations : -1;
   if (tc.nOrbitsPerIterations > 0) {
@@ -576,5 +577,10 @@ int Tracker::getNThreads() const
 {
   return mTraits->getNThreads();
 }
+
+void Tracker::setTaskScheduling(bool v)
+{
+  mTraits->setTaskScheduling(v);
+}
 } // namespace its
 } // namespace o2
@@ -18,6 +18,11 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <numeric>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 #include <fmt/format.h>
 
@@ -42,6 +47,36 @@ float Sq(float q)
 {
   return q * q;
 }
+
+// Granularity of the task-based scheduling
+constexpr int NPhiSlices{16};         // phi slices per (ROF, layer) in the tracklet finding
+constexpr int NTrackletsPerTask{256}; // tracklets per task in the cell finding
+constexpr int NCellsPerTask{256};     // cells per task in the neighbour processing
+
+/// run f(iTask) for iTask in [0, nTasks) as independent tasks balanced by work stealing among the threads of the arena
+template <typename F>
+void runTasks(tbb::task_arena* arena, size_t nTasks, F&& f)
+{
+  if (!nTasks) {
+    return;
+  }
+  if (!arena) { // setNThreads was not called, run on the calling thread
+    for (size_t iTask = 0; iTask < nTasks; ++iTask) {
+      f(iTask);
+    }
+    return;
+  }
+  arena->execute([&]() {
+    tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, nTasks, 1),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t iTask = range.begin(); iTask < range.end(); ++iTask) {
+          f(iTask);
+        }
+      },
+      tbb::simple_partitioner{});
+  });
+}
 } // namespace
 
 namespace o2
@@ -72,128 +107,169 @@ void TrackerTraits::computeLayerTracklets(const int iteration, int iROFslice, in
   gsl::span<const Vertex> diamondSpan(&diamondVert, 1);
   int startROF{mTrkParams[iteration].nROFsPerIterations > 0 ? iROFslice * mTrkParams[iteration].nROFsPerIterations : 0};
   int endROF{gpu::GPUCommonMath::Min(mTrkParams[iteration].nROFsPerIterations > 0 ? (iROFslice + 1) * mTrkParams[iteration].nROFsPerIterations + mTrkParams[iteration].DeltaROF : tf->getNrof(), tf->getNrof())};
-  for (int rof0{startROF}; rof0 < endROF; ++rof0) {
+  // Find the tracklets starting from the clusters [firstCluster, lastCluster) of layer iLayer in ROF rof0
+  auto findTracklets = [&](int rof0, int iLayer, int firstCluster, int lastCluster, std::vector<Tracklet>& tracklets) {
     gsl::span<const Vertex> primaryVertices = mTrkParams[iteration].UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
     const int startVtx{iVertex >= 0 ? iVertex : 0};
     const int endVtx{iVertex >= 0 ? o2::gpu::CAMath::Min(iVertex + 1, static_cast<int>(primaryVertices.size())) : static_cast<int>(primaryVertices.size())};
     int minRof = o2::gpu::CAMath::Max(startROF, rof0 - mTrkParams[iteration].DeltaROF);
     int maxRof = o2::gpu::CAMath::Min(endROF - 1, rof0 + mTrkParams[iteration].DeltaROF);
-#pragma omp parallel for num_threads(mNThreads)
-    for (int iLayer = 0; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
-      gsl::span<const Cluster> layer0 = tf->getClustersOnLayer(rof0, iLayer);
-      if (layer0.empty()) {
+    gsl::span<const Cluster> layer0 = tf->getClustersOnLayer(rof0, iLayer);
+    float meanDeltaR{mTrkParams[iteration].LayerRadii[iLayer + 1] - mTrkParams[iteration].LayerRadii[iLayer]};
+
+    for (int iCluster{firstCluster}; iCluster < lastCluster; ++iCluster) {
+      const Cluster& currentCluster{layer0[iCluster]};
+      const int currentSortedIndex{tf->getSortedIndex(rof0, iLayer, iCluster)};
+
+      if (tf->isClusterUsed(iLayer, currentCluster.clusterId)) {
         continue;
       }
-      float meanDeltaR{mTrkParams[iteration].LayerRadii[iLayer + 1] - mTrkParams[iteration].LayerRadii[iLayer]};
-
-      const int currentLayerClustersNum{static_cast<int>(layer0.size())};
-      for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
-        const Cluster& currentCluster{layer0[iCluster]};
-        const int currentSortedIndex{tf->getSortedIndex(rof0, iLayer, iCluster)};
+      const float inverseR0{1.f / currentCluster.radius};
 
-        if (tf->isClusterUsed(iLayer, currentCluster.clusterId)) {
+      for (int iV{startVtx}; iV < endVtx; ++iV) {
+        auto& primaryVertex{primaryVertices[iV]};
+        if (primaryVertex.isFlagSet(2) && iteration != 3) {
           continue;
         }
-        const float inverseR0{1.f / currentCluster.radius};
+        const float resolution = o2::gpu::CAMath::Sqrt(Sq(mTrkParams[iteration].PVres) / primaryVertex.getNContributors() + Sq(tf->getPositionResolution(iLayer)));
 
-        for (int iV{startVtx}; iV < endVtx; ++iV) {
-          auto& primaryVertex{primaryVertices[iV]};
-          if (primaryVertex.isFlagSet(2) && iteration != 3) {
-            continue;
-          }
-          const float resolution = o2::gpu::CAMath::Sqrt(Sq(mTrkParams[iteration].PVres) / primaryVertex.getNContributors() + Sq(tf->getPositionResolution(iLayer)));
+        const float tanLambda{(currentCluster.zCoordinate - primaryVertex.getZ()) * inverseR0};
 
-          const float tanLambda{(currentCluster.zCoordinate - primaryVertex.getZ()) * inverseR0};
+        const float zAtRmin{tanLambda * (tf->getMinR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
+        const float zAtRmax{tanLambda * (tf->getMaxR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
 
-          const float zAtRmin{tanLambda * (tf->getMinR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
-          const float zAtRmax{tanLambda * (tf->getMaxR(iLayer + 1) - currentCluster.radius) + currentCluster.zCoordinate};
+        const float sqInverseDeltaZ0{1.f / (Sq(currentCluster.zCoordinate - primaryVertex.getZ()) + 2.e-8f)}; /// protecting from overflows adding the detector resolution
+        const float sigmaZ{o2::gpu::CAMath::Sqrt(Sq(resolution) * Sq(tanLambda) * ((Sq(inverseR0) + sqInverseDeltaZ0) * Sq(meanDeltaR) + 1.f) + Sq(meanDeltaR * tf->getMSangle(iLayer)))};
 
-          const float sqInverseDeltaZ0{1.f / (Sq(currentCluster.zCoordinate - primaryVertex.getZ()) + 2.e-8f)}; /// protecting from overflows adding the detector resolution
-          const float sigmaZ{o2::gpu::CAMath::Sqrt(Sq(resolution) * Sq(tanLambda) * ((Sq(inverseR0) + sqInverseDeltaZ0) * Sq(meanDeltaR) + 1.f) + Sq(meanDeltaR * tf->getMSangle(iLayer)))};
+        const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer + 1, zAtRmin, zAtRmax,
+                                                sigmaZ * mTrkParams[iteration].NSigmaCut, tf->getPhiCut(iLayer))};
+        if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
+          continue;
+        }
 
-          const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer + 1, zAtRmin, zAtRmax,
-                                                  sigmaZ * mTrkParams[iteration].NSigmaCut, tf->getPhiCut(iLayer))};
-          if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
-            continue;
-          }
+        int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
 
-          int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
+        if (phiBinsNum < 0) {
+          phiBinsNum += mTrkParams[iteration].PhiBins;
+        }
 
-          if (phiBinsNum < 0) {
-            phiBinsNum += mTrkParams[iteration].PhiBins;
+        for (int rof1{minRof}; rof1 <= maxRof; ++rof1) {
+          gsl::span<const Cluster> layer1 = tf->getClustersOnLayer(rof1, iLayer + 1);
+          if (layer1.empty()) {
+            continue;
           }
-
-          for (int rof1{minRof}; rof1 <= maxRof; ++rof1) {
-            gsl::span<const Cluster> layer1 = tf->getClustersOnLayer(rof1, iLayer + 1);
-            if (layer1.empty()) {
-              continue;
+          for (int iPhiCount{0}; iPhiCount < phiBinsNum; iPhiCount++) {
+            int iPhiBin = (selectedBinsRect.y + iPhiCount) % mTrkParams[iteration].PhiBins;
+            const int firstBinIndex{tf->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
+            const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
+            if constexpr (debugLevel) {
+              if (firstBinIndex < 0 || firstBinIndex > tf->getIndexTable(rof1, iLayer + 1).size() ||
+                  maxBinIndex < 0 || maxBinIndex > tf->getIndexTable(rof1, iLayer + 1).size()) {
+                std::cout << iLayer << "\t" << iCluster << "\t" << zAtRmin << "\t" << zAtRmax << "\t" << sigmaZ * mTrkParams[iteration].NSigmaCut << "\t" << tf->getPhiCut(iLayer) << std::endl;
+                std::cout << currentCluster.zCoordinate << "\t" << primaryVertex.getZ() << "\t" << currentCluster.radius << std::endl;
+                std::cout << tf->getMinR(iLayer + 1) << "\t" << currentCluster.radius << "\t" << currentCluster.zCoordinate << std::endl;
+                std::cout << "Illegal access to IndexTable " << firstBinIndex << "\t" << maxBinIndex << "\t" << selectedBinsRect.z << "\t" << selectedBinsRect.x << std::endl;
+                exit(1);
+              }
             }
-            for (int iPhiCount{0}; iPhiCount < phiBinsNum; iPhiCount++) {
-              int iPhiBin = (selectedBinsRect.y + iPhiCount) % mTrkParams[iteration].PhiBins;
-              const int firstBinIndex{tf->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
-              const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
-              if constexpr (debugLevel) {
-                if (firstBinIndex < 0 || firstBinIndex > tf->getIndexTable(rof1, iLayer + 1).size() ||
-                    maxBinIndex < 0 || maxBinIndex > tf->getIndexTable(rof1, iLayer + 1).size()) {
-                  std::cout << iLayer << "\t" << iCluster << "\t" << zAtRmin << "\t" << zAtRmax << "\t" << sigmaZ * mTrkParams[iteration].NSigmaCut << "\t" << tf->getPhiCut(iLayer) << std::endl;
-                  std::cout << currentCluster.zCoordinate << "\t" << primaryVertex.getZ() << "\t" << currentCluster.radius << std::endl;
-                  std::cout << tf->getMinR(iLayer + 1) << "\t" << currentCluster.radius << "\t" << currentCluster.zCoordinate << std::endl;
-                  std::cout << "Illegal access to IndexTable " << firstBinIndex << "\t" << maxBinIndex << "\t" << selectedBinsRect.z << "\t" << selectedBinsRect.x << std::endl;
-                  exit(1);
-                }
+            const int firstRowClusterIndex = tf->getIndexTable(rof1, iLayer + 1)[firstBinIndex];
+            const int maxRowClusterIndex = tf->getIndexTable(rof1, iLayer + 1)[maxBinIndex];
+            for (int iNextCluster{firstRowClusterIndex}; iNextCluster < maxRowClusterIndex; ++iNextCluster) {
+              if (iNextCluster >= (int)layer1.size()) {
+                break;
               }
-              const int firstRowClusterIndex = tf->getIndexTable(rof1, iLayer + 1)[firstBinIndex];
-              const int maxRowClusterIndex = tf->getIndexTable(rof1, iLayer + 1)[maxBinIndex];
-              for (int iNextCluster{firstRowClusterIndex}; iNextCluster < maxRowClusterIndex; ++iNextCluster) {
-                if (iNextCluster >= (int)layer1.size()) {
-                  break;
-                }
 
-                const Cluster& nextCluster{layer1[iNextCluster]};
-                if (tf->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
-                  continue;
-                }
+              const Cluster& nextCluster{layer1[iNextCluster]};
+              if (tf->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
+                continue;
+              }
 
-                const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi)};
-                const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.radius - currentCluster.radius) +
-                                                           currentCluster.zCoordinate - nextCluster.zCoordinate)};
+              const float deltaPhi{gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi)};
+              const float deltaZ{gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.radius - currentCluster.radius) +
+                                                         currentCluster.zCoordinate - nextCluster.zCoordinate)};
 
 #ifdef OPTIMISATION_OUTPUT
-                MCCompLabel label;
-                int currentId{currentCluster.clusterId};
-                int nextId{nextCluster.clusterId};
-                for (auto& lab1 : tf->getClusterLabels(iLayer, currentId)) {
-                  for (auto& lab2 : tf->getClusterLabels(iLayer + 1, nextId)) {
-                    if (lab1 == lab2 && lab1.isValid()) {
-                      label = lab1;
-                      break;
-                    }
-                  }
-                  if (label.isValid()) {
+              MCCompLabel label;
+              int currentId{currentCluster.clusterId};
+              int nextId{nextCluster.clusterId};
+              for (auto& lab1 : tf->getClusterLabels(iLayer, currentId)) {
+                for (auto& lab2 : tf->getClusterLabels(iLayer + 1, nextId)) {
+                  if (lab1 == lab2 && lab1.isValid()) {
+                    label = lab1;
                     break;
                   }
                 }
-                off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
+                if (label.isValid()) {
+                  break;
+                }
+              }
+              off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
 #endif
 
-                if (deltaZ / sigmaZ < mTrkParams[iteration].NSigmaCut &&
-                    (deltaPhi < tf->getPhiCut(iLayer) ||
-                     gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < tf->getPhiCut(iLayer))) {
-                  if (iLayer > 0) {
-                    tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
-                  }
-                  const float phi{o2::gpu::GPUCommonMath::ATan2(currentCluster.yCoordinate - nextCluster.yCoordinate,
-                                                                currentCluster.xCoordinate - nextCluster.xCoordinate)};
-                  const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
-                                   (currentCluster.radius - nextCluster.radius)};
-                  tf->getTracklets()[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
+              if (deltaZ / sigmaZ < mTrkParams[iteration].NSigmaCut &&
+                  (deltaPhi < tf->getPhiCut(iLayer) ||
+                   gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < tf->getPhiCut(iLayer))) {
+                if (iLayer > 0) {
+                  tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
                 }
+                const float phi{o2::gpu::GPUCommonMath::ATan2(currentCluster.yCoordinate - nextCluster.yCoordinate,
+                                                              currentCluster.xCoordinate - nextCluster.xCoordinate)};
+                const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
+                                 (currentCluster.radius - nextCluster.radius)};
+                tracklets.emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
               }
             }
           }
         }
       }
     }
+  };
+
+  if (mUseTaskScheduling) {
+    // The clusters of a ROF are sorted by phi bin first, so that each (ROF, layer, phi slice) task is a contiguous
+    // range of clusters. The tasks are balanced by work stealing and fill their own buffers, merged in order at the end.
+    struct TrackletTask {
+      int rof0, iLayer, firstCluster, lastCluster;
+    };
+    std::vector<TrackletTask> tasks;
+    const int zBins{mTrkParams[iteration].ZBins};
+    const int phiBinsPerSlice{o2::gpu::CAMath::Max(1, mTrkParams[iteration].PhiBins / NPhiSlices)};
+    for (int rof0{startROF}; rof0 < endROF; ++rof0) {
+      for (int iLayer = 0; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
+        const int nClusters{static_cast<int>(tf->getClustersOnLayer(rof0, iLayer).size())};
+        if (!nClusters) {
+          continue;
+        }
+        auto indexTable = tf->getIndexTable(rof0, iLayer);
+        for (int phiBin{0}; phiBin < mTrkParams[iteration].PhiBins; phiBin += phiBinsPerSlice) {
+          const int nextPhiBin{phiBin + phiBinsPerSlice};
+          const int first{indexTable[phiBin * zBins]};
+          const int last{nextPhiBin >= mTrkParams[iteration].PhiBins ? nClusters : indexTable[nextPhiBin * zBins]};
+          if (last > first) {
+            tasks.push_back({rof0, iLayer, first, last});
+          }
+        }
+      }
+    }
+    std::vector<std::vector<Tracklet>> buffers(tasks.size());
+    runTasks(mTaskArena.get(), tasks.size(), [&](size_t iTask) {
+      const auto& task = tasks[iTask];
+      findTracklets(task.rof0, task.iLayer, task.firstCluster, task.lastCluster, buffers[iTask]);
+    });
+    for (size_t iTask{0}; iTask < tasks.size(); ++iTask) {
+      auto& tracklets = tf->getTracklets()[tasks[iTask].iLayer];
+      tracklets.insert(tracklets.end(), buffers[iTask].begin(), buffers[iTask].end());
+    }
+  } else {
+    for (int rof0{startROF}; rof0 < endROF; ++rof0) {
+#pragma omp parallel for num_threads(mNThreads)
+      for (int iLayer = 0; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
+        const int nClusters{static_cast<int>(tf->getClustersOnLayer(rof0, iLayer).size())};
+        if (nClusters) {
+          findTracklets(rof0, iLayer, 0, nClusters, tf->getTracklets()[iLayer]);
+        }
+      }
+    }
   }
   if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
     return;
@@ -282,20 +358,13 @@ void TrackerTraits::computeLayerCells(const int iteration)
   }
 
   TimeFrame* tf = mTimeFrame;
-#pragma omp parallel for num_threads(mNThreads)
-  for (int iLayer = 0; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
-
-    if (tf->getTracklets()[iLayer + 1].empty() ||
-        tf->getTracklets()[iLayer].empty()) {
-      continue;
-    }
-
+  // Find the cells starting from the tracklets [firstTracklet, lastTracklet) of layer iLayer, counting them per tracklet
+  auto findCells = [&](int iLayer, int firstTracklet, int lastTracklet, std::vector<CellSeed>& cells, int* nCellsPerTracklet) {
 #ifdef OPTIMISATION_OUTPUT
     float resolution{o2::gpu::CAMath::Sqrt(0.5f * (mTrkParams[iteration].SystErrorZ2[iLayer] + mTrkParams[iteration].SystErrorZ2[iLayer + 1] + mTrkParams[iteration].SystErrorZ2[iLayer + 2] + mTrkParams[iteration].SystErrorY2[iLayer] + mTrkParams[iteration].SystErrorY2[iLayer + 1] + mTrkParams[iteration].SystErrorY2[iLayer + 2])) / mTrkParams[iteration].LayerResolution[iLayer]};
     resolution = resolution > 1.e-12 ? resolution : 1.f;
 #endif
-    const int currentLayerTrackletsNum{static_cast<int>(tf->getTracklets()[iLayer].size())};
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+    for (int iTracklet{firstTracklet}; iTracklet < lastTracklet; ++iTracklet) {
 
       const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
       const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
@@ -365,17 +434,54 @@ void TrackerTraits::computeLayerCells(const int iteration)
           if (!good) {
             continue;
           }
-          if (iLayer > 0 && (int)tf->getCellsLookupTable()[iLayer - 1].size() <= iTracklet) {
-            tf->getCellsLookupTable()[iLayer - 1].resize(iTracklet + 1, tf->getCells()[iLayer].size());
-          }
-          tf->getCells()[iLayer].emplace_back(iLayer, clusId[0], clusId[1], clusId[2],
-                                              iTracklet, iNextTracklet, track, chi2);
+          nCellsPerTracklet[iTracklet]++;
+          cells.emplace_back(iLayer, clusId[0], clusId[1], clusId[2],
+                             iTracklet, iNextTracklet, track, chi2);
         }
       }
     }
-    if (iLayer > 0) {
-      tf->getCellsLookupTable()[iLayer - 1].resize(currentLayerTrackletsNum + 1, tf->getCells()[iLayer].size());
+  };
+
+  std::vector<std::vector<int>> nCellsPerTracklet(mTrkParams[iteration].CellsPerRoad());
+  for (int iLayer = 0; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
+    if (!tf->getTracklets()[iLayer + 1].empty() && !tf->getTracklets()[iLayer].empty()) {
+      nCellsPerTracklet[iLayer].resize(tf->getTracklets()[iLayer].size() + 1, 0);
+    }
+  }
+  if (mUseTaskScheduling) {
+    // Chunks of tracklets of all layers are processed as independent tasks, each with its own output buffer
+    struct CellTask {
+      int iLayer, firstTracklet, lastTracklet;
+    };
+    std::vector<CellTask> tasks;
+    for (int iLayer = 0; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
+      const int nTracklets{static_cast<int>(nCellsPerTracklet[iLayer].size()) - 1};
+      for (int first{0}; first < nTracklets; first += NTrackletsPerTask) {
+        tasks.push_back({iLayer, first, o2::gpu::CAMath::Min(first + NTrackletsPerTask, nTracklets)});
+      }
     }
+    std::vector<std::vector<CellSeed>> buffers(tasks.size());
+    runTasks(mTaskArena.get(), tasks.size(), [&](size_t iTask) {
+      const auto& task = tasks[iTask];
+      findCells(task.iLayer, task.firstTracklet, task.lastTracklet, buffers[iTask], nCellsPerTracklet[task.iLayer].data());
+    });
+    for (size_t iTask{0}; iTask < tasks.size(); ++iTask) {
+      auto& cells = tf->getCells()[tasks[iTask].iLayer];
+      cells.insert(cells.end(), buffers[iTask].begin(), buffers[iTask].end());
+    }
+  } else {
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iLayer = 0; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
+      if (!nCellsPerTracklet[iLayer].empty()) {
+        findCells(iLayer, 0, nCellsPerTracklet[iLayer].size() - 1, tf->getCells()[iLayer], nCellsPerTracklet[iLayer].data());
+      }
+    }
+  }
+  /// Compute LUT: index of the first cell of each tracklet
+  for (int iLayer = 1; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
+    auto& lut{tf->getCellsLookupTable()[iLayer - 1]};
+    lut.resize(nCellsPerTracklet[iLayer].size());
+    std::exclusive_scan(nCellsPerTracklet[iLayer].begin(), nCellsPerTracklet[iLayer].end(), lut.begin(), 0);
   }
   if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
     return;
@@ -481,78 +587,98 @@ void TrackerTraits::processNeighbours(int iLayer, int iLevel, const std::vector<
   int failed[5]{0, 0, 0, 0, 0}, attempts{0}, failedByMismatch{0};
 #endif
 
-#pragma omp parallel for num_threads(mNThreads)
-  for (unsigned int iCell = 0; iCell < currentCellSeed.size(); ++iCell) {
-    const CellSeed& currentCell{currentCellSeed[iCell]};
-    if (currentCell.getLevel() != iLevel) {
-      continue;
-    }
-    if (currentCellId.empty() && (mTimeFrame->isClusterUsed(iLayer, currentCell.getFirstClusterIndex()) ||
-                                  mTimeFrame->isClusterUsed(iLayer + 1, currentCell.getSecondClusterIndex()) ||
-                                  mTimeFrame->isClusterUsed(iLayer + 2, currentCell.getThirdClusterIndex()))) {
-      continue; /// this we do only on the first iteration, hence the check on currentCellId
-    }
-    const int cellId = currentCellId.empty() ? iCell : currentCellId[iCell];
-    const int startNeighbourId{cellId ? mTimeFrame->getCellsNeighboursLUT()[iLayer - 1][cellId - 1] : 0};
-    const int endNeighbourId{mTimeFrame->getCellsNeighboursLUT()[iLayer - 1][cellId]};
-
-    for (int iNeighbourCell{startNeighbourId}; iNeighbourCell < endNeighbourId; ++iNeighbourCell) {
-      CA_DEBUGGER(attempts++);
-      const int neighbourCellId = mTimeFrame->getCellsNeighbours()[iLayer - 1][iNeighbourCell];
-      const CellSeed& neighbourCell = mTimeFrame->getCells()[iLayer - 1][neighbourCellId];
-      if (neighbourCell.getSecondTrackletIndex() != currentCell.getFirstTrackletIndex()) {
-        CA_DEBUGGER(failedByMismatch++);
+  // Extend the cells [firstCell, lastCell) with their neighbours, each chunk of cells fills its own output buffers
+  // which are merged in order at the end, so that the result does not depend on the scheduling
+  auto processCells = [&](int firstCell, int lastCell, std::vector<CellSeed>& cellSeeds, std::vector<int>& cellsIds) {
+    for (int iCell{firstCell}; iCell < lastCell; ++iCell) {
+      const CellSeed& currentCell{currentCellSeed[iCell]};
+      if (currentCell.getLevel() != iLevel) {
         continue;
       }
-      if (mTimeFrame->isClusterUsed(iLayer - 1, neighbourCell.getFirstClusterIndex())) {
-        continue;
-      }
-      if (currentCell.getLevel() - 1 != neighbourCell.getLevel()) {
-        CA_DEBUGGER(failed[0]++);
-        continue;
-      }
-      /// Let's start the fitting procedure
-      CellSeed seed{currentCell};
-      auto& trHit = mTimeFrame->getTrackingFrameInfoOnLayer(iLayer - 1).at(neighbourCell.getFirstClusterIndex());
-
-      if (!seed.rotate(trHit.alphaTrackingFrame)) {
-        CA_DEBUGGER(failed[1]++);
-        continue;
+      if (currentCellId.empty() && (mTimeFrame->isClusterUsed(iLayer, currentCell.getFirstClusterIndex()) ||
+                                    mTimeFrame->isClusterUsed(iLayer + 1, currentCell.getSecondClusterIndex()) ||
+                                    mTimeFrame->isClusterUsed(iLayer + 2, currentCell.getThirdClusterIndex()))) {
+        continue; /// this we do only on the first iteration, hence the check on currentCellId
       }
+      const int cellId = currentCellId.empty() ? iCell : currentCellId[iCell];
+      const int startNeighbourId{cellId ? mTimeFrame->getCellsNeighboursLUT()[iLayer - 1][cellId - 1] : 0};
+      const int endNeighbourId{mTimeFrame->getCellsNeighboursLUT()[iLayer - 1][cellId]};
+
+      for (int iNeighbourCell{startNeighbourId}; iNeighbourCell < endNeighbourId; ++iNeighbourCell) {
+        CA_DEBUGGER(attempts++);
+        const int neighbourCellId = mTimeFrame->getCellsNeighbours()[iLayer - 1][iNeighbourCell];
+        const CellSeed& neighbourCell = mTimeFrame->getCells()[iLayer - 1][neighbourCellId];
+        if (neighbourCell.getSecondTrackletIndex() != currentCell.getFirstTrackletIndex()) {
+          CA_DEBUGGER(failedByMismatch++);
+          continue;
+        }
+        if (mTimeFrame->isClusterUsed(iLayer - 1, neighbourCell.getFirstClusterIndex())) {
+          continue;
+        }
+        if (currentCell.getLevel() - 1 != neighbourCell.getLevel()) {
+          CA_DEBUGGER(failed[0]++);
+          continue;
+        }
+        /// Let's start the fitting procedure
+        CellSeed seed{currentCell};
+        auto& trHit = mTimeFrame->getTrackingFrameInfoOnLayer(iLayer - 1).at(neighbourCell.getFirstClusterIndex());
 
-      if (!propagator->propagateToX(seed, trHit.xTrackingFrame, getBz(), o2::base::PropagatorImpl<float>::MAX_SIN_PHI, o2::base::PropagatorImpl<float>::MAX_STEP, mCorrType)) {
-        CA_DEBUGGER(failed[2]++);
-        continue;
-      }
+        if (!seed.rotate(trHit.alphaTrackingFrame)) {
+          CA_DEBUGGER(failed[1]++);
+          continue;
+        }
 
-      if (mCorrType == o2::base::PropagatorF::MatCorrType::USEMatCorrNONE) {
-        float radl = 9.36f; // Radiation length of Si [cm]
-        float rho = 2.33f;  // Density of Si [g/cm^3]
-        if (!seed.correctForMaterial(mTrkParams[0].LayerxX0[iLayer - 1], mTrkParams[0].LayerxX0[iLayer - 1] * radl * rho, true)) {
+        if (!propagator->propagateToX(seed, trHit.xTrackingFrame, getBz(), o2::base::PropagatorImpl<float>::MAX_SIN_PHI, o2::base::PropagatorImpl<float>::MAX_STEP, mCorrType)) {
+          CA_DEBUGGER(failed[2]++);
           continue;
         }
-      }
 
-      auto predChi2{seed.getPredictedChi2Quiet(trHit.positionTrackingFrame, trHit.covarianceTrackingFrame)};
-      if ((predChi2 > mTrkParams[0].MaxChi2ClusterAttachment) || predChi2 < 0.f) {
-        CA_DEBUGGER(failed[3]++);
-        continue;
-      }
-      seed.setChi2(seed.getChi2() + predChi2);
-      if (!seed.o2::track::TrackParCov::update(trHit.positionTrackingFrame, trHit.covarianceTrackingFrame)) {
-        CA_DEBUGGER(failed[4]++);
-        continue;
-      }
-      seed.getClusters()[iLayer - 1] = neighbourCell.getFirstClusterIndex();
-      seed.setLevel(neighbourCell.getLevel());
-      seed.setFirstTrackletIndex(neighbourCell.getFirstTrackletIndex());
-      seed.setSecondTrackletIndex(neighbourCell.getSecondTrackletIndex());
-#pragma omp critical
-      {
-        updatedCellsIds.push_back(neighbourCellId);
-        updatedCellSeeds.push_back(seed);
+        if (mCorrType == o2::base::PropagatorF::MatCorrType::USEMatCorrNONE) {
+          float radl = 9.36f; // Radiation length of Si [cm]
+          float rho = 2.33f;  // Density of Si [g/cm^3]
+          if (!seed.correctForMaterial(mTrkParams[0].LayerxX0[iLayer - 1], mTrkParams[0].LayerxX0[iLayer - 1] * radl * rho, true)) {
+            continue;
+          }
+        }
+
+        auto predChi2{seed.getPredictedChi2Quiet(trHit.positionTrackingFrame, trHit.covarianceTrackingFrame)};
+        if ((predChi2 > mTrkParams[0].MaxChi2ClusterAttachment) || predChi2 < 0.f) {
+          CA_DEBUGGER(failed[3]++);
+          continue;
+        }
+        seed.setChi2(seed.getChi2() + predChi2);
+        if (!seed.o2::track::TrackParCov::update(trHit.positionTrackingFrame, trHit.covarianceTrackingFrame)) {
+          CA_DEBUGGER(failed[4]++);
+          continue;
+        }
+        seed.getClusters()[iLayer - 1] = neighbourCell.getFirstClusterIndex();
+        seed.setLevel(neighbourCell.getLevel());
+        seed.setFirstTrackletIndex(neighbourCell.getFirstTrackletIndex());
+        seed.setSecondTrackletIndex(neighbourCell.getSecondTrackletIndex());
+        cellsIds.push_back(neighbourCellId);
+        cellSeeds.push_back(seed);
       }
     }
+  };
+
+  const int nCells{static_cast<int>(currentCellSeed.size())};
+  const int nChunks{(nCells + NCellsPerTask - 1) / NCellsPerTask};
+  std::vector<std::vector<CellSeed>> seedsBuffers(nChunks);
+  std::vector<std::vector<int>> idsBuffers(nChunks);
+  auto processChunk = [&](int iChunk) {
+    processCells(iChunk * NCellsPerTask, o2::gpu::CAMath::Min((iChunk + 1) * NCellsPerTask, nCells), seedsBuffers[iChunk], idsBuffers[iChunk]);
+  };
+  if (mUseTaskScheduling) {
+    runTasks(mTaskArena.get(), nChunks, processChunk);
+  } else {
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+    for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+      processChunk(iChunk);
+    }
+  }
+  for (int iChunk{0}; iChunk < nChunks; ++iChunk) {
+    updatedCellSeeds.insert(updatedCellSeeds.end(), seedsBuffers[iChunk].begin(), seedsBuffers[iChunk].end());
+    updatedCellsIds.insert(updatedCellsIds.end(), idsBuffers[iChunk].begin(), idsBuffers[iChunk].end());
   }
 #ifdef CA_DEBUG
   std::cout << "\t\t- Found " << updatedCellSeeds.size() << " cell seeds out of " << attempts << " attempts" << std::endl;
@@ -600,8 +726,7 @@ void TrackerTraits::findRoads(const int iteration)
 
     std::vector<TrackITSExt> tracks(trackSeeds.size());
     std::atomic<size_t> trackIndex{0};
-#pragma omp parallel for num_threads(mNThreads)
-    for (size_t seedId = 0; seedId < trackSeeds.size(); ++seedId) {
+    auto fitSeed = [&](size_t seedId) {
       const CellSeed& seed{trackSeeds[seedId]};
       TrackITSExt temporaryTrack{seed};
       temporaryTrack.resetCovariance();
@@ -612,16 +737,24 @@ void TrackerTraits::findRoads(const int iteration)
 
       bool fitSuccess = fitTrack(temporaryTrack, 0, mTrkParams[0].NLayers, 1, mTrkParams[0].MaxChi2ClusterAttachment, mTrkParams[0].MaxChi2NDF);
       if (!fitSuccess) {
-        continue;
+        return;
       }
       temporaryTrack.getParamOut() = temporaryTrack.getParamIn();
       temporaryTrack.resetCovariance();
       temporaryTrack.setChi2(0);
       fitSuccess = fitTrack(temporaryTrack, mTrkParams[0].NLayers - 1, -1, -1, mTrkParams[0].MaxChi2ClusterAttachment, mTrkParams[0].MaxChi2NDF, 50.f);
       if (!fitSuccess || temporaryTrack.getPt() < mTrkParams[iteration].MinPt[mTrkParams[iteration].NLayers - temporaryTrack.getNClusters()]) {
-        continue;
+        return;
       }
       tracks[trackIndex++] = temporaryTrack;
+    };
+    if (mUseTaskScheduling) {
+      runTasks(mTaskArena.get(), trackSeeds.size(), fitSeed);
+    } else {
+#pragma omp parallel for num_threads(mNThreads)
+      for (size_t seedId = 0; seedId < trackSeeds.size(); ++seedId) {
+        fitSeed(seedId);
+      }
     }
 
     tracks.resize(trackIndex);
@@ -1010,8 +1143,11 @@ void TrackerTraits::setNThreads(int n)
 #ifdef WITH_OPENMP
   mNThreads = n > 0 ? n : 1;
 #else
-  mNThreads = 1;
+  mNThreads = mUseTaskScheduling && n > 0 ? n : 1; // only the task-based mode runs in parallel without OpenMP
 #endif
+  if (!mTaskArena || mTaskArena->max_concurrency() != mNThreads) { // the threads are started at the first use
+    mTaskArena = std::make_unique<tbb::task_arena>(mNThreads);
+  }
 }
 
 int TrackerTraits::getTFNumberOfClusters() const
@@ -240,6 +240,7 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec, o2::c
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   ec.print(getPrefix(), mVerbosity);
+  BlockDecodingScope blockDecoding;
 #define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
@@ -253,6 +254,7 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec, o2::c
   iosize += DECODEITSMFT(cc.colInc,       CTF::BLCcolInc);
   iosize += DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
   iosize += DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
+  blockDecoding.flush();
   // clang-format on
   return cc;
 }
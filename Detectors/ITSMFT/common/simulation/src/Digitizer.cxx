@@ -241,11 +241,18 @@ void Digitizer::fillOutputContainer(uint32_t frameLast)
         if (preDig.charge >= mParams.getChargeThreshold()) {
           int digID = mDigits->size();
           mDigits->emplace_back(chip.getChipIndex(), preDig.row, preDig.col, preDig.charge);
-          mMCLabels->addElement(digID, preDig.labelRef.label);
-          auto& nextRef = preDig.labelRef; // extra contributors are in extra array
-          while (nextRef.next >= 0) {
-            nextRef = extra[nextRef.next];
-            mMCLabels->addElement(digID, nextRef.label);
+          auto addLabels = [&preDig, &extra](auto* labels, uint32_t labID) {
+            labels->addElement(labID, preDig.labelRef.label);
+            auto& nextRef = preDig.labelRef; // extra contributors are in extra array
+            while (nextRef.next >= 0) {
+              nextRef = extra[nextRef.next];
+              labels->addElement(labID, nextRef.label);
+            }
+          };
+          if (mMCLabelsSlot) {
+            addLabels(mMCLabelsSlot, mMCLabelsSlot->getIndexedSize()); // the slot indexes all digits flushed so far
+          } else {
+            addLabels(mMCLabels, digID);
           }
         }
       }
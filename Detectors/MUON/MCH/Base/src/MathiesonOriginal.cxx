@@ -16,7 +16,10 @@
 
 #include "MCHBase/MathiesonOriginal.h"
 
+#include <algorithm>
+
 #include <TMath.h>
+#include <Vc/Vc>
 
 namespace o2
 {
@@ -66,5 +69,36 @@ float MathiesonOriginal::integrate(float xMin, float yMin, float xMax, float yMa
                             mKy4 * (TMath::ATan(uyMax) - TMath::ATan(uyMin)));
 }
 
+//_________________________________________________________________________________________________
+void MathiesonOriginal::integrate(int n, const float xMin[], const float yMin[], const float xMax[], const float yMax[],
+                                  float integrals[]) const
+{
+  /// integrate the Mathieson over x and y in the n given areas, Vc::double_v::Size areas at a time
+  /// the computation is done in double precision, as for a single area. The tanh is derived from the
+  /// exponential (no vectorized tanh in Vc), with the argument clamped where tanh is +-1 in double precision.
+  /// The last incomplete batch repeats the last area, only the results of the actual areas are stored
+
+  using VDouble = Vc::double_v;
+  constexpr int NLanes = VDouble::Size;
+
+  const float inversePitch = mInversePitch;
+  auto u = [&](const float xy[], int i, float k2, float sqrtK3) {
+    auto arg = VDouble::generate([&](size_t k) { return static_cast<double>(k2 * (xy[std::min(i + static_cast<int>(k), n - 1)] * inversePitch)); });
+    arg = Vc::min(Vc::max(arg, VDouble(-20.)), VDouble(20.));
+    return static_cast<double>(sqrtK3) * (1. - 2. / (Vc::exp(2. * arg) + 1.));
+  };
+
+  for (int i = 0; i < n; i += NLanes) {
+    VDouble uxMin = u(xMin, i, mKx2, mSqrtKx3);
+    VDouble uxMax = u(xMax, i, mKx2, mSqrtKx3);
+    VDouble uyMin = u(yMin, i, mKy2, mSqrtKy3);
+    VDouble uyMax = u(yMax, i, mKy2, mSqrtKy3);
+    VDouble integral = 4. * mKx4 * (Vc::atan(uxMax) - Vc::atan(uxMin)) * mKy4 * (Vc::atan(uyMax) - Vc::atan(uyMin));
+    for (int k = 0; k < NLanes && i + k < n; ++k) {
+      integrals[i + k] = static_cast<float>(integral[k]);
+    }
+  }
+}
+
 } // namespace mch
 } // namespace o2
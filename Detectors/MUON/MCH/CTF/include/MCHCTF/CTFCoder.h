@@ -145,6 +145,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofVec, VCOL& dig
   std::vector<uint8_t> isSaturated;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEMCH(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEMCH(bcInc,       CTF::BLC_bcIncROF);
@@ -157,6 +158,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofVec, VCOL& dig
   iosize += DECODEMCH(detID,       CTF::BLC_detID);
   iosize += DECODEMCH(padID,       CTF::BLC_padID);
   iosize += DECODEMCH(ADC,         CTF::BLC_ADC);
+  blockDecoding.flush();
   // clang-format on
   //
   rofVec.clear();
@@ -25,8 +25,6 @@
 
 #include <gsl/span>
 
-#include <TH2D.h>
-
 #include "DataFormatsMCH/Digit.h"
 #include "DataFormatsMCH/Cluster.h"
 #include "MCHBase/ErrorMap.h"
@@ -41,6 +39,8 @@ namespace mch
 class PadOriginal;
 class ClusterOriginal;
 class MathiesonOriginal;
+template <typename T>
+class PixelGridOriginal;
 
 class ClusterFinderOriginal
 {
@@ -78,30 +78,33 @@ class ClusterFinderOriginal
   void processPreCluster();
 
   void buildPixArray();
-  void ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const;
+  void ProjectPadOverPixels(const PadOriginal& pad, PixelGridOriginal<double>& charges, PixelGridOriginal<int>& entries) const;
 
-  void findLocalMaxima(std::unique_ptr<TH2D>& histAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
-  void flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const;
-  void restrictPreCluster(const TH2D& histAnode, int i0, int j0);
+  void findLocalMaxima(PixelGridOriginal<double>& gridAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
+  void flagLocalMaxima(const PixelGridOriginal<double>& gridAnode, int i0, int j0, std::vector<int>& isLocalMax) const;
+  void restrictPreCluster(const PixelGridOriginal<double>& gridAnode, int i0, int j0);
 
   void processSimple();
   void process();
   void addVirtualPad();
-  void computeCoefficients(std::vector<double>& coef, std::vector<double>& prob) const;
+  void computeCoefficients(std::vector<double>& coef, std::vector<double>& prob);
   double mlem(const std::vector<double>& coef, const std::vector<double>& prob, int nIter);
-  void findCOG(const TH2D& histMLEM, double xy[2]) const;
+  void findCOG(const PixelGridOriginal<double>& gridMLEM, double xy[2]) const;
   void refinePixelArray(const double xyCOG[2], size_t nPixMax, double& xMin, double& xMax, double& yMin, double& yMax);
   void cleanPixelArray(double threshold, std::vector<double>& prob);
 
   int fit(const std::vector<const std::vector<int>*>& clustersOfPixels, const double fitRange[2][2], double fitParam[SNFitParamMax + 1]);
   double fit(double currentParam[SNFitParamMax + 2], const double parmin[SNFitParamMax], const double parmax[SNFitParamMax],
-             int nParamUsed, int& nTrials) const;
-  double computeChi2(const double param[SNFitParamMax + 2], int nParamUsed) const;
+             int nParamUsed, int& nTrials);
+  double fitLevenbergMarquardt(double currentParam[SNFitParamMax + 2], const double parmin[SNFitParamMax],
+                               const double parmax[SNFitParamMax], int nParamUsed, int& nTrials);
+  double computeChi2(const double param[SNFitParamMax + 2], int nParamUsed);
+  int computePadChargesFit(const double param[SNFitParamMax + 2], int nParamUsed);
   void param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed, double fraction[SNFitClustersMax]) const;
   float chargeIntegration(double x, double y, const PadOriginal& pad) const;
 
-  void split(const TH2D& histMLEM, const std::vector<double>& coef);
-  void addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed);
+  void split(const PixelGridOriginal<double>& gridMLEM, const std::vector<double>& coef);
+  void addPixel(const PixelGridOriginal<double>& gridMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<bool>& isUsed);
   void addCluster(int iCluster, std::vector<int>& coupledClusters, std::vector<bool>& isClUsed,
                   const std::vector<std::vector<double>>& couplingClCl) const;
   void extractLeastCoupledClusters(std::vector<int>& coupledClusters, std::vector<int>& clustersForFit,
@@ -121,12 +124,18 @@ class ClusterFinderOriginal
   double mLowestPixelCharge = 0.;   ///< minimum charge of a pixel
   double mLowestClusterCharge = 0.; ///< minimum charge of a cluster
 
+  bool mUseLevenbergMarquardt = false; ///< fit the clusters with the Levenberg-Marquardt algorithm
+
   std::unique_ptr<MathiesonOriginal[]> mMathiesons; ///< Mathieson functions for station 1 and the others
   MathiesonOriginal* mMathieson = nullptr;          ///< pointer to the Mathieson function currently used
 
   std::unique_ptr<ClusterOriginal> mPreCluster; ///< precluster currently processed
   std::vector<PadOriginal> mPixels;             ///< list of pixels for the current precluster
 
+  std::vector<float> mAreas[4]{};       ///< xMin, yMin, xMax, yMax of the areas where to integrate the Mathieson at once
+  std::vector<float> mIntegrals{};      ///< integrals of the Mathieson over these areas
+  std::vector<double> mPadChargesFit{}; ///< charges of the pads used in the fit expected from the current parameters
+
   const mapping::Segmentation* mSegmentation = nullptr; ///< pointer to the DE segmentation for the current precluster
 
   std::vector<Cluster> mClusters{}; ///< list of reconstructed clusters
@@ -37,6 +37,8 @@ struct ClusterizerParam : public o2::conf::ConfigurableParamHelper<ClusterizerPa
 
   bool legacy = true; ///< use original (run2) clustering
 
+  bool levenbergMarquardtFit = false; ///< fit the clusters with the Levenberg-Marquardt algorithm in the original clustering
+
   O2ParamDef(ClusterizerParam, "MCHClustering");
 };
 
@@ -27,9 +27,8 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
-#include <TH2I.h>
-#include <TAxis.h>
 #include <TMath.h>
 #include <TRandom.h>
 
@@ -41,10 +40,55 @@
 #include "MCHClustering/ClusterizerParam.h"
 #include "PadOriginal.h"
 #include "ClusterOriginal.h"
+#include "PixelGridOriginal.h"
 
 namespace o2::mch
 {
 
+namespace
+{
+//_________________________________________________________________________________________________
+template <int N>
+void solveLinearSystem(double (&matrix)[N][N], double (&vector)[N], int n)
+{
+  /// solve the n x n linear system matrix.x = vector using Gaussian elimination with partial pivoting
+  /// the solution is returned in vector and its components associated to a null pivot are set to 0
+
+  for (int k = 0; k < n; ++k) {
+    int iPivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (TMath::Abs(matrix[i][k]) > TMath::Abs(matrix[iPivot][k])) {
+        iPivot = i;
+      }
+    }
+    if (iPivot != k) {
+      std::swap(matrix[k], matrix[iPivot]);
+      std::swap(vector[k], vector[iPivot]);
+    }
+    if (matrix[k][k] == 0.) {
+      continue;
+    }
+    for (int i = k + 1; i < n; ++i) {
+      double factor = matrix[i][k] / matrix[k][k];
+      for (int j = k; j < n; ++j) {
+        matrix[i][j] -= factor * matrix[k][j];
+      }
+      vector[i] -= factor * vector[k];
+    }
+  }
+  for (int k = n - 1; k >= 0; --k) {
+    if (matrix[k][k] == 0.) {
+      vector[k] = 0.;
+      continue;
+    }
+    for (int j = k + 1; j < n; ++j) {
+      vector[k] -= matrix[k][j] * vector[j];
+    }
+    vector[k] /= matrix[k][k];
+  }
+}
+} // namespace
+
 //_________________________________________________________________________________________________
 ClusterFinderOriginal::ClusterFinderOriginal()
   : mMathiesons(std::make_unique<MathiesonOriginal[]>(2)),
@@ -77,6 +121,9 @@ void ClusterFinderOriginal::init(bool run2Config)
     mLowestPixelCharge = mLowestPadCharge / 12.;
     mLowestClusterCharge = 2. * mLowestPadCharge;
 
+    // fit the clusters with the original algorithm
+    mUseLevenbergMarquardt = false;
+
     // Mathieson function for station 1
     mMathiesons[0].setPitch(0.21);
     mMathiesons[0].setSqrtKx3AndDeriveKx2Kx4(0.7000);
@@ -94,6 +141,9 @@ void ClusterFinderOriginal::init(bool run2Config)
     mLowestPixelCharge = mLowestPadCharge / 12.;
     mLowestClusterCharge = 2. * mLowestPadCharge;
 
+    // fitting algorithm
+    mUseLevenbergMarquardt = ClusterizerParam::Instance().levenbergMarquardtFit;
+
     // Mathieson function for station 1
     mMathiesons[0].setPitch(ResponseParam::Instance().pitchSt1);
     mMathiesons[0].setSqrtKx3AndDeriveKx2Kx4(ResponseParam::Instance().mathiesonSqrtKx3St1);
@@ -402,9 +452,9 @@ void ClusterFinderOriginal::processPreCluster()
   } else {
 
     // find the local maxima in the pixel array
-    std::unique_ptr<TH2D> histAnode(nullptr);
+    PixelGridOriginal<double> gridAnode{};
     std::multimap<double, std::pair<int, int>, std::greater<>> localMaxima{};
-    findLocalMaxima(histAnode, localMaxima);
+    findLocalMaxima(gridAnode, localMaxima);
     if (localMaxima.empty()) {
       return;
     }
@@ -420,7 +470,7 @@ void ClusterFinderOriginal::processPreCluster()
       for (const auto& localMaximum : localMaxima) {
 
         // select the part of the precluster that is around the local maximum
-        restrictPreCluster(*histAnode, localMaximum.second.first, localMaximum.second.second);
+        restrictPreCluster(gridAnode, localMaximum.second.first, localMaximum.second.second);
 
         // treat it
         process();
@@ -490,23 +540,23 @@ void ClusterFinderOriginal::buildPixArray()
     area[ixy][1] = area[ixy][0] + nbins[ixy] * width[ixy] * 2.;
   }
 
-  // book pixel histograms and fill them
-  TH2D hCharges("Charges", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
-  TH2I hEntries("Entries", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  // book pixel grids and fill them
+  PixelGridOriginal<double> charges(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  PixelGridOriginal<int> entries(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
   for (const auto& pad : *mPreCluster) {
-    ProjectPadOverPixels(pad, hCharges, hEntries);
+    ProjectPadOverPixels(pad, charges, entries);
   }
 
   // store fired pixels with an entry from both planes if both planes are fired
   for (int i = 1; i <= nbins[0]; ++i) {
-    double x = hCharges.GetXaxis()->GetBinCenter(i);
+    double x = charges.binCenter(0, i);
     for (int j = 1; j <= nbins[1]; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
-      if (entries == 0 || (plane0 != plane1 && (entries < 1000 || entries % 1000 < 1))) {
+      int nEntries = entries.content(i, j);
+      if (nEntries == 0 || (plane0 != plane1 && (nEntries < 1000 || nEntries % 1000 < 1))) {
         continue;
       }
-      double y = hCharges.GetYaxis()->GetBinCenter(j);
-      double charge = hCharges.GetBinContent(i, j);
+      double y = charges.binCenter(1, j);
+      double charge = charges.content(i, j);
       mPixels.emplace_back(x, y, width[0], width[1], charge);
     }
   }
@@ -530,39 +580,37 @@ void ClusterFinderOriginal::buildPixArray()
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const
+void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, PixelGridOriginal<double>& charges,
+                                                 PixelGridOriginal<int>& entries) const
 {
-  /// project the pad over pixel histograms
-
-  const TAxis* xaxis = hCharges.GetXaxis();
-  const TAxis* yaxis = hCharges.GetYaxis();
+  /// project the pad over pixel grids
 
-  int iMin = TMath::Max(1, xaxis->FindBin(pad.x() - pad.dx() + SDistancePrecision));
-  int iMax = TMath::Min(hCharges.GetNbinsX(), xaxis->FindBin(pad.x() + pad.dx() - SDistancePrecision));
-  int jMin = TMath::Max(1, yaxis->FindBin(pad.y() - pad.dy() + SDistancePrecision));
-  int jMax = TMath::Min(hCharges.GetNbinsY(), yaxis->FindBin(pad.y() + pad.dy() - SDistancePrecision));
+  int iMin = TMath::Max(1, charges.findBin(0, pad.x() - pad.dx() + SDistancePrecision));
+  int iMax = TMath::Min(charges.nBins(0), charges.findBin(0, pad.x() + pad.dx() - SDistancePrecision));
+  int jMin = TMath::Max(1, charges.findBin(1, pad.y() - pad.dy() + SDistancePrecision));
+  int jMax = TMath::Min(charges.nBins(1), charges.findBin(1, pad.y() + pad.dy() - SDistancePrecision));
 
   double charge = pad.charge();
   int entry = 1 + pad.plane() * 999;
 
-  for (int i = iMin; i <= iMax; ++i) {
-    for (int j = jMin; j <= jMax; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
-      hCharges.SetBinContent(i, j, (entries > 0) ? TMath::Min(hCharges.GetBinContent(i, j), charge) : charge);
-      hEntries.SetBinContent(i, j, entries + entry);
+  for (int j = jMin; j <= jMax; ++j) {
+    for (int i = iMin; i <= iMax; ++i) {
+      int nEntries = entries.content(i, j);
+      charges.setContent(i, j, (nEntries > 0) ? TMath::Min(charges.content(i, j), charge) : charge);
+      entries.setContent(i, j, nEntries + entry);
     }
   }
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
+void ClusterFinderOriginal::findLocalMaxima(PixelGridOriginal<double>& gridAnode,
                                             std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima)
 {
   /// find local maxima in pixel space for large preclusters in order to
   /// try to split them into smaller pieces (to speed up the MLEM procedure)
   /// and tag the corresponding pixels
 
-  // create a 2D histogram from the pixel array
+  // create a 2D grid from the pixel array
   double xMin(std::numeric_limits<double>::max()), xMax(-std::numeric_limits<double>::max());
   double yMin(std::numeric_limits<double>::max()), yMax(-std::numeric_limits<double>::max());
   double dx(mPixels.front().dx()), dy(mPixels.front().dy());
@@ -574,29 +622,27 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
   }
   int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
   int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-  histAnode = std::make_unique<TH2D>("anode", "anode", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+  gridAnode.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
   for (const auto& pixel : mPixels) {
-    histAnode->Fill(pixel.x(), pixel.y(), pixel.charge());
+    gridAnode.fill(pixel.x(), pixel.y(), pixel.charge());
   }
 
   // find the local maxima
-  std::vector<std::vector<int>> isLocalMax(nBinsX, std::vector<int>(nBinsY, 0));
+  std::vector<int> isLocalMax(gridAnode.size(), 0);
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (isLocalMax[i - 1][j - 1] == 0 && histAnode->GetBinContent(i, j) >= mLowestPixelCharge) {
-        flagLocalMaxima(*histAnode, i, j, isLocalMax);
+      if (isLocalMax[gridAnode.index(i, j)] == 0 && gridAnode.content(i, j) >= mLowestPixelCharge) {
+        flagLocalMaxima(gridAnode, i, j, isLocalMax);
       }
     }
   }
 
   // store local maxima and tag corresponding pixels
-  TAxis* xAxis = histAnode->GetXaxis();
-  TAxis* yAxis = histAnode->GetYaxis();
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (isLocalMax[i - 1][j - 1] > 0) {
-        localMaxima.emplace(histAnode->GetBinContent(i, j), std::make_pair(i, j));
-        auto itPixel = findPad(mPixels, xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), mLowestPixelCharge);
+      if (isLocalMax[gridAnode.index(i, j)] > 0) {
+        localMaxima.emplace(gridAnode.content(i, j), std::make_pair(i, j));
+        auto itPixel = findPad(mPixels, gridAnode.binCenter(0, i), gridAnode.binCenter(1, j), mLowestPixelCharge);
         itPixel->setStatus(PadOriginal::kMustKeep);
         if (localMaxima.size() > 99) {
           break;
@@ -612,72 +658,68 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const
+void ClusterFinderOriginal::flagLocalMaxima(const PixelGridOriginal<double>& gridAnode, int i0, int j0, std::vector<int>& isLocalMax) const
 {
   /// flag the bin (i,j) as a local maximum or not by comparing its charge to the one of its neighbours
   /// and flag the neighbours accordingly (recursive procedure in case the charges are equal)
 
-  int idxi0 = i0 - 1;
-  int idxj0 = j0 - 1;
-  int charge0 = TMath::Nint(histAnode.GetBinContent(i0, j0));
+  int idx0 = gridAnode.index(i0, j0);
+  int charge0 = TMath::Nint(gridAnode.content(i0, j0));
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridAnode.nBins(0), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridAnode.nBins(1), j0 + 1);
 
   for (int j = jMin; j <= jMax; ++j) {
-    int idxj = j - 1;
     for (int i = iMin; i <= iMax; ++i) {
       if (i == i0 && j == j0) {
         continue;
       }
-      int idxi = i - 1;
-      int charge = TMath::Nint(histAnode.GetBinContent(i, j));
+      int idx = gridAnode.index(i, j);
+      int charge = TMath::Nint(gridAnode.content(i, j));
       if (charge0 < charge) {
-        isLocalMax[idxi0][idxj0] = -1;
+        isLocalMax[idx0] = -1;
         return;
       } else if (charge0 > charge) {
-        isLocalMax[idxi][idxj] = -1;
-      } else if (isLocalMax[idxi][idxj] == -1) {
-        isLocalMax[idxi0][idxj0] = -1;
+        isLocalMax[idx] = -1;
+      } else if (isLocalMax[idx] == -1) {
+        isLocalMax[idx0] = -1;
         return;
-      } else if (isLocalMax[idxi][idxj] == 0) {
-        isLocalMax[idxi0][idxj0] = 1;
-        flagLocalMaxima(histAnode, i, j, isLocalMax);
-        if (isLocalMax[idxi][idxj] == -1) {
-          isLocalMax[idxi0][idxj0] = -1;
+      } else if (isLocalMax[idx] == 0) {
+        isLocalMax[idx0] = 1;
+        flagLocalMaxima(gridAnode, i, j, isLocalMax);
+        if (isLocalMax[idx] == -1) {
+          isLocalMax[idx0] = -1;
           return;
         } else {
-          isLocalMax[idxi][idxj] = -2;
+          isLocalMax[idx] = -2;
         }
       }
     }
   }
-  isLocalMax[idxi0][idxj0] = 1;
+  isLocalMax[idx0] = 1;
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::restrictPreCluster(const TH2D& histAnode, int i0, int j0)
+void ClusterFinderOriginal::restrictPreCluster(const PixelGridOriginal<double>& gridAnode, int i0, int j0)
 {
   /// keep in the pixel array only the ones around the local maximum
   /// and tag the pads in the precluster that overlap with them
 
   // drop all pixels from the array and put back the ones around the local maximum
   mPixels.clear();
-  const TAxis* xAxis = histAnode.GetXaxis();
-  const TAxis* yAxis = histAnode.GetYaxis();
-  double dx = xAxis->GetBinWidth(1) / 2.;
-  double dy = yAxis->GetBinWidth(1) / 2.;
-  double charge0 = histAnode.GetBinContent(i0, j0);
+  double dx = gridAnode.binWidth(0) / 2.;
+  double dy = gridAnode.binWidth(1) / 2.;
+  double charge0 = gridAnode.content(i0, j0);
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridAnode.nBins(0), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridAnode.nBins(1), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      double charge = histAnode.GetBinContent(i, j);
+      double charge = gridAnode.content(i, j);
       if (charge >= mLowestPixelCharge && charge <= charge0) {
-        mPixels.emplace_back(xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), dx, dy, charge);
+        mPixels.emplace_back(gridAnode.binCenter(0, i), gridAnode.binCenter(1, j), dx, dy, charge);
       }
     }
   }
@@ -781,7 +823,7 @@ void ClusterFinderOriginal::process()
 
   std::vector<double> coef(0);
   std::vector<double> prob(0);
-  std::unique_ptr<TH2D> histMLEM(nullptr);
+  PixelGridOriginal<double> gridMLEM{};
   while (true) {
 
     // calculate pad-pixel coupling coefficients and pixel visibilities
@@ -802,14 +844,13 @@ void ClusterFinderOriginal::process()
       return;
     }
 
-    // create a 2D histogram from the pixel array
+    // create a 2D grid from the pixel array
     double dx(mPixels.front().dx()), dy(mPixels.front().dy());
     int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
     int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-    histMLEM.reset(nullptr); // delete first to avoid "Replacing existing TH1: mlem (Potential memory leak)"
-    histMLEM = std::make_unique<TH2D>("mlem", "mlem", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+    gridMLEM.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
     for (const auto& pixel : mPixels) {
-      histMLEM->Fill(pixel.x(), pixel.y(), pixel.charge());
+      gridMLEM.fill(pixel.x(), pixel.y(), pixel.charge());
     }
 
     // stop here if the pixel size is small enough
@@ -819,14 +860,14 @@ void ClusterFinderOriginal::process()
 
     // calculate the position of the center-of-gravity around the pixel with maximum charge
     double xyCOG[2] = {0., 0.};
-    findCOG(*histMLEM, xyCOG);
+    findCOG(gridMLEM, xyCOG);
 
     // decrease the pixel size and align the array with the position of the center-of-gravity
     refinePixelArray(xyCOG, npadOK, xMin, xMax, yMin, yMax);
   }
 
   // discard pixels with low visibility by moving their charge to their nearest neighbour (cuts are empirical !!!)
-  double threshold = TMath::Min(TMath::Max(histMLEM->GetMaximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
+  double threshold = TMath::Min(TMath::Max(gridMLEM.maximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
   cleanPixelArray(threshold, prob);
 
   // re-run the MLEM algorithm with 2 iterations
@@ -837,13 +878,13 @@ void ClusterFinderOriginal::process()
     return;
   }
 
-  // update the histogram
+  // update the grid
   for (const auto& pixel : mPixels) {
-    histMLEM->SetBinContent(histMLEM->GetXaxis()->FindBin(pixel.x()), histMLEM->GetYaxis()->FindBin(pixel.y()), pixel.charge());
+    gridMLEM.set(pixel.x(), pixel.y(), pixel.charge());
   }
 
   // split the precluster into clusters
-  split(*histMLEM, coef);
+  split(gridMLEM, coef);
 }
 
 //_________________________________________________________________________________________________
@@ -956,26 +997,44 @@ void ClusterFinderOriginal::addVirtualPad()
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::computeCoefficients(std::vector<double>& coef, std::vector<double>& prob) const
+void ClusterFinderOriginal::computeCoefficients(std::vector<double>& coef, std::vector<double>& prob)
 {
   /// Compute pad-pixel coupling coefficients and pixel visibilities needed for the MLEM algorithm
 
-  coef.assign(mPreCluster->multiplicity() * mPixels.size(), 0.);
-  prob.assign(mPixels.size(), 0.);
+  int nPixels = mPixels.size();
+  coef.assign(mPreCluster->multiplicity() * nPixels, 0.);
+  prob.assign(nPixels, 0.);
+
+  for (auto& area : mAreas) {
+    area.resize(nPixels);
+  }
+  mIntegrals.resize(nPixels);
 
   int iCoef(0);
   for (const auto& pad : *mPreCluster) {
 
     // ignore the pads that must not be considered
     if (pad.status() != PadOriginal::kZero) {
-      iCoef += mPixels.size();
+      iCoef += nPixels;
       continue;
     }
 
-    for (int i = 0; i < mPixels.size(); ++i) {
+    // area of the pad relative to each pixel, assuming the Mathieson is center at pixel
+    for (int i = 0; i < nPixels; ++i) {
+      double xPad = pad.x() - mPixels[i].x();
+      double yPad = pad.y() - mPixels[i].y();
+      mAreas[0][i] = xPad - pad.dx();
+      mAreas[1][i] = yPad - pad.dy();
+      mAreas[2][i] = xPad + pad.dx();
+      mAreas[3][i] = yPad + pad.dy();
+    }
+
+    // charge (given by Mathieson integral) on pad for all the pixels at once
+    mMathieson->integrate(nPixels, mAreas[0].data(), mAreas[1].data(), mAreas[2].data(), mAreas[3].data(), mIntegrals.data());
 
-      // charge (given by Mathieson integral) on pad, assuming the Mathieson is center at pixel.
-      coef[iCoef] = chargeIntegration(mPixels[i].x(), mPixels[i].y(), pad);
+    for (int i = 0; i < nPixels; ++i) {
+
+      coef[iCoef] = mIntegrals[i];
 
       // update the pixel visibility
       prob[i] += coef[iCoef];
@@ -1061,29 +1120,27 @@ double ClusterFinderOriginal::mlem(const std::vector<double>& coef, const std::v
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
+void ClusterFinderOriginal::findCOG(const PixelGridOriginal<double>& gridMLEM, double xy[2]) const
 {
   /// calculate the position of the center-of-gravity around the pixel with maximum charge
 
   // define the range of pixels and the minimum charge to consider
-  int ix0(0), iy0(0), iz0(0);
-  double chargeThreshold = histMLEM.GetBinContent(histMLEM.GetMaximumBin(ix0, iy0, iz0)) / 10.;
+  int ix0(0), iy0(0);
+  double chargeThreshold = gridMLEM.maximum(ix0, iy0) / 10.;
   int ixMin = TMath::Max(1, ix0 - 1);
-  int ixMax = TMath::Min(histMLEM.GetNbinsX(), ix0 + 1);
+  int ixMax = TMath::Min(gridMLEM.nBins(0), ix0 + 1);
   int iyMin = TMath::Max(1, iy0 - 1);
-  int iyMax = TMath::Min(histMLEM.GetNbinsY(), iy0 + 1);
+  int iyMax = TMath::Min(gridMLEM.nBins(1), iy0 + 1);
 
   // first only consider pixels above threshold
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
   double xq(0.), yq(0.), q(0.);
   bool onePixelWidthX(true), onePixelWidthY(true);
   for (int iy = iyMin; iy <= iyMax; ++iy) {
     for (int ix = ixMin; ix <= ixMax; ++ix) {
-      double charge = histMLEM.GetBinContent(ix, iy);
+      double charge = gridMLEM.content(ix, iy);
       if (charge >= chargeThreshold) {
-        xq += xAxis->GetBinCenter(ix) * charge;
-        yq += yAxis->GetBinCenter(iy) * charge;
+        xq += gridMLEM.binCenter(0, ix) * charge;
+        yq += gridMLEM.binCenter(1, iy) * charge;
         q += charge;
         if (ix != ix0) {
           onePixelWidthX = false;
@@ -1102,10 +1159,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int iy = iyMin; iy <= iyMax; ++iy) {
       if (iy != iy0) {
         for (int ix = ixMin; ix <= ixMax; ++ix) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = gridMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = gridMLEM.binCenter(0, ix);
+            yPixel = gridMLEM.binCenter(1, iy);
             chargePixel = charge;
             ixPixel = ix;
           }
@@ -1126,10 +1183,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int ix = ixMin; ix <= ixMax; ++ix) {
       if (ix != ix0) {
         for (int iy = iyMin; iy <= iyMax; ++iy) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = gridMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = gridMLEM.binCenter(0, ix);
+            yPixel = gridMLEM.binCenter(1, iy);
             chargePixel = charge;
           }
         }
@@ -1402,7 +1459,8 @@ int ClusterFinderOriginal::fit(const std::vector<const std::vector<int>*>& clust
     nParamUsed = 3 * nFitClusters - 1;
 
     // do the fit
-    double chi2 = fit(param, parmin, parmax, nParamUsed, nTrials);
+    double chi2 = mUseLevenbergMarquardt ? fitLevenbergMarquardt(param, parmin, parmax, nParamUsed, nTrials)
+                                         : fit(param, parmin, parmax, nParamUsed, nTrials);
 
     // stop here if the normalized chi2 is not (significantly) smaller than in the previous fit
     int dof = TMath::Max(nRealPadsToFit + nVirtualPadsToFit - nParamUsed, 1);
@@ -1458,7 +1516,7 @@ int ClusterFinderOriginal::fit(const std::vector<const std::vector<int>*>& clust
 //_________________________________________________________________________________________________
 double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
                                   const double parmin[SNFitParamMax], const double parmax[SNFitParamMax],
-                                  int nParamUsed, int& nTrials) const
+                                  int nParamUsed, int& nTrials)
 {
   /// perform the fit with a custom algorithm, using currentParam as starting parameters
   /// update currentParam with the fitted parameters and return the corresponding chi2
@@ -1635,7 +1693,138 @@ double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
 }
 
 //_________________________________________________________________________________________________
-double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2], int nParamUsed) const
+double ClusterFinderOriginal::fitLevenbergMarquardt(double currentParam[SNFitParamMax + 2],
+                                                    const double parmin[SNFitParamMax], const double parmax[SNFitParamMax],
+                                                    int nParamUsed, int& nTrials)
+{
+  /// perform the fit with the Levenberg-Marquardt algorithm, using currentParam as starting parameters
+  /// the residuals are the normalized differences between fitted and measured charges of the pads used in the fit
+  /// and their derivatives are computed numerically with the same step as in the custom algorithm
+  /// update currentParam with the fitted parameters and return the corresponding chi2
+
+  // step size in x, y and charge fraction used to compute the derivatives and check the convergence
+  static const double defaultShift[SNFitParamMax] = {0.01, 0.002, 0.02, 0.01, 0.002, 0.02, 0.01, 0.002};
+
+  // compute the residuals and the chi2 with the current parameters
+  int nPads = computePadChargesFit(currentParam, nParamUsed);
+  ++nTrials;
+  std::vector<double> weight(nPads, 0.);
+  std::vector<double> charge(nPads, 0.);
+  int iPad(0);
+  for (const auto& pad : *mPreCluster) {
+    if (pad.status() == PadOriginal::kUseForFit) {
+      weight[iPad] = 1. / TMath::Sqrt(pad.charge() * currentParam[SNFitParamMax + 1]);
+      charge[iPad++] = pad.charge();
+    }
+  }
+  std::vector<double> residual(nPads, 0.);
+  double chi2(0.);
+  for (iPad = 0; iPad < nPads; ++iPad) {
+    residual[iPad] = (mPadChargesFit[iPad] - charge[iPad]) * weight[iPad];
+    chi2 += residual[iPad] * residual[iPad];
+  }
+
+  std::vector<double> jacobian(nParamUsed * nPads, 0.);
+  double param[SNFitParamMax + 2] = {0.};
+  std::copy(currentParam, currentParam + SNFitParamMax + 2, param);
+  double lambda(1.e-3);
+
+  for (int iter = 0; iter < 50 && nTrials <= 2000; ++iter) {
+
+    // compute the derivatives of the residuals w.r.t. each parameter
+    for (int i = 0; i < nParamUsed; ++i) {
+      param[i] = currentParam[i] + defaultShift[i] / 10.;
+      computePadChargesFit(param, nParamUsed);
+      ++nTrials;
+      for (iPad = 0; iPad < nPads; ++iPad) {
+        double residualShift = (mPadChargesFit[iPad] - charge[iPad]) * weight[iPad];
+        jacobian[i * nPads + iPad] = (residualShift - residual[iPad]) / defaultShift[i] * 10.;
+      }
+      param[i] = currentParam[i];
+    }
+
+    // compute the approximate Hessian J^T.J and the gradient J^T.r
+    double hessian[SNFitParamMax][SNFitParamMax] = {{0.}};
+    double gradient[SNFitParamMax] = {0.};
+    for (int i = 0; i < nParamUsed; ++i) {
+      const double* ji = &jacobian[i * nPads];
+      for (iPad = 0; iPad < nPads; ++iPad) {
+        gradient[i] += ji[iPad] * residual[iPad];
+      }
+      for (int j = 0; j <= i; ++j) {
+        const double* jj = &jacobian[j * nPads];
+        double sum(0.);
+        for (iPad = 0; iPad < nPads; ++iPad) {
+          sum += ji[iPad] * jj[iPad];
+        }
+        hessian[i][j] = hessian[j][i] = sum;
+      }
+    }
+
+    // find a step that improves the chi2, increasing the damping until it does
+    bool improved(false);
+    double stepMax(0.);
+    double chi2New(0.);
+    while (lambda < 1.e6 && nTrials <= 2000) {
+
+      double step[SNFitParamMax] = {0.};
+      double matrix[SNFitParamMax][SNFitParamMax] = {{0.}};
+      for (int i = 0; i < nParamUsed; ++i) {
+        for (int j = 0; j < nParamUsed; ++j) {
+          matrix[i][j] = hessian[i][j];
+        }
+        matrix[i][i] *= 1. + lambda;
+        step[i] = -gradient[i];
+      }
+      solveLinearSystem(matrix, step, nParamUsed);
+
+      // move the parameters and make sure we do not overstep their limits
+      stepMax = 0.;
+      for (int i = 0; i < nParamUsed; ++i) {
+        param[i] = TMath::Min(TMath::Max(currentParam[i] + step[i], parmin[i]), parmax[i]);
+        stepMax = TMath::Max(stepMax, TMath::Abs(param[i] - currentParam[i]) / defaultShift[i]);
+      }
+
+      computePadChargesFit(param, nParamUsed);
+      ++nTrials;
+      chi2New = 0.;
+      for (iPad = 0; iPad < nPads; ++iPad) {
+        double delta = (mPadChargesFit[iPad] - charge[iPad]) * weight[iPad];
+        chi2New += delta * delta;
+      }
+
+      if (chi2New < chi2) {
+        improved = true;
+        lambda = TMath::Max(lambda / 10., 1.e-7);
+        break;
+      }
+      lambda *= 10.;
+    }
+
+    // stop here if no better parameters can be found
+    if (!improved) {
+      break;
+    }
+
+    // accept the new parameters and the associated residuals
+    std::copy(param, param + nParamUsed, currentParam);
+    for (iPad = 0; iPad < nPads; ++iPad) {
+      residual[iPad] = (mPadChargesFit[iPad] - charge[iPad]) * weight[iPad];
+    }
+    double chi2Change = chi2 - chi2New;
+    chi2 = chi2New;
+
+    // stop here if the minimum was found
+    if (stepMax < 0.1 || chi2Change < 1.e-4 * chi2) {
+      break;
+    }
+  }
+
+  return chi2;
+}
+
+//_________________________________________________________________________________________________
+double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2], int nParamUsed)
 {
   /// return the chi2 to be minimized when fitting the selected part of the precluster
   /// param[0... SNFitParamMax-1] are the cluster parameters
@@ -1643,11 +1832,11 @@ double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2],
   /// param[SNFitParamMax+1] is the average pad charge
   /// nParamUsed is the number of cluster parameters effectively used (= #cluster * 3 - 1)
 
-  // get the fraction of charge carried by each cluster
-  double chargeFraction[SNFitClustersMax] = {0.};
-  param2ChargeFraction(param, nParamUsed, chargeFraction);
+  // compute the expected pad charges with these cluster parameters
+  computePadChargesFit(param, nParamUsed);
 
   double chi2(0.);
+  int iPad(0);
   for (const auto& pad : *mPreCluster) {
 
     // skip pads not to be used for this fit
@@ -1655,21 +1844,63 @@ double ClusterFinderOriginal::computeChi2(const double param[SNFitParamMax + 2],
       continue;
     }
 
-    // compute the expected pad charge with these cluster parameters
-    double padChargeFit(0.);
-    for (int iParam = 0; iParam < nParamUsed; iParam += 3) {
-      padChargeFit += chargeIntegration(param[iParam], param[iParam + 1], pad) * chargeFraction[iParam / 3];
-    }
-    padChargeFit *= param[SNFitParamMax];
-
     // compute the chi2
-    double delta = padChargeFit - pad.charge();
+    double delta = mPadChargesFit[iPad++] - pad.charge();
     chi2 += delta * delta / pad.charge();
   }
 
   return chi2 / param[SNFitParamMax + 1];
 }
 
+//_________________________________________________________________________________________________
+int ClusterFinderOriginal::computePadChargesFit(const double param[SNFitParamMax + 2], int nParamUsed)
+{
+  /// compute the charges expected on the pads used in the fit with these cluster parameters
+  /// the Mathieson is integrated over all these pads for all the clusters at once
+  /// store them in mPadChargesFit in the order of the precluster and return the number of pads
+
+  // get the fraction of charge carried by each cluster
+  double chargeFraction[SNFitClustersMax] = {0.};
+  param2ChargeFraction(param, nParamUsed, chargeFraction);
+
+  // area of the pads relative to each cluster
+  int nClusters = (nParamUsed + 1) / 3;
+  for (auto& area : mAreas) {
+    area.clear();
+  }
+  for (int iParam = 0; iParam < nParamUsed; iParam += 3) {
+    for (const auto& pad : *mPreCluster) {
+      if (pad.status() == PadOriginal::kUseForFit) {
+        double xPad = pad.x() - param[iParam];
+        double yPad = pad.y() - param[iParam + 1];
+        mAreas[0].push_back(xPad - pad.dx());
+        mAreas[1].push_back(yPad - pad.dy());
+        mAreas[2].push_back(xPad + pad.dx());
+        mAreas[3].push_back(yPad + pad.dy());
+      }
+    }
+  }
+  int nPads = mAreas[0].size() / nClusters;
+
+  // integrate the Mathieson over these areas
+  mIntegrals.resize(mAreas[0].size());
+  mMathieson->integrate(mAreas[0].size(), mAreas[0].data(), mAreas[1].data(), mAreas[2].data(), mAreas[3].data(), mIntegrals.data());
+
+  // sum the contributions of all clusters
+  mPadChargesFit.assign(nPads, 0.);
+  for (int iCluster = 0; iCluster < nClusters; ++iCluster) {
+    const float* integrals = &mIntegrals[iCluster * nPads];
+    for (int iPad = 0; iPad < nPads; ++iPad) {
+      mPadChargesFit[iPad] += integrals[iPad] * chargeFraction[iCluster];
+    }
+  }
+  for (auto& padChargeFit : mPadChargesFit) {
+    padChargeFit *= param[SNFitParamMax];
+  }
+
+  return nPads;
+}
+
 //_________________________________________________________________________________________________
 void ClusterFinderOriginal::param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed,
                                                  double fraction[SNFitClustersMax]) const
@@ -1697,7 +1928,7 @@ float ClusterFinderOriginal::chargeIntegration(double x, double y, const PadOrig
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double>& coef)
+void ClusterFinderOriginal::split(const PixelGridOriginal<double>& gridMLEM, const std::vector<double>& coef)
 {
   /// group the pixels in clusters then group together the clusters coupled to the same pads,
   /// split them into sub-groups if they are too many, merge them if they are not coupled to enough pads
@@ -1711,16 +1942,16 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // find clusters of pixels
-  int nBinsX = histMLEM.GetNbinsX();
-  int nBinsY = histMLEM.GetNbinsY();
+  int nBinsX = gridMLEM.nBins(0);
+  int nBinsY = gridMLEM.nBins(1);
   std::vector<std::vector<int>> clustersOfPixels{};
-  std::vector<std::vector<bool>> isUsed(nBinsX, std::vector<bool>(nBinsY, false));
+  std::vector<bool> isUsed(gridMLEM.size(), false);
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (!isUsed[i - 1][j - 1] && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
+      if (!isUsed[gridMLEM.index(i, j)] && gridMLEM.content(i, j) >= mLowestPixelCharge) {
         // add a new cluster of pixels and the associated pixels recursively
         clustersOfPixels.emplace_back();
-        addPixel(histMLEM, i, j, clustersOfPixels.back(), isUsed);
+        addPixel(gridMLEM, i, j, clustersOfPixels.back(), isUsed);
       }
     }
   }
@@ -1763,10 +1994,8 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // define the fit range
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
-  double fitRange[2][2] = {{xAxis->GetXmin() - xAxis->GetBinWidth(1), xAxis->GetXmax() + xAxis->GetBinWidth(1)},
-                           {yAxis->GetXmin() - yAxis->GetBinWidth(1), yAxis->GetXmax() + yAxis->GetBinWidth(1)}};
+  double fitRange[2][2] = {{gridMLEM.min(0) - gridMLEM.binWidth(0), gridMLEM.max(0) + gridMLEM.binWidth(0)},
+                           {gridMLEM.min(1) - gridMLEM.binWidth(1), gridMLEM.max(1) + gridMLEM.binWidth(1)}};
 
   std::vector<bool> isClUsed(clustersOfPixels.size(), false);
   std::vector<int> coupledClusters{};
@@ -1832,23 +2061,23 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed)
+void ClusterFinderOriginal::addPixel(const PixelGridOriginal<double>& gridMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<bool>& isUsed)
 {
   /// add a pixel to the cluster of pixels then add recursively its neighbours,
   /// if their charge is higher than mLowestPixelCharge and excluding corners
 
-  auto itPixel = findPad(mPixels, histMLEM.GetXaxis()->GetBinCenter(i0), histMLEM.GetYaxis()->GetBinCenter(j0), mLowestPixelCharge);
+  auto itPixel = findPad(mPixels, gridMLEM.binCenter(0, i0), gridMLEM.binCenter(1, j0), mLowestPixelCharge);
   pixels.push_back(std::distance(mPixels.begin(), itPixel));
-  isUsed[i0 - 1][j0 - 1] = true;
+  isUsed[gridMLEM.index(i0, j0)] = true;
 
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histMLEM.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridMLEM.nBins(0), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histMLEM.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridMLEM.nBins(1), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      if (!isUsed[i - 1][j - 1] && (i == i0 || j == j0) && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
-        addPixel(histMLEM, i, j, pixels, isUsed);
+      if (!isUsed[gridMLEM.index(i, j)] && (i == i0 || j == j0) && gridMLEM.content(i, j) >= mLowestPixelCharge) {
+        addPixel(gridMLEM, i, j, pixels, isUsed);
       }
     }
   }
@@ -0,0 +1,135 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PixelGridOriginal.h
+/// \brief Definition of a regular grid of pixels used by the original MLEM algorithm
+
+#ifndef O2_MCH_PIXELGRIDORIGINAL_H_
+#define O2_MCH_PIXELGRIDORIGINAL_H_
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace o2
+{
+namespace mch
+{
+
+/// regular 2D grid of pixels with contiguous storage, replacing the TH2 histograms of the original implementation
+/// bins are numbered from 1 to nBins in each direction and the binning arithmetic is the one of TAxis,
+/// so that the algorithm is unchanged, but there is no underflow/overflow: values outside the grid are dropped
+template <typename T>
+class PixelGridOriginal
+{
+ public:
+  PixelGridOriginal() = default;
+  PixelGridOriginal(int nBinsX, double xMin, double xMax, int nBinsY, double yMin, double yMax)
+  {
+    reset(nBinsX, xMin, xMax, nBinsY, yMin, yMax);
+  }
+  ~PixelGridOriginal() = default;
+
+  PixelGridOriginal(const PixelGridOriginal&) = default;
+  PixelGridOriginal& operator=(const PixelGridOriginal&) = default;
+  PixelGridOriginal(PixelGridOriginal&&) = default;
+  PixelGridOriginal& operator=(PixelGridOriginal&&) = default;
+
+  /// redefine the grid and set all the contents to 0, reusing the allocated memory
+  void reset(int nBinsX, double xMin, double xMax, int nBinsY, double yMin, double yMax)
+  {
+    mNBins[0] = nBinsX;
+    mNBins[1] = nBinsY;
+    mMin[0] = xMin;
+    mMin[1] = yMin;
+    mMax[0] = xMax;
+    mMax[1] = yMax;
+    mContents.assign(nBinsX * nBinsY, T(0));
+  }
+
+  /// return the number of bins in x or y direction
+  int nBins(int ixy) const { return mNBins[ixy]; }
+  /// return the total number of bins
+  int size() const { return mContents.size(); }
+
+  /// return the lower edge of the grid in x or y direction
+  double min(int ixy) const { return mMin[ixy]; }
+  /// return the upper edge of the grid in x or y direction
+  double max(int ixy) const { return mMax[ixy]; }
+  /// return the bin width in x or y direction
+  double binWidth(int ixy) const { return (mMax[ixy] - mMin[ixy]) / mNBins[ixy]; }
+  /// return the center of the bin i (1 to nBins) in x or y direction
+  double binCenter(int ixy, int i) const
+  {
+    double width = binWidth(ixy);
+    return mMin[ixy] + (i - 1) * width + 0.5 * width;
+  }
+  /// return the bin (1 to nBins) containing the position in x or y direction, 0 or nBins+1 if outside
+  int findBin(int ixy, double xy) const
+  {
+    if (xy < mMin[ixy]) {
+      return 0;
+    } else if (!(xy < mMax[ixy])) {
+      return mNBins[ixy] + 1;
+    }
+    return 1 + int(mNBins[ixy] * (xy - mMin[ixy]) / (mMax[ixy] - mMin[ixy]));
+  }
+
+  /// return the index of the bin (i,j) in the contiguous storage, x direction running fastest
+  int index(int i, int j) const { return (j - 1) * mNBins[0] + i - 1; }
+
+  /// return the content of the bin (i,j)
+  T content(int i, int j) const { return mContents[index(i, j)]; }
+  /// set the content of the bin (i,j)
+  void setContent(int i, int j, T value) { mContents[index(i, j)] = value; }
+
+  /// set the content of the bin containing the position (x,y), if any
+  void set(double x, double y, T value)
+  {
+    int i = findBin(0, x);
+    int j = findBin(1, y);
+    if (i > 0 && i <= mNBins[0] && j > 0 && j <= mNBins[1]) {
+      setContent(i, j, value);
+    }
+  }
+  /// add the value to the content of the bin containing the position (x,y), if any
+  void fill(double x, double y, T value)
+  {
+    int i = findBin(0, x);
+    int j = findBin(1, y);
+    if (i > 0 && i <= mNBins[0] && j > 0 && j <= mNBins[1]) {
+      mContents[index(i, j)] += value;
+    }
+  }
+
+  /// return the maximum content and the first bin (i,j) where it is found, looping over x first
+  T maximum(int& i, int& j) const
+  {
+    auto itMax = std::max_element(mContents.begin(), mContents.end());
+    int idx = std::distance(mContents.begin(), itMax);
+    i = idx % mNBins[0] + 1;
+    j = idx / mNBins[0] + 1;
+    return *itMax;
+  }
+  /// return the maximum content
+  T maximum() const { return *std::max_element(mContents.begin(), mContents.end()); }
+
+ private:
+  int mNBins[2] = {0, 0};     ///< number of bins in x and y directions
+  double mMin[2] = {0., 0.};  ///< lower edges of the grid in x and y directions
+  double mMax[2] = {0., 0.};  ///< upper edges of the grid in x and y directions
+  std::vector<T> mContents{}; ///< contents of the bins, x direction running fastest
+};
+
+} // namespace mch
+} // namespace o2
+
+#endif // O2_MCH_PIXELGRIDORIGINAL_H_
@@ -0,0 +1,108 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchClusterFinderOriginal.cxx
+/// \brief Time of the original clustering of recorded preclusters, with the custom or the Levenberg-Marquardt fit
+///
+/// The preclusters are read from a binary file written by o2-mch-preclusters-sink-workflow,
+/// given as the first argument after the benchmark options:
+/// o2-bench-mch-clustering-original [--benchmark_xxx] preclusters.in
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gsl/span>
+
+#include "benchmark/benchmark.h"
+#include "CommonUtils/ConfigurableParam.h"
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/PreCluster.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+
+using namespace o2::mch;
+
+namespace
+{
+std::vector<PreCluster> gPreClusters{}; ///< preclusters of all the events
+std::vector<Digit> gDigits{};           ///< digits associated to the preclusters of all the events
+
+//_________________________________________________________________________________________________
+void readPreClusters(const std::string& fileName)
+{
+  /// read the preclusters and associated digits of all the events in the file
+  /// and modify the references to the digits to index them in the global vector
+
+  std::ifstream inFile(fileName, std::ios::binary);
+  if (!inFile.is_open()) {
+    throw std::invalid_argument("cannot open input file " + fileName);
+  }
+
+  int nPreClusters(0), nDigits(0);
+  while (inFile.read(reinterpret_cast<char*>(&nPreClusters), sizeof(int)) &&
+         inFile.read(reinterpret_cast<char*>(&nDigits), sizeof(int))) {
+    if (nPreClusters < 0 || nDigits < 0) {
+      throw std::length_error("invalid input");
+    }
+    auto firstPreCluster = gPreClusters.size();
+    auto firstDigit = gDigits.size();
+    gPreClusters.resize(firstPreCluster + nPreClusters);
+    gDigits.resize(firstDigit + nDigits);
+    inFile.read(reinterpret_cast<char*>(&gPreClusters[firstPreCluster]), nPreClusters * sizeof(PreCluster));
+    inFile.read(reinterpret_cast<char*>(&gDigits[firstDigit]), nDigits * sizeof(Digit));
+    if (!inFile) {
+      throw std::length_error("invalid input");
+    }
+    for (auto iPreCluster = firstPreCluster; iPreCluster < gPreClusters.size(); ++iPreCluster) {
+      gPreClusters[iPreCluster].firstDigit += firstDigit;
+    }
+  }
+}
+} // namespace
+
+/// state.range(0): 0 custom fit, 1 Levenberg-Marquardt fit
+static void BM_ClusterFinderOriginal(benchmark::State& state)
+{
+  o2::conf::ConfigurableParam::setValue("MCHClustering", "levenbergMarquardtFit", state.range(0) == 1);
+
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(false);
+
+  size_t nClusters(0);
+  for (auto _ : state) {
+    for (const auto& preCluster : gPreClusters) {
+      clusterFinder.findClusters(gsl::span<const Digit>(gDigits.data() + preCluster.firstDigit, preCluster.nDigits));
+    }
+    nClusters = clusterFinder.getClusters().size();
+    clusterFinder.reset();
+  }
+
+  clusterFinder.deinit();
+
+  state.counters["clusters"] = nClusters;
+  state.counters["preclusters"] = benchmark::Counter(state.iterations() * gPreClusters.size(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_ClusterFinderOriginal)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " [benchmark options] preclusters.in" << std::endl;
+    return 1;
+  }
+  readPreClusters(argv[1]);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
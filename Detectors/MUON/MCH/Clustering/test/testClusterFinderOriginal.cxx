@@ -0,0 +1,213 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testClusterFinderOriginal.cxx
+/// \brief Test of the original clustering: pixel grid binning, batched Mathieson integrals and fitting algorithms
+
+#define BOOST_TEST_MODULE Test MCHClustering ClusterFinderOriginal
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gsl/span>
+
+#include <TAxis.h>
+#include <TH2D.h>
+
+#include "CommonUtils/ConfigurableParam.h"
+#include "DataFormatsMCH/Cluster.h"
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/MathiesonOriginal.h"
+#include "MCHBase/ResponseParam.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+#include "MCHClustering/ClusterizerParam.h"
+#include "MCHMappingInterface/Segmentation.h"
+#include "../src/PixelGridOriginal.h"
+
+using namespace o2::mch;
+
+namespace
+{
+//_________________________________________________________________________________________________
+MathiesonOriginal mathieson(int deId)
+{
+  /// Mathieson function used by the clustering for this detection element
+  MathiesonOriginal m;
+  const auto& param = ResponseParam::Instance();
+  if (deId < 300) {
+    m.setPitch(param.pitchSt1);
+    m.setSqrtKx3AndDeriveKx2Kx4(param.mathiesonSqrtKx3St1);
+    m.setSqrtKy3AndDeriveKy2Ky4(param.mathiesonSqrtKy3St1);
+  } else {
+    m.setPitch(param.pitchSt2345);
+    m.setSqrtKx3AndDeriveKx2Kx4(param.mathiesonSqrtKx3St2345);
+    m.setSqrtKy3AndDeriveKy2Ky4(param.mathiesonSqrtKy3St2345);
+  }
+  return m;
+}
+
+//_________________________________________________________________________________________________
+std::vector<Digit> makePreCluster(int deId, const std::vector<std::pair<double, double>>& hits, double charge)
+{
+  /// digits on both cathodes induced by the hits, with noiseless Mathieson charges
+  const auto& seg = mapping::segmentation(deId);
+  auto m = mathieson(deId);
+  std::vector<double> padCharges(seg.nofPads(), 0.);
+  std::vector<int> padIds{};
+  for (const auto& [xHit, yHit] : hits) {
+    seg.forEachPadInArea(xHit - 3., yHit - 3., xHit + 3., yHit + 3., [&](int padId) {
+      double x = seg.padPositionX(padId) - xHit;
+      double y = seg.padPositionY(padId) - yHit;
+      double dx = seg.padSizeX(padId) / 2.;
+      double dy = seg.padSizeY(padId) / 2.;
+      if (padCharges[padId] == 0.) {
+        padIds.push_back(padId);
+      }
+      padCharges[padId] += charge * m.integrate(x - dx, y - dy, x + dx, y + dy);
+    });
+  }
+  std::vector<Digit> digits{};
+  for (auto padId : padIds) {
+    if (padCharges[padId] > 2. * ClusterizerParam::Instance().lowestPadCharge) {
+      digits.emplace_back(deId, padId, static_cast<uint32_t>(std::lround(padCharges[padId])), 0);
+    }
+  }
+  return digits;
+}
+
+//_________________________________________________________________________________________________
+std::vector<Cluster> findClusters(const std::vector<std::vector<Digit>>& preClusters, bool levenbergMarquardt)
+{
+  /// clusters of all the preclusters reconstructed with the custom or the Levenberg-Marquardt fit
+  o2::conf::ConfigurableParam::setValue("MCHClustering", "levenbergMarquardtFit", levenbergMarquardt);
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(false);
+  for (const auto& digits : preClusters) {
+    clusterFinder.findClusters(gsl::span<const Digit>(digits));
+  }
+  auto clusters = clusterFinder.getClusters();
+  clusterFinder.deinit();
+  o2::conf::ConfigurableParam::setValue("MCHClustering", "levenbergMarquardtFit", false);
+  return clusters;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PixelGridBinningAsTH2D)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> uni(0., 1.);
+  for (auto [nx, ny] : {std::pair{7, 5}, std::pair{24, 13}, std::pair{1, 30}}) {
+    double xMin = -10. * uni(gen), xMax = xMin + 0.1 + 20. * uni(gen);
+    double yMin = -5. * uni(gen), yMax = yMin + 0.1 + 10. * uni(gen);
+    PixelGridOriginal<double> grid(nx, xMin, xMax, ny, yMin, yMax);
+    TH2D histo("histo", "", nx, xMin, xMax, ny, yMin, yMax);
+    histo.SetDirectory(nullptr);
+    const TAxis* axes[2] = {histo.GetXaxis(), histo.GetYaxis()};
+
+    for (int ixy = 0; ixy < 2; ++ixy) {
+      BOOST_CHECK_EQUAL(grid.nBins(ixy), axes[ixy]->GetNbins());
+      BOOST_CHECK_EQUAL(grid.binWidth(ixy), axes[ixy]->GetBinWidth(1));
+      for (int i = 1; i <= grid.nBins(ixy); ++i) {
+        BOOST_CHECK_EQUAL(grid.binCenter(ixy, i), axes[ixy]->GetBinCenter(i));
+        // the bin edges are the most sensitive to the binning arithmetic
+        BOOST_CHECK_EQUAL(grid.findBin(ixy, axes[ixy]->GetBinLowEdge(i)), axes[ixy]->FindBin(axes[ixy]->GetBinLowEdge(i)));
+      }
+      for (int i = 0; i < 100; ++i) {
+        double xy = grid.min(ixy) - 1. + (grid.max(ixy) - grid.min(ixy) + 2.) * uni(gen);
+        BOOST_CHECK_EQUAL(grid.findBin(ixy, xy), axes[ixy]->FindBin(xy));
+      }
+      BOOST_CHECK_EQUAL(grid.findBin(ixy, grid.max(ixy)), axes[ixy]->FindBin(grid.max(ixy)));
+    }
+
+    for (int i = 0; i < 500; ++i) {
+      double x = xMin - 1. + (xMax - xMin + 2.) * uni(gen);
+      double y = yMin - 1. + (yMax - yMin + 2.) * uni(gen);
+      double w = uni(gen);
+      grid.fill(x, y, w);
+      histo.Fill(x, y, w);
+    }
+    double x = 0.5 * (xMin + xMax), y = 0.5 * (yMin + yMax);
+    grid.set(x, y, 1000.);
+    histo.SetBinContent(histo.FindBin(x, y), 1000.);
+    for (int j = 1; j <= ny; ++j) {
+      for (int i = 1; i <= nx; ++i) {
+        BOOST_CHECK_EQUAL(grid.content(i, j), histo.GetBinContent(i, j));
+      }
+    }
+
+    int iMax(0), jMax(0), kMax(0), iMaxH(0), jMaxH(0);
+    BOOST_CHECK_EQUAL(grid.maximum(iMax, jMax), histo.GetMaximum());
+    histo.GetBinXYZ(histo.GetMaximumBin(), iMaxH, jMaxH, kMax);
+    BOOST_CHECK_EQUAL(iMax, iMaxH);
+    BOOST_CHECK_EQUAL(jMax, jMaxH);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchedMathiesonIntegrals)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> uni(-3.f, 3.f);
+  for (int deId : {100, 500}) {
+    auto m = mathieson(deId);
+    const int n = 1001;
+    std::vector<float> xMin(n), yMin(n), xMax(n), yMax(n), integrals(n);
+    for (int i = 0; i < n; ++i) {
+      xMin[i] = uni(gen);
+      xMax[i] = xMin[i] + 0.1f + std::abs(uni(gen));
+      yMin[i] = uni(gen);
+      yMax[i] = yMin[i] + 0.1f + std::abs(uni(gen));
+    }
+    m.integrate(n, xMin.data(), yMin.data(), xMax.data(), yMax.data(), integrals.data());
+    for (int i = 0; i < n; ++i) {
+      // the Vc tanh/atan may differ from the scalar ones in the last bits, which matters for the tiny integrals in the tails
+      float integral = m.integrate(xMin[i], yMin[i], xMax[i], yMax[i]);
+      BOOST_CHECK_SMALL(integrals[i] - integral, 1.e-6f * integral + 1.e-12f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CustomVsLevenbergMarquardtFit)
+{
+  std::vector<std::pair<int, std::vector<std::pair<double, double>>>> hits = {
+    {100, {{30.3, 40.7}}},
+    {500, {{10.3, 2.1}}},
+    {500, {{-20.6, -3.3}, {-17.1, -2.2}}},
+    {300, {{50.2, 30.4}, {53.8, 32.1}}}};
+  std::vector<std::vector<Digit>> preClusters{};
+  for (const auto& [deId, deHits] : hits) {
+    preClusters.emplace_back(makePreCluster(deId, deHits, 2000.));
+    BOOST_REQUIRE(preClusters.back().size() > 2);
+  }
+
+  auto clusters = findClusters(preClusters, false);
+  auto clustersLM = findClusters(preClusters, true);
+
+  BOOST_REQUIRE(clusters.size() >= hits.size());
+  BOOST_REQUIRE_EQUAL(clusters.size(), clustersLM.size());
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    BOOST_CHECK_EQUAL(clusters[i].getDEId(), clustersLM[i].getDEId());
+    BOOST_CHECK_SMALL(clusters[i].getX() - clustersLM[i].getX(), 0.01);
+    BOOST_CHECK_SMALL(clusters[i].getY() - clustersLM[i].getY(), 0.01);
+  }
+
+  // the single hits are found at their position
+  for (size_t i = 0; i < 2; ++i) {
+    const auto& [deId, deHits] = hits[i];
+    BOOST_CHECK_EQUAL(clusters[i].getDEId(), deId);
+    BOOST_CHECK_SMALL(clusters[i].getX() - deHits[0].first, 0.05);
+    BOOST_CHECK_SMALL(clusters[i].getY() - deHits[0].second, 0.05);
+  }
+}
@@ -0,0 +1,162 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file clusters-compare.cxx
+/// \brief Compare event by event the clusters stored in two binary files written by o2-mch-clusters-sink-workflow
+///
+/// The clusters of each event are compared in the order they are stored, which is the order in which they are
+/// produced by the clustering, so both files must be made from the same preclusters. Returns 0 if all the clusters
+/// are on the same DE, with the same number of digits and at the same position within the tolerance.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+
+#include "DataFormatsMCH/Cluster.h"
+#include "DataFormatsMCH/Digit.h"
+
+namespace po = boost::program_options;
+using o2::mch::Cluster;
+using o2::mch::Digit;
+
+namespace
+{
+//_________________________________________________________________________________________________
+bool readNextEvent(std::ifstream& inFile, std::vector<Cluster>& clusters)
+{
+  /// read the clusters of the next event, skipping the associated digits
+  /// return false if there is no more event to read
+
+  int nClusters(0), nDigits(0);
+  if (!inFile.read(reinterpret_cast<char*>(&nClusters), sizeof(int))) {
+    return false;
+  }
+  if (!inFile.read(reinterpret_cast<char*>(&nDigits), sizeof(int)) || nClusters < 0 || nDigits < 0) {
+    throw std::length_error("invalid input");
+  }
+  clusters.resize(nClusters);
+  inFile.read(reinterpret_cast<char*>(clusters.data()), nClusters * sizeof(Cluster));
+  inFile.seekg(nDigits * sizeof(Digit), std::ios::cur);
+  if (!inFile) {
+    throw std::length_error("invalid input");
+  }
+  return true;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string inputFile1;
+  std::string inputFile2;
+  double tolerance(1.e-4);
+  bool verbose(false);
+
+  po::options_description options("options");
+  // clang-format off
+  options.add_options()
+      ("help,h", "produce help message")
+      ("infile1", po::value<std::string>(&inputFile1)->required(), "reference cluster file")
+      ("infile2", po::value<std::string>(&inputFile2)->required(), "cluster file to compare with the reference")
+      ("tolerance", po::value<double>(&tolerance)->default_value(1.e-4), "maximum difference in x, y and z (cm)")
+      ("verbose,v", po::bool_switch(&verbose), "print the clusters which differ")
+      ;
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
+  if (vm.count("help")) {
+    std::cout << options << "\n";
+    return 2;
+  }
+  try {
+    po::notify(vm);
+  } catch (po::error& e) {
+    std::cout << "Error: " << e.what() << "\n";
+    return 1;
+  }
+
+  std::ifstream inFile1(inputFile1, std::ios::binary);
+  std::ifstream inFile2(inputFile2, std::ios::binary);
+  if (!inFile1.is_open() || !inFile2.is_open()) {
+    std::cerr << "cannot open input files " << inputFile1 << " and " << inputFile2 << "\n";
+    return 3;
+  }
+
+  int nEvents(0), nEventsDiffSize(0);
+  size_t nClusters1(0), nClusters2(0), nCompared(0), nDiffDE(0), nDiffDigits(0), nOutOfTolerance(0);
+  double maxDiff[3] = {0., 0., 0.};
+  double sumDiff2[3] = {0., 0., 0.};
+  std::vector<Cluster> clusters1{}, clusters2{};
+  while (true) {
+    bool hasEvent1 = readNextEvent(inFile1, clusters1);
+    bool hasEvent2 = readNextEvent(inFile2, clusters2);
+    if (hasEvent1 != hasEvent2) {
+      std::cerr << "the two files do not contain the same number of events\n";
+      return 4;
+    }
+    if (!hasEvent1) {
+      break;
+    }
+    ++nEvents;
+    nClusters1 += clusters1.size();
+    nClusters2 += clusters2.size();
+    if (clusters1.size() != clusters2.size()) {
+      ++nEventsDiffSize;
+      if (verbose) {
+        std::cout << fmt::format("event {}: {} vs {} clusters\n", nEvents - 1, clusters1.size(), clusters2.size());
+      }
+      continue;
+    }
+    for (size_t i = 0; i < clusters1.size(); ++i) {
+      const auto& c1 = clusters1[i];
+      const auto& c2 = clusters2[i];
+      ++nCompared;
+      if (c1.getDEId() != c2.getDEId()) {
+        ++nDiffDE;
+        continue;
+      }
+      if (c1.nDigits != c2.nDigits) {
+        ++nDiffDigits;
+      }
+      double diff[3] = {std::abs(c1.getX() - c2.getX()), std::abs(c1.getY() - c2.getY()), std::abs(c1.getZ() - c2.getZ())};
+      for (int j = 0; j < 3; ++j) {
+        maxDiff[j] = std::max(maxDiff[j], diff[j]);
+        sumDiff2[j] += diff[j] * diff[j];
+      }
+      if (*std::max_element(diff, diff + 3) > tolerance) {
+        ++nOutOfTolerance;
+        if (verbose) {
+          std::cout << fmt::format("event {}: ", nEvents - 1) << c1 << " vs " << c2 << "\n";
+        }
+      }
+    }
+  }
+
+  std::cout << fmt::format("{} events, {} vs {} clusters\n", nEvents, nClusters1, nClusters2);
+  std::cout << fmt::format("{} events with a different number of clusters\n", nEventsDiffSize);
+  std::cout << fmt::format("{} clusters compared: {} on a different DE, {} with a different number of digits, {} out of tolerance ({} cm)\n",
+                           nCompared, nDiffDE, nDiffDigits, nOutOfTolerance, tolerance);
+  if (nCompared > nDiffDE) {
+    double n = nCompared - nDiffDE;
+    std::cout << fmt::format("max |dx| = {:.3g} cm, |dy| = {:.3g} cm, |dz| = {:.3g} cm\n", maxDiff[0], maxDiff[1], maxDiff[2]);
+    std::cout << fmt::format("rms dx = {:.3g} cm, dy = {:.3g} cm, dz = {:.3g} cm\n",
+                             std::sqrt(sumDiff2[0] / n), std::sqrt(sumDiff2[1] / n), std::sqrt(sumDiff2[2] / n));
+  }
+
+  return (nEventsDiffSize == 0 && nDiffDE == 0 && nDiffDigits == 0 && nOutOfTolerance == 0) ? 0 : 5;
+}
@@ -114,6 +114,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, std::array<VROF, NEvTyp
   std::vector<uint8_t> evType, deId, colId;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEMID(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEMID(bcInc,       CTF::BLC_bcIncROF);
@@ -124,6 +125,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, std::array<VROF, NEvTyp
   iosize += DECODEMID(pattern,     CTF::BLC_pattern);
   iosize += DECODEMID(deId,        CTF::BLC_deId);
   iosize += DECODEMID(colId,       CTF::BLC_colId);
+  blockDecoding.flush();
   // clang-format on
   //
   for (uint32_t i = 0; i < NEvTypes; i++) {
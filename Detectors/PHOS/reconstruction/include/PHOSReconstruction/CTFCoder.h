@@ -137,6 +137,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   std::vector<uint8_t> status;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEPHOS(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEPHOS(bcInc,       CTF::BLC_bcIncTrig);
@@ -147,6 +148,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   iosize += DECODEPHOS(cellTime,    CTF::BLC_time);
   iosize += DECODEPHOS(energy,      CTF::BLC_energy);
   iosize += DECODEPHOS(status,      CTF::BLC_status);
+  blockDecoding.flush();
   // clang-format on
   //
   trigVec.clear();
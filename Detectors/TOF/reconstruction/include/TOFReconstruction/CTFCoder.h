@@ -123,6 +123,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG&
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODETOF(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODETOF(cc.bcIncROF,     CTF::BLCbcIncROF);
@@ -137,6 +138,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG&
   iosize += DECODETOF(cc.chanInStrip,  CTF::BLCchanInStrip);
   iosize += DECODETOF(cc.tot,          CTF::BLCtot);
   iosize += DECODETOF(cc.pattMap,      CTF::BLCpattMap);
+  blockDecoding.flush();
   // clang-format on
   //
   decompress(cc, rofRecVec, cdigVec, pattVec);
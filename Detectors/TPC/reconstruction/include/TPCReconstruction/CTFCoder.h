@@ -345,6 +345,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec, TRIGVEC&
 
   // decode encoded data directly to destination buff
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
   auto decodeTPC = [&ec, &coders = mCoders, &iosize](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
     iosize += ec.decode(begin, slotVal, coders[slotVal]);
@@ -408,6 +409,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec, TRIGVEC&
   decodeTPC(trigInfo.deltaOrbit.data(), CTF::BLCTrigOrbitInc);
   decodeTPC(trigInfo.deltaBC.data(), CTF::BLCTrigBCInc);
   decodeTPC(trigInfo.triggerType.data(), CTF::BLCTrigType);
+  blockDecoding.flush();
   // convert trigger info to output format
   uint32_t prevOrbit = header.firstOrbitTrig;
   uint16_t prevBC = 0;
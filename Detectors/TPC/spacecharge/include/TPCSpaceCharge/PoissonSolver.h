@@ -95,6 +95,23 @@ class PoissonSolver
   /// set the number of threads used for some of the calculations
   static void setNThreads(int nThreads) { sNThreads = nThreads; }
 
+  /// Red-black Gauss-Seidel relaxation in 3D of the reference implementation, used by relax3D if MGParameters::tiledKernels is not set
+  ///
+  /// The half sweeps alternate the colours, starting with the vertices with (i + j + m) even. The parameters are the ones of relax3D.
+  /// \param nHalfSweeps number of half sweeps, one sweep being two half sweeps
+  void relax3DGaussSeidel(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
+                          const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nHalfSweeps) const;
+
+  /// Red-black Gauss-Seidel relaxation with temporal blocking, used by relax3D if MGParameters::tiledKernels is set
+  ///
+  /// The half sweeps are performed in a single wavefront along z: at each step the half sweep h is applied to the z row
+  /// j = step + 1 - h of each phi slice, so that the rows are reused from the cache by the following half sweeps.
+  /// The phi slices are distributed over sNThreads threads in static tiles, the rows are relaxed with SIMD kernels.
+  /// The result is identical to relax3DGaussSeidel with the same number of half sweeps, up to rounding.
+  /// \param nHalfSweeps number of half sweeps, one sweep being two half sweeps
+  void relax3DTiled(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
+                    const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nHalfSweeps) const;
+
  private:
   const RegularGrid& mGrid3D{};                                      ///< grid properties
   const ParamSpaceCharge mParamGrid{mGrid3D.getParamSC()};           ///< parameters of the grid on which the calculations are performed
@@ -238,8 +255,9 @@ class PoissonSolver
   /// \param coefficient2 coefficients for \f$  V_{x-1,y,z} \f$
   /// \param coefficient3 coefficients for z
   /// \param coefficient4 coefficients for f(r,\phi,z)
+  /// \param nSweeps number of relaxation sweeps
   void relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
-               const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
+               const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nSweeps = 1) const;
 
   /// Relax2D
   ///
@@ -444,6 +462,10 @@ class PoissonSolver
   void residue3D(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const DataT ih2, const DataT tempRatioZ,
                  const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const;
 
+  /// Residue calculation with SIMD kernels over the z rows, used by residue3D if MGParameters::tiledKernels is set. Parameters as for residue3D.
+  void residue3DTiled(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const DataT ih2, const DataT tempRatioZ,
+                      const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const;
+
   /// Residue2D
   ///
   ///    Compute residue from V(.) where V(.) is numerical potential and f(.).
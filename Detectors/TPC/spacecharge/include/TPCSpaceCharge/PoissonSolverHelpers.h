@@ -56,6 +56,7 @@ struct MGParameters {                                             ///< Parameter
   inline static int maxLoop = 7;                                  ///< the number of tree-deep of multi grid
   inline static int gamma = 1;                                    ///< number of iteration at coarsest level !TODO SET TO REASONABLE VALUE!
   inline static bool normalizeGridToOneSector = false;            ///< the grid in phi direction is squashed from 2 Pi to (2 Pi / SECTORSPERSIDE). This can used to get the potential for phi symmetric sc density or boundary potentials
+  inline static bool tiledKernels = true;                         ///< use the tiled and vectorised red-black relaxation and residue in 3D (false: reference implementation)
 };
 
 template <typename DataT = double>
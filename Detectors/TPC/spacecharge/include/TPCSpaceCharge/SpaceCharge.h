@@ -903,6 +903,12 @@ class SpaceCharge
   /// set the number of threads used for some of the calculations
   static void setNThreads(const int nThreads) { sNThreads = nThreads; }
 
+  /// process batches of Vc::Vector<DataT>::Size vertices at once in the drift of the electrons with the interpolated local distortions/corrections and in the RK4 calculation of the local distortions/corrections
+  static void setSIMDDrift(const bool simdDrift) { sSIMDDrift = simdDrift; }
+
+  /// \return returns if batches of vertices are processed at once in the calculation of the distortions/corrections
+  static bool getSIMDDrift() { return sSIMDDrift; }
+
   /// set which kind of numerical integration is used for calcution of the integrals int Er/Ez dz, int Ephi/Ez dz, int Ez dz
   /// \param strategy numerical integration strategy. see enum IntegrationStrategy for the different types
   static void setNumericalIntegrationStrategy(const IntegrationStrategy strategy) { sNumericalIntegrationStrategy = strategy; }
@@ -1234,6 +1240,7 @@ class SpaceCharge
  private:
   ParamSpaceCharge mParamGrid{};                                                                          ///< parameters of the grid on which the calculations are performed
   inline static int sNThreads{getOMPMaxThreads()};                                                        ///<! number of threads which are used during the calculations
+  inline static bool sSIMDDrift{true};                                                                    ///<! process batches of vertices at once in the drift of the electrons using the local distortions/corrections
   inline static IntegrationStrategy sNumericalIntegrationStrategy{IntegrationStrategy::SimpsonIterative}; ///<! numerical integration strategy of integration of the E-Field: 0: trapezoidal, 1: Simpson, 2: Root (only for analytical formula case)
   inline static int sSimpsonNIteratives{3};                                                               ///<! number of iterations which are performed in the iterative simpson calculation of distortions/corrections
   inline static int sSteps{1};                                                                            ///<! during the calculation of the corrections/distortions it is assumed that the electron drifts on a line from deltaZ = z0 -> z1. The value sets the deltaZ width: 1: deltaZ=zBin/1, 5: deltaZ=zBin/5
@@ -1349,6 +1356,35 @@ class SpaceCharge
     ddPhi = localDistCorr.evaldRPhi(z0Tmp, radius, phi) / radius;
   }
 
+  /// calculate distortions/corrections by interpolation of local distortions/corrections for Vc::Vector<DataT>::Size electrons at once
+  void processGlobalDistCorr(const Vc::Vector<DataT>& radius, const Vc::Vector<DataT>& phi, const Vc::Vector<DataT>& z0Tmp, Vc::Vector<DataT>& ddR, Vc::Vector<DataT>& ddPhi, Vc::Vector<DataT>& ddZ, const DistCorrInterpolator<DataT>& localDistCorr) const
+  {
+    ddR = localDistCorr.evaldR(z0Tmp, radius, phi);
+    ddZ = localDistCorr.evaldZ(z0Tmp, radius, phi);
+    ddPhi = localDistCorr.evaldRPhi(z0Tmp, radius, phi) / radius;
+  }
+
+  /// set z coordinates of Vc::Vector<DataT>::Size electrons between min z max z
+  Vc::Vector<DataT> regulateZ(const Vc::Vector<DataT>& posZ, const Side side) const { return Vc::Vector<DataT>::generate([&](size_t i) { return regulateZ(posZ[i], side); }); }
+
+  /// set r coordinates of Vc::Vector<DataT>::Size electrons between 'RMIN - 4 * GRIDSPACINGR' and 'RMAX + 2 * GRIDSPACINGR'
+  Vc::Vector<DataT> regulateR(const Vc::Vector<DataT>& posR, const Side side) const { return Vc::min(Vc::max(posR, Vc::Vector<DataT>(getRMinSim(side))), Vc::Vector<DataT>(getRMaxSim(side))); }
+
+  /// set phi coordinates of Vc::Vector<DataT>::Size electrons between min phi max phi
+  Vc::Vector<DataT> regulatePhi(const Vc::Vector<DataT>& posPhi, const Side side) const { return Vc::Vector<DataT>::generate([&](size_t i) { return regulatePhi(posPhi[i], side); }); }
+
+  /// get the local distortion or correction vectors for Vc::Vector<DataT>::Size coordinates
+  void getLocalDistCorrVectorCyl(const Type type, const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi, const Side side, Vc::Vector<DataT>& lvecZ, Vc::Vector<DataT>& lvecR, Vc::Vector<DataT>& lvecRPhi) const;
+
+  /// calculate the global distortions of the Vc::Vector<DataT>::Size vertices iRFirst, iRFirst + 1, ... for all z vertices of the phi slice iPhi at once by interpolation of the local distortions
+  void calcGlobalDistortionsSIMD(const DistCorrInterpolator<DataT>& formulaStruct, const int maxIterations, const size_t iRFirst, const size_t iPhi);
+
+  /// calculate the global corrections of the Vc::Vector<DataT>::Size vertices iRFirst, iRFirst + 1, ... for all z vertices of the phi slice iPhi at once by interpolation of the local corrections
+  void calcGlobalCorrectionsSIMD(const DistCorrInterpolator<DataT>& formulaStruct, const int type, const size_t iRFirst, const size_t iPhi);
+
+  /// calculate the local distortions/corrections of the Vc::Vector<DataT>::Size z vertices iZFirst, iZFirst + 1, ... at once with the RK4 method
+  void calcLocalDistortionsCorrectionsRK4SIMD(const Type type, const Side side, const size_t iZFirst, const size_t iR, const size_t iPhi);
+
   /// dump the created electron tracks with calculateElectronDriftPath function to a tree
   void dumpElectronTracksToTree(const std::vector<std::pair<std::vector<o2::math_utils::Point3D<float>>, std::array<DataT, 3>>>& electronTracks, const int nSamplingPoints, const char* outFile) const;
 
@@ -408,6 +408,15 @@ class DistCorrInterpolator
   /// \return returns the function value for the local distortion or correction dRPhi for given coordinate
   DataT evaldRPhi(const DataT z, const DataT r, const DataT phi) const { return interpolatorDistCorrdRPhi(z, r, phi); }
 
+  /// \return returns the function values for the local distortion or correction dR for Vc::Vector<DataT>::Size coordinates
+  Vc::Vector<DataT> evaldR(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const { return interpolatorDistCorrdR(z, r, phi); }
+
+  /// \return returns the function values for the local distortion or correction dZ for Vc::Vector<DataT>::Size coordinates
+  Vc::Vector<DataT> evaldZ(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const { return interpolatorDistCorrdZ(z, r, phi); }
+
+  /// \return returns the function values for the local distortion or correction dRPhi for Vc::Vector<DataT>::Size coordinates
+  Vc::Vector<DataT> evaldRPhi(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const { return interpolatorDistCorrdRPhi(z, r, phi); }
+
   o2::tpc::Side getSide() const { return mSide; }
 
   static constexpr unsigned int getID() { return ID; }
@@ -78,6 +78,13 @@ class TriCubicInterpolator
   /// \return returns the interpolated value at given coordinate
   DataT operator()(const DataT z, const DataT r, const DataT phi) const { return interpolateSparse(z, r, phi); }
 
+  // interpolate the values at Vc::Vector<DataT>::Size coordinates at once
+  /// \param z z coordinates
+  /// \param r r coordinates
+  /// \param phi phi coordinates
+  /// \return returns the interpolated values at given coordinates
+  Vc::Vector<DataT> operator()(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const { return interpolateSparse(z, r, phi); }
+
   /// set which type of extrapolation is used at the grid boundaries (linear or parabol can be used with periodic phi axis and non periodic z and r axis).
   /// \param extrapolationType sets type of extrapolation. See enum ExtrapolationType for different types
   void setExtrapolationType(const ExtrapolationType extrapolationType) { mExtrapolationType = extrapolationType; }
@@ -162,6 +169,14 @@ class TriCubicInterpolator
   /// \return returns the interpolated value at given coordinate
   DataT interpolateSparse(const DataT z, const DataT r, const DataT phi) const;
 
+  // interpolate the values at Vc::Vector<DataT>::Size coordinates at once. The values of the coordinates inside the inner volume of the grid are gathered for all lanes,
+  // the coordinates at the boundaries in z and r, where the missing values are extrapolated, are interpolated with the scalar method
+  /// \param z z coordinates
+  /// \param r r coordinates
+  /// \param phi phi coordinates
+  /// \return returns the interpolated values at given coordinates
+  Vc::Vector<DataT> interpolateSparse(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const;
+
   // for periodic boundary conditions
   void getDataIndexCircularArray(const int index0, const int dim, int arr[]) const;
 
@@ -26,6 +26,7 @@
 #include "TPCSpaceCharge/Vector3D.h"
 #include "TPCSpaceCharge/DataContainer3D.h"
 #include "DataFormatsTPC/Defs.h"
+#include <Vc/Vc>
 
 #ifdef WITH_OPENMP
 #include <omp.h>
@@ -33,6 +34,113 @@
 
 using namespace o2::tpc;
 
+namespace
+{
+/// neighbouring phi slices of the slice m for the given symmetry, see relax3D
+struct PhiNeighbours {
+  int mp1{};
+  int mm1{};
+  int signPlus{1};
+  int signMinus{1};
+
+  PhiNeighbours(const int m, const int nPhi, const int symmetry) : mp1{m + 1}, mm1{m - 1}
+  {
+    if (symmetry == 1) {
+      if (mp1 > nPhi - 1) {
+        mp1 = nPhi - 2;
+      }
+      if (mm1 < 0) {
+        mm1 = 1;
+      }
+    } else if (symmetry == -1) {
+      if (mp1 > nPhi - 1) {
+        mp1 = nPhi - 2;
+        signPlus = -1;
+      }
+      if (mm1 < 0) {
+        mm1 = 1;
+        signMinus = -1;
+      }
+    } else {
+      if (mp1 > nPhi - 1) {
+        mp1 = m + 1 - nPhi;
+      }
+      if (mm1 < 0) {
+        mm1 = m - 1 + nPhi;
+      }
+    }
+  }
+};
+
+/// pointers to the z row of a phi slice and to its neighbouring rows, indexed by r
+template <typename DataT>
+struct StencilRow {
+  const DataT* vRm;   ///< V(i - 1, j, m), the row itself shifted by one
+  const DataT* vRp;   ///< V(i + 1, j, m)
+  const DataT* vZm;   ///< V(i, j - 1, m)
+  const DataT* vZp;   ///< V(i, j + 1, m)
+  const DataT* vPhiP; ///< V(i, j, m + 1)
+  const DataT* vPhiM; ///< V(i, j, m - 1)
+  const DataT* q;     ///< charge (i, j, m)
+};
+
+/// Gauss-Seidel update of the vertices iStart, iStart + 2, ... < nR - 1 of the row v.
+/// All vertices are computed with unit stride loads, only those of the current colour are stored,
+/// the others being the neighbours of the updated ones they are not modified during this half sweep.
+template <typename DataT>
+void relaxRow(DataT* v, const StencilRow<DataT>& row, const int nR, const int iStart, const DataT h2, const DataT ratioZ, const DataT signPlus, const DataT signMinus,
+              const DataT* c1, const DataT* c2, const DataT* c3, const DataT* c4)
+{
+  using VDataT = Vc::Vector<DataT>;
+  constexpr int nLanes = VDataT::Size;
+  const auto oddLanes = VDataT::generate([](size_t k) { return DataT(k % 2); }) == VDataT::One();
+  const auto evenLanes = !oddLanes;
+
+  int i = 1;
+  for (; i + nLanes <= nR - 1; i += nLanes) {
+    const VDataT update = (VDataT(c2 + i, Vc::Unaligned) * VDataT(row.vRm + i, Vc::Unaligned) + ratioZ * (VDataT(row.vZm + i, Vc::Unaligned) + VDataT(row.vZp + i, Vc::Unaligned)) +
+                           VDataT(c1 + i, Vc::Unaligned) * VDataT(row.vRp + i, Vc::Unaligned) + VDataT(c3 + i, Vc::Unaligned) * (signPlus * VDataT(row.vPhiP + i, Vc::Unaligned) + signMinus * VDataT(row.vPhiM + i, Vc::Unaligned)) +
+                           h2 * VDataT(row.q + i, Vc::Unaligned)) *
+                          VDataT(c4 + i, Vc::Unaligned);
+    update.store(v + i, ((i - iStart) % 2) ? oddLanes : evenLanes, Vc::Unaligned); // the vertices of the other colour are not written
+  }
+  if ((i - iStart) % 2) {
+    ++i;
+  }
+  for (; i < nR - 1; i += 2) {
+    v[i] = (c2[i] * row.vRm[i] + ratioZ * (row.vZm[i] + row.vZp[i]) + c1[i] * row.vRp[i] + c3[i] * (signPlus * row.vPhiP[i] + signMinus * row.vPhiM[i]) + h2 * row.q[i]) * c4[i];
+  }
+}
+
+/// residue of the vertices 1 ... nR - 2 of the row
+template <typename DataT>
+void residueRow(DataT* res, const DataT* v, const StencilRow<DataT>& row, const int nR, const DataT ih2, const DataT ratioZ, const DataT signPlus, const DataT signMinus,
+                const DataT* c1, const DataT* c2, const DataT* c3, const DataT* ic4)
+{
+  using VDataT = Vc::Vector<DataT>;
+  constexpr int nLanes = VDataT::Size;
+  int i = 1;
+  for (; i + nLanes <= nR - 1; i += nLanes) {
+    const VDataT r = ih2 * (VDataT(c2 + i, Vc::Unaligned) * VDataT(row.vRm + i, Vc::Unaligned) + ratioZ * (VDataT(row.vZm + i, Vc::Unaligned) + VDataT(row.vZp + i, Vc::Unaligned)) +
+                            VDataT(c1 + i, Vc::Unaligned) * VDataT(row.vRp + i, Vc::Unaligned) + VDataT(c3 + i, Vc::Unaligned) * (signPlus * VDataT(row.vPhiP + i, Vc::Unaligned) + signMinus * VDataT(row.vPhiM + i, Vc::Unaligned)) -
+                            VDataT(ic4 + i, Vc::Unaligned) * VDataT(v + i, Vc::Unaligned)) +
+                     VDataT(row.q + i, Vc::Unaligned);
+    r.store(res + i, Vc::Unaligned);
+  }
+  for (; i < nR - 1; ++i) {
+    res[i] = ih2 * (c2[i] * row.vRm[i] + ratioZ * (row.vZm[i] + row.vZp[i]) + c1[i] * row.vRp[i] + c3[i] * (signPlus * row.vPhiP[i] + signMinus * row.vPhiM[i]) - ic4[i] * v[i]) + row.q[i];
+  }
+}
+
+/// stencil row (j, m) of V with the given neighbouring phi slices
+template <typename DataT, typename Vector>
+StencilRow<DataT> getStencilRow(const Vector& matricesV, const Vector& matricesCharge, const int j, const int m, const PhiNeighbours& phi)
+{
+  const DataT* v = &matricesV(0, j, m);
+  return StencilRow<DataT>{v - 1, v + 1, &matricesV(0, j - 1, m), &matricesV(0, j + 1, m), &matricesV(0, j, phi.mp1), &matricesV(0, j, phi.mm1), &matricesCharge(0, j, m)};
+}
+} // namespace
+
 template <typename DataT>
 void PoissonSolver<DataT>::poissonSolver3D(DataContainer& matricesV, const DataContainer& matricesCharge, const int symmetry)
 {
@@ -769,9 +877,7 @@ void PoissonSolver<DataT>::vCycle3D2D(const int symmetry, const int gridFrom, co
 
     // Info("VCycle3D2D","Before Pre-smoothing");
     //  1) Pre-Smoothing: Gauss-Seidel Relaxation or Jacobi
-    for (int jPre = 1; jPre <= nPre; ++jPre) {
-      relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, mParamGrid.NPhiVertices, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
-    } // end pre smoothing
+    relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, mParamGrid.NPhiVertices, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, nPre);
 
     // 2) Residue calculation
     residue3D(tvResidue[index], tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, mParamGrid.NPhiVertices, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
@@ -822,9 +928,7 @@ void PoissonSolver<DataT>::vCycle3D2D(const int symmetry, const int gridFrom, co
     calcCoefficients(1, tnRRow - 1, h, tempRatioZ, tempRatioPhi, coefficient1, coefficient2, coefficient3, coefficient4);
 
     // 5) Post-Smoothing: Gauss-Seidel Relaxation
-    for (int jPost = 1; jPost <= nPost; ++jPost) {
-      relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, mParamGrid.NPhiVertices, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
-    } // end post smoothing
+    relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, mParamGrid.NPhiVertices, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, nPost);
   }
 }
 
@@ -866,9 +970,7 @@ void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, cons
     }
 
     // 1) Pre-Smoothing: Gauss-Seidel Relaxation or Jacobi
-    for (int jPre = 1; jPre <= nPre; ++jPre) {
-      relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
-    } // end pre smoothing
+    relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, nPre);
 
     // 2) Residue calculation
     residue3D(tvResidue[index], tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
@@ -924,9 +1026,7 @@ void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, cons
     calcCoefficients(1, tnRRow - 1, h, tempRatioZ, tempRatioPhi, coefficient1, coefficient2, coefficient3, coefficient4);
 
     // 5) Post-Smoothing: Gauss-Seidel Relaxation
-    for (int jPost = 1; jPost <= nPost; ++jPost) {
-      relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
-    }
+    relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, nPost);
   }
 }
 
@@ -956,6 +1056,11 @@ template <typename DataT>
 void PoissonSolver<DataT>::residue3D(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry,
                                      const DataT ih2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const
 {
+  if (MGParameters::tiledKernels) {
+    residue3DTiled(residue, matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, tnPhi, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+    return;
+  }
+
 #pragma omp parallel for num_threads(sNThreads) // parallising this loop is possible - but using more than 2 cores makes it slower -
   for (int m = 0; m < tnPhi; ++m) {
     int mp1 = m + 1;
@@ -1001,6 +1106,20 @@ void PoissonSolver<DataT>::residue3D(Vector& residue, const Vector& matricesCurr
   }
 }
 
+template <typename DataT>
+void PoissonSolver<DataT>::residue3DTiled(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry,
+                                          const DataT ih2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const
+{
+#pragma omp parallel for num_threads(sNThreads) schedule(static)
+  for (int m = 0; m < tnPhi; ++m) {
+    const PhiNeighbours phi(m, tnPhi, symmetry);
+    for (int j = 1; j < tnZColumn - 1; ++j) {
+      const auto row = getStencilRow<DataT>(matricesCurrentV, matricesCurrentCharge, j, m, phi);
+      residueRow<DataT>(&residue(0, j, m), &matricesCurrentV(0, j, m), row, tnRRow, ih2, tempRatioZ, phi.signPlus, phi.signMinus, coefficient1.data(), coefficient2.data(), coefficient3.data(), inverseCoefficient4.data());
+    }
+  }
+}
+
 template <typename DataT>
 void PoissonSolver<DataT>::interp3D(Vector& matricesCurrentV, const Vector& matricesCurrentVC, const int tnRRow, const int tnZColumn, const int newPhiSlice, const int oldPhiSlice) const
 {
@@ -1218,55 +1337,25 @@ void PoissonSolver<DataT>::addInterp2D(Vector& matricesCurrentV, const Vector& m
 
 template <typename DataT>
 void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
-                                   const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
+                                   const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nSweeps) const
 {
-  // Gauss-Seidel (Read Black}
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
-    // for each slice
-    for (int iPass = 1; iPass <= 2; ++iPass) {
-      const int msw = (iPass % 2) ? 1 : 2;
-      for (int m = 0; m < iPhi; ++m) {
-        const int jsw = ((msw + m) % 2) ? 1 : 2;
-        int mp1 = m + 1;
-        int signPlus = 1;
-        int mm1 = m - 1;
-        int signMinus = 1;
-        // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
-        if (symmetry == 1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-          }
-        }
-        // Anti-symmetry in phi
-        else if (symmetry == -1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-            signPlus = -1;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-            signMinus = -1;
-          }
-        } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
-          if (mp1 > iPhi - 1) {
-            mp1 = m + 1 - iPhi;
-          }
-          if (mm1 < 0) {
-            mm1 = m - 1 + iPhi;
-          }
-        }
-        int isw = jsw;
-        for (int j = 1; j < tnZColumn - 1; ++j, isw = 3 - isw) {
-          for (int i = isw; i < tnRRow - 1; i += 2) {
-            (matricesCurrentV)(i, j, m) = (coefficient2[i] * (matricesCurrentV)(i - 1, j, m) + tempRatioZ * ((matricesCurrentV)(i, j - 1, m) + (matricesCurrentV)(i, j + 1, m)) + coefficient1[i] * (matricesCurrentV)(i + 1, j, m) + coefficient3[i] * (signPlus * (matricesCurrentV)(i, j, mp1) + signMinus * (matricesCurrentV)(i, j, mm1)) + (h2 * (matricesCurrentCharge)(i, j, m))) * coefficient4[i];
-          } // end cols
-        }   // end mParamGrid.NRVertices
-      }     // end phi
-    }       // end sweep
-  } else if (MGParameters::relaxType == RelaxType::Jacobi) {
+    if (MGParameters::tiledKernels) {
+      relax3DTiled(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, 2 * nSweeps);
+    } else {
+      relax3DGaussSeidel(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, 2 * nSweeps);
+    }
+    return;
+  }
+
+  if (nSweeps > 1) {
+    for (int iSweep = 0; iSweep < nSweeps; ++iSweep) {
+      relax3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+    }
+    return;
+  }
+
+  if (MGParameters::relaxType == RelaxType::Jacobi) {
     // for each slice
     for (int m = 0; m < iPhi; ++m) {
       int mp1 = m + 1;
@@ -1314,6 +1403,98 @@ void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matri
   }
 }
 
+template <typename DataT>
+void PoissonSolver<DataT>::relax3DGaussSeidel(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
+                                              const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nHalfSweeps) const
+{
+  // Gauss-Seidel (Read Black}
+  for (int iHalfSweep = 0; iHalfSweep < nHalfSweeps; ++iHalfSweep) {
+    const int msw = (iHalfSweep % 2) ? 2 : 1;
+    // for each slice
+    for (int m = 0; m < iPhi; ++m) {
+      const int jsw = ((msw + m) % 2) ? 1 : 2;
+      int mp1 = m + 1;
+      int signPlus = 1;
+      int mm1 = m - 1;
+      int signMinus = 1;
+      // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
+      if (symmetry == 1) {
+        if (mp1 > iPhi - 1) {
+          mp1 = iPhi - 2;
+        }
+        if (mm1 < 0) {
+          mm1 = 1;
+        }
+      }
+      // Anti-symmetry in phi
+      else if (symmetry == -1) {
+        if (mp1 > iPhi - 1) {
+          mp1 = iPhi - 2;
+          signPlus = -1;
+        }
+        if (mm1 < 0) {
+          mm1 = 1;
+          signMinus = -1;
+        }
+      } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
+        if (mp1 > iPhi - 1) {
+          mp1 = m + 1 - iPhi;
+        }
+        if (mm1 < 0) {
+          mm1 = m - 1 + iPhi;
+        }
+      }
+      int isw = jsw;
+      for (int j = 1; j < tnZColumn - 1; ++j, isw = 3 - isw) {
+        for (int i = isw; i < tnRRow - 1; i += 2) {
+          (matricesCurrentV)(i, j, m) = (coefficient2[i] * (matricesCurrentV)(i - 1, j, m) + tempRatioZ * ((matricesCurrentV)(i, j - 1, m) + (matricesCurrentV)(i, j + 1, m)) + coefficient1[i] * (matricesCurrentV)(i + 1, j, m) + coefficient3[i] * (signPlus * (matricesCurrentV)(i, j, mp1) + signMinus * (matricesCurrentV)(i, j, mm1)) + (h2 * (matricesCurrentCharge)(i, j, m))) * coefficient4[i];
+        } // end cols
+      }   // end mParamGrid.NRVertices
+    }     // end phi
+  }       // end half sweep
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::relax3DTiled(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
+                                        const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4, const int nHalfSweeps) const
+{
+  // the half sweep h updates the vertices with (i + j + m) % 2 == h % 2. At each step the half sweeps are applied in increasing order to the rows
+  // j = step + 1 - h of a slice: the row j of the half sweep h only depends on the rows j - 1, j + 1 of the half sweep h - 1, which are done
+  // at the steps step - 2 and step, and on the rows j of the neighbouring slices of the half sweep h - 1, done at the previous step.
+  // The slices are therefore independent within a step.
+  const int nSteps = tnZColumn - 2 + nHalfSweeps - 1;
+
+  // with periodic phi and an odd number of slices the first and the last slice have the same colour: as in relax3D the last slice is relaxed after the first one
+  const bool lastSliceAfterFirst = (symmetry == 0) && (iPhi % 2);
+  const int nIndependentSlices = lastSliceAfterFirst ? iPhi - 1 : iPhi;
+
+  const auto relaxSlice = [&](const int step, const int m) {
+    const PhiNeighbours phi(m, iPhi, symmetry);
+    for (int h = 0; h < nHalfSweeps; ++h) {
+      const int j = step + 1 - h;
+      if (j < 1 || j > tnZColumn - 2) {
+        continue;
+      }
+      const int iStart = 2 - (h + j + m) % 2;
+      const auto row = getStencilRow<DataT>(matricesCurrentV, matricesCurrentCharge, j, m, phi);
+      relaxRow<DataT>(&matricesCurrentV(0, j, m), row, tnRRow, iStart, h2, tempRatioZ, phi.signPlus, phi.signMinus, coefficient1.data(), coefficient2.data(), coefficient3.data(), coefficient4.data());
+    }
+  };
+
+  // the static schedule keeps the same tile of slices on each thread for all the steps
+#pragma omp parallel num_threads(sNThreads)
+  for (int step = 0; step < nSteps; ++step) {
+#pragma omp for schedule(static)
+    for (int m = 0; m < nIndependentSlices; ++m) {
+      relaxSlice(step, m);
+    }
+    if (lastSliceAfterFirst) {
+#pragma omp single
+      relaxSlice(step, iPhi - 1);
+    }
+  }
+}
+
 template <typename DataT>
 void PoissonSolver<DataT>::relax2D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const DataT h2, const DataT tempFourth, const DataT tempRatio,
                                    std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2)
@@ -34,6 +34,7 @@
 
 #include <numeric>
 #include <chrono>
+#include <type_traits>
 #include "TF1.h"
 #include "TH3.h"
 #include "TH2F.h"
@@ -1387,7 +1388,12 @@ void SpaceCharge<DataT>::calcLocalDistortionsCorrectionsRK4(const SpaceCharge<Da
     const DataT phi = getPhiVertex(iPhi, side);
     for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
       const DataT radius = getRVertex(iR, side);
-      for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
+      // calculate the local distortions/corrections of neighbouring vertices in z at once, the remaining vertices are processed below
+      size_t iZStart = 0;
+      for (; sSIMDDrift && (iZStart + Vc::Vector<DataT>::Size < mParamGrid.NZVertices); iZStart += Vc::Vector<DataT>::Size) {
+        calcLocalDistortionsCorrectionsRK4SIMD(type, side, iZStart, iR, iPhi);
+      }
+      for (size_t iZ = iZStart; iZ < mParamGrid.NZVertices - 1; ++iZ) {
         // set z coordinate depending on distortions or correction calculation
         const size_t iZ0 = type == Type::Corrections ? iZ + 1 : iZ;
         const size_t iZ1 = type == Type::Corrections ? iZ : iZ + 1;
@@ -1508,10 +1514,17 @@ void SpaceCharge<DataT>::calcGlobalDistortions(const Fields& formulaStruct, cons
   initContainer(mGlobalDistdRPhi[side], true);
   const DataT stepSize = formulaStruct.getID() == 2 ? getGridSpacingZ(side) : getGridSpacingZ(side) / sSteps; // if one used local distortions then no smaller stepsize is needed. if electric fields are used then smaller stepsize can be used
   // loop over tpc volume and let the electron drift from each vertex to the readout of the tpc
-#pragma omp parallel for num_threads(sNThreads)
+#pragma omp parallel for num_threads(sNThreads) schedule(dynamic)
   for (size_t iPhi = 0; iPhi < mParamGrid.NPhiVertices; ++iPhi) {
     const DataT phi0 = getPhiVertex(iPhi, side);
-    for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
+    size_t iRStart = 0;
+    if constexpr (std::is_same_v<Fields, DistCorrInterpolator<DataT>>) {
+      // drift the electrons of neighbouring vertices in r at once, the remaining vertices are processed below
+      for (; sSIMDDrift && (iRStart + Vc::Vector<DataT>::Size <= mParamGrid.NRVertices); iRStart += Vc::Vector<DataT>::Size) {
+        calcGlobalDistortionsSIMD(formulaStruct, maxIterations, iRStart, iPhi);
+      }
+    }
+    for (size_t iR = iRStart; iR < mParamGrid.NRVertices; ++iR) {
       const DataT r0 = getRVertex(iR, side);
       for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
         const DataT z0 = getZVertex(iZ, side); // the electron starts at z0, r0, phi0
@@ -1596,10 +1609,17 @@ void SpaceCharge<DataT>::calcGlobalCorrections(const Formulas& formulaStruct, co
   const int iSteps = formulaStruct.getID() == 2 ? 1 : sSteps; // if one used local corrections no step width is needed. since it is already used for calculation of the local corrections
   const DataT stepSize = -getGridSpacingZ(side) / iSteps;
 // loop over tpc volume and let the electron drift from each vertex to the readout of the tpc
-#pragma omp parallel for num_threads(sNThreads)
+#pragma omp parallel for num_threads(sNThreads) schedule(dynamic)
   for (size_t iPhi = 0; iPhi < mParamGrid.NPhiVertices; ++iPhi) {
     const DataT phi0 = getPhiVertex(iPhi, side);
-    for (size_t iR = 0; iR < mParamGrid.NRVertices; ++iR) {
+    size_t iRStart = 0;
+    if constexpr (std::is_same_v<Formulas, DistCorrInterpolator<DataT>>) {
+      // follow the electrons of neighbouring vertices in r at once, the remaining vertices are processed below
+      for (; sSIMDDrift && (iRStart + Vc::Vector<DataT>::Size <= mParamGrid.NRVertices); iRStart += Vc::Vector<DataT>::Size) {
+        calcGlobalCorrectionsSIMD(formulaStruct, type, iRStart, iPhi);
+      }
+    }
+    for (size_t iR = iRStart; iR < mParamGrid.NRVertices; ++iR) {
 
       const DataT r0 = getRVertex(iR, side);
       DataT drCorr = 0;
@@ -1737,6 +1757,269 @@ void SpaceCharge<DataT>::calcGlobalCorrections(const Formulas& formulaStruct, co
   LOGP(detail, "calcGlobalCorrections took {}s", totalTime);
 }
 
+template <typename DataT>
+void SpaceCharge<DataT>::calcGlobalDistortionsSIMD(const DistCorrInterpolator<DataT>& formulaStruct, const int maxIterations, const size_t iRFirst, const size_t iPhi)
+{
+  using VDataT = Vc::Vector<DataT>;
+  using MaskT = typename VDataT::MaskType;
+  const Side side = formulaStruct.getSide();
+  const DataT stepSize = getGridSpacingZ(side);
+  const DataT zMax = getZMax(side);
+  const DataT phi0 = getPhiVertex(iPhi, side);
+  const VDataT r0 = VDataT::generate([&](size_t i) { return getRVertex(iRFirst + i, side); });
+  const size_t iRLast = iRFirst + VDataT::Size - 1;
+
+  // the electrons starting at the same z vertex have similar drift lengths, the lanes are masked once the electron reached the readout
+  for (size_t iZ = 0; iZ < mParamGrid.NZVertices - 1; ++iZ) {
+    const DataT z0 = getZVertex(iZ, side); // the electrons start at z0, r0, phi0
+    VDataT drDist = VDataT::Zero();        // global distortion dR
+    VDataT dPhiDist = VDataT::Zero();      // global distortion dPhi (multiplication with R has to be done at the end)
+    VDataT dzDist = VDataT::Zero();        // global distortion dZ
+    MaskT active(true);                    // electrons which did not reach the readout yet
+
+    for (int iter = 0; !active.isEmpty(); ++iter) {
+      if (iter > maxIterations) {
+        LOGP(error, "Aborting calculation of distortions for iZ: {}, iR: {}-{}, iPhi: {} due to iteration '{}' > maxIterations '{}'!", iZ, iRFirst, iRLast, iPhi, iter, maxIterations);
+        break;
+      }
+      const VDataT z0Tmp = z0 + dzDist + iter * stepSize; // starting z position
+
+      // do not do check for first iteration
+      if (iter) {
+        const MaskT sideChanged = active && ((side == Side::A) ? (z0Tmp < VDataT::Zero()) : (z0Tmp >= VDataT::Zero()));
+        if (!sideChanged.isEmpty()) {
+          LOGP(error, "Aborting calculation of distortions for iZ: {}, iR: {}-{}, iPhi: {} due to change in the sides!", iZ, iRFirst, iRLast, iPhi);
+          active = active && !sideChanged;
+          if (active.isEmpty()) {
+            break;
+          }
+        }
+      }
+
+      const VDataT z1Tmp = z0Tmp + stepSize;                 // electron drifts from z0Tmp to z1Tmp
+      const VDataT radius = regulateR(r0 + drDist, side);    // current radial position of the electron
+      const VDataT phi = regulatePhi(phi0 + dPhiDist, side); // current phi position of the electron
+
+      VDataT ddR;
+      VDataT ddPhi;
+      VDataT ddZ;
+      processGlobalDistCorr(radius, phi, z0Tmp, ddR, ddPhi, ddZ, formulaStruct);
+
+      // scale the interpolated value in the last bin to the distance to the readout
+      const MaskT checkReached = (side == Side::A) ? (z1Tmp >= zMax) : (z1Tmp <= zMax);
+      const VDataT facLastBin = Vc::iif(checkReached, Vc::abs((zMax - z0Tmp) * getInvSpacingZ(side)), VDataT::One());
+      ddR *= facLastBin;
+      ddZ *= facLastBin;
+      ddPhi *= facLastBin;
+
+      // add local distortions to global distortions
+      drDist(active) += ddR;
+      dPhiDist(active) += ddPhi;
+      dzDist(active) += ddZ;
+
+      // approximate the distortion of the 'missing' drift distance to the readout
+      const MaskT reached = active && checkReached;
+      if (!reached.isEmpty()) {
+        const VDataT endPoint = z1Tmp + ddZ;
+        const VDataT deltaZ = zMax - endPoint; // distance from last point to read out
+        const VDataT diff = endPoint - z0Tmp;
+        const VDataT fac = Vc::iif(diff != VDataT::Zero(), Vc::abs(deltaZ / diff), VDataT::Zero());
+        drDist(reached) += ddR * fac;
+        dPhiDist(reached) += ddPhi * fac;
+        dzDist(reached) += ddZ * fac;
+        active = active && !reached;
+      }
+    }
+
+    // store global distortions
+    for (size_t i = 0; i < VDataT::Size; ++i) {
+      const size_t iR = iRFirst + i;
+      mGlobalDistdR[side](iZ, iR, iPhi) = drDist[i];
+      mGlobalDistdRPhi[side](iZ, iR, iPhi) = dPhiDist[i] * r0[i];
+      mGlobalDistdZ[side](iZ, iR, iPhi) = dzDist[i];
+    }
+  }
+}
+
+template <typename DataT>
+void SpaceCharge<DataT>::calcGlobalCorrectionsSIMD(const DistCorrInterpolator<DataT>& formulaStruct, const int type, const size_t iRFirst, const size_t iPhi)
+{
+  using VDataT = Vc::Vector<DataT>;
+  using MaskT = typename VDataT::MaskType;
+  const Side side = formulaStruct.getSide();
+  const DataT stepSize = -getGridSpacingZ(side); // the local corrections are defined for one z bin: one step per vertex
+  const DataT zMin = getZMin(side);
+  const DataT zMaxOutOfVolume = 1.2 * std::abs(getZMax(side));
+  const DataT phi0 = getPhiVertex(iPhi, side);
+  const VDataT r0 = VDataT::generate([&](size_t i) { return getRVertex(iRFirst + i, side); });
+
+  VDataT drCorr = VDataT::Zero();
+  VDataT dPhiCorr = VDataT::Zero();
+  VDataT dzCorr = VDataT::Zero();
+  MaskT isOutOfVolume(false);
+
+  // start at the readout and follow the electrons towards central electrode
+  for (size_t iZ = mParamGrid.NZVertices - 1; iZ >= 1; --iZ) {
+    const DataT z0 = getZVertex(iZ, side); // the electrons start at z0, r0, phi0
+    // electrons corrected outside of the TPC volume are not followed anymore
+    MaskT active = (type != 3) ? !isOutOfVolume : MaskT(true);
+    MaskT centralElectrodeReached(false);
+    if (!active.isEmpty()) {
+      VDataT radius = r0 + drCorr;      // current radial position of the electron
+      VDataT phi = phi0 + dPhiCorr;     // current phi position of the electron
+      const VDataT z0Tmp = z0 + dzCorr; // starting z position
+      VDataT z1Tmp = z0Tmp + stepSize;  // follow electron from z0Tmp to z1Tmp
+
+      // restrict to inner TPC volume
+      if (type != 3) {
+        radius = regulateR(radius, side);
+        phi = regulatePhi(phi, side);
+        z1Tmp = regulateZ(z1Tmp, side);
+      }
+
+      VDataT ddR;
+      VDataT ddPhi;
+      VDataT ddZ;
+      processGlobalDistCorr(radius, phi, z0Tmp, ddR, ddPhi, ddZ, formulaStruct);
+
+      // scale the interpolated value in the first bin to the distance to the central electrode
+      centralElectrodeReached = active && (DataT(getSign(side)) * z1Tmp <= zMin);
+      const VDataT facFirstBin = Vc::iif(centralElectrodeReached, (z0Tmp - zMin) * getInvSpacingZ(side), VDataT::One());
+      ddR *= facFirstBin;
+      ddZ *= facFirstBin;
+      ddPhi *= facFirstBin;
+
+      // check if current position lies in the TPC volume
+      if (type != 3) {
+        const VDataT rCurr = r0 + drCorr + ddR;
+        const VDataT zCurr = z0Tmp + dzCorr + ddZ + stepSize;
+        const MaskT outOfVolume = active && ((rCurr <= getRMinSim(side)) || (rCurr >= getRMaxSim(side)) || (Vc::abs(zCurr) > zMaxOutOfVolume));
+        isOutOfVolume = isOutOfVolume || outOfVolume;
+        active = active && !outOfVolume;
+      }
+
+      // add local corrections to global corrections
+      drCorr(active) += ddR;
+      dPhiCorr(active) += ddPhi;
+      dzCorr(active) += ddZ;
+
+      // approximate the correction of the 'missing' distance to the central electrode
+      const MaskT reached = active && centralElectrodeReached;
+      if ((type != 3) && !reached.isEmpty()) {
+        const VDataT endPoint = z1Tmp + ddZ;
+        const VDataT deltaZ = endPoint - zMin;
+        const VDataT diff = z0Tmp - endPoint;
+        const VDataT fac = Vc::iif(diff != VDataT::Zero(), deltaZ / diff, VDataT::Zero());
+        drCorr(reached) += ddR * fac;
+        dPhiCorr(reached) += ddPhi * fac;
+        dzCorr(reached) += ddZ * fac;
+      }
+    }
+
+    // store global corrections
+    for (size_t i = 0; i < VDataT::Size; ++i) {
+      const size_t iR = iRFirst + i;
+      if ((type == 1 || type == 2) && (centralElectrodeReached[i] || isOutOfVolume[i])) {
+        mGlobalCorrdR[side](iZ - 1, iR, iPhi) = -1;
+        mGlobalCorrdRPhi[side](iZ - 1, iR, iPhi) = -1;
+        mGlobalCorrdZ[side](iZ - 1, iR, iPhi) = -1;
+      } else {
+        mGlobalCorrdR[side](iZ - 1, iR, iPhi) = drCorr[i];
+        mGlobalCorrdRPhi[side](iZ - 1, iR, iPhi) = dPhiCorr[i] * r0[i];
+        mGlobalCorrdZ[side](iZ - 1, iR, iPhi) = dzCorr[i];
+      }
+    }
+  }
+}
+
+template <typename DataT>
+void SpaceCharge<DataT>::calcLocalDistortionsCorrectionsRK4SIMD(const Type type, const Side side, const size_t iZFirst, const size_t iR, const size_t iPhi)
+{
+  using VDataT = Vc::Vector<DataT>;
+  const DataT phi = getPhiVertex(iPhi, side);
+  const DataT radius = getRVertex(iR, side);
+
+  // set z coordinate depending on distortions or correction calculation
+  const size_t iZOffs0 = type == Type::Corrections ? 1 : 0;
+  const size_t iZOffs1 = type == Type::Corrections ? 0 : 1;
+  const VDataT z0 = VDataT::generate([&](size_t i) { return getZVertex(iZFirst + i + iZOffs0, side); });
+  const VDataT z1 = VDataT::generate([&](size_t i) { return getZVertex(iZFirst + i + iZOffs1, side); });
+
+  const VDataT stepSize = z1 - z0; // h in the RK4 method
+  const VDataT absstepSize = Vc::abs(stepSize);
+  const VDataT stepSizeHalf = DataT(0.5) * stepSize; // half z bin for RK4
+  const VDataT absstepSizeHalf = Vc::abs(stepSizeHalf);
+
+  // get derivative on current vertex
+  const auto getLocalVec = [&](const size_t iZ, const int dim) -> DataT {
+    if (type == Type::Corrections) {
+      return (dim == 0) ? getLocalVecCorrR(iZ, iR, iPhi, side) : ((dim == 1) ? getLocalVecCorrZ(iZ, iR, iPhi, side) : getLocalVecCorrRPhi(iZ, iR, iPhi, side));
+    }
+    return (dim == 0) ? getLocalVecDistR(iZ, iR, iPhi, side) : ((dim == 1) ? getLocalVecDistZ(iZ, iR, iPhi, side) : getLocalVecDistRPhi(iZ, iR, iPhi, side));
+  };
+  const VDataT k1dR = VDataT::generate([&](size_t i) { return getLocalVec(iZFirst + i + iZOffs0, 0); });
+  const VDataT k1dZ = VDataT::generate([&](size_t i) { return getLocalVec(iZFirst + i + iZOffs0, 1); });
+  const VDataT k1dRPhi = VDataT::generate([&](size_t i) { return getLocalVec(iZFirst + i + iZOffs0, 2); });
+
+  // approximate position after half stepSize
+  const VDataT zk2 = z0 + stepSizeHalf + absstepSizeHalf * k1dZ;
+  const VDataT rk2 = radius + absstepSizeHalf * k1dR;
+  const VDataT k1dPhi = k1dRPhi / radius;
+  const VDataT phik2 = phi + absstepSizeHalf * k1dPhi;
+
+  // get derivative for new position
+  VDataT k2dR;
+  VDataT k2dZ;
+  VDataT k2dRPhi;
+  getLocalDistCorrVectorCyl(type, zk2, rk2, phik2, side, k2dZ, k2dR, k2dRPhi);
+
+  // approximate new position
+  const VDataT zk3 = z0 + stepSizeHalf + absstepSizeHalf * k2dZ;
+  const VDataT rk3 = radius + absstepSizeHalf * k2dR;
+  const VDataT k2dPhi = k2dRPhi / rk2;
+  const VDataT phik3 = phi + absstepSizeHalf * k2dPhi;
+
+  VDataT k3dR;
+  VDataT k3dZ;
+  VDataT k3dRPhi;
+  getLocalDistCorrVectorCyl(type, zk3, rk3, phik3, side, k3dZ, k3dR, k3dRPhi);
+
+  const VDataT zk4 = z0 + stepSize + absstepSize * k3dZ;
+  const VDataT rk4 = radius + absstepSize * k3dR;
+  const VDataT k3dPhi = k3dRPhi / rk3;
+  const VDataT phik4 = phi + absstepSize * k3dPhi;
+
+  VDataT k4dR;
+  VDataT k4dZ;
+  VDataT k4dRPhi;
+  getLocalDistCorrVectorCyl(type, zk4, rk4, phik4, side, k4dZ, k4dR, k4dRPhi);
+  const VDataT k4dPhi = k4dRPhi / rk4;
+
+  // RK4 formula. See wikipedia: u = h * 1/6 * (k1 + 2*k2 + 2*k3 + k4)
+  const VDataT stepsizeSixth = absstepSize / DataT(6);
+  const VDataT drRK = stepsizeSixth * (k1dR + DataT(2) * k2dR + DataT(2) * k3dR + k4dR);
+  const VDataT dzRK = stepsizeSixth * (k1dZ + DataT(2) * k2dZ + DataT(2) * k3dZ + k4dZ);
+  const VDataT dphiRK = stepsizeSixth * (k1dPhi + DataT(2) * k2dPhi + DataT(2) * k3dPhi + k4dPhi);
+
+  // store local distortions/corrections
+  for (size_t i = 0; i < VDataT::Size; ++i) {
+    const size_t iZ = iZFirst + i;
+    switch (type) {
+      case Type::Corrections:
+        mLocalCorrdR[side](iZ + 1, iR, iPhi) = drRK[i];
+        mLocalCorrdRPhi[side](iZ + 1, iR, iPhi) = dphiRK[i] * radius;
+        mLocalCorrdZ[side](iZ + 1, iR, iPhi) = dzRK[i];
+        break;
+
+      case Type::Distortions:
+        mLocalDistdR[side](iZ, iR, iPhi) = drRK[i];
+        mLocalDistdRPhi[side](iZ, iR, iPhi) = dphiRK[i] * radius;
+        mLocalDistdZ[side](iZ, iR, iPhi) = dzRK[i];
+        break;
+    }
+  }
+}
+
 template <typename DataT>
 void SpaceCharge<DataT>::correctElectron(GlobalPosition3D& point)
 {
@@ -1942,6 +2225,19 @@ void SpaceCharge<DataT>::getLocalDistortionVectorCyl(const std::vector<DataT>& z
   }
 }
 
+template <typename DataT>
+void SpaceCharge<DataT>::getLocalDistCorrVectorCyl(const Type type, const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi, const Side side, Vc::Vector<DataT>& lvecZ, Vc::Vector<DataT>& lvecR, Vc::Vector<DataT>& lvecRPhi) const
+{
+  lvecZ = mInterpolatorLocalVecDist[side].evaldZ(z, r, phi);
+  lvecR = mInterpolatorLocalVecDist[side].evaldR(z, r, phi);
+  lvecRPhi = mInterpolatorLocalVecDist[side].evaldRPhi(z, r, phi);
+  if (type == Type::Corrections) {
+    lvecZ = -lvecZ;
+    lvecR = -lvecR;
+    lvecRPhi = -lvecRPhi;
+  }
+}
+
 template <typename DataT>
 void SpaceCharge<DataT>::getLocalCorrectionVectorCyl(const DataT z, const DataT r, const DataT phi, const Side side, DataT& lveccorrZ, DataT& lveccorrR, DataT& lveccorrRPhi) const
 {
@@ -4059,6 +4355,7 @@ template void O2TPCSpaceCharge3DCalcD::calcLocalDistortionsCorrections(const O2T
 template void O2TPCSpaceCharge3DCalcD::calcLocalDistortionsCorrections(const O2TPCSpaceCharge3DCalcD::Type, const AnaFieldsD&);
 template void O2TPCSpaceCharge3DCalcD::calcLocalDistortionCorrectionVector(const NumFieldsD&);
 template void O2TPCSpaceCharge3DCalcD::calcLocalDistortionCorrectionVector(const AnaFieldsD&);
+template void O2TPCSpaceCharge3DCalcD::calcLocalDistortionsCorrectionsRK4<AnaFieldsD>(const O2TPCSpaceCharge3DCalcD::Type, const Side);
 template void O2TPCSpaceCharge3DCalcD::calcGlobalCorrections(const NumFieldsD&, const int);
 template void O2TPCSpaceCharge3DCalcD::calcGlobalCorrections(const AnaFieldsD&, const int);
 template void O2TPCSpaceCharge3DCalcD::calcGlobalCorrections(const DistCorrInterpD&, const int);
@@ -4082,6 +4379,7 @@ template void O2TPCSpaceCharge3DCalcF::calcLocalDistortionsCorrections(const O2T
 template void O2TPCSpaceCharge3DCalcF::calcLocalDistortionsCorrections(const O2TPCSpaceCharge3DCalcF::Type, const AnaFieldsF&);
 template void O2TPCSpaceCharge3DCalcF::calcLocalDistortionCorrectionVector(const NumFieldsF&);
 template void O2TPCSpaceCharge3DCalcF::calcLocalDistortionCorrectionVector(const AnaFieldsF&);
+template void O2TPCSpaceCharge3DCalcF::calcLocalDistortionsCorrectionsRK4<AnaFieldsF>(const O2TPCSpaceCharge3DCalcF::Type, const Side);
 template void O2TPCSpaceCharge3DCalcF::calcGlobalCorrections(const NumFieldsF&, const int);
 template void O2TPCSpaceCharge3DCalcF::calcGlobalCorrections(const AnaFieldsF&, const int);
 template void O2TPCSpaceCharge3DCalcF::calcGlobalCorrections(const DistCorrInterpF&, const int);
@@ -123,6 +123,115 @@ DataT TriCubicInterpolator<DataT>::interpolateSparse(const DataT z, const DataT
   return result;
 }
 
+template <typename DataT>
+Vc::Vector<DataT> TriCubicInterpolator<DataT>::interpolateSparse(const Vc::Vector<DataT>& z, const Vc::Vector<DataT>& r, const Vc::Vector<DataT>& phi) const
+{
+  using VDataT = Vc::Vector<DataT>;
+  using IndexT = typename VDataT::IndexType;
+  constexpr size_t nLanes = VDataT::Size;
+  const int nPoints = 4;
+
+  // check if data is empty
+  if (!mGridData->getNDataPoints()) {
+    return VDataT::Zero();
+  }
+
+  const Vector<DataT, FDim>& gridMin = mGridProperties->getGridMin();
+  const Vector<DataT, FDim>& invSpacing = mGridProperties->getInvSpacing();
+  std::array<DataT, nLanes> posRelZ{};
+  std::array<DataT, nLanes> posRelR{};
+  std::array<DataT, nLanes> posRelPhi{};
+  ((z - gridMin[FZ]) * invSpacing[FZ]).store(posRelZ.data(), Vc::Unaligned);
+  ((r - gridMin[FR]) * invSpacing[FR]).store(posRelR.data(), Vc::Unaligned);
+  ((phi - gridMin[FPHI]) * invSpacing[FPHI]).store(posRelPhi.data(), Vc::Unaligned);
+
+  const int nZ = mGridData->getNZ();
+  const int nR = mGridData->getNR();
+  const int nPhi = mGridData->getNPhi();
+
+  std::array<bool, nLanes> isInner{};
+  std::array<DataT, nLanes> values{};                 // values of the lanes which are interpolated with the scalar method
+  std::array<std::array<int, nLanes>, nPoints> ind{}; // data index of the first value of the four phi slices for each lane
+  size_t nInner = 0;
+  for (size_t i = 0; i < nLanes; ++i) {
+    const DataT relPhi = mGridProperties->clampToGridCircularRel(posRelPhi[i], FPHI);
+    const DataT relZ = mGridProperties->clampToGridRel(posRelZ[i], FZ);
+    const DataT relR = mGridProperties->clampToGridRel(posRelR[i], FR);
+    const int iz = static_cast<int>(relZ);
+    const int ir = static_cast<int>(relR);
+    const int iphi = static_cast<int>(relPhi);
+
+    // values are extrapolated at the boundaries in z and r: use the scalar method
+    if (iz < 1 || iz > nZ - 3 || ir < 1 || ir > nR - 3 || iphi >= nPhi) {
+      values[i] = interpolateSparse(z[i], r[i], phi[i]);
+      continue;
+    }
+    isInner[i] = true;
+    ++nInner;
+    posRelZ[i] = relZ - iz;
+    posRelR[i] = relR - ir;
+    posRelPhi[i] = relPhi - iphi;
+
+    // periodic boundary condition in phi
+    const int iPhiSlice[nPoints]{iphi == 0 ? nPhi - 1 : iphi - 1, iphi, (iphi + 1) % nPhi, (iphi + 2) % nPhi};
+    for (int slice = 0; slice < nPoints; ++slice) {
+      ind[slice][i] = mGridData->getDataIndex(iz - 1, ir - 1, iPhiSlice[slice]);
+    }
+  }
+
+  if (nInner == 0) {
+    return VDataT(values.data(), Vc::Unaligned);
+  }
+
+  // weights of the four points along each dimension, same as the product of matrixA with (1, t, t^2, t^3) of the scalar method
+  const auto getWeights = [](const VDataT& t, std::array<VDataT, nPoints>& weights) {
+    const VDataT t2 = t * t;
+    const VDataT t3 = t2 * t;
+    weights[0] = DataT(-0.5) * t + t2 - DataT(0.5) * t3;
+    weights[1] = DataT(1) - DataT(2.5) * t2 + DataT(1.5) * t3;
+    weights[2] = DataT(0.5) * t + DataT(2) * t2 - DataT(1.5) * t3;
+    weights[3] = DataT(-0.5) * t2 + DataT(0.5) * t3;
+  };
+
+  std::array<VDataT, nPoints> weightsZ;
+  std::array<VDataT, nPoints> weightsR;
+  std::array<VDataT, nPoints> weightsPhi;
+  getWeights(VDataT(posRelZ.data(), Vc::Unaligned), weightsZ);
+  getWeights(VDataT(posRelR.data(), Vc::Unaligned), weightsR);
+  getWeights(VDataT(posRelPhi.data(), Vc::Unaligned), weightsPhi);
+
+  // the indices of the lanes which are not in the inner volume point to the first values of the grid
+  const DataT* data = &(*mGridData)[0];
+  const int deltaR = mGridProperties->getDeltaDataIndex(1, FR);
+  const int deltaZ = mGridProperties->getDeltaDataIndex(1, FZ);
+  VDataT result = VDataT::Zero();
+  for (int slice = 0; slice < nPoints; ++slice) {
+    const IndexT indSlice(ind[slice].data(), Vc::Unaligned);
+    VDataT valSlice = VDataT::Zero();
+    for (int row = 0; row < nPoints; ++row) {
+      VDataT valRow = VDataT::Zero();
+      for (int k = 0; k < nPoints; ++k) {
+        valRow += weightsZ[k] * VDataT(data, indSlice + (row * deltaR + k * deltaZ));
+      }
+      valSlice += weightsR[row] * valRow;
+    }
+    result += weightsPhi[slice] * valSlice;
+  }
+
+  if (nInner == nLanes) {
+    return result;
+  }
+
+  std::array<DataT, nLanes> resultLanes{};
+  result.store(resultLanes.data(), Vc::Unaligned);
+  for (size_t i = 0; i < nLanes; ++i) {
+    if (isInner[i]) {
+      values[i] = resultLanes[i];
+    }
+  }
+  return VDataT(values.data(), Vc::Unaligned);
+}
+
 // for perdiodic boundary condition
 template <typename DataT>
 void TriCubicInterpolator<DataT>::getDataIndexCircularArray(const int index0, const int dim, int arr[]) const
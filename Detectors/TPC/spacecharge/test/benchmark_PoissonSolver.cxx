@@ -0,0 +1,83 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmark_PoissonSolver.cxx
+/// \brief Time of the multigrid V cycles of the 3D poisson solver with the reference and the tiled relaxation and residue kernels
+
+#include "benchmark/benchmark.h"
+#include "TPCSpaceCharge/PoissonSolver.h"
+#include "TPCSpaceCharge/PoissonSolverHelpers.h"
+#include "TPCSpaceCharge/SpaceChargeHelpers.h"
+#include "TPCSpaceCharge/DataContainer3D.h"
+
+using namespace o2::tpc;
+using DataT = double;
+
+constexpr unsigned short NR = 129;   // standard grid in r
+constexpr unsigned short NZ = 129;   // standard grid in z
+constexpr unsigned short NPHI = 180; // standard grid in phi
+constexpr int NVCYCLES = 3;          // number of V cycles per iteration
+
+/// state.range(0): 0 reference kernels, 1 tiled kernels, state.range(1): number of threads, state.range(2): 1 full 3D, 0 3D2D
+static void BM_PoissonSolver3D(benchmark::State& state)
+{
+  using GridProp = GridProperties<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI), params};
+
+  DataContainer3D<DataT> potential(NZ, NR, NPHI);
+  DataContainer3D<DataT> charge(NZ, NR, NPHI);
+  const AnalyticalFields<DataT> analyticalFields;
+  for (size_t iPhi = 0; iPhi < NPHI; ++iPhi) {
+    const DataT phi = grid3D.getPhiVertex(iPhi);
+    for (size_t iR = 0; iR < NR; ++iR) {
+      const DataT radius = grid3D.getRVertex(iR);
+      for (size_t iZ = 0; iZ < NZ; ++iZ) {
+        const DataT z = grid3D.getZVertex(iZ);
+        charge(iZ, iR, iPhi) = analyticalFields.evalDensity(z, radius, phi);
+        if (iR == 0 || iR == NR - 1 || iZ == 0 || iZ == NZ - 1) {
+          potential(iZ, iR, iPhi) = analyticalFields.evalPotential(z, radius, phi);
+        }
+      }
+    }
+  }
+
+  // fixed number of V cycles on the finest grid, independent of the convergence
+  MGParameters::cycleType = CycleType::VCycle;
+  MGParameters::nMGCycle = NVCYCLES;
+  MGParameters::tiledKernels = state.range(0);
+  MGParameters::isFull3D = state.range(2);
+  PoissonSolver<DataT>::setConvergenceError(0);
+  PoissonSolver<DataT>::setNThreads(state.range(1));
+  PoissonSolver<DataT> poissonSolver(grid3D);
+
+  for (auto _ : state) {
+    auto work = potential;
+    poissonSolver.poissonSolver3D(work, charge, 0);
+    benchmark::DoNotOptimize(work);
+  }
+  state.counters["VCycles"] = benchmark::Counter(state.iterations() * NVCYCLES, benchmark::Counter::kIsRate);
+}
+
+static void PoissonSolverArguments(benchmark::internal::Benchmark* b)
+{
+  for (int full3D : {1, 0}) {
+    for (int tiled : {0, 1}) {
+      for (int nThreads : {1, 2, 4, 8, 16}) {
+        b->Args({tiled, nThreads, full3D});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_PoissonSolver3D)->Apply(PoissonSolverArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -22,6 +22,9 @@
 #include "TPCSpaceCharge/SpaceChargeHelpers.h"
 #include "TPCSpaceCharge/PoissonSolverHelpers.h"
 #include "TPCSpaceCharge/DataContainer3D.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 namespace o2
 {
@@ -198,6 +201,99 @@ void poissonSolver3D()
   testAlmostEqualArray<DataT>(potentialAnalytical, potentialNumerical);
 }
 
+template <typename DataT>
+void poissonSolver3DTiledKernels()
+{
+  using GridProp = GridProperties<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const o2::tpc::RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI), params};
+
+  using DataContainer = o2::tpc::DataContainer3D<DataT>;
+  DataContainer potentialReference(NZ, NR, NPHI);
+  DataContainer charge(NZ, NR, NPHI);
+
+  const o2::tpc::AnalyticalFields<DataT> analyticalFields;
+  setChargeDensityFromFormula<DataT>(analyticalFields, grid3D, charge);
+  setPotentialBoundaryFromFormula<DataT>(analyticalFields, grid3D, potentialReference);
+  DataContainer potentialTiled = potentialReference;
+
+  // the tiled kernels only reorder the red-black relaxation, the solution has to agree with the reference kernels up to rounding
+  PoissonSolver<DataT> poissonSolver(grid3D);
+  const int symmetry = 0;
+  o2::tpc::MGParameters::tiledKernels = false;
+  poissonSolver.poissonSolver3D(potentialReference, charge, symmetry);
+  o2::tpc::MGParameters::tiledKernels = true;
+  poissonSolver.poissonSolver3D(potentialTiled, charge, symmetry);
+
+  for (size_t iPhi = 0; iPhi < potentialTiled.getNPhi(); ++iPhi) {
+    for (size_t iR = 0; iR < potentialTiled.getNR(); ++iR) {
+      for (size_t iZ = 0; iZ < potentialTiled.getNZ(); ++iZ) {
+        BOOST_CHECK_SMALL(potentialTiled(iZ, iR, iPhi) - potentialReference(iZ, iR, iPhi), DataT(1e-6) * (1 + std::fabs(potentialReference(iZ, iR, iPhi))));
+      }
+    }
+  }
+}
+
+/// compare the tiled red-black relaxation with the reference one after each half sweep, starting from a random potential
+template <typename DataT>
+void relax3DTiledKernel(const int nR, const int nZ, const int nPhi, const int symmetry)
+{
+  using GridProp = GridProperties<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const o2::tpc::RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI), params};
+  PoissonSolver<DataT> poissonSolver(grid3D);
+
+  using Vector = typename PoissonSolver<DataT>::Vector;
+  Vector potentialInitial(nR, nZ, nPhi);
+  Vector charge(nR, nZ, nPhi);
+  std::mt19937 gen(1000 * nR + 10 * nPhi + nZ);
+  std::uniform_real_distribution<DataT> uni(-1, 1);
+  for (int m = 0; m < nPhi; ++m) {
+    for (int j = 0; j < nZ; ++j) {
+      for (int i = 0; i < nR; ++i) {
+        potentialInitial(i, j, m) = uni(gen);
+        charge(i, j, m) = uni(gen);
+      }
+    }
+  }
+
+  // coefficients with the same structure as the ones of the solver
+  const DataT h = 0.5;
+  const DataT h2 = h * h;
+  const DataT tempRatioZ = 0.7;
+  const DataT tempRatioPhi = 0.4;
+  std::vector<DataT> coefficient1(nR), coefficient2(nR), coefficient3(nR), coefficient4(nR);
+  for (int i = 0; i < nR; ++i) {
+    const DataT radiusInv = 1 / (1 + i * h);
+    coefficient1[i] = 1 + h * radiusInv / 2;
+    coefficient2[i] = 1 - h * radiusInv / 2;
+    coefficient3[i] = tempRatioPhi * radiusInv * radiusInv;
+    coefficient4[i] = 1 / (2 * (1 + tempRatioZ + coefficient3[i]));
+  }
+
+  const int nHalfSweeps = 5;
+  for (int iHalfSweep = 1; iHalfSweep <= nHalfSweeps; ++iHalfSweep) {
+    Vector potentialReference = potentialInitial;
+    Vector potentialTiled = potentialInitial;
+    poissonSolver.relax3DGaussSeidel(potentialReference, charge, nR, nZ, nPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, iHalfSweep);
+    poissonSolver.relax3DTiled(potentialTiled, charge, nR, nZ, nPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4, iHalfSweep);
+
+    DataT maxDiff = 0;
+    DataT maxChange = 0;
+    for (int m = 0; m < nPhi; ++m) {
+      for (int j = 0; j < nZ; ++j) {
+        for (int i = 0; i < nR; ++i) {
+          maxDiff = std::max(maxDiff, std::abs(potentialTiled(i, j, m) - potentialReference(i, j, m)));
+          maxChange = std::max(maxChange, std::abs(potentialReference(i, j, m) - potentialInitial(i, j, m)));
+        }
+      }
+    }
+    BOOST_TEST_INFO("nR " << nR << " nZ " << nZ << " nPhi " << nPhi << " symmetry " << symmetry << " half sweeps " << iHalfSweep);
+    BOOST_CHECK_SMALL(maxDiff, DataT(1e-12));
+    BOOST_CHECK(maxChange > 0);
+  }
+}
+
 template <typename DataT>
 void poissonSolver2D()
 {
@@ -238,6 +334,31 @@ BOOST_AUTO_TEST_CASE(PoissonSolver3D2D_test)
   poissonSolver3D<DataT>();
 }
 
+BOOST_AUTO_TEST_CASE(PoissonSolver3DTiledKernels_test)
+{
+  o2::tpc::MGParameters::isFull3D = true; // 3D
+  poissonSolver3DTiledKernels<DataT>();
+  o2::tpc::MGParameters::isFull3D = false; // 3D2D
+  poissonSolver3DTiledKernels<DataT>();
+}
+
+BOOST_AUTO_TEST_CASE(Relax3DTiledKernel_test)
+{
+  // the number of interior vertices in r leaves different tails for the SIMD rows, the odd number of slices is a special case for periodic phi
+  const int nThreads = PoissonSolver<DataT>::getNThreads();
+  PoissonSolver<DataT>::setNThreads(3);
+  for (const int symmetry : {0, 1, -1}) {
+    for (const int nR : {7, 10, 13, 22}) {
+      for (const int nZ : {4, 9}) {
+        for (const int nPhi : {5, 6, 7}) {
+          relax3DTiledKernel<DataT>(nR, nZ, nPhi, symmetry);
+        }
+      }
+    }
+  }
+  PoissonSolver<DataT>::setNThreads(nThreads);
+}
+
 BOOST_AUTO_TEST_CASE(PoissonSolver2D_test)
 {
   poissonSolver2D<DataT>();
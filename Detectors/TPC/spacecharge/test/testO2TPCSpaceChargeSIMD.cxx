@@ -0,0 +1,101 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file  testO2TPCSpaceChargeSIMD.cxx
+/// \brief this task tests that the distortions and corrections are the same with and without the SIMD drift of the electrons
+
+#define BOOST_TEST_MODULE Test TPC O2TPCSpaceCharge3DCalc SIMD drift
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TPCSpaceCharge/SpaceCharge.h"
+#include "TPCSpaceCharge/SpaceChargeHelpers.h"
+#include <algorithm>
+#include <cmath>
+
+namespace o2
+{
+namespace tpc
+{
+
+using DataT = double;
+using SC = SpaceCharge<DataT>;
+static constexpr DataT TOLERANCE = 1e-6;   // tolerance in cm, relative to the size of the distortion/correction + 1 cm
+static constexpr unsigned short NR = 17;   // grid in r, the SIMD batches do not cover it fully
+static constexpr unsigned short NZ = 17;   // grid in z, the SIMD batches do not cover it fully
+static constexpr unsigned short NPHI = 18; // grid in phi
+static constexpr int BFIELD = 5;           // magnetic field in kG
+
+/// local distortions/corrections with RK4 and global distortions/corrections with the local distortions/corrections
+void calcDistortionsCorrections(SC& sc, const Side side, const bool simd)
+{
+  const bool simdOld = SC::getSIMDDrift();
+  SC::setSIMDDrift(simd);
+  AnalyticalFields<DataT> anaFields(side);
+  sc.calcLocalDistortionCorrectionVector(anaFields);
+  sc.calcLocalDistortionsCorrectionsRK4(SC::Type::Distortions, side);
+  sc.calcLocalDistortionsCorrectionsRK4(SC::Type::Corrections, side);
+  sc.calcGlobalCorrections(sc.getLocalCorrInterpolator(side));
+  sc.calcGlobalDistortions(sc.getLocalDistInterpolator(side));
+  SC::setSIMDDrift(simdOld);
+}
+
+/// compare the map of the SIMD drift to the one of the scalar drift
+template <typename Getter>
+void compareMaps(const SC& scSIMD, const SC& scScalar, const Side side, Getter getter, const char* name)
+{
+  DataT maxDiff = 0;
+  for (size_t iPhi = 0; iPhi < NPHI; ++iPhi) {
+    for (size_t iR = 0; iR < NR; ++iR) {
+      for (size_t iZ = 0; iZ < NZ; ++iZ) {
+        const DataT valSIMD = getter(scSIMD, iZ, iR, iPhi, side);
+        const DataT valScalar = getter(scScalar, iZ, iR, iPhi, side);
+        const DataT diff = std::abs(valSIMD - valScalar) / (1 + std::abs(valScalar));
+        maxDiff = std::max(maxDiff, diff);
+      }
+    }
+  }
+  BOOST_TEST_INFO("map " << name << " side " << int(side));
+  BOOST_CHECK_SMALL(maxDiff, TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(SpaceChargeSIMDDrift_test)
+{
+  for (const Side side : {Side::A, Side::C}) {
+    SC scSIMD(BFIELD, NZ, NR, NPHI);
+    SC scScalar(BFIELD, NZ, NR, NPHI);
+    calcDistortionsCorrections(scSIMD, side, true);
+    calcDistortionsCorrections(scScalar, side, false);
+
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalDistR(iz, ir, iphi, s); }, "local dist R");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalDistZ(iz, ir, iphi, s); }, "local dist Z");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalDistRPhi(iz, ir, iphi, s); }, "local dist RPhi");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalCorrR(iz, ir, iphi, s); }, "local corr R");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalCorrZ(iz, ir, iphi, s); }, "local corr Z");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getLocalCorrRPhi(iz, ir, iphi, s); }, "local corr RPhi");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalDistR(iz, ir, iphi, s); }, "global dist R");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalDistZ(iz, ir, iphi, s); }, "global dist Z");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalDistRPhi(iz, ir, iphi, s); }, "global dist RPhi");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalCorrR(iz, ir, iphi, s); }, "global corr R");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalCorrZ(iz, ir, iphi, s); }, "global corr Z");
+    compareMaps(scSIMD, scScalar, side, [](const SC& sc, size_t iz, size_t ir, size_t iphi, Side s) { return sc.getGlobalCorrRPhi(iz, ir, iphi, s); }, "global corr RPhi");
+
+    // the maps are not trivially equal
+    DataT sumGlobalDist = 0;
+    for (size_t iR = 0; iR < NR; ++iR) {
+      sumGlobalDist += std::abs(scScalar.getGlobalDistR(NZ / 2, iR, 0, side));
+    }
+    BOOST_CHECK(sumGlobalDist > 0);
+  }
+}
+
+} // namespace tpc
+} // namespace o2
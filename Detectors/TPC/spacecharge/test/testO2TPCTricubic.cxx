@@ -99,5 +99,43 @@ BOOST_AUTO_TEST_CASE(PoissonSolver3D_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TriCubicSIMD_test)
+{
+  using VDataT = Vc::Vector<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const DataT zmin = o2::tpc::GridProperties<DataT>::ZMIN;
+  const DataT rmin = o2::tpc::GridProperties<DataT>::RMIN;
+  const DataT phimin = o2::tpc::GridProperties<DataT>::PHIMIN;
+  const DataT rSpacing = o2::tpc::GridProperties<DataT>::getGridSpacingR(NR);
+  const DataT zSpacing = o2::tpc::GridProperties<DataT>::getGridSpacingZ(NZ);
+  const DataT phiSpacing = o2::tpc::GridProperties<DataT>::getGridSpacingPhi(NPHI);
+  o2::tpc::RegularGrid3D<DataT> grid3D(zmin, rmin, phimin, zSpacing, rSpacing, phiSpacing, params);
+  o2::tpc::DataContainer3D<DataT> data3D(NZ, NR, NPHI);
+  o2::tpc::AnalyticalFields<DataT> field;
+  for (int iz = 0; iz < NZ; ++iz) {
+    for (int ir = 0; ir < NR; ++ir) {
+      for (int iphi = 0; iphi < NPHI; ++iphi) {
+        data3D(iz, ir, iphi) = field.evalPotential(zSpacing * iz + zmin, rSpacing * ir + rmin, phiSpacing * iphi + phimin);
+      }
+    }
+  }
+  o2::tpc::TriCubicInterpolator<DataT> interpolator(data3D, grid3D);
+
+  // the lanes cover the inner volume and the boundaries of the grid, where the scalar method is used, in the same batch
+  const int nPoints = 3 * std::max(NR, NZ);
+  for (int iR = -2; iR < nPoints + 2; ++iR) {
+    for (int iZ = -2; iZ < nPoints + 2; ++iZ) {
+      const VDataT z = VDataT::generate([&](size_t i) { return zmin + (iZ + 0.5 * i) * (NZ - 1) * zSpacing / nPoints; });
+      const VDataT r = VDataT::generate([&](size_t i) { return rmin + (iR + 0.7 * i) * (NR - 1) * rSpacing / nPoints; });
+      const VDataT phi = VDataT::generate([&](size_t i) { return phimin + (iR * 7 + iZ * 3 + 13 * i) * phiSpacing * 0.31; });
+      const VDataT interpolated = interpolator(z, r, phi);
+      for (size_t i = 0; i < VDataT::Size; ++i) {
+        const DataT interpolatedScalar = interpolator(z[i], r[i], phi[i]);
+        BOOST_CHECK_SMALL(interpolated[i] - interpolatedScalar, DataT(1e-10));
+      }
+    }
+  }
+}
+
 } // namespace tpc
 } // namespace o2
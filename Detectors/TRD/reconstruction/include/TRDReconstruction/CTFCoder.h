@@ -188,6 +188,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VTRK& tr
   std::vector<uint8_t> padrowTrk, colTrk, slopeTrk, ROBDig, MCMDig, chanDig;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODETRD(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODETRD(bcInc,       CTF::BLC_bcIncTrig);
@@ -207,6 +208,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VTRK& tr
   iosize += DECODETRD(MCMDig,      CTF::BLC_MCMDig);
   iosize += DECODETRD(chanDig,     CTF::BLC_chanDig);
   iosize += DECODETRD(ADCDig,      CTF::BLC_ADCDig);
+  blockDecoding.flush();
   // clang-format on
   //
   trigVec.clear();
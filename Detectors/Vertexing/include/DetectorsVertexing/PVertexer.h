@@ -134,11 +134,28 @@ class PVertexer
 
   void setPoolDumpDirectory(const std::string& d) { mPoolDumpDirectory = d; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   void printInpuTracksStatus(const VertexingInput& input) const;
 
  private:
   static constexpr int DBS_UNDEF = -2, DBS_NOISE = -1, DBS_INCHECK = -10;
 
+  struct TZClusterStat { // statistics of the processing of single time-Z cluster
+    int nTrials = 0;
+    long timeMS = 0;
+    long mult = 0;
+    bool timeOut = false;
+  };
+
+  struct TZClusterOutput { // vertices found in single time-Z cluster, used by the multithreaded processing
+    std::vector<PVertex> vertices;
+    std::vector<uint32_t> trackIDs;
+    std::vector<V2TRef> v2tRefs;
+    TZClusterStat stat;
+  };
+
   SeedHistoTZ buildHistoTZ(const VertexingInput& input);
   int runVertexing(gsl::span<o2d::GlobalTrackID> gids, const gsl::span<InteractionCandidate> intCand,
                    std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs,
@@ -164,7 +181,9 @@ class PVertexer
   template <typename TR>
   void createTracksPool(const TR& tracks, gsl::span<const o2d::GlobalTrackID> gids);
 
-  int findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
+  int findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs, TZClusterStat& stat);
+  void findVerticesMT(std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
+  void accountClusterStat(const TZClusterStat& stat);
   void reAttach(std::vector<PVertex>& vertices, std::vector<int>& timeSort, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
 
   std::pair<int, int> getBestIR(const PVertex& vtx, const gsl::span<InteractionCandidate> intCand, int& currEntry) const;
@@ -223,6 +242,7 @@ class PVertexer
   int mLongestClusterMult = 0;
   bool mPoolDumpProduced = false;
   bool mITSOnly = false;
+  int mNThreads = 1;
   TStopwatch mTimeDBScan;
   TStopwatch mTimeVertexing;
   TStopwatch mTimeDebris;
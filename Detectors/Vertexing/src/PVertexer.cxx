@@ -22,6 +22,10 @@
 #include "CommonUtils/StringUtils.h"
 #include <TH2F.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::vertexing;
 using DetID = o2::detectors::DetID;
 constexpr float PVertexer::kAlmost0F;
@@ -63,17 +67,24 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
   mTimeVertexing.Start();
-  int cntTZ = 0;
-  for (auto tc : mTimeZClusters) {
-    size_t nnold = verticesLoc.size();
-    VertexingInput inp;
-    inp.idRange = gsl::span<int>(tc.trackIDs);
-    inp.scaleSigma2 = mPVParams->iniScale2;
-    inp.timeEst = tc.timeEst;
+#ifndef _PV_DEBUG_TREE_
+  if (mNThreads > 1 && mTimeZClusters.size() > 1) {
+    findVerticesMT(verticesLoc, trackIDs, v2tRefsLoc);
+  } else
+#endif
+  {
+    for (auto tc : mTimeZClusters) {
+      VertexingInput inp;
+      inp.idRange = gsl::span<int>(tc.trackIDs);
+      inp.scaleSigma2 = mPVParams->iniScale2;
+      inp.timeEst = tc.timeEst;
 #ifdef _PV_DEBUG_TREE_
-    doDBScanDump(inp, lblTracks);
+      doDBScanDump(inp, lblTracks);
 #endif
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+      TZClusterStat stat;
+      findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc, stat);
+      accountClusterStat(stat);
+    }
   }
   mTimeVertexing.Stop();
   // sort in time
@@ -170,7 +181,56 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 }
 
 //______________________________________________
-int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs)
+void PVertexer::findVerticesMT(std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs)
+{
+  // Process time-Z clusters in parallel. The clusters do not share tracks, so each one can be fitted independently to its own output,
+  // the outputs are merged in the order of clusters, reproducing the result of the sequential processing
+  int nClusters = mTimeZClusters.size();
+  std::vector<TZClusterOutput> outputs(nClusters);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ic = 0; ic < nClusters; ic++) {
+    const auto& tc = mTimeZClusters[ic];
+    auto& out = outputs[ic];
+    VertexingInput inp;
+    inp.idRange = gsl::span<int>(const_cast<std::vector<int>&>(tc.trackIDs));
+    inp.scaleSigma2 = mPVParams->iniScale2;
+    inp.timeEst = tc.timeEst;
+    findVertices(inp, out.vertices, out.trackIDs, out.v2tRefs, out.stat);
+  }
+  for (auto& out : outputs) {
+    int vtxOffset = vertices.size(), trOffset = trackIDs.size();
+    for (const auto& ref : out.v2tRefs) {
+      v2tRefs.emplace_back(ref.getFirstEntry() + trOffset, ref.getEntries());
+    }
+    for (auto id : out.trackIDs) {
+      mTracksPool[id].vtxID += vtxOffset; // vertex IDs were assigned wrt the cluster output
+      trackIDs.push_back(id);
+    }
+    vertices.insert(vertices.end(), out.vertices.begin(), out.vertices.end());
+    accountClusterStat(out.stat);
+  }
+}
+
+//______________________________________________
+void PVertexer::accountClusterStat(const TZClusterStat& stat)
+{
+  mTotTrials += stat.nTrials;
+  if (size_t(stat.nTrials) > mMaxTrialPerCluster) {
+    mMaxTrialPerCluster = stat.nTrials;
+  }
+  if (stat.timeMS > mLongestClusterTimeMS) {
+    mLongestClusterTimeMS = stat.timeMS;
+    mLongestClusterMult = stat.mult;
+  }
+  if (stat.timeOut && !mPoolDumpProduced) {
+    dumpPool();
+  }
+}
+
+//______________________________________________
+int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs, TZClusterStat& stat)
 {
   // find vertices using tracks with indices (sorted in time) from idRange from "tracks" pool. The pool may containt arbitrary number of tracks,
   // only those which are in the idRange and have canUse()==true, will be used.
@@ -223,20 +283,13 @@ int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& v
     auto clTime = tCurr - tStart;
     if (clTime > mPVParams->maxTimeMSPerCluster) {
       LOGP(warn, "Time per TZ-cluster ({}ms) of {} tracks exceeded limit after {} trials, abandon", clTime, mult, nTrials);
-      if (!mPoolDumpProduced) {
-        dumpPool();
-      }
+      stat.timeOut = true; // the pool dump is requested once the cluster is done
       break;
     }
   }
-  mTotTrials += nTrials;
-  if (size_t(nTrials) > mMaxTrialPerCluster) {
-    mMaxTrialPerCluster = nTrials;
-  }
-  if (tCurr - tStart > mLongestClusterTimeMS) {
-    mLongestClusterTimeMS = tCurr - tStart;
-    mLongestClusterMult = mult;
-  }
+  stat.nTrials = nTrials;
+  stat.timeMS = tCurr - tStart;
+  stat.mult = mult;
   return nfound;
 }
 
@@ -1379,6 +1432,16 @@ int PVertexer::processFromExternalPool(const std::vector<TrackVF>& pool, std::ve
   return runVertexing(gids, intCand, vertices, vertexTrackIDs, v2tRefs, lblTracks, lblVtx);
 }
 
+//______________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 void PVertexer::setTrackSources(GTrackID::mask_t s)
 {
@@ -165,6 +165,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCHAN& c
   std::vector<uint8_t> extTriggers, chanID;
 
   o2::ctf::CTFIOSize iosize;
+  BlockDecodingScope blockDecoding;
 #define DECODEZDC(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
   // clang-format off
   iosize += DECODEZDC(bcIncTrig,      CTF::BLC_bcIncTrig);
@@ -181,6 +182,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCHAN& c
   iosize += DECODEZDC(orbitIncEOD,    CTF::BLC_orbitIncEOD);
   iosize += DECODEZDC(pedData,        CTF::BLC_pedData);
   iosize += DECODEZDC(scalerInc,      CTF::BLC_sclInc);
+  blockDecoding.flush();
   // clang-format on
   //
   trigVec.clear();
@@ -151,6 +151,8 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
     auto filename = options.get<std::string>("aod-file-private");
 
     auto maxRate = options.get<float>("aod-max-io-rate");
+    auto readAllColumns = options.get<bool>("aod-read-all-columns");
+    auto prefetchMemory = options.get<int64_t>("aod-prefetch-memory");
 
     // create a DataInputDirector
     auto didir = std::make_shared<DataInputDirector>(filename, &monitoring, parentAccessLevel, parentFileReplacement);
@@ -160,6 +162,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
         LOGP(error, "Check the JSON document! Can not be properly parsed!");
       }
     }
+    if (prefetchMemory > 0) {
+      didir->setPrefetching(prefetchMemory * 1000000);
+    }
 
     // get the run time watchdog
     auto* watchdog = new RuntimeWatchdog(options.get<int64_t>("time-limit"));
@@ -171,6 +176,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
     header::DataHeader TFNumberHeader;
     header::DataHeader TFFileNameHeader;
     std::vector<OutputRoute> requestedTables;
+    std::vector<std::vector<std::string>> requestedColumns; // persistent columns of the subscribed table definitions, empty to read all
     std::vector<OutputRoute> routes(spec.outputs);
     for (auto route : routes) {
       if (DataSpecUtils::partialMatch(route.matcher, header::DataOrigin("TFN"))) {
@@ -183,6 +189,12 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
         reportTFFileName = true;
       } else {
         requestedTables.emplace_back(route);
+        auto& columns = requestedColumns.emplace_back();
+        for (auto& meta : route.matcher.metadata) {
+          if (!readAllColumns && meta.name.starts_with("column:")) {
+            columns.emplace_back(meta.name.substr(strlen("column:")));
+          }
+        }
       }
     }
 
@@ -191,6 +203,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
     return adaptStateless([TFNumberHeader,
                            TFFileNameHeader,
                            requestedTables,
+                           requestedColumns,
                            fileCounter,
                            numTF,
                            watchdog,
@@ -212,6 +225,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
       bool first = true;
       static size_t totalSizeUncompressed = 0;
       static size_t totalSizeCompressed = 0;
+      static size_t totalSizeSkipped = 0;
       static uint64_t totalDFSent = 0;
 
       // check if RuntimeLimit is reached
@@ -227,7 +241,10 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
 
       int64_t startTime = uv_hrtime();
       int64_t startSize = totalSizeCompressed;
-      for (auto& route : requestedTables) {
+      uint64_t startReadTime = didir->getReadTime();
+      for (size_t ir = 0; ir < requestedTables.size(); ir++) {
+        auto& route = requestedTables[ir];
+        auto& columns = requestedColumns[ir];
         if ((device.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
           continue;
         }
@@ -236,7 +253,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
         auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
         auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
 
-        if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed)) {
+        if (!didir->readTree(outputs, dh, fcnt, ntf, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped)) {
           if (first) {
             // check if there is a next file to read
             fcnt += device.maxInputTimeslices;
@@ -250,7 +267,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
             }
             // get first folder of next file
             ntf = 0;
-            if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed)) {
+            if (!didir->readTree(outputs, dh, fcnt, ntf, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped)) {
               LOGP(fatal, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin.as<std::string>(), fcnt, ntf);
               throw std::runtime_error("Processing is stopped!");
             }
@@ -299,6 +316,10 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
       monitoring.send(Metric{(uint64_t)totalDFSent, "df-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      monitoring.send(Metric{(uint64_t)totalSizeSkipped / 1000, "aod-bytes-skipped-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      // time to read the DF and time the reader waited for it, which differ when the DF was prefetched
+      monitoring.send(Metric{(uint64_t)(didir->getReadTime() - startReadTime) / 1000, "aod-df-read-time-us"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      monitoring.send(Metric{(uint64_t)(stopTime - startTime) / 1000, "aod-df-wait-time-us"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
 
       // save file number and time frame
       *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
@@ -323,6 +344,26 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
           control.readyToQuit(QuitRequest::Me);
           return;
         }
+        // the next DF is the 1st one of the next file of this reader
+        fcnt += device.maxInputTimeslices - 1;
+        if (didir->isPrefetching() && !didir->atEnd(fcnt)) {
+          *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
+          *numTF = -1;
+        }
+      }
+
+      // read the next DF while the current one is processed
+      if (didir->isPrefetching() && !didir->atEnd(fcnt)) {
+        std::vector<std::pair<header::DataHeader, std::vector<std::string>>> tables;
+        for (size_t ir = 0; ir < requestedTables.size(); ir++) {
+          auto& route = requestedTables[ir];
+          if ((device.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
+            continue;
+          }
+          auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+          tables.emplace_back(header::DataHeader(concrete.description, concrete.origin, concrete.subSpec), requestedColumns[ir]);
+        }
+        didir->prefetch(tables, fcnt, ntf);
       }
     });
   })};
@@ -26,6 +26,9 @@
 #include "TGrid.h"
 #include "TObjString.h"
 #include "TMap.h"
+#include "TROOT.h"
+
+#include <arrow/table.h>
 
 #include <uv.h>
 
@@ -234,9 +237,7 @@ DataInputDescriptor* DataInputDescriptor::getParentFile(int counter, int numTF,
     if (parentFileName->GetString().CompareTo(mParentFile->mcurrentFile->GetName()) == 0) {
       return mParentFile;
     } else {
-      mParentFile->closeInputFile();
-      delete mParentFile;
-      mParentFile = nullptr;
+      closeParentFile();
     }
   }
 
@@ -279,17 +280,30 @@ void DataInputDescriptor::printFileStatistics()
     monitoringInfo += fmt::format(",se={},open_time={:.1f}", alienFile->GetSE(), alienFile->GetElapsed());
   }
 #endif
-  mMonitoring->send(o2::monitoring::Metric{monitoringInfo, "aod-file-read-info"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+  mFileReadInfo.emplace_back(monitoringInfo);
   LOGP(info, "Read info: {}", monitoringInfo);
 }
 
+std::vector<std::string> DataInputDescriptor::takeFileReadInfo()
+{
+  return std::move(mFileReadInfo);
+}
+
+void DataInputDescriptor::closeParentFile()
+{
+  mParentFile->closeInputFile();
+  for (auto& info : mParentFile->takeFileReadInfo()) {
+    mFileReadInfo.emplace_back(std::move(info));
+  }
+  delete mParentFile;
+  mParentFile = nullptr;
+}
+
 void DataInputDescriptor::closeInputFile()
 {
   if (mcurrentFile) {
     if (mParentFile) {
-      mParentFile->closeInputFile();
-      delete mParentFile;
-      mParentFile = nullptr;
+      closeParentFile();
     }
 
     delete mParentFileMap;
@@ -354,13 +368,25 @@ int DataInputDescriptor::findDFNumber(int file, std::string dfName)
   return it - dfList.begin();
 }
 
-bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, std::vector<std::string> const& columns,
+                                   size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped)
+{
+  auto table = readTable(counter, numTF, treename, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped);
+  if (!table) {
+    return false;
+  }
+  outputs.adopt(Output(dh), table);
+  return true;
+}
+
+std::shared_ptr<arrow::Table> DataInputDescriptor::readTable(int counter, int numTF, std::string treename, std::vector<std::string> const& columns,
+                                                             size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped)
 {
   auto ioStart = uv_hrtime();
 
   auto fileAndFolder = getFileFolder(counter, numTF);
   if (!fileAndFolder.file) {
-    return false;
+    return nullptr;
   }
 
   auto fullpath = fileAndFolder.folderName + "/" + treename;
@@ -375,27 +401,25 @@ bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh
         throw std::runtime_error(fmt::format(R"(DF {} listed in parent file map but not found in the corresponding file "{}")", fileAndFolder.folderName, parentFile->mcurrentFile->GetName()));
       }
       // first argument is 0 as the parent file object contains only 1 file
-      return parentFile->readTree(outputs, dh, 0, parentNumTF, treename, totalSizeCompressed, totalSizeUncompressed);
+      return parentFile->readTable(0, parentNumTF, treename, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped);
     }
     throw std::runtime_error(fmt::format(R"(Couldn't get TTree "{}" from "{}". Please check https://aliceo2group.github.io/analysis-framework/docs/troubleshooting/#tree-not-found for more information.)", fileAndFolder.folderName + "/" + treename, fileAndFolder.file->GetName()));
   }
 
-  // create table output
-  auto o = Output(dh);
-  auto t2t = outputs.make<TreeToTable>(o);
-
   // add branches to read
   // fill the table
-  t2t->setLabel(tree->GetName());
-  totalSizeCompressed += tree->GetZipBytes();
-  totalSizeUncompressed += tree->GetTotBytes();
-  t2t->addAllColumns(tree);
-  t2t->fill(tree);
+  TreeToTable t2t;
+  t2t.setLabel(tree->GetName());
+  t2t.addAllColumns(tree, std::vector<std::string>{columns});
+  totalSizeCompressed += t2t.getZipBytes();
+  totalSizeUncompressed += t2t.getTotBytes();
+  totalSizeSkipped += tree->GetZipBytes() - t2t.getZipBytes();
+  t2t.fill(tree);
   delete tree;
 
   mIOTime += (uv_hrtime() - ioStart);
 
-  return true;
+  return t2t.finalize();
 }
 
 DataInputDirector::DataInputDirector()
@@ -426,6 +450,7 @@ DataInputDirector::DataInputDirector(std::vector<std::string> inputFiles, o2::mo
 
 DataInputDirector::~DataInputDirector()
 {
+  stopPrefetching();
   for (auto fn : mdefaultInputFiles) {
     delete fn;
   }
@@ -693,8 +718,25 @@ DataInputDescriptor* DataInputDirector::getDataInputDescriptor(header::DataHeade
   return result;
 }
 
+DataInputDescriptor* DataInputDirector::getDataInputDescriptor(header::DataHeader dh, std::string& treename)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  if (didesc) {
+    // if match then use filename and treename from DataInputDescriptor
+    treename = didesc->treename;
+  } else {
+    // if NOT match then use
+    //  . filename from defaultDataInputDescriptor
+    //  . treename from DataHeader
+    didesc = mdefaultDataInputDescriptor;
+    treename = aod::datamodel::getTreeName(dh);
+  }
+  return didesc;
+}
+
 FileAndFolder DataInputDirector::getFileFolder(header::DataHeader dh, int counter, int numTF)
 {
+  std::lock_guard<std::mutex> lock(mMutex);
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -706,6 +748,7 @@ FileAndFolder DataInputDirector::getFileFolder(header::DataHeader dh, int counte
 
 int DataInputDirector::getTimeFramesInFile(header::DataHeader dh, int counter)
 {
+  std::lock_guard<std::mutex> lock(mMutex);
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -717,6 +760,7 @@ int DataInputDirector::getTimeFramesInFile(header::DataHeader dh, int counter)
 
 uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counter, int numTF)
 {
+  std::lock_guard<std::mutex> lock(mMutex);
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -726,31 +770,207 @@ uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counte
   return didesc->getTimeFrameNumber(counter, numTF);
 }
 
-bool DataInputDirector::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+bool DataInputDirector::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::vector<std::string> const& columns,
+                                 size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped)
 {
+  auto table = readTable(dh, counter, numTF, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped);
+  if (!table) {
+    return false;
+  }
+  outputs.adopt(Output(dh), table);
+  return true;
+}
+
+std::shared_ptr<arrow::Table> DataInputDirector::readTable(header::DataHeader dh, int counter, int numTF, std::vector<std::string> const& columns,
+                                                           size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped)
+{
+  PrefetchedTable prefetched;
+  if (takePrefetched(dh, counter, numTF, prefetched)) {
+    totalSizeCompressed += prefetched.sizeCompressed;
+    totalSizeUncompressed += prefetched.sizeUncompressed;
+    totalSizeSkipped += prefetched.sizeSkipped;
+    mReadTime += prefetched.readTime;
+    std::lock_guard<std::mutex> lock(mMutex);
+    sendFileReadInfo();
+    return prefetched.table;
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto readStart = uv_hrtime();
   std::string treename;
+  auto didesc = getDataInputDescriptor(dh, treename);
+  auto table = didesc->readTable(counter, numTF, treename, columns, totalSizeCompressed, totalSizeUncompressed, totalSizeSkipped);
+  mReadTime += uv_hrtime() - readStart;
+  sendFileReadInfo();
 
-  auto didesc = getDataInputDescriptor(dh);
-  if (didesc) {
-    // if match then use filename and treename from DataInputDescriptor
-    treename = didesc->treename;
-  } else {
-    // if NOT match then use
-    //  . filename from defaultDataInputDescriptor
-    //  . treename from DataHeader
-    didesc = mdefaultDataInputDescriptor;
-    treename = aod::datamodel::getTreeName(dh);
+  return table;
+}
+
+void DataInputDirector::setPrefetching(size_t memoryBudget)
+{
+  stopPrefetching();
+  mPrefetchBudget = memoryBudget;
+  if (mPrefetchBudget == 0) {
+    return;
+  }
+  // the files are opened and read alternately by the processing and the prefetching threads
+  ROOT::EnableThreadSafety();
+  mStopPrefetching = false;
+  mPrefetchThread = std::thread(&DataInputDirector::prefetchLoop, this);
+}
+
+void DataInputDirector::prefetch(std::vector<std::pair<header::DataHeader, std::vector<std::string>>> const& tables, int counter, int numTF)
+{
+  if (!isPrefetching()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  // a running read can not be interrupted but the remaining tables of the previous DF are not read anymore,
+  // the ones which were not taken are dropped
+  mAbortPrefetch = true;
+  mPrefetchCondition.notify_all();
+  mPrefetchCondition.wait(lock, [this]() { return mPrefetchState != PrefetchState::Requested; });
+  mAbortPrefetch = false;
+  mPrefetched.clear();
+  mPrefetchedMemory = 0;
+  mPrefetchError = nullptr;
+  mPrefetchTables = tables;
+  mPrefetchCounter = counter;
+  mPrefetchNumTF = numTF;
+  mPrefetchState = PrefetchState::Requested;
+  mPrefetchCondition.notify_all();
+}
+
+void DataInputDirector::prefetchLoop()
+{
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  while (true) {
+    mPrefetchCondition.wait(lock, [this]() { return mStopPrefetching || mPrefetchState == PrefetchState::Requested; });
+    if (mStopPrefetching) {
+      return;
+    }
+    auto tables = mPrefetchTables;
+    auto counter = mPrefetchCounter;
+    auto numTF = mPrefetchNumTF;
+
+    std::exception_ptr error;
+    try {
+      for (auto& [dh, columns] : tables) {
+        if (mStopPrefetching || mAbortPrefetch) {
+          break;
+        }
+        lock.unlock();
+        PrefetchedTable table{dh};
+        {
+          std::lock_guard<std::mutex> readLock(mMutex);
+          auto readStart = uv_hrtime();
+          std::string treename;
+          auto didesc = getDataInputDescriptor(dh, treename);
+          table.table = didesc->readTable(counter, numTF, treename, columns, table.sizeCompressed, table.sizeUncompressed, table.sizeSkipped);
+          table.readTime = uv_hrtime() - readStart;
+        }
+        lock.lock();
+        if (!table.table) {
+          // not available, this is handled by the synchronous reading
+          break;
+        }
+        // queue the table only once it fits in the budget together with the tables not taken yet,
+        // a table larger than the budget is queued alone
+        mPrefetchBlocked = true;
+        mPrefetchCondition.notify_all();
+        mPrefetchCondition.wait(lock, [this, &table]() {
+          return mStopPrefetching || mAbortPrefetch || mPrefetched.empty() || mPrefetchedMemory + table.sizeUncompressed <= mPrefetchBudget;
+        });
+        mPrefetchBlocked = false;
+        if (mStopPrefetching || mAbortPrefetch) {
+          break;
+        }
+        mPrefetchedMemory += table.sizeUncompressed;
+        mPrefetched.emplace_back(std::move(table));
+        mPrefetchCondition.notify_all();
+      }
+    } catch (...) {
+      error = std::current_exception();
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+    }
+
+    mPrefetchError = error;
+    mPrefetchState = PrefetchState::Done;
+    mPrefetchCondition.notify_all();
   }
+}
 
-  return didesc->readTree(outputs, dh, counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed);
+bool DataInputDirector::takePrefetched(header::DataHeader dh, int counter, int numTF, PrefetchedTable& prefetched)
+{
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  if (mPrefetchState == PrefetchState::Idle || mPrefetchCounter != counter || mPrefetchNumTF != numTF) {
+    return false;
+  }
+  auto findTable = [this, &dh]() { return std::find_if(mPrefetched.begin(), mPrefetched.end(), [&dh](auto const& table) { return table.dh == dh; }); };
+  // the tables are taken as soon as they are queued, when the prefetching waits for the memory of other tables
+  // to be released, the requested one is read synchronously
+  mPrefetchCondition.wait(lock, [this, &findTable]() { return mPrefetchState == PrefetchState::Done || mPrefetchBlocked || findTable() != mPrefetched.end(); });
+  auto it = findTable();
+  if (it == mPrefetched.end()) {
+    if (mPrefetchError) {
+      auto error = mPrefetchError;
+      mPrefetchError = nullptr;
+      mPrefetched.clear();
+      mPrefetchedMemory = 0;
+      mPrefetchState = PrefetchState::Idle;
+      std::rethrow_exception(error);
+    }
+    return false;
+  }
+  prefetched = std::move(*it);
+  mPrefetched.erase(it);
+  mPrefetchedMemory -= prefetched.sizeUncompressed;
+  lock.unlock();
+  mPrefetchCondition.notify_all();
+  return true;
+}
+
+void DataInputDirector::stopPrefetching()
+{
+  if (!isPrefetching()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    mStopPrefetching = true;
+  }
+  mPrefetchCondition.notify_all();
+  mPrefetchThread.join();
+  mPrefetched.clear();
+  mPrefetchedMemory = 0;
+  mPrefetchState = PrefetchState::Idle;
+}
+
+void DataInputDirector::sendFileReadInfo()
+{
+  auto send = [this](DataInputDescriptor* didesc) {
+    for (auto& info : didesc->takeFileReadInfo()) {
+      if (mMonitoring) {
+        mMonitoring->send(o2::monitoring::Metric{info, "aod-file-read-info"}.addTag(o2::monitoring::tags::Key::Subsystem, o2::monitoring::tags::Value::DPL));
+      }
+    }
+  };
+  send(mdefaultDataInputDescriptor);
+  for (auto didesc : mdataInputDescriptors) {
+    send(didesc);
+  }
 }
 
 void DataInputDirector::closeInputFiles()
 {
+  stopPrefetching();
   mdefaultDataInputDescriptor->closeInputFile();
   for (auto didesc : mdataInputDescriptors) {
     didesc->closeInputFile();
   }
+  sendFileReadInfo();
 }
 
 bool DataInputDirector::isValid()
@@ -766,6 +986,7 @@ bool DataInputDirector::isValid()
 
 bool DataInputDirector::atEnd(int counter)
 {
+  std::lock_guard<std::mutex> lock(mMutex);
   bool status = mdefaultDataInputDescriptor->getNumberInputfiles() <= counter;
   for (auto didesc : mdataInputDescriptors) {
     status &= (didesc->getNumberInputfiles() <= counter);
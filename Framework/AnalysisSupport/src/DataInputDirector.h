@@ -16,7 +16,11 @@
 #include "Framework/DataDescriptorMatcher.h"
 #include "Framework/DataAllocator.h"
 
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <regex>
+#include <thread>
 #include "rapidjson/fwd.h"
 
 namespace o2::monitoring
@@ -24,6 +28,11 @@ namespace o2::monitoring
 class Monitoring;
 }
 
+namespace arrow
+{
+class Table;
+}
+
 namespace o2::framework
 {
 
@@ -83,11 +92,18 @@ class DataInputDescriptor
   int getTimeFramesInFile(int counter);
   int getReadTimeFramesInFile(int counter);
 
-  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed);
+  /// read the tree, if the list of columns is not empty only these are read and the size of the others is added to totalSizeSkipped
+  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, std::vector<std::string> const& columns,
+                size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped);
+  /// same as readTree, but the table is returned instead of being sent, nullptr if the DF is not available
+  std::shared_ptr<arrow::Table> readTable(int counter, int numTF, std::string treename, std::vector<std::string> const& columns,
+                                          size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped);
 
   void printFileStatistics();
   void closeInputFile();
   bool isAlienSupportOn() { return mAlienSupport; }
+  /// statistics of the files closed since the last call, to be sent to the monitoring
+  std::vector<std::string> takeFileReadInfo();
 
  private:
   std::string minputfilesFile = "";
@@ -112,6 +128,10 @@ class DataInputDescriptor
 
   uint64_t mIOTime = 0;
   uint64_t mCurrentFileStartedAt = 0;
+
+  // files may be closed by the prefetching thread, the monitoring is only accessed from the processing thread
+  std::vector<std::string> mFileReadInfo;
+  void closeParentFile();
 };
 
 class DataInputDirector
@@ -141,7 +161,11 @@ class DataInputDirector
   DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh);
   int getNumberInputDescriptors() { return mdataInputDescriptors.size(); }
 
-  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed);
+  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::vector<std::string> const& columns,
+                size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped);
+  /// the table of dh in the DF numTF of the file counter, the prefetched one if available, nullptr if the DF is not available
+  std::shared_ptr<arrow::Table> readTable(header::DataHeader dh, int counter, int numTF, std::vector<std::string> const& columns,
+                                          size_t& totalSizeCompressed, size_t& totalSizeUncompressed, size_t& totalSizeSkipped);
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
@@ -149,6 +173,16 @@ class DataInputDirector
   uint64_t getTotalSizeCompressed();
   uint64_t getTotalSizeUncompressed();
 
+  /// read the next DF in a background thread, keeping at most memoryBudget uncompressed bytes of tables read ahead
+  /// and not taken yet, 0 to disable
+  void setPrefetching(size_t memoryBudget);
+  bool isPrefetching() const { return mPrefetchThread.joinable(); }
+  /// start reading the tables (with their list of columns) of the DF numTF of the file counter in the background,
+  /// readTree of these tables then returns the prefetched data
+  void prefetch(std::vector<std::pair<header::DataHeader, std::vector<std::string>>> const& tables, int counter, int numTF);
+  /// time spent reading the tables sent so far, in the background or not, in ns
+  uint64_t getReadTime() const { return mReadTime; }
+
  private:
   std::string minputfilesFile;
   std::string* const minputfilesFilePtr = &minputfilesFile;
@@ -165,8 +199,42 @@ class DataInputDirector
   bool mDebugMode = false;
   bool mAlienSupport = false;
 
+  // prefetching of the next DF
+  struct PrefetchedTable {
+    header::DataHeader dh;
+    std::shared_ptr<arrow::Table> table;
+    size_t sizeCompressed = 0;
+    size_t sizeUncompressed = 0;
+    size_t sizeSkipped = 0;
+    uint64_t readTime = 0;
+  };
+  enum struct PrefetchState { Idle,
+                              Requested,
+                              Done };
+  std::mutex mMutex; // serialises the access to the input descriptors and their files
+  std::mutex mPrefetchMutex;
+  std::condition_variable mPrefetchCondition;
+  std::thread mPrefetchThread;
+  size_t mPrefetchBudget = 0;
+  bool mStopPrefetching = false;
+  bool mAbortPrefetch = false;   // a new DF is requested, the tables of the current one are not read anymore
+  bool mPrefetchBlocked = false; // a read table waits for the memory of the queued ones to be released
+  size_t mPrefetchedMemory = 0;  // uncompressed size of the queued tables
+  PrefetchState mPrefetchState = PrefetchState::Idle;
+  int mPrefetchCounter = -1;
+  int mPrefetchNumTF = -1;
+  std::vector<std::pair<header::DataHeader, std::vector<std::string>>> mPrefetchTables;
+  std::vector<PrefetchedTable> mPrefetched;
+  std::exception_ptr mPrefetchError;
+  uint64_t mReadTime = 0;
+
   bool readJsonDocument(rapidjson::Document* doc);
   bool isValid();
+  DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh, std::string& treename);
+  void prefetchLoop();
+  bool takePrefetched(header::DataHeader dh, int counter, int numTF, PrefetchedTable& prefetched);
+  void stopPrefetching();
+  void sendFileReadInfo();
 };
 
 } // namespace o2::framework
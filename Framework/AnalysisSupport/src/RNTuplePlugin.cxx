@@ -109,12 +109,14 @@ class RNTupleFileFormat : public arrow::dataset::FileFormat
 {
   size_t& mTotCompressedSize;
   size_t& mTotUncompressedSize;
+  size_t& mTotSkippedSize;
 
  public:
-  RNTupleFileFormat(size_t& totalCompressedSize, size_t& totalUncompressedSize)
+  RNTupleFileFormat(size_t& totalCompressedSize, size_t& totalUncompressedSize, size_t& totalSkippedSize)
     : FileFormat({}),
       mTotCompressedSize(totalCompressedSize),
-      mTotUncompressedSize(totalUncompressedSize)
+      mTotUncompressedSize(totalUncompressedSize),
+      mTotSkippedSize(totalSkippedSize)
   {
   }
 
@@ -521,7 +523,7 @@ arrow::Result<arrow::RecordBatchGenerator> RNTupleFileFormat::ScanBatchesAsync(
   auto ntupleFragment = std::dynamic_pointer_cast<RNTupleFileFragment>(fragment);
 
   auto generator = [pool = options->pool, ntupleFragment, dataset_schema, &totalCompressedSize = mTotCompressedSize,
-                    &totalUncompressedSize = mTotUncompressedSize]() -> arrow::Future<std::shared_ptr<arrow::RecordBatch>> {
+                    &totalUncompressedSize = mTotUncompressedSize, &totalSkippedSize = mTotSkippedSize]() -> arrow::Future<std::shared_ptr<arrow::RecordBatch>> {
     using namespace ROOT::Experimental;
     std::vector<std::shared_ptr<arrow::Array>> columns;
     std::vector<std::shared_ptr<arrow::Field>> fields = dataset_schema->fields();
@@ -531,7 +533,24 @@ arrow::Result<arrow::RecordBatchGenerator> RNTupleFileFormat::ScanBatchesAsync(
 
     int64_t rows = -1;
     ROOT::Experimental::RNTuple* rntuple = fs->GetRNTuple(ntupleFragment->source());
-    auto reader = ROOT::Experimental::RNTupleReader::Open(rntuple);
+    // the reader is opened with a model made only of the requested fields, so that the pages
+    // of the other columns are neither read nor decompressed
+    auto inspector = RNTupleInspector::Create(rntuple);
+    auto ntupleDescriptor = inspector->GetDescriptor();
+    auto projectedModel = RNTupleModel::CreateBare();
+    size_t readCompressedSize = 0, readUncompressedSize = 0;
+    for (auto& field : fields) {
+      auto& fieldDescriptor = ntupleDescriptor->GetFieldDescriptor(ntupleDescriptor->FindFieldId(field->name()));
+      projectedModel->AddField(RFieldBase::Create(field->name(), fieldDescriptor.GetTypeName()).Unwrap());
+      auto& fieldInspector = inspector->GetFieldTreeInspector(field->name());
+      readCompressedSize += fieldInspector.GetCompressedSize();
+      readUncompressedSize += fieldInspector.GetUncompressedSize();
+    }
+    totalCompressedSize += readCompressedSize;
+    totalUncompressedSize += readUncompressedSize;
+    totalSkippedSize += inspector->GetCompressedSize() - readCompressedSize;
+
+    auto reader = ROOT::Experimental::RNTupleReader::Open(std::move(projectedModel), rntuple);
     auto& model = reader->GetModel();
     for (auto& physicalField : fields) {
       auto bulk = model.CreateBulk(physicalField->name());
@@ -809,7 +828,7 @@ arrow::Result<std::shared_ptr<arrow::dataset::FileFragment>> RNTupleFileFormat::
   arrow::dataset::FileSource source, arrow::compute::Expression partition_expression,
   std::shared_ptr<arrow::Schema> physical_schema)
 {
-  std::shared_ptr<arrow::dataset::FileFormat> format = std::make_shared<RNTupleFileFormat>(mTotCompressedSize, mTotUncompressedSize);
+  std::shared_ptr<arrow::dataset::FileFormat> format = std::make_shared<RNTupleFileFormat>(mTotCompressedSize, mTotUncompressedSize, mTotSkippedSize);
 
   auto fragment = std::make_shared<RNTupleFileFragment>(std::move(source), std::move(format),
                                                         std::move(partition_expression),
@@ -828,6 +847,7 @@ std::shared_ptr<arrow::dataset::FileWriteOptions>
 struct RNTuplePluginContext {
   size_t totalCompressedSize = 0;
   size_t totalUncompressedSize = 0;
+  size_t totalSkippedSize = 0;
   std::shared_ptr<o2::framework::RNTupleFileFormat> format = nullptr;
 };
 
@@ -835,7 +855,7 @@ struct RNTupleObjectReadingImplementation : public RootArrowFactoryPlugin {
   RootArrowFactory* create() override
   {
     auto context = new RNTuplePluginContext;
-    context->format = std::make_shared<o2::framework::RNTupleFileFormat>(context->totalCompressedSize, context->totalUncompressedSize);
+    context->format = std::make_shared<o2::framework::RNTupleFileFormat>(context->totalCompressedSize, context->totalUncompressedSize, context->totalSkippedSize);
     return new RootArrowFactory{
       .options = [context]() { return context->format->DefaultWriteOptions(); },
       .format = [context]() { return context->format; },
@@ -107,12 +107,14 @@ class TTreeFileFormat : public arrow::dataset::FileFormat
 {
   size_t& mTotCompressedSize;
   size_t& mTotUncompressedSize;
+  size_t& mTotSkippedSize;
 
  public:
-  TTreeFileFormat(size_t& totalCompressedSize, size_t& totalUncompressedSize)
+  TTreeFileFormat(size_t& totalCompressedSize, size_t& totalUncompressedSize, size_t& totalSkippedSize)
     : FileFormat({}),
       mTotCompressedSize(totalCompressedSize),
-      mTotUncompressedSize(totalUncompressedSize)
+      mTotUncompressedSize(totalUncompressedSize),
+      mTotSkippedSize(totalSkippedSize)
   {
   }
 
@@ -227,6 +229,7 @@ TBranch* TTreeOutputStream::CreateBranch(char const* branchName, char const* siz
 struct TTreePluginContext {
   size_t totalCompressedSize = 0;
   size_t totalUncompressedSize = 0;
+  size_t totalSkippedSize = 0;
   std::shared_ptr<o2::framework::TTreeFileFormat> format = nullptr;
 };
 
@@ -234,7 +237,7 @@ struct TTreeObjectReadingImplementation : public RootArrowFactoryPlugin {
   RootArrowFactory* create() override
   {
     auto context = new TTreePluginContext;
-    context->format = std::make_shared<o2::framework::TTreeFileFormat>(context->totalCompressedSize, context->totalUncompressedSize);
+    context->format = std::make_shared<o2::framework::TTreeFileFormat>(context->totalCompressedSize, context->totalUncompressedSize, context->totalSkippedSize);
     return new RootArrowFactory{
       .options = [context]() { return context->format->DefaultWriteOptions(); },
       .format = [context]() { return context->format; },
@@ -255,9 +258,7 @@ arrow::Result<arrow::RecordBatchGenerator> TTreeFileFormat::ScanBatchesAsync(
   auto dataset_schema = options->dataset_schema;
 
   auto generator = [pool = options->pool, treeFragment, dataset_schema, &totalCompressedSize = mTotCompressedSize,
-                    &totalUncompressedSize = mTotUncompressedSize]() -> arrow::Future<std::shared_ptr<arrow::RecordBatch>> {
-    auto schema = treeFragment->format()->Inspect(treeFragment->source());
-
+                    &totalUncompressedSize = mTotUncompressedSize, &totalSkippedSize = mTotSkippedSize]() -> arrow::Future<std::shared_ptr<arrow::RecordBatch>> {
     std::vector<std::shared_ptr<arrow::Array>> columns;
     std::vector<std::shared_ptr<arrow::Field>> fields = dataset_schema->fields();
     auto physical_schema = *treeFragment->ReadPhysicalSchema();
@@ -268,6 +269,26 @@ arrow::Result<arrow::RecordBatchGenerator> TTreeFileFormat::ScanBatchesAsync(
 
     int64_t rows = -1;
     auto& tree = fs->GetTree(treeFragment->source());
+    // only the branches of the requested columns are cached and decompressed
+    size_t readZipBytes = 0, readTotBytes = 0;
+    tree->SetCacheSize(25000000);
+    for (auto& field : fields) {
+      auto name = physical_schema->GetFieldByName(field->name())->name();
+      auto* branch = tree->GetBranch(name.c_str());
+      auto* sizeBranch = tree->GetBranch((name + "_size").c_str());
+      for (auto* b : {branch, sizeBranch}) {
+        if (b) {
+          tree->AddBranchToCache(b);
+          readZipBytes += b->GetZipBytes();
+          readTotBytes += b->GetTotBytes();
+        }
+      }
+    }
+    tree->StopCacheLearningPhase();
+    totalCompressedSize += readZipBytes;
+    totalUncompressedSize += readTotBytes;
+    totalSkippedSize += tree->GetZipBytes() - readZipBytes;
+
     for (auto& field : fields) {
       // The field actually on disk
       auto physicalField = physical_schema->GetFieldByName(field->name());
@@ -435,8 +456,6 @@ arrow::Result<arrow::RecordBatchGenerator> TTreeFileFormat::ScanBatchesAsync(
       columns.push_back(array);
     }
     auto batch = arrow::RecordBatch::Make(dataset_schema, rows, columns);
-    totalCompressedSize += tree->GetZipBytes();
-    totalUncompressedSize += tree->GetTotBytes();
     return batch;
   };
   return generator;
@@ -568,8 +587,8 @@ arrow::Result<std::shared_ptr<arrow::Schema>> TTreeFileFormat::Inspect(const arr
     }
   }
 
+  // the branches are added to the cache only when scanning, for the requested columns
   std::vector<std::shared_ptr<arrow::Field>> fields;
-  tree->SetCacheSize(25000000);
   for (auto& bi : branchInfos) {
     static TClass* cls;
     EDataType type;
@@ -580,18 +599,7 @@ arrow::Result<std::shared_ptr<arrow::Schema>> TTreeFileFormat::Inspect(const arr
     }
     auto field = std::make_shared<arrow::Field>(bi.ptr->GetName(), arrowTypeFromROOT(type, listSize));
     fields.push_back(field);
-
-    tree->AddBranchToCache(bi.ptr);
-    if (strncmp(bi.ptr->GetName(), "fIndexArray", strlen("fIndexArray")) == 0) {
-      std::string sizeBranchName = bi.ptr->GetName();
-      sizeBranchName += "_size";
-      auto* sizeBranch = (TBranch*)tree->GetBranch(sizeBranchName.c_str());
-      if (sizeBranch) {
-        tree->AddBranchToCache(sizeBranch);
-      }
-    }
   }
-  tree->StopCacheLearningPhase();
 
   return std::make_shared<arrow::Schema>(fields);
 }
@@ -601,7 +609,7 @@ arrow::Result<std::shared_ptr<arrow::dataset::FileFragment>> TTreeFileFormat::Ma
   arrow::dataset::FileSource source, arrow::compute::Expression partition_expression,
   std::shared_ptr<arrow::Schema> physical_schema)
 {
-  std::shared_ptr<arrow::dataset::FileFormat> format = std::make_shared<TTreeFileFormat>(mTotCompressedSize, mTotUncompressedSize);
+  std::shared_ptr<arrow::dataset::FileFormat> format = std::make_shared<TTreeFileFormat>(mTotCompressedSize, mTotUncompressedSize, mTotSkippedSize);
 
   auto fragment = std::make_shared<TTreeFileFragment>(std::move(source), std::move(format),
                                                       std::move(partition_expression),
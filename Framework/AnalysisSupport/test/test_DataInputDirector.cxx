@@ -12,12 +12,18 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 
+#include <cstdio>
 #include <fstream>
 #include <boost/test/unit_test.hpp>
 
 #include "Headers/DataHeader.h"
 #include "../src/DataInputDirector.h"
 
+#include <TFile.h>
+#include <TTree.h>
+#include <arrow/table.h>
+#include <fmt/format.h>
+
 BOOST_AUTO_TEST_CASE(TestDatainputDirector)
 {
   using namespace o2::header;
@@ -108,3 +114,74 @@ BOOST_AUTO_TEST_CASE(TestDatainputDirector)
   BOOST_CHECK(didesc);
   BOOST_CHECK_EQUAL(didesc->getNumberInputfiles(), 3);
 }
+
+BOOST_AUTO_TEST_CASE(TestDataInputDirectorPrefetching)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  // small AOD file with 3 DFs of 2 tables of different sizes
+  constexpr int NDF = 3;
+  std::string aodFile("testPrefetchAO2D.root");
+  {
+    TFile file(aodFile.c_str(), "RECREATE");
+    for (int df = 0; df < NDF; df++) {
+      file.mkdir(fmt::format("DF_{}", df + 1).c_str())->cd();
+      for (auto [name, size] : {std::pair{"O2una", 100}, std::pair{"O2altra", 1000}}) {
+        float x = 0;
+        int n = 0;
+        TTree tree(name, name);
+        tree.Branch("fX", &x, "fX/F");
+        tree.Branch("fN", &n, "fN/I");
+        for (int i = 0; i < size * (df + 1); i++) {
+          x = 0.5f * i + df;
+          n = i;
+          tree.Fill();
+        }
+        tree.Write();
+      }
+    }
+    file.Close();
+  }
+
+  std::vector<std::pair<DataHeader, std::vector<std::string>>> tables;
+  for (auto description : {"UNA", "ALTRA"}) {
+    tables.emplace_back(DataHeader(DataDescription{description}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0}), std::vector<std::string>{});
+  }
+
+  // read all the DFs like the AOD reader, which requests the next DF once the current one is sent
+  auto readAll = [&](size_t memoryBudget) {
+    std::vector<std::shared_ptr<arrow::Table>> result;
+    DataInputDirector didir(aodFile);
+    didir.setPrefetching(memoryBudget);
+    BOOST_CHECK_EQUAL(didir.isPrefetching(), memoryBudget > 0);
+    didir.prefetch(tables, 0, 0);
+    for (int df = 0; df < NDF; df++) {
+      for (auto& [dh, columns] : tables) {
+        size_t sizeCompressed = 0, sizeUncompressed = 0, sizeSkipped = 0;
+        result.emplace_back(didir.readTable(dh, 0, df, columns, sizeCompressed, sizeUncompressed, sizeSkipped));
+        BOOST_REQUIRE(result.back());
+        BOOST_CHECK(sizeUncompressed > 0);
+      }
+      didir.prefetch(tables, 0, df + 1); // the last one is not available
+    }
+    // the prefetching thread must be stopped and joined also with a pending request
+    didir.setPrefetching(0);
+    BOOST_CHECK(!didir.isPrefetching());
+    didir.closeInputFiles();
+    return result;
+  };
+
+  auto reference = readAll(0);
+  BOOST_REQUIRE_EQUAL(reference.size(), NDF * tables.size());
+  BOOST_CHECK_EQUAL(reference[1]->num_rows(), 1000);
+  // large budget: all the tables are read ahead, 1 byte: each table waits for the previous one to be taken
+  for (size_t memoryBudget : {size_t(1) << 30, size_t(1)}) {
+    auto prefetched = readAll(memoryBudget);
+    BOOST_REQUIRE_EQUAL(prefetched.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); i++) {
+      BOOST_CHECK(prefetched[i]->Equals(*reference[i]));
+    }
+  }
+  std::remove(aodFile.c_str());
+}
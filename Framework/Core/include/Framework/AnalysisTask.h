@@ -137,6 +137,13 @@ struct AnalysisDataProcessorBuilder {
       auto inputSources = getInputMetadata<metadata>();
       inputMetadata.insert(inputMetadata.end(), inputSources.begin(), inputSources.end());
     }
+    // persistent columns of the tables read from the AOD files, so that the reader can skip the others.
+    // The granularity is the table definition, not the columns actually accessed by the task
+    if constexpr (!soa::with_sources<metadata> && R.origin_hash == "AOD"_h) {
+      [&inputMetadata]<typename... C>(framework::pack<C...>) {
+        (inputMetadata.emplace_back(ConfigParamSpec{std::string{"column:"} + C::columnLabel(), VariantType::Bool, true, {"\"\""}}), ...);
+      }(typename metadata::persistent_columns_t{});
+    }
     DataSpecUtils::updateInputList(inputs, InputSpec{o2::aod::label<R>(), o2::aod::origin<R>(), aod::description(o2::aod::signature<R>()), R.version, Lifetime::Timeframe, inputMetadata});
   }
 
@@ -570,6 +577,8 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       return FilterManager<std::decay_t<decltype(x)>>::createExpressionTrees(x, expressionInfos);
     },
                            *task.get());
+    /// compile in the background the filters already seen by the previous jobs
+    expressions::prewarmFilters(expressionInfos);
 
     if constexpr (requires { task->init(ic); }) {
       task->init(ic);
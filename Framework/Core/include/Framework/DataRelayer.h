@@ -23,6 +23,7 @@
 #include "Framework/ServiceRegistryRef.h"
 
 #include <cstddef>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <functional>
@@ -47,9 +48,15 @@ enum struct CacheEntryStatus : int {
 class DataRelayer
 {
  public:
-  /// DataRelayer is thread safe because we have a lock around
-  /// each method and there is no particular order in which
-  /// methods need to be called.
+  /// DataRelayer is thread safe and there is no particular order in which
+  /// methods need to be called. The TimesliceIndex bookkeeping (slot selection,
+  /// dirty / valid flags, variables) is protected by mMutex, while the cache
+  /// entries of each slot are protected by a per-slot mutex. The per-slot work
+  /// (storing the messages, running the completion policy or the expiration
+  /// checkers, moving the data out) is done with the slot lock only, so that
+  /// it does not block the other slots. When a slot lock must be taken before
+  /// the bookkeeping is released, mMutex is always acquired first and is not
+  /// acquired again while the slot lock is held.
   constexpr static ServiceKind service_kind = ServiceKind::Global;
   /// This represents what the DataRelayer did when
   /// inserting a set of messages in the cache.
@@ -192,6 +199,10 @@ class DataRelayer
   [[nodiscard]] size_t getNumberOfUniqueInputs() const { return mDistinctRoutesIndex.size(); }
 
  private:
+  /// Make sure there is one mutex for each of the first @a slots slots.
+  /// Must be called with mMutex held.
+  void growSlotMutexes(size_t slots);
+
   ServiceRegistryRef mContext;
 
   /// This is the actual cache of all the parts in flight.
@@ -214,6 +225,8 @@ class DataRelayer
   size_t mMaxLanes;
 
   O2_LOCKABLE_NAMED(std::recursive_mutex, mMutex, "data relayer mutex");
+  /// One mutex per slot, protecting the cache entries and their status
+  std::vector<std::unique_ptr<std::mutex>> mSlotMutexes;
 };
 
 } // namespace o2::framework
@@ -0,0 +1,62 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_EXPRESSIONCACHE_H_
+#define O2_FRAMEWORK_EXPRESSIONCACHE_H_
+
+#include <gandiva/gandiva_aliases.h>
+#include <arrow/type_fwd.h>
+#include <string>
+#include <vector>
+
+namespace o2::framework::expressions
+{
+/// Persistent record of the gandiva filters compiled by the analysis tasks, keyed by the canonical
+/// expression tree and the schema it was compiled against, stored in the local directory given by
+/// the DPL_GANDIVA_CACHE_DIR environment variable (disabled if not set).
+/// Gandiva keeps the compiled code only in its in-memory cache, so at the initialization of a task
+/// the filters recorded by the previous jobs are compiled in the background, while the device waits
+/// for its first dataframe, and the filter creation for the incoming table then hits the gandiva cache.
+/// The background compilation uses DPL_GANDIVA_CACHE_THREADS threads (1 by default).
+/// When built against the LLVM used by gandiva (O2_GANDIVA_OBJECT_CACHE), the object code of every
+/// filter and projector is also stored in the directory, keyed by the schema, the expressions and the
+/// host, and loaded into the gandiva cache before they are made again, skipping the LLVM code generation.
+struct ExpressionCache {
+  /// max number of schema variants recorded per expression, the least recently used ones are evicted
+  static constexpr long MaxSchemasPerTree = 8;
+  /// max number of stored object files, the least recently used ones are evicted
+  static constexpr long MaxObjectFiles = 512;
+
+  /// cache directory, empty if the cache is disabled
+  static std::string const& directory();
+  /// override the cache directory given by DPL_GANDIVA_CACHE_DIR
+  static void setDirectory(std::string const& dir);
+  /// max number of threads of the background compilation
+  static int prewarmThreads();
+  static void setPrewarmThreads(int n);
+  /// record the filter tree as compiled against the schema
+  static void recordFilter(gandiva::SchemaPtr const& schema, gandiva::NodePtr const& tree);
+  /// compile in the background the filters of the trees for all the schemas recorded with them
+  static void prewarmFilters(std::vector<gandiva::NodePtr> const& trees);
+  /// wait until the background compilation of this filter is over, returns true if the filter was compiled by it
+  static bool waitPrewarmed(gandiva::SchemaPtr const& schema, gandiva::NodePtr const& tree);
+
+  /// true if the object code is persisted, see O2_GANDIVA_OBJECT_CACHE
+  static bool hasObjectCode();
+  /// load the stored object code of the filter/projector into the gandiva cache, returns true if found
+  static bool loadObjectCode(gandiva::SchemaPtr const& schema, gandiva::ConditionPtr const& condition);
+  static bool loadObjectCode(gandiva::SchemaPtr const& schema, gandiva::ExpressionVector const& expressions);
+  /// store the object code of the filter/projector made last with these arguments from the gandiva cache
+  static void storeObjectCode(gandiva::SchemaPtr const& schema, gandiva::ConditionPtr const& condition);
+  static void storeObjectCode(gandiva::SchemaPtr const& schema, gandiva::ExpressionVector const& expressions);
+};
+} // namespace o2::framework::expressions
+
+#endif // O2_FRAMEWORK_EXPRESSIONCACHE_H_
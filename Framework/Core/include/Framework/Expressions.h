@@ -41,6 +41,7 @@ class Projector;
 #include <string>
 #include <memory>
 #include <set>
+#include <vector>
 namespace gandiva
 {
 using Selection = std::shared_ptr<gandiva::SelectionVector>;
@@ -420,10 +421,24 @@ struct Filter {
 
 using Projector = Filter;
 
+/// Settings for the evaluation of gandiva filters and projectors over the record batches of a table
+struct ChunkedEvaluation {
+  int nThreads = 1;      // number of threads evaluating the batches, the calling one included; 0 = hardware concurrency
+  int64_t batchSize = 0; // maximum number of rows per batch, 0 = the chunks of the table (split further if evaluated in parallel)
+};
+/// Default settings, initialized from the DPL_GANDIVA_THREADS and DPL_GANDIVA_BATCH_SIZE environment variables
+ChunkedEvaluation& defaultChunkedEvaluation();
+
 /// Function for creating gandiva selection from our internal filter tree
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, Filter const& expression);
 /// Function for creating gandiva selection from prepared gandiva expressions tree
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter);
+/// Function for creating gandiva selection from prepared gandiva expressions tree, the record batches of the table
+/// being filtered in parallel and their selections concatenated in order
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter, ChunkedEvaluation const& mode);
+/// Function evaluating the gandiva projector on the record batches of the table in parallel, returns the projected arrays of each batch in order
+std::vector<arrow::ArrayVector> createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector,
+                                                 ChunkedEvaluation const& mode = defaultChunkedEvaluation());
 
 struct ColumnOperationSpec;
 using Operations = std::vector<ColumnOperationSpec>;
@@ -477,6 +492,8 @@ std::shared_ptr<gandiva::Projector> createProjectors(framework::pack<C...>, std:
   return createProjectorHelper(sizeof...(C), projectors.data(), schema, fields);
 }
 
+/// Compile in the background the filters of the expression infos recorded by the previous jobs, see ExpressionCache
+void prewarmFilters(std::vector<ExpressionInfo> const& eInfos);
 void updateFilterInfo(ExpressionInfo& info, std::shared_ptr<arrow::Table>& table);
 } // namespace o2::framework::expressions
 
@@ -29,8 +29,10 @@
 #include <TProfile2D.h>
 #include <fmt/core.h>
 
+#include <array>
 #include <concepts>
 #include <deque>
+#include <vector>
 
 class TList;
 
@@ -76,6 +78,64 @@ concept ValidComplexFillStep = std::is_base_of_v<StepTHn, T>;
 template <typename T, int D>
 concept ValidFill = ValidSimpleFill<T, D> || ValidComplexFill<T, D> || ValidComplexFillStep<T, D>;
 
+template <typename T, int D>
+concept ValidShardFill = ValidTH1<T, D> || ValidTH2<T, D> || ValidTH3<T, D>;
+
+//**************************************************************************************************
+/**
+ * Plain-array replica of the bin contents of a histogram, filled by a single thread in the sharded mode of the HistogramRegistry.
+ */
+//**************************************************************************************************
+struct HistShard {
+  std::vector<double> sumw{};  // sum of weights per (global) bin, allocated at the first fill
+  std::vector<double> sumw2{}; // sum of squared weights per bin
+  std::array<double, 11> stats{}; // as the TH3 statistics: sum of w, w^2, w*x, w*x^2, w*y, w*y^2, w*x*y, w*z, w*z^2, w*x*z, w*y*z
+  double entries{0.};
+  bool weighted{false};
+
+  void fill(int64_t bin, double weight, int64_t nBins)
+  {
+    if (sumw.empty()) {
+      sumw.resize(nBins, 0.);
+      sumw2.resize(nBins, 0.);
+    }
+    sumw[bin] += weight;
+    sumw2[bin] += weight * weight;
+    entries += 1.;
+    weighted |= (weight != 1.);
+  }
+
+  void fillStats(const double* x, int nDim, double weight)
+  {
+    stats[0] += weight;
+    stats[1] += weight * weight;
+    stats[2] += weight * x[0];
+    stats[3] += weight * x[0] * x[0];
+    if (nDim > 1) {
+      stats[4] += weight * x[1];
+      stats[5] += weight * x[1] * x[1];
+      stats[6] += weight * x[0] * x[1];
+    }
+    if (nDim > 2) {
+      stats[7] += weight * x[2];
+      stats[8] += weight * x[2] * x[2];
+      stats[9] += weight * x[0] * x[2];
+      stats[10] += weight * x[1] * x[2];
+    }
+  }
+
+  void reset()
+  {
+    sumw.clear();
+    sumw.shrink_to_fit();
+    sumw2.clear();
+    sumw2.shrink_to_fit();
+    stats.fill(0.);
+    entries = 0.;
+    weighted = false;
+  }
+};
+
 struct HistFiller {
   // fill any type of histogram (if weight was requested it must be the last argument)
   template <typename T, typename... Ts>
@@ -103,6 +163,23 @@ struct HistFiller {
   template <typename... Cs, typename R, typename T>
   static void fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // fill the plain-array replica of a TH1, TH2, TH3 or THn histogram (if weight was requested it must be the last argument)
+  template <typename T, typename... Ts>
+  static void fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight)
+    requires ValidShardFill<T, sizeof...(Ts)> && (FillValue<Ts> && ...);
+
+  template <typename T, typename... Ts>
+  static void fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight)
+    requires std::same_as<T, THn> && (FillValue<Ts> && ...);
+
+  // histogram types without plain-array replica
+  template <typename T, typename... Ts>
+  static void fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight);
+
+  // add the content of the replica to the histogram
+  template <typename T>
+  static void mergeShard(std::shared_ptr<T> hist, const HistShard& shard);
+
   // function that returns rough estimate for the size of a histogram in MB
   template <typename T>
   static double getSize(std::shared_ptr<T> hist, double fillFraction = 1.);
@@ -119,6 +196,7 @@ struct HistFiller {
   static int getBaseElementSize(T* ptr);
 
   static void badHistogramFill(char const* name);
+  static void badShardFill(char const* name);
 };
 
 //**************************************************************************************************
@@ -193,6 +271,20 @@ class HistogramRegistry
   template <typename... Cs, typename T>
   void fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // sharded mode: each of the nShards threads fills its own plain-array replica of the TH1, TH2, TH3 and THn
+  // histograms, without locking; the replicas are merged into the histograms by mergeShards(), which is called
+  // when the list of histograms is produced for the output
+  void setNShards(int nShards);
+  int getNShards() const { return mShards.size(); }
+
+  // fill the replica of the shard (owned by the calling thread) with values, throws if the shard does not exist
+  template <typename... Ts>
+  void fillShard(int shard, const HistName& histName, Ts... positionAndWeight)
+    requires(FillValue<Ts> && ...);
+
+  // add the content of the replicas to the histograms and reset them, not to be called concurrently to fillShard()
+  void mergeShards();
+
   // get rough estimate for size of histogram stored in registry
   double getSize(const HistName& histName, double fillFraction = 1.);
 
@@ -248,6 +340,7 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+  std::vector<std::vector<HistShard>> mShards{}; // replicas for each shard and registry index
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -292,6 +385,100 @@ void HistFiller::fillHistAny(std::shared_ptr<T> hist, Ts... positionAndWeight)
   HistFiller::badHistogramFill(hist->GetName());
 }
 
+template <typename T, typename... Ts>
+void HistFiller::fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight)
+  requires ValidShardFill<T, sizeof...(Ts)> && (FillValue<Ts> && ...)
+{
+  constexpr int nDim = std::same_as<T, TH1> ? 1 : (std::same_as<T, TH2> ? 2 : 3);
+  double tempArray[] = {static_cast<double>(positionAndWeight)...};
+  double weight{1.};
+  if constexpr (sizeof...(Ts) > nDim) {
+    weight = tempArray[nDim];
+  }
+  TAxis* axes[] = {hist->GetXaxis(), hist->GetYaxis(), hist->GetZaxis()};
+  int axisBins[] = {0, 0, 0};
+  bool inRange{true};
+  for (int d = 0; d < nDim; ++d) {
+    axisBins[d] = axes[d]->FindFixBin(tempArray[d]);
+    inRange &= axisBins[d] > 0 && axisBins[d] <= axes[d]->GetNbins();
+  }
+  shard.fill(hist->GetBin(axisBins[0], axisBins[1], axisBins[2]), weight, hist->GetNcells());
+  // like TH1::Fill, the under- and overflows do not enter the statistics unless requested
+  if (inRange || hist->GetStatOverflowsBehaviour()) {
+    shard.fillStats(tempArray, nDim, weight);
+  }
+}
+
+template <typename T, typename... Ts>
+void HistFiller::fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight)
+  requires std::same_as<T, THn> && (FillValue<Ts> && ...)
+{
+  constexpr int nArgs = sizeof...(Ts);
+  double tempArray[] = {static_cast<double>(positionAndWeight)...};
+  double weight{1.};
+  const int nDim = hist->GetNdimensions();
+  if (nDim == nArgs - 1) {
+    weight = tempArray[nArgs - 1];
+  } else if (nDim != nArgs) {
+    badHistogramFill(hist->GetName());
+  }
+  Int_t coord[nArgs];
+  for (int d = 0; d < nDim; ++d) {
+    coord[d] = hist->GetAxis(d)->FindFixBin(tempArray[d]);
+  }
+  shard.fill(hist->GetBin(coord), weight, hist->GetNbins());
+}
+
+template <typename T, typename... Ts>
+void HistFiller::fillShardAny(std::shared_ptr<T> hist, HistShard& shard, Ts... positionAndWeight)
+{
+  HistFiller::badShardFill(hist->GetName());
+}
+
+template <typename T>
+void HistFiller::mergeShard(std::shared_ptr<T> hist, const HistShard& shard)
+{
+  // the replica is turned into an empty copy of the histogram which is added to it, merging also the statistics
+  if constexpr (std::same_as<T, TH1> || std::same_as<T, TH2> || std::same_as<T, TH3>) {
+    std::unique_ptr<T> replica(static_cast<T*>(hist->Clone()));
+    replica->SetDirectory(nullptr);
+    replica->Reset();
+    if (shard.weighted && replica->GetSumw2N() == 0) {
+      replica->Sumw2();
+    }
+    for (size_t bin = 0; bin < shard.sumw.size(); ++bin) {
+      if (shard.sumw2[bin] != 0.) {
+        replica->SetBinContent(bin, shard.sumw[bin]);
+        if (replica->GetSumw2N()) {
+          replica->GetSumw2()->fArray[bin] = shard.sumw2[bin];
+        }
+      }
+    }
+    auto stats = shard.stats;
+    replica->PutStats(stats.data());
+    replica->SetEntries(shard.entries);
+    hist->Add(replica.get());
+  } else if constexpr (std::same_as<T, THn>) {
+    std::unique_ptr<THn> replica(static_cast<THn*>(hist->Clone()));
+    replica->Reset();
+    if (shard.weighted && !replica->GetCalculateErrors()) {
+      replica->Sumw2();
+    }
+    for (size_t bin = 0; bin < shard.sumw.size(); ++bin) {
+      if (shard.sumw2[bin] != 0.) {
+        replica->SetBinContent(bin, shard.sumw[bin]);
+        if (replica->GetCalculateErrors()) {
+          replica->SetBinError2(bin, shard.sumw2[bin]);
+        }
+      }
+    }
+    replica->SetEntries(shard.entries);
+    hist->Add(replica.get());
+  } else {
+    HistFiller::badShardFill(hist->GetName());
+  }
+}
+
 template <typename... Cs, typename R, typename T>
 void HistFiller::fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter)
   requires(!ValidComplexFillStep<R, sizeof...(Cs)>) && requires(T t) { t.asArrowTable(); }
@@ -487,6 +674,18 @@ void HistogramRegistry::fill(const HistName& histName, Ts... positionAndWeight)
   std::visit([positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, positionAndWeight...); }, mRegistryValue[getHistIndex(histName)]);
 }
 
+template <typename... Ts>
+void HistogramRegistry::fillShard(int shard, const HistName& histName, Ts... positionAndWeight)
+  requires(FillValue<Ts> && ...)
+{
+  if (O2_BUILTIN_UNLIKELY(shard < 0 || shard >= getNShards())) {
+    throw runtime_error_f(R"(Shard %d is out of range, HistogramRegistry "%s" has %d shards!)", shard, mName.data(), getNShards());
+  }
+  auto idx = getHistIndex(histName);
+  auto& replica = mShards[shard][idx];
+  std::visit([&replica, positionAndWeight...](auto&& hist) { HistFiller::fillShardAny(hist, replica, positionAndWeight...); }, mRegistryValue[idx]);
+}
+
 extern template void HistogramRegistry::fill(const HistName& histName, double);
 extern template void HistogramRegistry::fill(const HistName& histName, float);
 extern template void HistogramRegistry::fill(const HistName& histName, int);
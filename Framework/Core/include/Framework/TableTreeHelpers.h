@@ -133,12 +133,17 @@ class TreeToTable
   void addAllColumns(TTree* tree, std::vector<std::string>&& names = {});
   void fill(TTree*);
   std::shared_ptr<arrow::Table> finalize();
+  // compressed and uncompressed size of the branches selected for reading
+  [[nodiscard]] size_t getZipBytes() const { return mZipBytes; }
+  [[nodiscard]] size_t getTotBytes() const { return mTotBytes; }
 
  private:
   arrow::MemoryPool* mArrowMemoryPool;
   std::vector<std::unique_ptr<BranchToColumn>> mBranchReaders;
   std::string mTableLabel;
   std::shared_ptr<arrow::Table> mTable;
+  size_t mZipBytes = 0;
+  size_t mTotBytes = 0;
 
   void addReader(TBranch* branch, std::string const& name, bool VLA);
 };
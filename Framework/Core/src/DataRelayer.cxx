@@ -47,6 +47,7 @@
 #include <fmt/ostream.h>
 #include <gsl/span>
 #include <numeric>
+#include <optional>
 #include <string>
 
 using namespace o2::framework::data_matcher;
@@ -111,7 +112,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
                                                               ServiceRegistryRef services, bool createNew)
 {
   LOGP(debug, "DataRelayer::processDanglingInputs");
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::unique_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
   auto& deviceProxy = services.get<FairMQDeviceProxy>();
 
   ActivityStats activity;
@@ -144,6 +145,18 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
   } else {
     LOGP(debug, "DataRelayer::processDanglingInputs: no slots created by handler");
   }
+  // The valid slots and their timestamp are taken from the index, the
+  // checkers then only need the slot lock.
+  std::vector<std::pair<TimesliceSlot, TimesliceId>> validTimeslices;
+  for (size_t ti = 0; ti < mTimesliceIndex.size(); ++ti) {
+    TimesliceSlot slot{ti};
+    if (mTimesliceIndex.isValid(slot) == false) {
+      continue;
+    }
+    validTimeslices.emplace_back(slot, VariableContextHelpers::getTimeslice(mTimesliceIndex.getVariablesForSlot(slot)));
+  }
+  lock.unlock();
+
   // Outer loop, we process all the records because the fact that the record
   // expires is independent from having received data for it.
   int headerPresent = 0;
@@ -151,14 +164,11 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
   int noCheckers = 0;
   int badSlot = 0;
   int checkerDenied = 0;
-  for (size_t ti = 0; ti < mTimesliceIndex.size(); ++ti) {
-    TimesliceSlot slot{ti};
-    if (mTimesliceIndex.isValid(slot) == false) {
-      continue;
-    }
+  std::vector<std::tuple<TimesliceSlot, TimesliceId, size_t>> toExpire;
+  for (auto& [slot, timestamp] : validTimeslices) {
+    auto ti = slot.index;
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[ti]);
     assert(mDistinctRoutesIndex.empty() == false);
-    auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
-    auto timestamp = VariableContextHelpers::getTimeslice(variables);
     // We iterate on all the hanlders checking if they need to be expired.
     for (size_t ei = 0; ei < expirationHandlers.size(); ++ei) {
       auto& expirator = expirationHandlers[ei];
@@ -214,18 +224,40 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
         checkerDenied++;
         continue;
       }
+      toExpire.emplace_back(slot, timestamp, ei);
+    }
+  }
 
-      assert(ti * mDistinctRoutesIndex.size() + expirator.routeIndex.value < mCache.size());
-      assert(expirator.handler);
-      PartRef newRef;
-      expirator.handler(services, newRef, variables);
-      part.reset(std::move(newRef));
-      activity.expiredSlots++;
-
-      mTimesliceIndex.markAsDirty(slot, true);
-      assert(part.header(0) != nullptr);
-      assert(part.payload(0) != nullptr);
+  // The expiration handlers update the variables of the slot, so they run
+  // under the index lock. The slot lock is taken before releasing it, like
+  // in relay(), and the cell is checked again because data might have been
+  // relayed in the meanwhile.
+  for (auto& [slot, timestamp, ei] : toExpire) {
+    auto& expirator = expirationHandlers[ei];
+    lock.lock();
+    auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
+    if (mTimesliceIndex.isValid(slot) == false || VariableContextHelpers::getTimeslice(variables).value != timestamp.value) {
+      lock.unlock();
+      continue;
     }
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[slot.index]);
+    assert(slot.index * mDistinctRoutesIndex.size() + expirator.routeIndex.value < mCache.size());
+    auto& part = mCache[slot.index * mDistinctRoutesIndex.size() + expirator.routeIndex.value];
+    if (part.size() > 0) {
+      lock.unlock();
+      headerPresent++;
+      continue;
+    }
+    assert(expirator.handler);
+    PartRef newRef;
+    expirator.handler(services, newRef, variables);
+    mTimesliceIndex.markAsDirty(slot, true);
+    lock.unlock();
+    part.reset(std::move(newRef));
+    activity.expiredSlots++;
+
+    assert(part.header(0) != nullptr);
+    assert(part.payload(0) != nullptr);
   }
   LOGP(debug, "DataRelayer::processDanglingInputs headerPresent:{}, payloadPresent:{}, noCheckers:{}, badSlot:{}, checkerDenied:{}",
        headerPresent, payloadPresent, noCheckers, badSlot, checkerDenied);
@@ -283,6 +315,7 @@ void sendVariableContextMetrics(VariableContext& context, TimesliceSlot slot, Da
 
 void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex channel)
 {
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
   auto newOldest = mTimesliceIndex.setOldestPossibleInput(proposed, channel);
   LOGP(debug, "DataRelayer::setOldestPossibleInput {} from channel {}", newOldest.timeslice.value, newOldest.channel.value);
   static bool dontDrop = getenv("DPL_DONT_DROP_OLD_TIMESLICE") && atoi(getenv("DPL_DONT_DROP_OLD_TIMESLICE"));
@@ -300,6 +333,7 @@ void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex chan
       continue;
     }
     mPruneOps.push_back(PruneOp{si});
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[si]);
     bool didDrop = false;
     for (size_t mi = 0; mi < mInputs.size(); ++mi) {
       auto& input = mInputs[mi];
@@ -350,6 +384,7 @@ TimesliceIndex::OldestOutputInfo DataRelayer::getOldestPossibleOutput() const
 
 void DataRelayer::prunePending(OnDropCallback onDrop)
 {
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
   for (auto& op : mPruneOps) {
     this->pruneCache(op.slot, onDrop);
   }
@@ -366,36 +401,42 @@ void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
                      &cachedStateMetrics = mCachedStateMetrics,
                      numInputTypes = mDistinctRoutesIndex.size(),
                      &index = mTimesliceIndex,
+                     &slotMutex = *mSlotMutexes[slot.index],
                      ref = mContext](TimesliceSlot slot) {
-    if (onDrop) {
-      auto oldestPossibleTimeslice = index.getOldestPossibleOutput();
-      // State of the computation
-      std::vector<MessageSet> dropped(numInputTypes);
-      for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
-        auto cacheId = slot.index * numInputTypes + ai;
-        cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
-        // TODO: in the original implementation of the cache, there have been only two messages per entry,
-        // check if the 2 above corresponds to the number of messages.
-        if (cache[cacheId].size() > 0) {
-          dropped[ai] = std::move(cache[cacheId]);
+    // State of the computation
+    std::vector<MessageSet> dropped;
+    {
+      std::scoped_lock<std::mutex> slotLock(slotMutex);
+      if (onDrop) {
+        dropped.resize(numInputTypes);
+        for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
+          auto cacheId = slot.index * numInputTypes + ai;
+          cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
+          // TODO: in the original implementation of the cache, there have been only two messages per entry,
+          // check if the 2 above corresponds to the number of messages.
+          if (cache[cacheId].size() > 0) {
+            dropped[ai] = std::move(cache[cacheId]);
+          }
         }
       }
-      bool anyDropped = std::any_of(dropped.begin(), dropped.end(), [](auto& m) { return m.size(); });
-      if (anyDropped) {
-        O2_SIGNPOST_ID_GENERATE(aid, data_relayer);
-        O2_SIGNPOST_EVENT_EMIT(data_relayer, aid, "pruneCache", "Dropping stuff from slot %zu with timeslice %zu", slot.index, oldestPossibleTimeslice.timeslice.value);
-        onDrop(slot, dropped, oldestPossibleTimeslice);
+      assert(cache.empty() == false);
+      assert(index.size() * numInputTypes == cache.size());
+      // Prune old stuff from the cache, hopefully deleting it...
+      // We set the current slot to the timeslice value, so that old stuff
+      // will be ignored.
+      assert(numInputTypes * slot.index < cache.size());
+      for (size_t ai = slot.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
+        cache[ai].clear();
+        cachedStateMetrics[ai] = CacheEntryStatus::EMPTY;
       }
     }
-    assert(cache.empty() == false);
-    assert(index.size() * numInputTypes == cache.size());
-    // Prune old stuff from the cache, hopefully deleting it...
-    // We set the current slot to the timeslice value, so that old stuff
-    // will be ignored.
-    assert(numInputTypes * slot.index < cache.size());
-    for (size_t ai = slot.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
-      cache[ai].clear();
-      cachedStateMetrics[ai] = CacheEntryStatus::EMPTY;
+    // The dropped data is not in the cache anymore, no need to keep the slot locked while forwarding it.
+    bool anyDropped = std::any_of(dropped.begin(), dropped.end(), [](auto& m) { return m.size(); });
+    if (anyDropped) {
+      auto oldestPossibleTimeslice = index.getOldestPossibleOutput();
+      O2_SIGNPOST_ID_GENERATE(aid, data_relayer);
+      O2_SIGNPOST_EVENT_EMIT(data_relayer, aid, "pruneCache", "Dropping stuff from slot %zu with timeslice %zu", slot.index, oldestPossibleTimeslice.timeslice.value);
+      onDrop(slot, dropped, oldestPossibleTimeslice);
     }
   };
 
@@ -416,7 +457,7 @@ DataRelayer::RelayChoice
                      size_t nPayloads,
                      std::function<void(TimesliceSlot, std::vector<MessageSet>&, TimesliceIndex::OldestOutputInfo)> onDrop)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::unique_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
   DataProcessingHeader const* dph = o2::header::get<DataProcessingHeader*>(rawHeader);
   // IMPLEMENTATION DETAILS
   //
@@ -455,7 +496,8 @@ DataRelayer::RelayChoice
     };
   };
 
-  // Actually save the header / payload in the slot
+  // Actually save the header / payload in the slot. This is called with
+  // the slot lock held and the index lock released, see saveAndPublish.
   auto saveInSlot = [&cachedStateMetrics = mCachedStateMetrics,
                      &messages,
                      &nMessages,
@@ -490,6 +532,26 @@ DataRelayer::RelayChoice
     return saved;
   };
 
+  // The slot lock is taken before releasing the index lock, so that nobody
+  // can prune or consume the slot between the bookkeeping and the copy of
+  // the messages, which happens with the slot lock only. The slot is then
+  // published under the index lock, after the slot lock has been released
+  // to respect the locking order.
+  auto saveAndPublish = [&lock, &saveInSlot, &slotMutexes = mSlotMutexes, &index = mTimesliceIndex](TimesliceId timeslice, int input, TimesliceSlot slot, InputInfo const& info) -> size_t {
+    std::unique_lock<std::mutex> slotLock(*slotMutexes[slot.index]);
+    lock.unlock();
+    size_t saved = saveInSlot(timeslice, input, slot, info);
+    slotLock.unlock();
+    if (saved == 0) {
+      return saved;
+    }
+    lock.lock();
+    index.publishSlot(slot);
+    index.markAsDirty(slot, true);
+    lock.unlock();
+    return saved;
+  };
+
   auto updateStatistics = [ref = mContext](TimesliceIndex::ActionTaken action) {
     auto& stats = ref.get<DataProcessingStats>();
 
@@ -566,12 +628,10 @@ DataRelayer::RelayChoice
       this->pruneCache(slot, onDrop);
       mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
     }
-    size_t saved = saveInSlot(timeslice, input, slot, info);
+    size_t saved = saveAndPublish(timeslice, input, slot, info);
     if (saved == 0) {
       return RelayChoice{.type = RelayChoice::Type::Dropped, .timeslice = timeslice};
     }
-    index.publishSlot(slot);
-    index.markAsDirty(slot, true);
     stats.updateStats({static_cast<short>(ProcessingStatsId::RELAYED_MESSAGES), DataProcessingStats::Op::Add, (int)1});
     return RelayChoice{.type = RelayChoice::Type::WillRelay, .timeslice = timeslice};
   }
@@ -651,12 +711,10 @@ DataRelayer::RelayChoice
       // cache still holds the old data, so we prune it.
       this->pruneCache(slot, onDrop);
       mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
-      size_t saved = saveInSlot(timeslice, input, slot, info);
+      size_t saved = saveAndPublish(timeslice, input, slot, info);
       if (saved == 0) {
         return RelayChoice{.type = RelayChoice::Type::Dropped, .timeslice = timeslice};
       }
-      index.publishSlot(slot);
-      index.markAsDirty(slot, true);
       return RelayChoice{.type = RelayChoice::Type::WillRelay};
   }
   O2_BUILTIN_UNREACHABLE();
@@ -665,7 +723,6 @@ DataRelayer::RelayChoice
 void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& completed)
 {
   LOGP(debug, "DataRelayer::getReadyToProcess");
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
 
   // THE STATE
   const auto& cache = mCache;
@@ -686,7 +743,7 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   // These two are trivial, but in principle the whole loop could be parallelised
   // or vectorised so "completed" could be a thread local variable which needs
   // merging at the end.
-  auto updateCompletionResults = [&completed](TimesliceSlot li, uint64_t const* timeslice, CompletionPolicy::CompletionOp op) {
+  auto updateCompletionResults = [&completed](TimesliceSlot li, std::optional<uint64_t> timeslice, CompletionPolicy::CompletionOp op) {
     if (timeslice) {
       LOGP(debug, "Doing action {} for slot {} (timeslice: {})", (int)op, li.index, *timeslice);
       completed.emplace_back(RecordAction{li, {*timeslice}, op});
@@ -710,6 +767,9 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
     LOGP(debug, "numInputTypes == 0, returning.");
     return;
   }
+  if (!mCompletionPolicy.callbackFull) {
+    throw runtime_error_f("Completion police %s has no callback set", mCompletionPolicy.name.c_str());
+  }
   size_t cacheLines = cache.size() / numInputTypes;
   assert(cacheLines * numInputTypes == cache.size());
   int countConsume = 0;
@@ -719,17 +779,36 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   int countWait = 0;
   int notDirty = 0;
 
-  for (int li = cacheLines - 1; li >= 0; --li) {
-    TimesliceSlot slot{(size_t)li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
-      notDirty++;
-      continue;
-    }
-    if (!mCompletionPolicy.callbackFull) {
-      throw runtime_error_f("Completion police %s has no callback set", mCompletionPolicy.name.c_str());
+  // The dirty slots and their timeslice are taken from the index under the
+  // index lock. The dirty flag is cleared right away, so that data relayed
+  // while the completion policy runs marks the slot dirty again.
+  struct Candidate {
+    TimesliceSlot slot;
+    std::optional<uint64_t> timeslice;
+  };
+  std::vector<Candidate> candidates;
+  {
+    std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+    for (int li = cacheLines - 1; li >= 0; --li) {
+      TimesliceSlot slot{(size_t)li};
+      // We only check the cachelines which have been updated by an incoming
+      // message.
+      if (mTimesliceIndex.isDirty(slot) == false) {
+        notDirty++;
+        continue;
+      }
+      auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
+      auto timeslice = std::get_if<uint64_t>(&variables.get(0));
+      candidates.push_back({slot, timeslice ? std::optional<uint64_t>{*timeslice} : std::nullopt});
+      mTimesliceIndex.markAsDirty(slot, false);
     }
+  }
+
+  // The completion policy only needs the content of the slot.
+  std::vector<CompletionPolicy::CompletionOp> actions(candidates.size());
+  for (size_t ci = 0; ci < candidates.size(); ++ci) {
+    auto li = candidates[ci].slot.index;
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[li]);
     auto partial = getPartialRecord(li);
     // TODO: get the data ref from message model
     auto getter = [&partial](size_t idx, size_t part) {
@@ -747,15 +826,17 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
       return partial[idx].size();
     };
     InputSpan span{getter, nPartsGetter, static_cast<size_t>(partial.size())};
-    CompletionPolicy::CompletionOp action = mCompletionPolicy.callbackFull(span, mInputs, mContext);
+    actions[ci] = mCompletionPolicy.callbackFull(span, mInputs, mContext);
+  }
 
-    auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
-    auto timeslice = std::get_if<uint64_t>(&variables.get(0));
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  for (size_t ci = 0; ci < candidates.size(); ++ci) {
+    auto [slot, timeslice] = candidates[ci];
+    auto action = actions[ci];
     switch (action) {
       case CompletionPolicy::CompletionOp::Consume:
         countConsume++;
         updateCompletionResults(slot, timeslice, action);
-        mTimesliceIndex.markAsDirty(slot, false);
         break;
       case CompletionPolicy::CompletionOp::ConsumeAndRescan:
         // This is just like Consume, but we also mark all slots as dirty
@@ -767,17 +848,14 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
       case CompletionPolicy::CompletionOp::ConsumeExisting:
         countConsumeExisting++;
         updateCompletionResults(slot, timeslice, action);
-        mTimesliceIndex.markAsDirty(slot, false);
         break;
       case CompletionPolicy::CompletionOp::Process:
         countProcess++;
         updateCompletionResults(slot, timeslice, action);
-        mTimesliceIndex.markAsDirty(slot, false);
         break;
       case CompletionPolicy::CompletionOp::Discard:
         countDiscard++;
         updateCompletionResults(slot, timeslice, action);
-        mTimesliceIndex.markAsDirty(slot, false);
         break;
       case CompletionPolicy::CompletionOp::Retry:
         countWait++;
@@ -786,7 +864,6 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
         break;
       case CompletionPolicy::CompletionOp::Wait:
         countWait++;
-        mTimesliceIndex.markAsDirty(slot, false);
         break;
     }
   }
@@ -798,7 +875,7 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
 
 void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStatus, CacheEntryStatus newStatus)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[slot.index]);
   const auto numInputTypes = mDistinctRoutesIndex.size();
 
   auto markInputDone = [&cachedStateMetrics = mCachedStateMetrics,
@@ -816,13 +893,18 @@ void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStat
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  // We mark the slot invalid right away, so that it can be reused once we
+  // release the index lock. The slot lock guarantees that no new data can
+  // end up in it before we have moved out the current content.
+  std::unique_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  mTimesliceIndex.markAsInvalid(slot);
+  std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[slot.index]);
+  lock.unlock();
 
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
   std::vector<MessageSet> messages(numInputTypes);
   auto& cache = mCache;
-  auto& index = mTimesliceIndex;
 
   // Nothing to see here, this is just to make the outer loop more understandable.
   auto jumpToCacheEntryAssociatedWith = [](TimesliceSlot) {
@@ -835,7 +917,7 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
   // cache where to put them.
   auto moveHeaderPayloadToOutput = [&messages,
                                     &cachedStateMetrics = mCachedStateMetrics,
-                                    &cache, &index, &numInputTypes](TimesliceSlot s, size_t arg) {
+                                    &cache, &numInputTypes](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
     cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
@@ -843,19 +925,17 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
     if (cache[cacheId].size() > 0) {
       messages[arg] = std::move(cache[cacheId]);
     }
-    index.markAsInvalid(s);
   };
 
   // An invalid set of arguments is a set of arguments associated to an invalid
   // timeslice, so I can simply do that. I keep the assertion there because in principle
   // we should have dispatched the timeslice already!
   // FIXME: what happens when we have enough timeslices to hit the invalid one?
-  auto invalidateCacheFor = [&numInputTypes, &index, &cache](TimesliceSlot s) {
+  auto invalidateCacheFor = [&numInputTypes, &cache](TimesliceSlot s) {
     for (size_t ai = s.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
       assert(std::accumulate(cache[ai].messages.begin(), cache[ai].messages.end(), true, [](bool result, auto const& element) { return result && element.get() == nullptr; }));
       cache[ai].clear();
     }
-    index.markAsInvalid(s);
   };
 
   // Outer loop here.
@@ -870,13 +950,13 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  // The slot stays valid, only its content is needed.
+  std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[slot.index]);
 
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
   std::vector<MessageSet> messages(numInputTypes);
   auto& cache = mCache;
-  auto& index = mTimesliceIndex;
 
   // Nothing to see here, this is just to make the outer loop more understandable.
   auto jumpToCacheEntryAssociatedWith = [](TimesliceSlot) {
@@ -889,7 +969,7 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTime
   // cache where to put them.
   auto copyHeaderPayloadToOutput = [&messages,
                                     &cachedStateMetrics = mCachedStateMetrics,
-                                    &cache, &index, &numInputTypes](TimesliceSlot s, size_t arg) {
+                                    &cache, &numInputTypes](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
     cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
@@ -915,10 +995,12 @@ void DataRelayer::clear()
 {
   std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
 
-  for (auto& cache : mCache) {
-    cache.clear();
-  }
+  const auto numInputTypes = mDistinctRoutesIndex.size();
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[s]);
+    for (size_t ai = s * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
+      mCache[ai].clear();
+    }
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
 }
@@ -937,11 +1019,22 @@ void DataRelayer::setPipelineLength(size_t s)
 {
   std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
 
+  // The slots must have their mutex before they become visible in the index.
+  growSlotMutexes(s);
   mTimesliceIndex.resize(s);
   mVariableContextes.resize(s);
   publishMetrics();
 }
 
+void DataRelayer::growSlotMutexes(size_t slots)
+{
+  // The slot mutexes are never removed, so that a mutex cannot disappear
+  // while being held.
+  while (mSlotMutexes.size() < slots) {
+    mSlotMutexes.emplace_back(std::make_unique<std::mutex>());
+  }
+}
+
 void DataRelayer::publishMetrics()
 {
   std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
@@ -954,6 +1047,7 @@ void DataRelayer::publishMetrics()
   auto& states = mContext.get<DataProcessingStates>();
 
   mCachedStateMetrics.resize(mCache.size());
+  growSlotMutexes(mTimesliceIndex.size());
 
   // There is maximum 16 variables available. We keep them row-wise so that
   // that we can take mod 16 of the index to understand which variable we
@@ -1018,6 +1112,7 @@ void DataRelayer::sendContextState()
   int written = snprintf(relayerSlotState, 1024, "%d ", (int)mTimesliceIndex.size());
   char* buffer = relayerSlotState + written;
   for (size_t ci = 0; ci < mTimesliceIndex.size(); ++ci) {
+    std::scoped_lock<std::mutex> slotLock(*mSlotMutexes[ci]);
     for (size_t si = 0; si < mDistinctRoutesIndex.size(); ++si) {
       int index = si * mTimesliceIndex.size() + ci;
       int value = static_cast<int>(mCachedStateMetrics[index]);
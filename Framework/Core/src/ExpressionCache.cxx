@@ -0,0 +1,399 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/ExpressionCache.h"
+#include "Framework/Logger.h"
+#include <arrow/buffer.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/dictionary.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/type.h>
+#include <gandiva/filter.h>
+#include <gandiva/node.h>
+#include <gandiva/tree_expr_builder.h>
+#ifdef O2_GANDIVA_OBJECT_CACHE
+#include <gandiva/condition.h>
+#include <gandiva/configuration.h>
+#include <gandiva/expression_cache_key.h>
+#include <gandiva/llvm_generator.h>
+#include <gandiva/selection_vector.h>
+#include <llvm/Support/MemoryBuffer.h>
+#endif
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace o2::framework::expressions
+{
+namespace
+{
+/// FNV-1a, stable across builds and processes
+std::string stableHash(std::string const& s)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (auto c : s) {
+    h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+  }
+  return fmt::format("{:016x}", h);
+}
+
+std::string treeKey(gandiva::NodePtr const& tree)
+{
+  return stableHash(tree->ToString());
+}
+
+std::string schemaKey(gandiva::SchemaPtr const& schema)
+{
+  return stableHash(schema->ToString());
+}
+
+/// remove the least recently used files with this extension, so that one more file fits in maxFiles
+void evictFiles(fs::path const& dir, std::string const& extension, long maxFiles)
+{
+  std::error_code ec;
+  std::vector<std::pair<fs::file_time_type, fs::path>> files;
+  for (auto const& entry : fs::directory_iterator(dir, ec)) {
+    if (entry.path().extension() == extension) {
+      files.emplace_back(entry.last_write_time(ec), entry.path());
+    }
+  }
+  if (long(files.size()) >= maxFiles) {
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size() + 1 - maxFiles; ++i) {
+      fs::remove(files[i].second, ec);
+    }
+  }
+}
+
+/// write and rename, so that the concurrent jobs never see a partial file
+void writeFile(fs::path const& file, const char* data, size_t size)
+{
+  std::error_code ec;
+  auto tmp = file;
+  tmp += fmt::format(".{}.tmp", getpid());
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(data, size);
+  }
+  fs::rename(tmp, file, ec);
+  if (ec) {
+    fs::remove(tmp, ec);
+  }
+}
+
+std::shared_ptr<arrow::Schema> readSchema(fs::path const& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  arrow::io::BufferReader reader(arrow::Buffer::FromString(std::move(bytes)));
+  arrow::ipc::DictionaryMemo memo;
+  auto result = arrow::ipc::ReadSchema(&reader, &memo);
+  if (!result.ok()) {
+    LOGP(warn, "Cannot read the cached schema {}: {}", path.string(), result.status().ToString());
+    return nullptr;
+  }
+  return *result;
+}
+
+struct PrewarmState {
+  std::mutex mutex;
+  std::condition_variable done;
+  std::vector<std::thread> threads;
+  std::set<std::string> pending;  // tree/schema keys of the filters queued for the background compilation
+  std::set<std::string> compiled; // tree/schema keys of the filters compiled in the background
+
+  ~PrewarmState()
+  {
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+};
+
+PrewarmState& prewarmState()
+{
+  static PrewarmState state;
+  return state;
+}
+
+std::string& cacheDirectory()
+{
+  static std::string dir = getenv("DPL_GANDIVA_CACHE_DIR") ? getenv("DPL_GANDIVA_CACHE_DIR") : "";
+  return dir;
+}
+
+int& cacheThreads()
+{
+  static int n = getenv("DPL_GANDIVA_CACHE_THREADS") ? std::max(1, atoi(getenv("DPL_GANDIVA_CACHE_THREADS"))) : 1;
+  return n;
+}
+} // namespace
+
+std::string const& ExpressionCache::directory()
+{
+  return cacheDirectory();
+}
+
+void ExpressionCache::setDirectory(std::string const& dir)
+{
+  cacheDirectory() = dir;
+}
+
+int ExpressionCache::prewarmThreads()
+{
+  return cacheThreads();
+}
+
+void ExpressionCache::setPrewarmThreads(int n)
+{
+  cacheThreads() = std::max(1, n);
+}
+
+void ExpressionCache::recordFilter(gandiva::SchemaPtr const& schema, gandiva::NodePtr const& tree)
+{
+  if (directory().empty()) {
+    return;
+  }
+  std::error_code ec;
+  auto treeDir = fs::path(directory()) / treeKey(tree);
+  auto file = treeDir / (schemaKey(schema) + ".schema");
+  if (fs::exists(file, ec)) {
+    fs::last_write_time(file, fs::file_time_type::clock::now(), ec); // keep the used variants from the eviction
+    return;
+  }
+  fs::create_directories(treeDir, ec);
+  if (ec) {
+    LOGP(warn, "Cannot create the gandiva cache directory {}: {}", treeDir.string(), ec.message());
+    return;
+  }
+  // evict the least recently used schema variants of the expression to make room for the new one
+  evictFiles(treeDir, ".schema", MaxSchemasPerTree);
+  auto buffer = arrow::ipc::SerializeSchema(*schema);
+  if (!buffer.ok()) {
+    LOGP(warn, "Cannot serialize the schema for the gandiva cache: {}", buffer.status().ToString());
+    return;
+  }
+  writeFile(file, reinterpret_cast<const char*>((*buffer)->data()), (*buffer)->size());
+}
+
+void ExpressionCache::prewarmFilters(std::vector<gandiva::NodePtr> const& trees)
+{
+  if (directory().empty()) {
+    return;
+  }
+  auto& state = prewarmState();
+  auto jobs = std::make_shared<std::vector<std::pair<gandiva::SchemaPtr, gandiva::NodePtr>>>();
+  for (auto const& tree : trees) {
+    std::error_code ec;
+    for (auto const& entry : fs::directory_iterator(fs::path(directory()) / treeKey(tree), ec)) {
+      if (entry.path().extension() != ".schema") {
+        continue;
+      }
+      if (auto schema = readSchema(entry.path())) {
+        auto key = treeKey(tree) + "/" + schemaKey(schema);
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.compiled.count(key) || !state.pending.insert(key).second) {
+          continue; // already compiled or queued
+        }
+        jobs->emplace_back(schema, tree);
+      }
+    }
+  }
+  if (jobs->empty()) {
+    return;
+  }
+  auto nThreads = std::min<size_t>(jobs->size(), prewarmThreads());
+  LOGP(info, "Compiling {} gandiva filters recorded in {} in the background with {} thread(s)", jobs->size(), directory(), nThreads);
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  for (size_t i = 0; i < nThreads; ++i) {
+    state.threads.emplace_back([jobs, next, &state]() {
+      for (size_t j = (*next)++; j < jobs->size(); j = (*next)++) {
+        auto const& [schema, tree] = (*jobs)[j];
+        std::shared_ptr<gandiva::Filter> filter;
+        // the filter itself is dropped, the compiled module stays in the gandiva cache
+        auto condition = gandiva::TreeExprBuilder::MakeCondition(tree);
+        bool loaded = ExpressionCache::loadObjectCode(schema, condition);
+        auto s = gandiva::Filter::Make(schema, condition, &filter);
+        if (s.ok() && !loaded) {
+          ExpressionCache::storeObjectCode(schema, condition);
+        }
+        auto key = treeKey(tree) + "/" + schemaKey(schema);
+        {
+          std::lock_guard<std::mutex> lock(state.mutex);
+          if (s.ok()) {
+            state.compiled.insert(key);
+          }
+          state.pending.erase(key);
+        }
+        state.done.notify_all();
+      }
+    });
+  }
+}
+
+bool ExpressionCache::waitPrewarmed(gandiva::SchemaPtr const& schema, gandiva::NodePtr const& tree)
+{
+  if (directory().empty()) {
+    return false;
+  }
+  auto& state = prewarmState();
+  auto key = treeKey(tree) + "/" + schemaKey(schema);
+  // wait only for the background compilation of this filter, if it is queued
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.done.wait(lock, [&state, &key]() { return state.pending.count(key) == 0; });
+  return state.compiled.count(key) > 0;
+}
+
+#ifdef O2_GANDIVA_OBJECT_CACHE
+namespace
+{
+/// key of the stored object code, which is compiled for the host CPU
+std::string objectKey(gandiva::SchemaPtr const& schema, std::string const& expressions)
+{
+  static const std::string host = []() {
+    char name[256] = {0};
+    gethostname(name, sizeof(name) - 1);
+    return std::string(name);
+  }();
+  return stableHash(schema->ToString() + "\n" + expressions + "\n" + host);
+}
+
+fs::path objectFile(std::string const& key)
+{
+  return fs::path(cacheDirectory()) / "objects" / (key + ".o");
+}
+
+bool loadObject(gandiva::ExpressionCacheKey const& cacheKey, std::string const& key)
+{
+  auto file = objectFile(key);
+  std::ifstream in(file, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (bytes.empty()) {
+    return false;
+  }
+  std::error_code ec;
+  fs::last_write_time(file, fs::file_time_type::clock::now(), ec); // keep the used objects from the eviction
+  std::shared_ptr<llvm::MemoryBuffer> code = llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(bytes.data(), bytes.size()), file.string());
+  gandiva::LLVMGenerator::GetCache()->PutObjectCode(cacheKey, code);
+  return true;
+}
+
+void storeObject(gandiva::ExpressionCacheKey const& cacheKey, std::string const& key)
+{
+  auto code = gandiva::LLVMGenerator::GetCache()->GetObjectCode(cacheKey);
+  if (code == nullptr) {
+    return;
+  }
+  std::error_code ec;
+  auto file = objectFile(key);
+  if (fs::exists(file, ec)) {
+    return;
+  }
+  fs::create_directories(file.parent_path(), ec);
+  if (ec) {
+    LOGP(warn, "Cannot create the gandiva cache directory {}: {}", file.parent_path().string(), ec.message());
+    return;
+  }
+  evictFiles(file.parent_path(), ".o", ExpressionCache::MaxObjectFiles);
+  writeFile(file, code->getBufferStart(), code->getBufferSize());
+}
+
+std::string toString(gandiva::ExpressionVector const& expressions)
+{
+  std::string result = "projector";
+  for (auto const& expression : expressions) {
+    result += "\n" + expression->ToString();
+  }
+  return result;
+}
+} // namespace
+
+bool ExpressionCache::hasObjectCode()
+{
+  return true;
+}
+
+bool ExpressionCache::loadObjectCode(gandiva::SchemaPtr const& schema, gandiva::ConditionPtr const& condition)
+{
+  if (directory().empty()) {
+    return false;
+  }
+  // same key as in gandiva::Filter::Make
+  gandiva::ExpressionCacheKey cacheKey(schema, gandiva::ConfigurationBuilder::DefaultConfiguration(), *condition);
+  return loadObject(cacheKey, objectKey(schema, "filter\n" + condition->ToString()));
+}
+
+bool ExpressionCache::loadObjectCode(gandiva::SchemaPtr const& schema, gandiva::ExpressionVector const& expressions)
+{
+  if (directory().empty()) {
+    return false;
+  }
+  // same key as in gandiva::Projector::Make
+  gandiva::ExpressionCacheKey cacheKey(schema, gandiva::ConfigurationBuilder::DefaultConfiguration(), expressions, gandiva::SelectionVector::MODE_NONE);
+  return loadObject(cacheKey, objectKey(schema, toString(expressions)));
+}
+
+void ExpressionCache::storeObjectCode(gandiva::SchemaPtr const& schema, gandiva::ConditionPtr const& condition)
+{
+  if (directory().empty()) {
+    return;
+  }
+  gandiva::ExpressionCacheKey cacheKey(schema, gandiva::ConfigurationBuilder::DefaultConfiguration(), *condition);
+  storeObject(cacheKey, objectKey(schema, "filter\n" + condition->ToString()));
+}
+
+void ExpressionCache::storeObjectCode(gandiva::SchemaPtr const& schema, gandiva::ExpressionVector const& expressions)
+{
+  if (directory().empty()) {
+    return;
+  }
+  gandiva::ExpressionCacheKey cacheKey(schema, gandiva::ConfigurationBuilder::DefaultConfiguration(), expressions, gandiva::SelectionVector::MODE_NONE);
+  storeObject(cacheKey, objectKey(schema, toString(expressions)));
+}
+#else
+bool ExpressionCache::hasObjectCode()
+{
+  return false;
+}
+
+bool ExpressionCache::loadObjectCode(gandiva::SchemaPtr const&, gandiva::ConditionPtr const&)
+{
+  return false;
+}
+
+bool ExpressionCache::loadObjectCode(gandiva::SchemaPtr const&, gandiva::ExpressionVector const&)
+{
+  return false;
+}
+
+void ExpressionCache::storeObjectCode(gandiva::SchemaPtr const&, gandiva::ConditionPtr const&)
+{
+}
+
+void ExpressionCache::storeObjectCode(gandiva::SchemaPtr const&, gandiva::ExpressionVector const&)
+{
+}
+#endif
+} // namespace o2::framework::expressions
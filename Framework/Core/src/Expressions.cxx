@@ -10,14 +10,24 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/ExpressionHelpers.h"
+#include "Framework/ExpressionCache.h"
+#include "Framework/Logger.h"
 #include "Framework/RuntimeError.h"
 #include "Framework/VariantHelpers.h"
 #include "arrow/table.h"
+#include "arrow/util/thread_pool.h"
 #include "gandiva/tree_expr_builder.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
 #include <iostream>
+#include <latch>
+#include <mutex>
 #include <set>
 #include <stack>
+#include <thread>
 #include <unordered_map>
 
 using namespace o2::framework;
@@ -440,13 +450,33 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(std::move(node), std::move(result));
 }
 
+namespace
+{
+/// gandiva Filter::Make / Projector::Make going through the stored object code, see ExpressionCache
+template <typename T, typename E>
+arrow::Status makeCached(gandiva::SchemaPtr const& schema, E const& expressions, std::shared_ptr<T>* result)
+{
+  auto start = std::chrono::steady_clock::now();
+  bool loaded = ExpressionCache::loadObjectCode(schema, expressions);
+  auto s = T::Make(schema, expressions, result);
+  if (s.ok() && !loaded) {
+    ExpressionCache::storeObjectCode(schema, expressions);
+  }
+  if (!ExpressionCache::directory().empty()) {
+    LOGP(debug, "Gandiva module made in {} ms ({})", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+         loaded ? "stored object code" : "compiled");
+  }
+  return s;
+}
+} // namespace
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
   std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
+  auto s = makeCached(Schema,
+                      makeCondition(createExpressionTree(opSpecs, Schema)),
+                      &filter);
   if (!s.ok()) {
     throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
   }
@@ -457,9 +487,9 @@ std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
   std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 condition,
-                                 &filter);
+  auto s = makeCached(Schema,
+                      condition,
+                      &filter);
   if (!s.ok()) {
     throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
   }
@@ -470,9 +500,9 @@ std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
   std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))},
-                                    &projector);
+  auto s = makeCached(Schema,
+                      gandiva::ExpressionVector{makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))},
+                      &projector);
   if (!s.ok()) {
     throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
   }
@@ -501,7 +531,7 @@ std::shared_ptr<gandiva::Projector> createProjectorHelper(size_t nColumns, expre
   }
 
   std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
+  auto s = makeCached(
     schema,
     expressions,
     &projector);
@@ -511,7 +541,114 @@ std::shared_ptr<gandiva::Projector> createProjectorHelper(size_t nColumns, expre
   throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
 }
 
+namespace
+{
+/// split the table into record batches of at most batchSize rows, without copying the data
+std::vector<std::shared_ptr<arrow::RecordBatch>> splitToBatches(arrow::Table const& table, ChunkedEvaluation const& mode, int nThreads)
+{
+  arrow::TableBatchReader reader(table);
+  auto batchSize = mode.batchSize;
+  if (batchSize <= 0 && nThreads > 1) { // a few batches per thread to balance the load
+    batchSize = std::max<int64_t>(4096, (table.num_rows() + 4 * nThreads - 1) / (4 * nThreads));
+  }
+  if (batchSize > 0) {
+    reader.set_chunksize(batchSize);
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    auto s = reader.ReadNext(&batch);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
+    }
+    if (batch == nullptr) {
+      break;
+    }
+    batches.push_back(batch);
+  }
+  return batches;
+}
+
+int resolveThreads(ChunkedEvaluation const& mode)
+{
+  return mode.nThreads > 0 ? mode.nThreads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// workers of the chunked evaluation, shared by all the evaluations of the process and grown on demand
+arrow::internal::ThreadPool& evaluationPool(int nWorkers)
+{
+  static std::shared_ptr<arrow::internal::ThreadPool> pool = []() {
+    auto result = arrow::internal::ThreadPool::MakeEternal(1);
+    if (!result.ok()) {
+      throw runtime_error_f("Cannot create the evaluation thread pool %s", result.status().ToString().c_str());
+    }
+    return *result;
+  }();
+  static std::mutex poolMutex;
+  std::lock_guard<std::mutex> lock(poolMutex);
+  if (pool->GetCapacity() < nWorkers) {
+    auto s = pool->SetCapacity(nWorkers);
+    if (!s.ok()) {
+      LOGP(warn, "Cannot resize the evaluation thread pool to {} threads: {}", nWorkers, s.ToString());
+    }
+  }
+  return *pool;
+}
+
+/// run f(i) for i in [0, n) on up to nThreads threads, the calling one included
+template <typename F>
+void parallelFor(size_t n, int nThreads, F&& f)
+{
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  const auto nWorkers = static_cast<ptrdiff_t>(std::min<size_t>(nThreads - 1, n > 0 ? n - 1 : 0));
+  std::latch done(nWorkers);
+  if (nWorkers > 0) {
+    auto& pool = evaluationPool(nWorkers);
+    for (ptrdiff_t it = 0; it < nWorkers; ++it) {
+      auto s = pool.Spawn([&]() {
+        worker();
+        done.count_down();
+      });
+      if (!s.ok()) { // the remaining items are processed by the other threads
+        done.count_down();
+      }
+    }
+  }
+  worker();
+  done.wait(); // the workers reference the state of this call
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+} // namespace
+
+ChunkedEvaluation& defaultChunkedEvaluation()
+{
+  static ChunkedEvaluation mode{getenv("DPL_GANDIVA_THREADS") ? atoi(getenv("DPL_GANDIVA_THREADS")) : 1,
+                                getenv("DPL_GANDIVA_BATCH_SIZE") ? std::atoll(getenv("DPL_GANDIVA_BATCH_SIZE")) : 0};
+  return mode;
+}
+
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter)
+{
+  return createSelection(table, gfilter, defaultChunkedEvaluation());
+}
+
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter, ChunkedEvaluation const& mode)
 {
   gandiva::Selection selection;
   auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(),
@@ -523,22 +660,40 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, s
   if (table->num_rows() == 0) {
     return selection;
   }
-  arrow::TableBatchReader reader(*table);
-  std::shared_ptr<arrow::RecordBatch> batch;
-  while (true) {
-    s = reader.ReadNext(&batch);
+  auto nThreads = resolveThreads(mode);
+  auto batches = splitToBatches(*table, mode, nThreads);
+  if (batches.size() == 1) {
+    s = gfilter->Evaluate(*batches[0], selection);
     if (!s.ok()) {
-      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
+      throw runtime_error_f("Cannot apply filter %s", s.ToString().c_str());
     }
-    if (batch == nullptr) {
-      break;
+    return selection;
+  }
+
+  // the compiled filter is shared by the threads, each batch is evaluated into its own selection vector
+  std::vector<gandiva::Selection> selections(batches.size());
+  parallelFor(batches.size(), nThreads, [&](size_t i) {
+    auto s = gandiva::SelectionVector::MakeInt64(batches[i]->num_rows(), arrow::default_memory_pool(), &selections[i]);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
     }
-    s = gfilter->Evaluate(*batch, selection);
+    s = gfilter->Evaluate(*batches[i], selections[i]);
     if (!s.ok()) {
       throw runtime_error_f("Cannot apply filter %s", s.ToString().c_str());
     }
-  }
+  });
 
+  // concatenate in order, shifting the row indices of each batch by its offset in the table
+  int64_t nSelected = 0;
+  int64_t offset = 0;
+  for (size_t i = 0; i < batches.size(); ++i) {
+    auto const& sel = selections[i];
+    for (int64_t j = 0; j < sel->GetNumSlots(); ++j) {
+      selection->SetIndex(nSelected++, sel->GetIndex(j) + offset);
+    }
+    offset += batches[i]->num_rows();
+  }
+  selection->SetNumSlots(nSelected);
   return selection;
 }
 
@@ -548,25 +703,19 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table,
   return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
 }
 
-auto createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector)
+std::vector<arrow::ArrayVector> createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector,
+                                                 ChunkedEvaluation const& mode)
 {
-  arrow::TableBatchReader reader(*table);
-  std::shared_ptr<arrow::RecordBatch> batch;
-  std::shared_ptr<arrow::ArrayVector> v;
-  while (true) {
-    auto s = reader.ReadNext(&batch);
-    if (!s.ok()) {
-      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
-    }
-    if (batch == nullptr) {
-      break;
-    }
-    s = gprojector->Evaluate(*batch, arrow::default_memory_pool(), v.get());
+  auto nThreads = resolveThreads(mode);
+  auto batches = splitToBatches(*table, mode, nThreads);
+  std::vector<arrow::ArrayVector> projected(batches.size());
+  parallelFor(batches.size(), nThreads, [&](size_t i) {
+    auto s = gprojector->Evaluate(*batches[i], arrow::default_memory_pool(), &projected[i]);
     if (!s.ok()) {
       throw runtime_error_f("Cannot apply projector %s", s.ToString().c_str());
     }
-  }
-  return v;
+  });
+  return projected;
 }
 
 gandiva::NodePtr createExpressionTree(Operations const& opSpecs,
@@ -735,10 +884,28 @@ void updateExpressionInfos(expressions::Filter const& filter, std::vector<Expres
   }
 }
 
+void prewarmFilters(std::vector<ExpressionInfo> const& eInfos)
+{
+  std::vector<gandiva::NodePtr> trees;
+  for (auto const& info : eInfos) {
+    if (info.tree != nullptr) {
+      trees.push_back(info.tree);
+    }
+  }
+  ExpressionCache::prewarmFilters(trees);
+}
+
 void updateFilterInfo(ExpressionInfo& info, std::shared_ptr<arrow::Table>& table)
 {
   if (info.tree != nullptr && info.filter == nullptr) {
+    auto prewarmed = ExpressionCache::waitPrewarmed(table->schema(), info.tree);
+    auto start = std::chrono::steady_clock::now();
     info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
+    if (!ExpressionCache::directory().empty()) {
+      LOGP(info, "Gandiva filter created in {} ms ({})", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(),
+           prewarmed ? "precompiled in the background" : "compiled");
+      ExpressionCache::recordFilter(table->schema(), info.tree);
+    }
   }
   if (info.tree != nullptr && info.filter != nullptr && info.resetSelection == true) {
     info.selection = framework::expressions::createSelection(table, info.filter);
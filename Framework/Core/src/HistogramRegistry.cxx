@@ -282,9 +282,31 @@ void HistogramRegistry::print(bool showAxisDetails)
   LOGF(info, "");
 }
 
+void HistogramRegistry::setNShards(int nShards)
+{
+  mergeShards();
+  mShards.clear();
+  mShards.resize(nShards, std::vector<HistShard>(MAX_REGISTRY_SIZE));
+}
+
+void HistogramRegistry::mergeShards()
+{
+  for (auto& replicas : mShards) {
+    for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
+      auto& replica = replicas[i];
+      if (replica.sumw.empty()) {
+        continue;
+      }
+      std::visit([&replica](auto&& hist) { if (hist) { HistFiller::mergeShard(hist, replica); } }, mRegistryValue[i]);
+      replica.reset();
+    }
+  }
+}
+
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::getListOfHistograms()
 {
+  mergeShards();
   TList* list = new TList();
   list->SetName(mName.data());
 
@@ -414,4 +436,9 @@ void HistFiller::badHistogramFill(char const* name)
   LOGF(fatal, "The number of arguments in fill function called for histogram %s is incompatible with histogram dimensions.", name);
 }
 
+void HistFiller::badShardFill(char const* name)
+{
+  LOGF(fatal, "Histogram %s cannot be filled in the sharded mode, only TH1, TH2, TH3 and THn are supported.", name);
+}
+
 } // namespace o2::framework
@@ -89,30 +89,19 @@ std::shared_ptr<arrow::Table> spawnerHelper(std::shared_ptr<arrow::Table> const&
 {
   auto mergedProjectors = framework::expressions::createProjectorHelper(nColumns, projectors, fullTable->schema(), fields);
 
-  arrow::TableBatchReader reader(*fullTable);
-  std::shared_ptr<arrow::RecordBatch> batch;
-  arrow::ArrayVector v;
+  std::vector<arrow::ArrayVector> projected;
+  try {
+    projected = framework::expressions::createProjection(fullTable, mergedProjectors);
+  } catch (std::exception& e) {
+    throw runtime_error_f("Cannot apply projector to source table of %s: exception caught: %s", name, e.what());
+  } catch (RuntimeErrorRef& ref) {
+    throw runtime_error_f("Cannot apply projector to source table of %s: %s", name, error_from_ref(ref).what);
+  }
+
   std::vector<arrow::ArrayVector> chunks;
   chunks.resize(nColumns);
   std::vector<std::shared_ptr<arrow::ChunkedArray>> arrays;
-
-  while (true) {
-    auto s = reader.ReadNext(&batch);
-    if (!s.ok()) {
-      throw runtime_error_f("Cannot read batches from source table to spawn %s: %s", name, s.ToString().c_str());
-    }
-    if (batch == nullptr) {
-      break;
-    }
-    try {
-      s = mergedProjectors->Evaluate(*batch, arrow::default_memory_pool(), &v);
-      if (!s.ok()) {
-        throw runtime_error_f("Cannot apply projector to source table of %s: %s", name, s.ToString().c_str());
-      }
-    } catch (std::exception& e) {
-      throw runtime_error_f("Cannot apply projector to source table of %s: exception caught: %s", name, e.what());
-    }
-
+  for (auto& v : projected) {
     for (auto i = 0U; i < nColumns; ++i) {
       chunks[i].emplace_back(v.at(i));
     }
@@ -496,8 +496,10 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
         addReader(lookup->ptr, lookup->name, lookup->mVLA);
       }
     }
-    if (names.size() != mBranchReaders.size()) {
-      LOGF(warn, "Not all requested columns were found in the tree");
+    static bool warned = false; // the same tables are read for every timeframe
+    if (names.size() != mBranchReaders.size() && !warned) {
+      LOGF(warn, "Not all requested columns were found in the tree %s, this is reported only once", tree->GetName());
+      warned = true;
     }
   }
   if (mBranchReaders.empty()) {
@@ -507,13 +509,16 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
   // Re-enabling this seems to cut the number of IOPS in half
   tree->SetCacheSize(25000000);
   // tree->SetClusterPrefetch(true);
+  mZipBytes = mTotBytes = 0;
   for (auto& reader : mBranchReaders) {
     tree->AddBranchToCache(reader->branch());
-    if (strncmp(reader->branch()->GetName(), "fIndexArray", strlen("fIndexArray")) == 0) {
-      std::string sizeBranchName = reader->branch()->GetName();
-      sizeBranchName += "_size";
-      auto* sizeBranch = (TBranch*)tree->GetBranch(sizeBranchName.c_str());
-      if (sizeBranch) {
+    mZipBytes += reader->branch()->GetZipBytes();
+    mTotBytes += reader->branch()->GetTotBytes();
+    auto* sizeBranch = (TBranch*)tree->GetBranch((std::string{reader->branch()->GetName()} + TableTreeHelpers::sizeBranchSuffix).c_str());
+    if (sizeBranch) {
+      mZipBytes += sizeBranch->GetZipBytes();
+      mTotBytes += sizeBranch->GetTotBytes();
+      if (strncmp(reader->branch()->GetName(), "fIndexArray", strlen("fIndexArray")) == 0) {
         tree->AddBranchToCache(sizeBranch);
       }
     }
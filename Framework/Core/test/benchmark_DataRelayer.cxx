@@ -15,9 +15,19 @@
 #include "Framework/CompletionPolicyHelpers.h"
 #include "Framework/DataRelayer.h"
 #include "Framework/DataProcessingHeader.h"
+#include "Framework/DataProcessingStats.h"
+#include "Framework/DataProcessingStates.h"
+#include "Framework/DeviceState.h"
+#include "Framework/DriverConfig.h"
+#include "Framework/ServiceRegistryHelpers.h"
+#include "Framework/TimingHelpers.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/TransportFactory.h>
+#include <uv.h>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -354,4 +364,111 @@ static void BM_RelayMultiplePayloads(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultiplePayloads)->Arg(10)->Arg(100)->Arg(1000);
 
+// Several processing streams relaying, completing and consuming their own
+// timeslices concurrently on the same relayer, as it happens for a device
+// with multiple streams. The argument is the number of streams, each of them
+// handles a distinct set of timeslices and the pipeline is long enough for
+// all of them to have a slot in flight.
+static void BM_RelayConcurrentStreams(benchmark::State& state)
+{
+  const int nStreams = state.range(0);
+  constexpr int TimeslicesPerStream = 1000;
+
+  ServiceRegistry registry;
+  ServiceRegistryRef ref{registry};
+  Monitoring monitoring;
+  const DriverConfig driverConfig{
+    .batch = false,
+  };
+  DataProcessingStates states(
+    TimingHelpers::defaultRealtimeBaseConfigurator(0, uv_default_loop()),
+    TimingHelpers::defaultCPUTimeConfigurator(uv_default_loop()));
+  DataProcessingStats stats(
+    TimingHelpers::defaultRealtimeBaseConfigurator(0, uv_default_loop()),
+    TimingHelpers::defaultCPUTimeConfigurator(uv_default_loop()), {});
+  stats.registerMetric({.name = "relayed_messages", .metricId = static_cast<short>(ProcessingStatsId::RELAYED_MESSAGES)});
+  DeviceState deviceState;
+  ref.registerService(ServiceRegistryHelpers::handleForService<Monitoring>(&monitoring));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DataProcessingStats>(&stats));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DataProcessingStates>(&states));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DriverConfig const>(&driverConfig));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DeviceState>(&deviceState));
+
+  InputSpec spec{"clusters", "TPC", "CLUSTERS"};
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec, 0, "Fake", 0}};
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{1, infos};
+  ref.registerService(ServiceRegistryHelpers::handleForService<TimesliceIndex>(&index));
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, index, {registry});
+  relayer.setPipelineLength(2 * nStreams);
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+  dh.subSpecification = 0;
+  dh.payloadSize = 1000;
+
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  const size_t headerSize = Stack{dh, DataProcessingHeader{0, 1}}.size();
+  std::atomic<size_t> firstTimeslice = 0;
+
+  auto runStream = [&](int stream) {
+    // The messages are recycled, but since any stream can consume any
+    // ready slot, a stream might need to create new ones.
+    std::vector<fair::mq::MessagePtr> pool;
+    std::vector<RecordAction> ready;
+    auto consumeReady = [&]() {
+      ready.clear();
+      relayer.getReadyToProcess(ready);
+      for (auto& action : ready) {
+        auto result = relayer.consumeAllInputsForTimeslice(action.slot);
+        for (auto& m : result[0].messages) {
+          pool.emplace_back(std::move(m));
+        }
+        relayer.updateCacheStatus(action.slot, CacheEntryStatus::RUNNING, CacheEntryStatus::DONE);
+      }
+    };
+    auto base = firstTimeslice.load();
+    for (size_t i = 0; i < TimeslicesPerStream; ++i) {
+      size_t timeslice = base + i * nStreams + stream;
+      if (pool.size() < 2) {
+        pool.emplace_back(transport->CreateMessage(headerSize));
+        pool.emplace_back(transport->CreateMessage(dh.payloadSize));
+      }
+      std::array<fair::mq::MessagePtr, 2> messages{std::move(pool[pool.size() - 2]), std::move(pool[pool.size() - 1])};
+      pool.resize(pool.size() - 2);
+      Stack stack{dh, DataProcessingHeader{timeslice, 1}};
+      memcpy(messages[0]->GetData(), stack.data(), stack.size());
+      DataRelayer::InputInfo fakeInfo{0, messages.size(), DataRelayer::InputType::Data, {ChannelIndex::INVALID}};
+      while (relayer.relay(messages[0]->GetData(), messages.data(), fakeInfo, messages.size()).type == DataRelayer::RelayChoice::Type::Backpressured) {
+        consumeReady();
+      }
+      consumeReady();
+    }
+  };
+
+  for (auto _ : state) {
+    std::vector<std::thread> streams;
+    for (int si = 0; si < nStreams; ++si) {
+      streams.emplace_back(runStream, si);
+    }
+    for (auto& s : streams) {
+      s.join();
+    }
+    // Leftovers of the streams whose slots were made ready after their last check.
+    std::vector<RecordAction> ready;
+    relayer.getReadyToProcess(ready);
+    for (auto& action : ready) {
+      relayer.consumeAllInputsForTimeslice(action.slot);
+    }
+    firstTimeslice += TimeslicesPerStream * nStreams;
+  }
+  state.SetItemsProcessed(state.iterations() * TimeslicesPerStream * nStreams);
+}
+
+BENCHMARK(BM_RelayConcurrentStreams)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
 BENCHMARK_MAIN();
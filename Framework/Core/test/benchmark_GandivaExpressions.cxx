@@ -40,8 +40,8 @@ static std::default_random_engine e(1234567890);
 static std::normal_distribution<float> G;
 
 auto createTable = [](size_t nrows) {
-  static TableBuilder builder;
-  auto static rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
 
   for (auto i = 0u; i < nrows; ++i) {
     rowWriter(0, G(e), G(e), G(e));
@@ -67,7 +67,38 @@ static void BM_GandivaExpression(benchmark::State& state)
   benchmark::DoNotOptimize(tt);
 }
 
+// filter evaluated over record batches of 8192 rows on state.range(1) threads
+static void BM_GandivaChunkedFilter(benchmark::State& state)
+{
+  auto tt = createTable(state.range(0));
+  auto table = tt.asArrowTable();
+  expressions::Filter f = nsqrt(test::x * test::x + test::y * test::y + test::z * test::z) < 1.5f && test::x > 0.f;
+  auto gfilter = expressions::createFilter(table->schema(), expressions::createOperations(f));
+  expressions::ChunkedEvaluation mode{static_cast<int>(state.range(1)), 8192};
+  for (auto _ : state) {
+    auto selection = expressions::createSelection(table, gfilter, mode);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// projector evaluated over record batches of 8192 rows on state.range(1) threads
+static void BM_GandivaChunkedProjector(benchmark::State& state)
+{
+  auto tt = createTable(state.range(0));
+  auto table = tt.asArrowTable();
+  auto gprojector = expressions::createProjector(table->schema(), test::x * test::y + nsqrt(test::z * test::z + 1.f), test::cD::asArrowField());
+  expressions::ChunkedEvaluation mode{static_cast<int>(state.range(1)), 8192};
+  for (auto _ : state) {
+    auto projected = expressions::createProjection(table, gprojector, mode);
+    benchmark::DoNotOptimize(projected);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
 BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+BENCHMARK(BM_GandivaChunkedFilter)->ArgsProduct({{1 << 16, 1 << 22}, {1, 2, 4, 8}})->UseRealTime();
+BENCHMARK(BM_GandivaChunkedProjector)->ArgsProduct({{1 << 16, 1 << 22}, {1, 2, 4, 8}})->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -16,6 +16,7 @@
 
 #include <benchmark/benchmark.h>
 #include <boost/format.hpp>
+#include <thread>
 
 using namespace o2::framework;
 using namespace arrow;
@@ -62,7 +63,49 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+/// Number of fills to perform
+const int nFills = 1000000;
+
+/// Fill TH1 and TH2 histograms of a HistogramRegistry directly, from a single thread
+static void BM_DirectFill(benchmark::State& state)
+{
+  HistogramRegistry registry{"registry", {{"pt", "pt", {HistType::kTH1F, {{1000, 0, 10}}}}, {"ptEta", "ptEta", {HistType::kTH2F, {{100, 0, 10}, {100, -1, 1}}}}}};
+  for (auto _ : state) {
+    for (auto i = 0; i < nFills; ++i) {
+      registry.fill(HIST("pt"), (i % 1000) * 0.01);
+      registry.fill(HIST("ptEta"), (i % 1000) * 0.01, (i % 200) * 0.01 - 1.);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nFills);
+}
+
+/// Fill the same histograms in the sharded mode from state.range(0) threads, merging the replicas at the end
+static void BM_ShardedFill(benchmark::State& state)
+{
+  HistogramRegistry registry{"registry", {{"pt", "pt", {HistType::kTH1F, {{1000, 0, 10}}}}, {"ptEta", "ptEta", {HistType::kTH2F, {{100, 0, 10}, {100, -1, 1}}}}}};
+  const int nShards = state.range(0);
+  registry.setNShards(nShards);
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (auto shard = 0; shard < nShards; ++shard) {
+      threads.emplace_back([&registry, shard, nShards]() {
+        for (auto i = shard; i < nFills; i += nShards) {
+          registry.fillShard(shard, HIST("pt"), (i % 1000) * 0.01);
+          registry.fillShard(shard, HIST("ptEta"), (i % 1000) * 0.01, (i % 200) * 0.01 - 1.);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    registry.mergeShards();
+  }
+  state.SetItemsProcessed(state.iterations() * nFills);
+}
+
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+BENCHMARK(BM_DirectFill);
+BENCHMARK(BM_ShardedFill)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
 
 BENCHMARK_MAIN();
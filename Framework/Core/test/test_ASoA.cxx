@@ -689,6 +689,26 @@ TEST_CASE("TestNestedFiltering")
   REQUIRE(i == 1);
 }
 
+TEST_CASE("TestChunkedFilterEvaluation")
+{
+  TableBuilder builderA;
+  auto rowWriterA = builderA.persist<int32_t, int32_t>({"fX", "fY"});
+  for (auto i = 0; i < 1000; ++i) {
+    rowWriterA(0, i, 2 * i);
+  }
+  auto tableA = builderA.finalize();
+
+  expressions::Filter f = o2::aod::test::x < 100 || (o2::aod::test::y > 500 && o2::aod::test::y < 700);
+  auto gfilter = expressions::createFilter(tableA->schema(), expressions::createOperations(f));
+  auto serial = expressions::createSelection(tableA, gfilter, expressions::ChunkedEvaluation{1, 0});
+  auto chunked = expressions::createSelection(tableA, gfilter, expressions::ChunkedEvaluation{4, 64});
+  REQUIRE(serial->GetNumSlots() == 199);
+  REQUIRE(chunked->GetNumSlots() == serial->GetNumSlots());
+  for (auto i = 0; i < serial->GetNumSlots(); ++i) {
+    REQUIRE(chunked->GetIndex(i) == serial->GetIndex(i));
+  }
+}
+
 TEST_CASE("TestEmptyTables")
 {
   TableBuilder bPoints;
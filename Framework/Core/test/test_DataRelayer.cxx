@@ -26,7 +26,10 @@
 #include "Framework/WorkflowSpec.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/TransportFactory.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <uv.h>
 
@@ -808,4 +811,94 @@ TEST_CASE("DataRelayer")
       }
     }
   }
+
+  // One thread relaying timeslices while another one consumes them, to
+  // check that a slot is never published before its messages are stored
+  // and that no timeslice is lost or consumed twice.
+  SECTION("TestConcurrentRelayAndConsume")
+  {
+    InputSpec spec{"clusters", "TPC", "CLUSTERS"};
+    std::vector<InputRoute> inputs = {
+      InputRoute{spec, 0, "Fake", 0}};
+
+    std::vector<InputChannelInfo> infos{1};
+    TimesliceIndex index{1, infos};
+    ref.registerService(ServiceRegistryHelpers::handleForService<TimesliceIndex>(&index));
+
+    auto policy = CompletionPolicyHelpers::consumeWhenAny();
+    DataRelayer relayer(policy, inputs, index, {registry});
+    relayer.setPipelineLength(4);
+
+    DataHeader dh;
+    dh.dataDescription = "CLUSTERS";
+    dh.dataOrigin = "TPC";
+    dh.subSpecification = 0;
+    dh.splitPayloadIndex = 0;
+    dh.splitPayloadParts = 1;
+
+    constexpr size_t nTimeslices = 2000;
+    auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+    auto channelAlloc = o2::pmr::getTransportAllocator(transport.get());
+
+    // Catch assertions are not thread safe, the results are checked once both threads are done.
+    std::vector<DataRelayer::RelayChoice::Type> relayed;
+    std::vector<size_t> consumed;
+    size_t emptySets = 0;
+    size_t wrongPayloads = 0;
+    std::atomic<bool> relayDone = false;
+
+    std::thread producer([&]() {
+      for (size_t timeslice = 0; timeslice < nTimeslices; ++timeslice) {
+        std::array<fair::mq::MessagePtr, 2> messages;
+        messages[0] = o2::pmr::getMessage(Stack{channelAlloc, dh, DataProcessingHeader{timeslice, 1}});
+        messages[1] = transport->CreateMessage(sizeof(size_t));
+        *(reinterpret_cast<size_t*>(messages[1]->GetData())) = timeslice;
+        DataRelayer::InputInfo fakeInfo{0, messages.size(), DataRelayer::InputType::Data, {ChannelIndex::INVALID}};
+        DataRelayer::RelayChoice::Type result;
+        while ((result = relayer.relay(messages[0]->GetData(), messages.data(), fakeInfo, messages.size()).type) == DataRelayer::RelayChoice::Type::Backpressured) {
+          std::this_thread::yield();
+        }
+        relayed.push_back(result);
+      }
+      relayDone = true;
+    });
+
+    std::thread consumer([&]() {
+      std::vector<RecordAction> ready;
+      while (true) {
+        bool lastRound = relayDone.load();
+        ready.clear();
+        relayer.getReadyToProcess(ready);
+        for (auto& action : ready) {
+          auto result = relayer.consumeAllInputsForTimeslice(action.slot);
+          if (result.size() != 1 || result[0].size() != 1) {
+            ++emptySets;
+            continue;
+          }
+          auto const* dph = o2::header::get<DataProcessingHeader*>(result[0].header(0)->GetData());
+          consumed.push_back(dph->startTime);
+          if (*(reinterpret_cast<size_t const*>(result[0].payload(0)->GetData())) != dph->startTime) {
+            ++wrongPayloads;
+          }
+          relayer.updateCacheStatus(action.slot, CacheEntryStatus::RUNNING, CacheEntryStatus::DONE);
+        }
+        if (lastRound && ready.empty()) {
+          break;
+        }
+      }
+    });
+
+    producer.join();
+    consumer.join();
+
+    REQUIRE(relayed.size() == nTimeslices);
+    REQUIRE(std::count(relayed.begin(), relayed.end(), DataRelayer::RelayChoice::Type::WillRelay) == nTimeslices);
+    REQUIRE(emptySets == 0);
+    REQUIRE(wrongPayloads == 0);
+    std::sort(consumed.begin(), consumed.end());
+    REQUIRE(consumed.size() == nTimeslices);
+    for (size_t i = 0; i < nTimeslices; ++i) {
+      REQUIRE(consumed[i] == i);
+    }
+  }
 }
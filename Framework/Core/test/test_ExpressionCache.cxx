@@ -0,0 +1,139 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ExpressionCache.h"
+#include "Framework/Expressions.h"
+#include <catch_amalgamated.hpp>
+#include <arrow/array/builder_primitive.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <gandiva/filter.h>
+#include <gandiva/projector.h>
+#include <gandiva/selection_vector.h>
+#include <gandiva/tree_expr_builder.h>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace o2::framework::expressions;
+namespace fs = std::filesystem;
+
+namespace
+{
+/// schema variants of the same expression, differing by the unused columns
+gandiva::SchemaPtr makeSchema(int variant)
+{
+  arrow::FieldVector fields{arrow::field("x", arrow::int32())};
+  for (int i = 0; i <= variant; ++i) {
+    fields.push_back(arrow::field("extra" + std::to_string(i), arrow::float32()));
+  }
+  return arrow::schema(fields);
+}
+
+size_t countFiles(fs::path const& dir, std::string const& extension)
+{
+  size_t n = 0;
+  if (!fs::exists(dir)) {
+    return n;
+  }
+  for (auto const& entry : fs::recursive_directory_iterator(dir)) {
+    n += entry.path().extension() == extension;
+  }
+  return n;
+}
+} // namespace
+
+TEST_CASE("TestExpressionCacheRoundTrip")
+{
+  auto oldDirectory = ExpressionCache::directory();
+  auto oldThreads = ExpressionCache::prewarmThreads();
+  auto dir = fs::temp_directory_path() / ("test_ExpressionCache_" + std::to_string(getpid()));
+  fs::remove_all(dir);
+  ExpressionCache::setDirectory(dir.string());
+  ExpressionCache::setPrewarmThreads(2);
+
+  auto x = gandiva::TreeExprBuilder::MakeField(arrow::field("x", arrow::int32()));
+  auto tree = gandiva::TreeExprBuilder::MakeFunction("greater_than", {x, gandiva::TreeExprBuilder::MakeLiteral(int32_t{1})}, arrow::boolean());
+  constexpr int NVariants = ExpressionCache::MaxSchemasPerTree + 1;
+  auto pause = []() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }; // distinct modification times
+
+  SECTION("Record and evict")
+  {
+    for (int i = 0; i < NVariants - 1; ++i) {
+      ExpressionCache::recordFilter(makeSchema(i), tree);
+      pause();
+    }
+    REQUIRE(countFiles(dir, ".schema") == ExpressionCache::MaxSchemasPerTree);
+    ExpressionCache::recordFilter(makeSchema(0), tree); // used again, variant 1 becomes the oldest
+    pause();
+    ExpressionCache::recordFilter(makeSchema(NVariants - 1), tree);
+    REQUIRE(countFiles(dir, ".schema") == ExpressionCache::MaxSchemasPerTree);
+
+    // the prewarm compiles exactly the recorded variants
+    ExpressionCache::prewarmFilters({tree});
+    REQUIRE(ExpressionCache::waitPrewarmed(makeSchema(0), tree));
+    REQUIRE(ExpressionCache::waitPrewarmed(makeSchema(NVariants - 1), tree));
+    for (int i = 2; i < NVariants - 1; ++i) {
+      REQUIRE(ExpressionCache::waitPrewarmed(makeSchema(i), tree));
+    }
+    REQUIRE(!ExpressionCache::waitPrewarmed(makeSchema(1), tree));
+
+    // another prewarm does not compile again the same filters
+    ExpressionCache::prewarmFilters({tree});
+    REQUIRE(ExpressionCache::waitPrewarmed(makeSchema(0), tree));
+  }
+
+  SECTION("Object code")
+  {
+    const size_t nObjects = ExpressionCache::hasObjectCode() ? 2 : 0;
+    auto schema = makeSchema(0);
+    auto condition = gandiva::TreeExprBuilder::MakeCondition(tree);
+    gandiva::ExpressionVector expressions{gandiva::TreeExprBuilder::MakeExpression(tree, arrow::field("out", arrow::boolean()))};
+    REQUIRE(!ExpressionCache::loadObjectCode(schema, condition));
+    REQUIRE(!ExpressionCache::loadObjectCode(schema, expressions));
+    REQUIRE(createFilter(schema, condition) != nullptr); // stores the object code of the filter
+    std::shared_ptr<gandiva::Projector> projector;
+    REQUIRE(gandiva::Projector::Make(schema, expressions, &projector).ok());
+    ExpressionCache::storeObjectCode(schema, expressions);
+    REQUIRE(countFiles(dir, ".o") == nObjects);
+    ExpressionCache::storeObjectCode(schema, expressions); // stored only once
+    REQUIRE(countFiles(dir, ".o") == nObjects);
+    REQUIRE(ExpressionCache::loadObjectCode(schema, condition) == (nObjects > 0));
+    REQUIRE(ExpressionCache::loadObjectCode(schema, expressions) == (nObjects > 0));
+
+    // the filter made from the loaded object code gives the right selection
+    arrow::Int32Builder xBuilder;
+    arrow::FloatBuilder extraBuilder;
+    REQUIRE(xBuilder.AppendValues({0, 1, 2, 3}).ok());
+    REQUIRE(extraBuilder.AppendValues({0.f, 0.f, 0.f, 0.f}).ok());
+    auto batch = arrow::RecordBatch::Make(schema, 4, {*xBuilder.Finish(), *extraBuilder.Finish()});
+    std::shared_ptr<gandiva::SelectionVector> selection;
+    REQUIRE(gandiva::SelectionVector::MakeInt16(4, arrow::default_memory_pool(), &selection).ok());
+    REQUIRE(createFilter(schema, condition)->Evaluate(*batch, selection).ok());
+    REQUIRE(selection->GetNumSlots() == 2);
+    REQUIRE(selection->GetIndex(0) == 2);
+    REQUIRE(selection->GetIndex(1) == 3);
+  }
+
+  SECTION("Disabled")
+  {
+    ExpressionCache::setDirectory("");
+    ExpressionCache::recordFilter(makeSchema(0), tree);
+    REQUIRE(!fs::exists(dir));
+    REQUIRE(!ExpressionCache::waitPrewarmed(makeSchema(0), tree));
+  }
+
+  ExpressionCache::setDirectory(oldDirectory);
+  ExpressionCache::setPrewarmThreads(oldThreads);
+  fs::remove_all(dir);
+}
@@ -11,6 +11,8 @@
 
 #include "Framework/HistogramRegistry.h"
 #include <catch_amalgamated.hpp>
+#include <cmath>
+#include <thread>
 
 using namespace o2;
 using namespace o2::framework;
@@ -125,3 +127,69 @@ TEST_CASE("HistogramRegistryStepTHn")
 
   registry.print();
 }
+
+TEST_CASE("HistogramRegistryShardedFill")
+{
+  auto makeRegistry = [](char const* name) {
+    HistogramRegistry registry{name};
+    registry.add("x", "x", kTH1F, {{100, -5.0, 5.0}});
+    registry.add("xy", "xy", kTH2D, {{20, -5.0, 5.0}, {20, -5.0, 5.0}});
+    registry.add("xyz", "xyz", kTHnF, {{10, -5.0, 5.0}, {10, -5.0, 5.0}, {10, -5.0, 5.0}});
+    return registry;
+  };
+  auto reference = makeRegistry("reference");
+  auto sharded = makeRegistry("sharded");
+
+  constexpr int nShards = 4;
+  constexpr int nFills = 10000;
+  auto value = [](int i, int k) { return std::fmod(0.37 * i + 1.3 * k, 11.) - 5.5; };
+  for (auto i = 0; i < nFills; ++i) {
+    reference.fill(HIST("x"), value(i, 0));
+    reference.fill(HIST("xy"), value(i, 0), value(i, 1), 0.5);
+    reference.fill(HIST("xyz"), value(i, 0), value(i, 1), value(i, 2));
+  }
+
+  sharded.setNShards(nShards);
+  std::vector<std::thread> threads;
+  for (auto shard = 0; shard < nShards; ++shard) {
+    threads.emplace_back([&sharded, &value, shard]() {
+      for (auto i = shard; i < nFills; i += nShards) {
+        sharded.fillShard(shard, HIST("x"), value(i, 0));
+        sharded.fillShard(shard, HIST("xy"), value(i, 0), value(i, 1), 0.5);
+        sharded.fillShard(shard, HIST("xyz"), value(i, 0), value(i, 1), value(i, 2));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  sharded.mergeShards();
+
+  auto h1 = sharded.get<TH1>(HIST("x"));
+  auto r1 = reference.get<TH1>(HIST("x"));
+  REQUIRE(h1->GetEntries() == r1->GetEntries());
+  for (auto bin = 0; bin < r1->GetNcells(); ++bin) {
+    REQUIRE(h1->GetBinContent(bin) == r1->GetBinContent(bin));
+  }
+  auto h2 = sharded.get<TH2>(HIST("xy"));
+  auto r2 = reference.get<TH2>(HIST("xy"));
+  REQUIRE(h2->GetEntries() == r2->GetEntries());
+  for (auto bin = 0; bin < r2->GetNcells(); ++bin) {
+    REQUIRE(h2->GetBinContent(bin) == Catch::Approx(r2->GetBinContent(bin)));
+    REQUIRE(h2->GetBinError(bin) == Catch::Approx(r2->GetBinError(bin)));
+  }
+  auto hn = sharded.get<THn>(HIST("xyz"));
+  auto rn = reference.get<THn>(HIST("xyz"));
+  REQUIRE(hn->GetEntries() == rn->GetEntries());
+  for (auto bin = 0; bin < rn->GetNbins(); ++bin) {
+    REQUIRE(hn->GetBinContent(bin) == rn->GetBinContent(bin));
+  }
+  // the statistics are merged as filled, not recomputed from the bin centres
+  REQUIRE(h1->GetMean() == Catch::Approx(r1->GetMean()));
+  REQUIRE(h1->GetStdDev() == Catch::Approx(r1->GetStdDev()));
+  REQUIRE(h2->GetMean(1) == Catch::Approx(r2->GetMean(1)));
+  REQUIRE(h2->GetMean(2) == Catch::Approx(r2->GetMean(2)));
+  REQUIRE(h2->GetCovariance() == Catch::Approx(r2->GetCovariance()));
+
+  REQUIRE_THROWS(sharded.fillShard(nShards, HIST("x"), 0.));
+}
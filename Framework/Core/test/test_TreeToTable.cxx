@@ -234,4 +234,26 @@ TEST_CASE("VariableLists")
     }
     ++i;
   }
+
+  // only the branches of the requested columns are read
+  auto bytesRead = [](std::vector<std::string> columns, std::shared_ptr<arrow::Table>& result) {
+    auto* file = TFile::Open("variable_lists.root", "READ");
+    auto* tree = static_cast<TTree*>(file->Get("lists;1"));
+    TreeToTable t2t;
+    t2t.addAllColumns(tree, std::move(columns));
+    t2t.fill(tree);
+    result = t2t.finalize();
+    auto bytes = file->GetBytesRead();
+    file->Close();
+    return bytes;
+  };
+  std::shared_ptr<arrow::Table> all, selected;
+  auto bytesAll = bytesRead({}, all);
+  auto bytesSelected = bytesRead({"fIvec"}, selected);
+  REQUIRE(all->num_columns() == 4);
+  REQUIRE(selected->num_columns() == 1);
+  REQUIRE(selected->schema()->field(0)->name() == "fIvec");
+  REQUIRE(selected->num_rows() == all->num_rows());
+  REQUIRE(selected->column(0)->Equals(*all->GetColumnByName("fIvec")));
+  REQUIRE(bytesSelected < bytesAll);
 }
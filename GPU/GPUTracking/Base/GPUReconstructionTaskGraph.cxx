@@ -0,0 +1,132 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GPUReconstructionTaskGraph.cxx
+/// \brief Dependency graph of CPU tasks executed on a pool of OpenMP threads
+
+#include "GPUReconstructionTaskGraph.h"
+#include "GPUDefMacros.h"
+#include "utils/timer.h"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+
+#if defined(WITH_OPENMP) || defined(_OPENMP)
+#include <omp.h>
+#else
+static inline int32_t omp_get_thread_num() { return 0; }
+#endif
+
+using namespace GPUCA_NAMESPACE::gpu;
+
+void GPUReconstructionTaskGraph::clear()
+{
+  mTasks.clear();
+  mTimeline.clear();
+}
+
+int32_t GPUReconstructionTaskGraph::addTask(int32_t stage, int32_t item, taskFunction&& function, std::initializer_list<int32_t> dependencies)
+{
+  int32_t id = mTasks.size();
+  mTasks.emplace_back();
+  mTasks.back().function = std::move(function);
+  mTimeline.emplace_back(taskTiming{stage, item, -1, 0., 0.});
+  for (int32_t dependency : dependencies) {
+    addDependency(id, dependency);
+  }
+  return id;
+}
+
+void GPUReconstructionTaskGraph::addDependency(int32_t task, int32_t dependency)
+{
+  if (dependency < 0) {
+    return; // No dependency, e.g. the first task of a chain
+  }
+  if (task >= (int32_t)mTasks.size() || dependency >= task) {
+    throw std::runtime_error("Invalid task graph dependency");
+  }
+  mTasks[dependency].dependents.emplace_back(task);
+  mTasks[task].nDependencies++;
+}
+
+int32_t GPUReconstructionTaskGraph::run(int32_t nWorkers)
+{
+  const int32_t nTasks = mTasks.size();
+  std::vector<int32_t> waiting(nTasks);
+  std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>> ready;
+  for (int32_t i = 0; i < nTasks; i++) {
+    waiting[i] = mTasks[i].nDependencies;
+    if (waiting[i] == 0) {
+      ready.push(i);
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  int32_t nDone = 0;
+  int32_t retVal = 0;
+  std::exception_ptr exception;
+  HighResTimer clock;
+  clock.Start();
+
+  GPUCA_OPENMP(parallel num_threads(nWorkers) if(nWorkers > 1))
+  {
+    const int32_t worker = omp_get_thread_num();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cond.wait(lock, [&] { return !ready.empty() || nDone == nTasks; });
+      if (ready.empty()) {
+        break;
+      }
+      const int32_t iTask = ready.top();
+      ready.pop();
+      const bool cancelled = retVal || exception;
+      lock.unlock();
+
+      taskTiming& timing = mTimeline[iTask];
+      int32_t taskRetVal = 0;
+      std::exception_ptr taskException;
+      if (!cancelled) {
+        timing.worker = worker;
+        timing.start = clock.GetCurrentElapsedTime();
+        try {
+          taskRetVal = mTasks[iTask].function();
+        } catch (...) {
+          taskException = std::current_exception();
+        }
+        timing.end = clock.GetCurrentElapsedTime();
+      }
+
+      lock.lock();
+      if (taskRetVal && retVal == 0) {
+        retVal = taskRetVal;
+      }
+      if (taskException && !exception) {
+        exception = taskException;
+      }
+      nDone++;
+      for (int32_t dependent : mTasks[iTask].dependents) {
+        if (--waiting[dependent] == 0) {
+          ready.push(dependent);
+        }
+      }
+      cond.notify_all();
+    }
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  return retVal;
+}
@@ -0,0 +1,69 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GPUReconstructionTaskGraph.h
+/// \brief Dependency graph of CPU tasks executed on a pool of OpenMP threads
+
+#ifndef GPURECONSTRUCTIONTASKGRAPH_H
+#define GPURECONSTRUCTIONTASKGRAPH_H
+
+#include "GPUCommonDef.h"
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+namespace GPUCA_NAMESPACE
+{
+namespace gpu
+{
+
+// Used by the CPU backend to run the per-sector kernel sequences of the chain as independent dependency chains,
+// instead of one parallel loop over the sectors per step with a barrier in between.
+// Tasks may only depend on tasks added before them. Ready tasks are picked in the order they were added,
+// so that the later steps of the first sectors are preferred over the first steps of the later sectors.
+// A task returning a nonzero value or throwing cancels all tasks not yet started, the first error is returned / rethrown by run().
+class GPUReconstructionTaskGraph
+{
+ public:
+  typedef std::function<int32_t()> taskFunction;
+
+  struct taskTiming {
+    int32_t stage;
+    int32_t item;
+    int32_t worker; // -1 if the task was cancelled
+    double start;   // in seconds after the start of run()
+    double end;
+  };
+
+  void clear();
+  int32_t addTask(int32_t stage, int32_t item, taskFunction&& function, std::initializer_list<int32_t> dependencies = {});
+  void addDependency(int32_t task, int32_t dependency);
+  int32_t run(int32_t nWorkers);
+
+  uint32_t nTasks() const { return mTasks.size(); }
+  const std::vector<taskTiming>& timeline() const { return mTimeline; }
+
+ private:
+  struct task {
+    taskFunction function;
+    std::vector<int32_t> dependents;
+    int32_t nDependencies = 0;
+  };
+
+  std::vector<task> mTasks;
+  std::vector<taskTiming> mTimeline;
+};
+
+} // namespace gpu
+} // namespace GPUCA_NAMESPACE
+
+#endif
@@ -0,0 +1,122 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testGPUReconstructionTaskGraph.cxx
+/// \brief Unit tests of the CPU task graph executor
+
+#define BOOST_TEST_MODULE Test GPUReconstructionTaskGraph
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "GPUReconstructionTaskGraph.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace o2::gpu;
+
+BOOST_AUTO_TEST_CASE(TaskGraphEmpty)
+{
+  GPUReconstructionTaskGraph graph;
+  BOOST_CHECK_EQUAL(graph.nTasks(), 0u);
+  BOOST_CHECK_EQUAL(graph.run(1), 0);
+  BOOST_CHECK_EQUAL(graph.run(4), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TaskGraphDependencyOrder)
+{
+  // 8 chains of 4 steps, step k of chain i also depends on step k-1 of chains i-1 and i+1 (like the global tracking of the sectors)
+  constexpr int32_t nChains = 8, nSteps = 4;
+  for (int32_t nWorkers : {1, 2, 4, 8}) {
+    GPUReconstructionTaskGraph graph;
+    std::mutex mutex;
+    std::vector<int32_t> order;
+    int32_t ids[nSteps][nChains];
+    for (int32_t k = 0; k < nSteps; k++) {
+      for (int32_t i = 0; i < nChains; i++) {
+        ids[k][i] = graph.addTask(k, i, [&, k, i]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.emplace_back(k * nChains + i);
+          return 0;
+        });
+        if (k > 0) {
+          for (int32_t j : {i - 1, i, i + 1}) {
+            if (j >= 0 && j < nChains) {
+              graph.addDependency(ids[k][i], ids[k - 1][j]);
+            }
+          }
+        }
+      }
+    }
+    BOOST_CHECK_EQUAL(graph.run(nWorkers), 0);
+    BOOST_REQUIRE_EQUAL(order.size(), (size_t)(nSteps * nChains));
+
+    std::vector<int32_t> position(nSteps * nChains, -1);
+    for (size_t p = 0; p < order.size(); p++) {
+      position[order[p]] = p;
+    }
+    for (int32_t k = 1; k < nSteps; k++) {
+      for (int32_t i = 0; i < nChains; i++) {
+        for (int32_t j : {i - 1, i, i + 1}) {
+          if (j >= 0 && j < nChains) {
+            BOOST_CHECK_LT(position[(k - 1) * nChains + j], position[k * nChains + i]);
+          }
+        }
+      }
+    }
+    for (const auto& timing : graph.timeline()) {
+      BOOST_CHECK_GE(timing.worker, 0);
+      BOOST_CHECK_LE(timing.start, timing.end);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TaskGraphInvalidDependency)
+{
+  GPUReconstructionTaskGraph graph;
+  int32_t first = graph.addTask(0, 0, []() { return 0; });
+  BOOST_CHECK_THROW(graph.addDependency(first, first), std::runtime_error);
+  BOOST_CHECK_THROW(graph.addTask(0, 1, []() { return 0; }, {first + 1}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TaskGraphErrorCancels)
+{
+  for (int32_t nWorkers : {1, 4}) {
+    GPUReconstructionTaskGraph graph;
+    std::atomic<int32_t> nRun{0};
+    int32_t failing = graph.addTask(0, 0, [&]() { nRun++; return 3; });
+    graph.addTask(1, 0, [&]() { nRun++; return 0; }, {failing});
+    BOOST_CHECK_EQUAL(graph.run(nWorkers), 3);
+    BOOST_CHECK_EQUAL(nRun.load(), 1);
+    BOOST_CHECK_EQUAL(graph.timeline()[1].worker, -1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TaskGraphExceptionPropagation)
+{
+  for (int32_t nWorkers : {1, 4}) {
+    GPUReconstructionTaskGraph graph;
+    std::atomic<int32_t> nRun{0};
+    int32_t throwing = graph.addTask(0, 0, [&]() -> int32_t { nRun++; throw std::out_of_range("task failure"); });
+    int32_t dependent = graph.addTask(1, 0, [&]() { nRun++; return 0; }, {throwing});
+    graph.addTask(2, 0, [&]() { nRun++; return 0; }, {dependent});
+    BOOST_CHECK_THROW(graph.run(nWorkers), std::out_of_range);
+    BOOST_CHECK_EQUAL(nRun.load(), 1);
+
+    // the graph can be cleared and reused after a failure
+    graph.clear();
+    graph.addTask(0, 0, [&]() { nRun++; return 0; });
+    BOOST_CHECK_EQUAL(graph.run(nWorkers), 0);
+    BOOST_CHECK_EQUAL(nRun.load(), 2);
+  }
+}
@@ -67,6 +67,7 @@ struct GPUChainTrackingFinalContext;
 struct GPUTPCCFChainContext;
 struct GPUNewCalibValues;
 struct GPUTriggerOutputs;
+class GPUReconstructionTaskGraph;
 
 class GPUChainTracking : public GPUChain, GPUReconstructionHelpers::helperDelegateBase
 {
@@ -239,6 +240,7 @@ class GPUChainTracking : public GPUChain, GPUReconstructionHelpers::helperDelega
 
   int32_t PrepareProfile();
   int32_t DoProfile();
+  void ReportTaskGraph(const GPUReconstructionTaskGraph& graph);
   void PrintMemoryRelations();
   void PrintMemoryStatistics() override;
   void PrepareDebugOutput();
@@ -302,10 +304,12 @@ class GPUChainTracking : public GPUChain, GPUReconstructionHelpers::helperDelega
   int32_t RunChainFinalize();
   void SanityCheck();
   int32_t RunTPCTrackingSlices_internal();
+  int32_t RunTPCTrackingSlices_taskGraph();
   int32_t RunTPCClusterizer_prepare(bool restorePointers);
 #ifdef GPUCA_TPC_GEOMETRY_O2
   std::pair<uint32_t, uint32_t> RunTPCClusterizer_transferZS(int32_t iSlice, const CfFragment& fragment, int32_t lane);
   void RunTPCClusterizer_compactPeaks(GPUTPCClusterFinder& clusterer, GPUTPCClusterFinder& clustererShadow, int32_t stage, bool doGPU, int32_t lane);
+  void RunTPCClusterizer_taskGraph(uint32_t iSliceBase, int32_t maxLane, bool propagateMCLabels, int8_t* transferRunning, std::vector<bool>& laneHasData);
   std::pair<uint32_t, uint32_t> TPCClusterizerDecodeZSCount(uint32_t iSlice, const CfFragment& fragment);
   std::pair<uint32_t, uint32_t> TPCClusterizerDecodeZSCountUpdate(uint32_t iSlice, const CfFragment& fragment);
   void TPCClusterizerEnsureZSOffsets(uint32_t iSlice, const CfFragment& fragment);
@@ -324,6 +328,21 @@ class GPUChainTracking : public GPUChain, GPUReconstructionHelpers::helperDelega
   int32_t HelperReadEvent(int32_t iSlice, int32_t threadId, GPUReconstructionHelpers::helperParam* par);
   int32_t HelperOutput(int32_t iSlice, int32_t threadId, GPUReconstructionHelpers::helperParam* par);
 
+  // Stages of the per-sector tasks run by the CPU task graph
+  enum taskGraphStage : int32_t {
+    TaskClusterizerInput = 0,
+    TaskClusterizerPeakFinder,
+    TaskClusterizerNoiseSuppression,
+    TaskClusterizerClusters,
+    TaskSliceTracking,
+    TaskGlobalTracking,
+    TaskSliceOutput,
+    N_TASK_GRAPH_STAGES
+  };
+  bool UseTaskGraph(bool doGPU) const { return !doGPU && GetProcessingSettings().ompTaskGraph && GetProcessingSettings().ompKernels != 1 && GetProcessingSettings().debugLevel < 4; }
+  template <int32_t S = 0>
+  HighResTimer& getTaskGraphStageTimer(int32_t stage, int32_t worker);
+
   int32_t OutputStream() const { return mRec->NStreams() - 2; }
 };
 } // namespace gpu
@@ -19,6 +19,7 @@
 #include "GPUMemorySizeScalers.h"
 #include "GPUTrackingInputProvider.h"
 #include "GPUNewCalibValues.h"
+#include "GPUReconstructionTaskGraph.h"
 #include <fstream>
 
 #ifdef GPUCA_O2_LIB
@@ -456,6 +457,212 @@ std::pair<uint32_t, uint32_t> GPUChainTracking::RunTPCClusterizer_transferZS(int
   return retVal;
 }
 
+void GPUChainTracking::RunTPCClusterizer_taskGraph(uint32_t iSliceBase, int32_t maxLane, bool propagateMCLabels, int8_t* transferRunning, std::vector<bool>& laneHasData)
+{
+  // CPU only variant of the fragment loop of RunTPCClusterizer: the steps of all fragments of a lane only depend on the previous step of the same lane,
+  // so the lanes do not wait for each other between the steps. Must produce the same clusterer state as the serial loop.
+  auto* digitsMC = propagateMCLabels ? processors()->ioPtrs.tpcPackedDigits->tpcDigitsMC : nullptr;
+  std::vector<uint8_t> laneDone(maxLane, false); // Not std::vector<bool>, the lanes are written concurrently
+
+  auto runFragmentInput = [&](int32_t lane, const CfFragment& fragment) {
+    uint32_t iSlice = iSliceBase + lane;
+    GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
+    clusterer.mPmemory->counters.nPeaks = clusterer.mPmemory->counters.nClusters = 0;
+    clusterer.mPmemory->fragment = fragment;
+
+    if (mIOPtrs.tpcPackedDigits) {
+      auto* inDigits = mIOPtrs.tpcPackedDigits;
+      if (not mIOPtrs.tpcZS || propagateMCLabels) {
+        clusterer.mPdigits = const_cast<o2::tpc::Digit*>(inDigits->tpcDigits[iSlice]); // TODO: Needs fixing (invalid const cast)
+      }
+      clusterer.mPmemory->counters.nDigits = inDigits->nTPCDigits[iSlice];
+    }
+
+    if (mIOPtrs.tpcZS) {
+      if (mCFContext->nPagesSector[iSlice] && mCFContext->zsVersion != -1) {
+        clusterer.mPmemory->counters.nPositions = mCFContext->nextPos[iSlice].first;
+        clusterer.mPmemory->counters.nPagesSubslice = mCFContext->nextPos[iSlice].second;
+      } else {
+        clusterer.mPmemory->counters.nPositions = clusterer.mPmemory->counters.nPagesSubslice = 0;
+      }
+    }
+    TransferMemoryResourceLinkToGPU(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+
+    using ChargeMapType = decltype(*clusterer.mPchargeMap);
+    using PeakMapType = decltype(*clusterer.mPpeakMap);
+    runKernel<GPUMemClean16>({GetGridAutoStep(lane, RecoStep::TPCClusterFinding)}, clusterer.mPchargeMap, TPCMapMemoryLayout<ChargeMapType>::items(GetProcessingSettings().overrideClusterizerFragmentLen) * sizeof(ChargeMapType));
+    runKernel<GPUMemClean16>({GetGridAutoStep(lane, RecoStep::TPCClusterFinding)}, clusterer.mPpeakMap, TPCMapMemoryLayout<PeakMapType>::items(GetProcessingSettings().overrideClusterizerFragmentLen) * sizeof(PeakMapType));
+    if (fragment.index == 0) {
+      runKernel<GPUMemClean16>({GetGridAutoStep(lane, RecoStep::TPCClusterFinding)}, clusterer.mPpadIsNoisy, TPC_PADS_IN_SECTOR * sizeof(*clusterer.mPpadIsNoisy));
+    }
+    DoDebugAndDump(RecoStep::TPCClusterFinding, 262144, clusterer, &GPUTPCClusterFinder::DumpChargeMap, *mDebugFile, "Zeroed Charges");
+
+    if (mIOPtrs.tpcZS && (mCFContext->abandonTimeframe || !mCFContext->nPagesSector[iSlice] || mCFContext->zsVersion == -1)) {
+      clusterer.mPmemory->counters.nPositions = 0;
+      return;
+    }
+    if (!mIOPtrs.tpcZS && mIOPtrs.tpcPackedDigits->nTPCDigits[iSlice] == 0) {
+      clusterer.mPmemory->counters.nPositions = 0;
+      return;
+    }
+
+    if (propagateMCLabels && fragment.index == 0) {
+      clusterer.PrepareMC();
+      clusterer.mPinputLabels = digitsMC->v[iSlice];
+      if (clusterer.mPinputLabels == nullptr) {
+        GPUFatal("MC label container missing, sector %d", iSlice);
+      }
+      if (clusterer.mPinputLabels->getIndexedSize() != mIOPtrs.tpcPackedDigits->nTPCDigits[iSlice]) {
+        GPUFatal("MC label container has incorrect number of entries: %d expected, has %d\n", (int32_t)mIOPtrs.tpcPackedDigits->nTPCDigits[iSlice], (int32_t)clusterer.mPinputLabels->getIndexedSize());
+      }
+    }
+
+    if (GetProcessingSettings().tpcSingleSector == -1 || GetProcessingSettings().tpcSingleSector == (int32_t)iSlice) {
+      if (not mIOPtrs.tpcZS) {
+        runKernel<GPUTPCCFChargeMapFiller, GPUTPCCFChargeMapFiller::findFragmentStart>({GetGrid(1, lane), {iSlice}}, mIOPtrs.tpcZS == nullptr);
+        TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+      } else if (propagateMCLabels) {
+        runKernel<GPUTPCCFChargeMapFiller, GPUTPCCFChargeMapFiller::findFragmentStart>({GetGrid(1, lane, GPUReconstruction::krnlDeviceType::CPU), {iSlice}}, mIOPtrs.tpcZS == nullptr);
+        TransferMemoryResourceLinkToGPU(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+      }
+    }
+
+    if (mIOPtrs.tpcZS) {
+      int32_t firstHBF = (mIOPtrs.settingsTF && mIOPtrs.settingsTF->hasTfStartOrbit) ? mIOPtrs.settingsTF->tfStartOrbit : (mIOPtrs.tpcZS->slice[iSlice].count[0] && mIOPtrs.tpcZS->slice[iSlice].nZSPtr[0][0]) ? o2::raw::RDHUtils::getHeartBeatOrbit(*(const o2::header::RAWDataHeader*)mIOPtrs.tpcZS->slice[iSlice].zsPtr[0][0])
+                                                                                                                                                                                                               : 0;
+      uint32_t nBlocks = GPUTrackingInOutZS::NENDPOINTS;
+      switch (mCFContext->zsVersion) {
+        default:
+          GPUFatal("Data with invalid TPC ZS mode (%d) received", mCFContext->zsVersion);
+          break;
+        case ZSVersionRowBased10BitADC:
+        case ZSVersionRowBased12BitADC:
+          runKernel<GPUTPCCFDecodeZS>({GetGridBlk(nBlocks, lane), {iSlice}}, firstHBF);
+          break;
+        case ZSVersionLinkBasedWithMeta:
+          runKernel<GPUTPCCFDecodeZSLink>({GetGridBlk(nBlocks, lane), {iSlice}}, firstHBF);
+          break;
+        case ZSVersionDenseLinkBased:
+          runKernel<GPUTPCCFDecodeZSDenseLink>({GetGridBlk(nBlocks, lane), {iSlice}}, firstHBF);
+          break;
+      }
+      TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+    }
+  };
+
+  auto runFragmentPeakFinder = [&](int32_t lane, const CfFragment& fragment) {
+    uint32_t iSlice = iSliceBase + lane;
+    if (mIOPtrs.tpcZS) {
+      CfFragment f = fragment.next();
+      int32_t nextSlice = iSlice;
+      if (f.isEnd()) {
+        nextSlice += GetProcessingSettings().nTPCClustererLanes;
+        f = mCFContext->fragmentFirst;
+      }
+      if (nextSlice < NSLICES && mCFContext->nPagesSector[nextSlice] && mCFContext->zsVersion != -1 && !mCFContext->abandonTimeframe) {
+        mCFContext->nextPos[nextSlice] = RunTPCClusterizer_transferZS(nextSlice, f, GetProcessingSettings().nTPCClustererLanes + lane);
+      }
+    }
+    GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
+    if (clusterer.mPmemory->counters.nPositions == 0) {
+      return;
+    }
+    if (!mIOPtrs.tpcZS) {
+      runKernel<GPUTPCCFChargeMapFiller, GPUTPCCFChargeMapFiller::fillFromDigits>({GetGrid(clusterer.mPmemory->counters.nPositions, lane), {iSlice}});
+    }
+    if (DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 1, clusterer, &GPUTPCClusterFinder::DumpDigits, *mDebugFile)) {
+      clusterer.DumpChargeMap(*mDebugFile, "Charges");
+    }
+
+    if (propagateMCLabels) {
+      runKernel<GPUTPCCFChargeMapFiller, GPUTPCCFChargeMapFiller::fillIndexMap>({GetGrid(clusterer.mPmemory->counters.nDigitsInFragment, lane, GPUReconstruction::krnlDeviceType::CPU), {iSlice}});
+    }
+
+    bool checkForNoisyPads = (rec()->GetParam().rec.tpc.maxTimeBinAboveThresholdIn1000Bin > 0) || (rec()->GetParam().rec.tpc.maxConsecTimeBinAboveThreshold > 0);
+    checkForNoisyPads &= (rec()->GetParam().rec.tpc.noisyPadsQuickCheck ? fragment.index == 0 : true);
+    checkForNoisyPads &= !GetProcessingSettings().disableTPCNoisyPadFilter;
+
+    if (checkForNoisyPads) {
+      int32_t nBlocks = TPC_PADS_IN_SECTOR / GPUTPCCFCheckPadBaseline::PadsPerCacheline;
+
+      runKernel<GPUTPCCFCheckPadBaseline>({GetGridBlk(nBlocks, lane), {iSlice}});
+    }
+
+    runKernel<GPUTPCCFPeakFinder>({GetGrid(clusterer.mPmemory->counters.nPositions, lane), {iSlice}});
+    if (DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 2, clusterer, &GPUTPCClusterFinder::DumpPeaks, *mDebugFile)) {
+      clusterer.DumpPeakMap(*mDebugFile, "Peaks");
+    }
+
+    RunTPCClusterizer_compactPeaks(clusterer, clusterer, 0, false, lane);
+    TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+    DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 2, clusterer, &GPUTPCClusterFinder::DumpPeaksCompacted, *mDebugFile);
+  };
+
+  auto runFragmentNoiseSuppression = [&](int32_t lane, const CfFragment& fragment) {
+    uint32_t iSlice = iSliceBase + lane;
+    GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
+    if (clusterer.mPmemory->counters.nPeaks == 0) {
+      return;
+    }
+    runKernel<GPUTPCCFNoiseSuppression, GPUTPCCFNoiseSuppression::noiseSuppression>({GetGrid(clusterer.mPmemory->counters.nPeaks, lane), {iSlice}});
+    runKernel<GPUTPCCFNoiseSuppression, GPUTPCCFNoiseSuppression::updatePeaks>({GetGrid(clusterer.mPmemory->counters.nPeaks, lane), {iSlice}});
+    if (DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 3, clusterer, &GPUTPCClusterFinder::DumpSuppressedPeaks, *mDebugFile)) {
+      clusterer.DumpPeakMap(*mDebugFile, "Suppressed Peaks");
+    }
+
+    RunTPCClusterizer_compactPeaks(clusterer, clusterer, 1, false, lane);
+    TransferMemoryResourceLinkToHost(RecoStep::TPCClusterFinding, clusterer.mMemoryId, lane);
+    DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 3, clusterer, &GPUTPCClusterFinder::DumpSuppressedPeaksCompacted, *mDebugFile);
+  };
+
+  auto runFragmentClusters = [&](int32_t lane, const CfFragment& fragment) {
+    uint32_t iSlice = iSliceBase + lane;
+    GPUTPCClusterFinder& clusterer = processors()->tpcClusterer[iSlice];
+    if (fragment.index == 0) {
+      deviceEvent* waitEvent = nullptr;
+      if (transferRunning[lane] == 1) {
+        waitEvent = &mEvents->stream[lane];
+        transferRunning[lane] = 2;
+      }
+      runKernel<GPUMemClean16>({GetGridAutoStep(lane, RecoStep::TPCClusterFinding), krnlRunRangeNone, {nullptr, waitEvent}}, clusterer.mPclusterInRow, GPUCA_ROW_COUNT * sizeof(*clusterer.mPclusterInRow));
+    }
+
+    if (clusterer.mPmemory->counters.nClusters == 0) {
+      return;
+    }
+
+    runKernel<GPUTPCCFDeconvolution>({GetGrid(clusterer.mPmemory->counters.nPositions, lane), {iSlice}});
+    DoDebugAndDump(RecoStep::TPCClusterFinding, 262144 << 4, clusterer, &GPUTPCClusterFinder::DumpChargeMap, *mDebugFile, "Split Charges");
+
+    runKernel<GPUTPCCFClusterizer>({GetGrid(clusterer.mPmemory->counters.nClusters, lane), {iSlice}}, 0);
+    if (GetProcessingSettings().debugLevel >= 3) {
+      GPUInfo("Sector %02d Fragment %02d Lane %d: Found clusters: digits %u peaks %u clusters %u", iSlice, fragment.index, lane, (int32_t)clusterer.mPmemory->counters.nPositions, (int32_t)clusterer.mPmemory->counters.nPeaks, (int32_t)clusterer.mPmemory->counters.nClusters);
+    }
+
+    TransferMemoryResourcesToHost(RecoStep::TPCClusterFinding, &clusterer, lane);
+    laneDone[lane] = true;
+    // Include clusters in default debug mask, exclude other debug output by default
+    DoDebugAndDump(RecoStep::TPCClusterFinding, 131072, clusterer, &GPUTPCClusterFinder::DumpClusters, *mDebugFile);
+  };
+
+  GPUReconstructionTaskGraph graph;
+  std::vector<int32_t> lastTask(maxLane, -1);
+  for (CfFragment fragment = mCFContext->fragmentFirst; !fragment.isEnd(); fragment = fragment.next()) {
+    for (int32_t lane = 0; lane < maxLane; lane++) {
+      lastTask[lane] = graph.addTask(TaskClusterizerInput, iSliceBase + lane, [&runFragmentInput, lane, fragment]() { runFragmentInput(lane, fragment); return 0; }, {lastTask[lane]});
+      lastTask[lane] = graph.addTask(TaskClusterizerPeakFinder, iSliceBase + lane, [&runFragmentPeakFinder, lane, fragment]() { runFragmentPeakFinder(lane, fragment); return 0; }, {lastTask[lane]});
+      lastTask[lane] = graph.addTask(TaskClusterizerNoiseSuppression, iSliceBase + lane, [&runFragmentNoiseSuppression, lane, fragment]() { runFragmentNoiseSuppression(lane, fragment); return 0; }, {lastTask[lane]});
+      lastTask[lane] = graph.addTask(TaskClusterizerClusters, iSliceBase + lane, [&runFragmentClusters, lane, fragment]() { runFragmentClusters(lane, fragment); return 0; }, {lastTask[lane]});
+    }
+  }
+  graph.run(mRec->SetAndGetNestedLoopOmpFactor(true, GetProcessingSettings().nTPCClustererLanes));
+  ReportTaskGraph(graph);
+  mRec->SetNestedLoopOmpFactor(1);
+  for (int32_t lane = 0; lane < maxLane; lane++) {
+    laneHasData[lane] = laneDone[lane];
+  }
+}
+
 int32_t GPUChainTracking::RunTPCClusterizer_prepare(bool restorePointers)
 {
   bool doGPU = mRec->GetRecoStepsGPU() & GPUDataTypes::RecoStep::TPCClusterFinding;
@@ -670,12 +877,16 @@ int32_t GPUChainTracking::RunTPCClusterizer(bool synchronizeOutput)
     }
   };
   bool synchronizeCalibUpdate = false;
+  const bool useTaskGraph = UseTaskGraph(doGPU);
 
   for (uint32_t iSliceBase = 0; iSliceBase < NSLICES; iSliceBase += GetProcessingSettings().nTPCClustererLanes) {
     std::vector<bool> laneHasData(GetProcessingSettings().nTPCClustererLanes, false);
     static_assert(NSLICES <= GPUCA_MAX_STREAMS, "Stream events must be able to hold all slices");
     const int32_t maxLane = std::min<int32_t>(GetProcessingSettings().nTPCClustererLanes, NSLICES - iSliceBase);
-    for (CfFragment fragment = mCFContext->fragmentFirst; !fragment.isEnd(); fragment = fragment.next()) {
+    if (useTaskGraph) {
+      RunTPCClusterizer_taskGraph(iSliceBase, maxLane, propagateMCLabels, transferRunning, laneHasData);
+    }
+    for (CfFragment fragment = mCFContext->fragmentFirst; !useTaskGraph && !fragment.isEnd(); fragment = fragment.next()) {
       if (GetProcessingSettings().debugLevel >= 3) {
         GPUInfo("Processing time bins [%d, %d) for sectors %d to %d", fragment.start, fragment.last(), iSliceBase, iSliceBase + GetProcessingSettings().nTPCClustererLanes - 1);
       }
@@ -15,6 +15,9 @@
 #include "GPUChainTracking.h"
 #include "GPUTrackingInputProvider.h"
 #include "GPUMemorySizeScalers.h"
+#include "GPUReconstructionTaskGraph.h"
+#include <algorithm>
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -114,6 +117,59 @@ int32_t GPUChainTracking::DoProfile()
   return 0;
 }
 
+namespace
+{
+template <int32_t S>
+struct GPUChainTrackingTaskStage {
+};
+constexpr const char* TASK_GRAPH_STAGE_NAMES[] = {"TaskGraph_TPCClusterizerInput", "TaskGraph_TPCClusterizerPeakFinder", "TaskGraph_TPCClusterizerNoiseSuppression", "TaskGraph_TPCClusterizerClusters", "TaskGraph_TPCSliceTracking", "TaskGraph_TPCGlobalTracking", "TaskGraph_TPCSliceOutput"};
+} // namespace
+
+template <int32_t S>
+HighResTimer& GPUChainTracking::getTaskGraphStageTimer(int32_t stage, int32_t worker)
+{
+  static_assert(sizeof(TASK_GRAPH_STAGE_NAMES) / sizeof(TASK_GRAPH_STAGE_NAMES[0]) == N_TASK_GRAPH_STAGES);
+  if constexpr (S + 1 < N_TASK_GRAPH_STAGES) {
+    if (stage != S) {
+      return getTaskGraphStageTimer<S + 1>(stage, worker);
+    }
+  }
+  return getTimer<GPUChainTrackingTaskStage<S>>(TASK_GRAPH_STAGE_NAMES[S], worker);
+}
+
+void GPUChainTracking::ReportTaskGraph(const GPUReconstructionTaskGraph& graph)
+{
+  if (GetProcessingSettings().debugLevel < 1) {
+    return;
+  }
+  std::array<double, N_TASK_GRAPH_STAGES> first, last, busy;
+  std::array<uint32_t, N_TASK_GRAPH_STAGES> count;
+  first.fill(1e30);
+  last.fill(0.);
+  busy.fill(0.);
+  count.fill(0);
+  for (const auto& task : graph.timeline()) {
+    if (task.worker < 0) {
+      continue;
+    }
+    getTaskGraphStageTimer(task.stage, task.worker).AddTime(task.end - task.start);
+    first[task.stage] = std::min(first[task.stage], task.start);
+    last[task.stage] = std::max(last[task.stage], task.end);
+    busy[task.stage] += task.end - task.start;
+    count[task.stage]++;
+    if (GetProcessingSettings().debugLevel >= 3) {
+      GPUInfo("Task graph: %-40s sector %2d worker %2d: %9.3f - %9.3f ms", TASK_GRAPH_STAGE_NAMES[task.stage], task.item, task.worker, task.start * 1000., task.end * 1000.);
+    }
+  }
+  if (GetProcessingSettings().debugLevel >= 2) {
+    for (int32_t i = 0; i < N_TASK_GRAPH_STAGES; i++) {
+      if (count[i]) {
+        GPUInfo("Task graph: %-40s %3u tasks running from %9.3f to %9.3f ms, busy %9.3f ms", TASK_GRAPH_STAGE_NAMES[i], count[i], first[i] * 1000., last[i] * 1000., busy[i] * 1000.);
+      }
+    }
+  }
+}
+
 namespace
 {
 struct GPUChainTrackingMemUsage {
@@ -19,6 +19,7 @@
 #include "GPUTPCClusterData.h"
 #include "GPUTrackingInputProvider.h"
 #include "GPUTPCClusterOccupancyMap.h"
+#include "GPUReconstructionTaskGraph.h"
 #include "utils/strtag.h"
 #include <fstream>
 
@@ -174,9 +175,13 @@ int32_t GPUChainTracking::RunTPCTrackingSlices_internal()
 
   int32_t streamMap[NSLICES];
 
+  const bool useTaskGraph = UseTaskGraph(doGPU);
+  if (useTaskGraph && RunTPCTrackingSlices_taskGraph()) {
+    return (3);
+  }
   bool error = false;
   GPUCA_OPENMP(parallel for if(!doGPU && GetProcessingSettings().ompKernels != 1) num_threads(mRec->SetAndGetNestedLoopOmpFactor(!doGPU, NSLICES)))
-  for (uint32_t iSlice = 0; iSlice < NSLICES; iSlice++) {
+  for (uint32_t iSlice = 0; iSlice < (useTaskGraph ? 0 : NSLICES); iSlice++) {
     GPUTPCTracker& trk = processors()->tpcTrackers[iSlice];
     GPUTPCTracker& trkShadow = doGPU ? processorsShadow()->tpcTrackers[iSlice] : trk;
     int32_t useStream = (iSlice % mRec->NStreams());
@@ -298,7 +303,9 @@ int32_t GPUChainTracking::RunTPCTrackingSlices_internal()
     return (3);
   }
 
-  if (doGPU || GetProcessingSettings().debugLevel >= 1) {
+  if (useTaskGraph) {
+    // Global tracking and output already done by the task graph
+  } else if (doGPU || GetProcessingSettings().debugLevel >= 1) {
     if (doGPU) {
       ReleaseEvent(mEvents->init);
     }
@@ -506,6 +513,101 @@ int32_t GPUChainTracking::RunTPCTrackingSlices_internal()
   return 0;
 }
 
+int32_t GPUChainTracking::RunTPCTrackingSlices_taskGraph()
+{
+  // CPU only variant of the sector loop of RunTPCTrackingSlices_internal: the global tracking and the output of a sector run as soon as the sector and its
+  // neighbours are tracked, instead of waiting for all sectors after each step. Must produce the same tracks as the serial loop.
+  auto runSlice = [this](uint32_t iSlice) -> int32_t {
+    GPUTPCTracker& trk = processors()->tpcTrackers[iSlice];
+    int32_t useStream = (iSlice % mRec->NStreams());
+
+    if (GetProcessingSettings().debugLevel >= 3) {
+      GPUInfo("Creating Slice Data (Slice %d)", iSlice);
+    }
+    if (ReadEvent(iSlice, 0)) {
+      GPUError("Error reading event");
+      return 1;
+    }
+    if (GetProcessingSettings().deterministicGPUReconstruction) {
+      runKernel<GPUTPCSectorDebugSortKernels, GPUTPCSectorDebugSortKernels::hitData>({GetGridBlk(GPUCA_ROW_COUNT, useStream), {iSlice}});
+    }
+    if (trk.CheckEmptySlice() && GetProcessingSettings().debugLevel == 0) {
+      return 0;
+    }
+
+    if (GetProcessingSettings().keepDisplayMemory) {
+      memset((void*)trk.Data().HitWeights(), 0, trk.Data().NumberOfHitsPlusAlign() * sizeof(*trk.Data().HitWeights()));
+    } else {
+      runKernel<GPUMemClean16>(GetGridAutoStep(useStream, RecoStep::TPCSliceTracking), trk.Data().HitWeights(), trk.Data().NumberOfHitsPlusAlign() * sizeof(*trk.Data().HitWeights()));
+    }
+    TransferMemoryResourcesToGPU(RecoStep::TPCSliceTracking, &trk, useStream);
+
+    runKernel<GPUTPCNeighboursFinder>({GetGridBlk(GPUCA_ROW_COUNT, useStream), {iSlice}});
+    if (GetProcessingSettings().keepDisplayMemory) {
+      TransferMemoryResourcesToHost(RecoStep::TPCSliceTracking, &trk, -1, true);
+      memcpy(trk.LinkTmpMemory(), mRec->Res(trk.MemoryResLinks()).Ptr(), mRec->Res(trk.MemoryResLinks()).Size());
+      if (GetProcessingSettings().debugMask & 2) {
+        trk.DumpLinks(*mDebugFile, 0);
+      }
+    }
+
+    runKernel<GPUTPCNeighboursCleaner>({GetGridBlk(GPUCA_ROW_COUNT - 2, useStream), {iSlice}});
+    DoDebugAndDump(RecoStep::TPCSliceTracking, 4, trk, &GPUTPCTracker::DumpLinks, *mDebugFile, 1);
+
+    runKernel<GPUTPCStartHitsFinder>({GetGridBlk(GPUCA_ROW_COUNT - 6, useStream), {iSlice}});
+    if (GetProcessingSettings().deterministicGPUReconstruction) {
+      runKernel<GPUTPCSectorDebugSortKernels, GPUTPCSectorDebugSortKernels::startHits>({GetGrid(1, 1, useStream), {iSlice}});
+    }
+    DoDebugAndDump(RecoStep::TPCSliceTracking, 32, trk, &GPUTPCTracker::DumpStartHits, *mDebugFile);
+
+    if (GetProcessingSettings().memoryAllocationStrategy == GPUMemoryResource::ALLOCATION_INDIVIDUAL) {
+      trk.UpdateMaxData();
+      AllocateRegisteredMemory(trk.MemoryResTracklets());
+      AllocateRegisteredMemory(trk.MemoryResOutput());
+    }
+
+    runKernel<GPUTPCTrackletConstructor>({GetGridAuto(useStream), {iSlice}});
+    DoDebugAndDump(RecoStep::TPCSliceTracking, 128, trk, &GPUTPCTracker::DumpTrackletHits, *mDebugFile);
+    if (GetProcessingSettings().debugMask & 256 && GetProcessingSettings().deterministicGPUReconstruction < 2) {
+      trk.DumpHitWeights(*mDebugFile);
+    }
+
+    runKernel<GPUTPCTrackletSelector>({GetGridAuto(useStream), {iSlice}});
+    runKernel<GPUTPCGlobalTrackingCopyNumbers>({{1, -ThreadCount(), useStream}, {iSlice}}, 1);
+    if (GetProcessingSettings().deterministicGPUReconstruction) {
+      runKernel<GPUTPCSectorDebugSortKernels, GPUTPCSectorDebugSortKernels::sliceTracks>({GetGrid(1, 1, useStream), {iSlice}});
+    }
+    TransferMemoryResourceLinkToHost(RecoStep::TPCSliceTracking, trk.MemoryResCommon(), useStream);
+    if (GetProcessingSettings().debugLevel >= 3) {
+      GPUInfo("Slice %u, Number of tracks: %d", iSlice, *trk.NTracks());
+    }
+    DoDebugAndDump(RecoStep::TPCSliceTracking, 512, trk, &GPUTPCTracker::DumpTrackHits, *mDebugFile);
+    return 0;
+  };
+
+  GPUReconstructionTaskGraph graph;
+  std::array<int32_t, NSLICES> trackingTask;
+  for (uint32_t iSlice = 0; iSlice < NSLICES; iSlice++) {
+    trackingTask[iSlice] = graph.addTask(TaskSliceTracking, iSlice, [&runSlice, iSlice]() { return runSlice(iSlice); });
+  }
+  for (uint32_t iSlice = 0; iSlice < NSLICES; iSlice++) {
+    int32_t lastTask = trackingTask[iSlice];
+    if (param().rec.tpc.globalTracking) {
+      uint32_t sliceLeft, sliceRight;
+      GPUTPCGlobalTracking::GlobalTrackingSliceLeftRight(iSlice, sliceLeft, sliceRight);
+      lastTask = graph.addTask(TaskGlobalTracking, iSlice, [this, iSlice]() { return GlobalTracking(iSlice, 0); }, {trackingTask[iSlice], trackingTask[sliceLeft], trackingTask[sliceRight]});
+    }
+    if (GetRecoStepsOutputs() & GPUDataTypes::InOutType::TPCSectorTracks) {
+      graph.addTask(TaskSliceOutput, iSlice, [this, iSlice]() { WriteOutput(iSlice, 0); return 0; }, {lastTask});
+    }
+  }
+  mSliceSelectorReady = NSLICES;
+  int32_t retVal = graph.run(mRec->SetAndGetNestedLoopOmpFactor(true, NSLICES));
+  mRec->SetNestedLoopOmpFactor(1);
+  ReportTaskGraph(graph);
+  return retVal;
+}
+
 int32_t GPUChainTracking::ReadEvent(uint32_t iSlice, int32_t threadId)
 {
   if (GetProcessingSettings().debugLevel >= 5) {
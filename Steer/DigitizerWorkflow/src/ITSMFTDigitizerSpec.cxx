@@ -22,6 +22,7 @@
 #include "DataFormatsITSMFT/NoiseMap.h"
 #include "DataFormatsITSMFT/TimeDeadMap.h"
 #include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/MCTruthContainerBuilder.h"
 #include "DetectorsBase/BaseDPLDigitizer.h"
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "DetectorsCommonDataFormats/SimTraits.h"
@@ -81,7 +82,7 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
 
     mDigitizer.setDigits(&mDigits);
     mDigitizer.setROFRecords(&mROFRecords);
-    mDigitizer.setMCLabels(&mLabels);
+    mDigitizer.setMCLabelsSlot(&mLabelsAccum.getSlot(0)); // the labels of the accumulated digits are written directly to the builder
 
     // digits are directly put into DPL owned resource
     auto& digitsAccum = pc.outputs().make<std::vector<itsmft::Digit>>(Output{mOrigin, "DIGITS", 0});
@@ -117,12 +118,11 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
       }
 
       std::copy(mROFRecords.begin(), mROFRecords.end(), std::back_inserter(mROFRecordsAccum));
-      if (mWithMCTruth) {
-        mLabelsAccum.mergeAtBack(mLabels);
+      if (!mWithMCTruth) {
+        mLabelsAccum.clear(); // the digitizer produces the labels anyway
       }
       LOG(info) << "Added " << mDigits.size() << " digits ";
       // clean containers from already accumulated stuff
-      mLabels.clear();
       mDigits.clear();
       mROFRecords.clear();
     }; // and accumulate lambda
@@ -165,10 +165,9 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
     if (mWithMCTruth) {
       pc.outputs().snapshot(Output{mOrigin, "DIGITSMC2ROF", 0}, mMC2ROFRecordsAccum);
       auto& sharedlabels = pc.outputs().make<o2::dataformats::ConstMCTruthContainer<o2::MCCompLabel>>(Output{mOrigin, "DIGITSMCTR", 0});
-      mLabelsAccum.flatten_to(sharedlabels);
-      // free space of existing label containers
-      mLabels.clear_andfreememory();
-      mLabelsAccum.clear_andfreememory();
+      mLabelsAccum.flatten_to(sharedlabels); // single copy from the chunked accumulator to the output message
+      // free space of the label accumulator
+      mLabelsAccum.clear();
     }
     LOG(info) << mID.getName() << ": Sending ROMode= " << mROMode << " to GRPUpdater";
     pc.outputs().snapshot(Output{mOrigin, "ROMode", 0}, mROMode);
@@ -292,8 +291,7 @@ class ITSMFTDPLDigitizerTask : BaseDPLDigitizer
   std::vector<o2::itsmft::ROFRecord> mROFRecordsAccum;
   std::vector<o2::itsmft::Hit> mHits;
   std::vector<o2::itsmft::Hit>* mHitsP = &mHits;
-  o2::dataformats::MCTruthContainer<o2::MCCompLabel> mLabels;
-  o2::dataformats::MCTruthContainer<o2::MCCompLabel> mLabelsAccum;
+  o2::dataformats::MCLabelContainerBuilder mLabelsAccum; // chunked accumulator: no reallocation and copy of the labels on every merge
   std::vector<o2::itsmft::MC2ROFRecord> mMC2ROFRecordsAccum;
   std::vector<TChain*> mSimChains;
   o2::itsmft::NoiseMap* mDeadMap = nullptr;
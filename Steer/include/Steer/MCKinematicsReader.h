@@ -18,6 +18,12 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class TChain;
@@ -93,6 +99,23 @@ class MCKinematicsReader
   /// variant returning all tracks for an event id (source = 0) at once
   std::vector<MCTrack> const& getTracks(int event) const;
 
+  /// bulk variant: fills the tracks of the events [firstEvent, lastEvent] of the source contiguously into the storage
+  /// and returns the span of tracks for each event. The events not already in memory are read without being cached.
+  std::vector<gsl::span<const MCTrack>> getTracksForEvents(int source, int firstEvent, int lastEvent, std::vector<MCTrack>& storage) const;
+
+  /// limit the number of events (of all sources) whose tracks are kept in memory, 0 = no limit (default).
+  /// When the limit is reached, the tracks of the least recently accessed event are released, invalidating
+  /// the references and pointers obtained for this event from getTracks or getTrack.
+  void setMaxCachedEvents(size_t n);
+  size_t getMaxCachedEvents() const { return mMaxCachedEvents; }
+  size_t getNCachedEvents() const { return mCachedEvents.size(); }
+
+  /// number of events following the one being loaded to be read in advance on a background thread, 0 = no prefetching (default).
+  /// Since the background thread reads the input chains while the calling thread may do other ROOT I/O, enabling the
+  /// prefetching calls ROOT::EnableThreadSafety(), which is process wide and stays in effect after the prefetching is disabled.
+  void setPrefetchDepth(int n);
+  int getPrefetchDepth() const { return mPrefetchDepth; }
+
   /// get all primaries for a certain event
 
   /// get all secondaries of the given label
@@ -123,6 +146,13 @@ class MCKinematicsReader
  private:
   void initTracksForSource(int source) const;
   void loadTracksForSourceAndEvent(int source, int eventID) const;
+  std::vector<MCTrack>* readTracks(int source, int event) const;
+  std::vector<MCTrack>* takePrefetched(int source, int event) const;
+  void schedulePrefetch(int source, int event) const;
+  void releaseTracks(int source, int event) const;
+  void evictTracks(size_t maxEvents) const;
+  void prefetcher() const;
+  void stopPrefetcher() const;
   void loadHeadersForSource(int source) const;
   void loadTrackRefsForSource(int source) const;
   void initIndexedTrackRefs(std::vector<o2::TrackReference>& refs, o2::dataformats::MCTruthContainer<o2::TrackReference>& indexedrefs) const;
@@ -138,6 +168,23 @@ class MCKinematicsReader
   mutable std::vector<std::vector<o2::dataformats::MCEventHeader>> mHeaders;                                 // the in-memory header container
   mutable std::vector<std::vector<o2::dataformats::MCTruthContainer<o2::TrackReference>>> mIndexedTrackRefs; // the in-memory track ref container
 
+  // LRU bookkeeping of the loaded tracks
+  mutable std::vector<std::vector<size_t>> mLastAccess;   // access stamp for each source and event
+  mutable std::vector<std::pair<int, int>> mCachedEvents; // (source, event) of the loaded tracks
+  mutable size_t mAccessCounter = 0;
+  size_t mMaxCachedEvents = 0;
+
+  // background prefetching, the chains are only accessed under mChainMutex
+  int mPrefetchDepth = 0;
+  mutable std::mutex mChainMutex;                                           //!
+  mutable std::mutex mPrefetchMutex;                                        //!
+  mutable std::condition_variable mPrefetchCond;                            //!
+  mutable std::deque<std::pair<int, int>> mPrefetchQueue;                   //! events to be read by the prefetcher
+  mutable std::map<std::pair<int, int>, std::vector<MCTrack>*> mPrefetched; //! events read by the prefetcher
+  mutable std::pair<int, int> mPrefetchInFlight{-1, -1};                    //! event being read by the prefetcher
+  mutable bool mStopPrefetch = false;                                       //!
+  mutable std::thread mPrefetchThread;                                      //!
+
   bool mInitialized = false; // whether initialized
 };
 
@@ -167,6 +214,7 @@ inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int source, int
   if (mTracks[source][event] == nullptr) {
     loadTracksForSourceAndEvent(source, event);
   }
+  mLastAccess[source][event] = ++mAccessCounter;
   return *mTracks[source][event];
 }
 
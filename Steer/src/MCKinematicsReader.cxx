@@ -14,6 +14,9 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include <TChain.h>
+#include <TROOT.h>
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <fairlogger/Logger.h>
 
@@ -21,6 +24,12 @@ using namespace o2::steer;
 
 MCKinematicsReader::~MCKinematicsReader()
 {
+  stopPrefetcher();
+  for (auto& tracks : mTracks) {
+    for (auto t : tracks) {
+      delete t;
+    }
+  }
   for (auto chain : mInputChains) {
     delete chain;
   }
@@ -54,41 +63,221 @@ void MCKinematicsReader::initTracksForSource(int source) const
 {
   auto chain = mInputChains[source];
   if (chain) {
+    std::lock_guard<std::mutex> lock(mChainMutex);
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
     mTracks[source].resize(br->GetEntries(), nullptr);
+    mLastAccess[source].resize(br->GetEntries(), 0);
   }
 }
 
-void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
+std::vector<o2::MCTrack>* MCKinematicsReader::readTracks(int source, int event) const
 {
+  // read the tracks of the event, the returned vector is owned by the caller
+  std::vector<MCTrack>* loadtracks = nullptr;
   auto chain = mInputChains[source];
   if (chain) {
+    std::lock_guard<std::mutex> lock(mChainMutex);
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
     if (br) {
-      std::vector<MCTrack>* loadtracks = nullptr;
       br->SetAddress(&loadtracks);
       br->GetEntry(event);
-      mTracks[source][event] = new std::vector<o2::MCTrack>;
-      *mTracks[source][event] = *loadtracks;
-      delete loadtracks;
+      br->SetAddress(nullptr);
     }
   }
+  return loadtracks ? loadtracks : new std::vector<o2::MCTrack>;
 }
 
-void MCKinematicsReader::releaseTracksForSourceAndEvent(int source, int eventID)
+void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
+{
+  std::vector<MCTrack>* tracks = nullptr;
+  if (mPrefetchDepth > 0) {
+    tracks = takePrefetched(source, event);
+  }
+  if (!tracks) {
+    tracks = readTracks(source, event);
+  }
+  if (mMaxCachedEvents > 0) {
+    evictTracks(mMaxCachedEvents - 1);
+  }
+  mTracks[source][event] = tracks;
+  mCachedEvents.emplace_back(source, event);
+  if (mPrefetchDepth > 0) {
+    schedulePrefetch(source, event);
+  }
+}
+
+void MCKinematicsReader::releaseTracks(int source, int eventID) const
 {
   if (mTracks.at(source).at(eventID) != nullptr) {
     delete mTracks[source][eventID];
     mTracks[source][eventID] = nullptr;
+    auto it = std::find(mCachedEvents.begin(), mCachedEvents.end(), std::make_pair(source, eventID));
+    if (it != mCachedEvents.end()) {
+      *it = mCachedEvents.back();
+      mCachedEvents.pop_back();
+    }
+  }
+}
+
+void MCKinematicsReader::releaseTracksForSourceAndEvent(int source, int eventID)
+{
+  releaseTracks(source, eventID);
+}
+
+void MCKinematicsReader::evictTracks(size_t maxEvents) const
+{
+  // release the least recently accessed events until no more than maxEvents are kept
+  while (mCachedEvents.size() > maxEvents) {
+    auto lru = std::min_element(mCachedEvents.begin(), mCachedEvents.end(), [this](const auto& a, const auto& b) {
+      return mLastAccess[a.first][a.second] < mLastAccess[b.first][b.second];
+    });
+    releaseTracks(lru->first, lru->second);
+  }
+}
+
+void MCKinematicsReader::setMaxCachedEvents(size_t n)
+{
+  mMaxCachedEvents = n;
+  if (n > 0) {
+    evictTracks(n);
+  }
+}
+
+std::vector<gsl::span<const o2::MCTrack>> MCKinematicsReader::getTracksForEvents(int source, int firstEvent, int lastEvent, std::vector<MCTrack>& storage) const
+{
+  if (mTracks[source].size() == 0) {
+    initTracksForSource(source);
+  }
+  lastEvent = std::min(lastEvent, int(mTracks[source].size()) - 1);
+  std::vector<size_t> offsets;
+  storage.clear();
+  for (int event = firstEvent; event <= lastEvent; event++) {
+    offsets.push_back(storage.size());
+    if (const auto* cached = mTracks[source][event]) {
+      storage.insert(storage.end(), cached->begin(), cached->end());
+      continue;
+    }
+    auto* tracks = mPrefetchDepth > 0 ? takePrefetched(source, event) : nullptr;
+    if (!tracks) {
+      tracks = readTracks(source, event);
+    }
+    storage.insert(storage.end(), std::make_move_iterator(tracks->begin()), std::make_move_iterator(tracks->end()));
+    delete tracks;
+  }
+  offsets.push_back(storage.size());
+  std::vector<gsl::span<const MCTrack>> spans;
+  spans.reserve(offsets.size() - 1);
+  for (size_t i = 0; i + 1 < offsets.size(); i++) {
+    spans.emplace_back(storage.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+  return spans;
+}
+
+void MCKinematicsReader::setPrefetchDepth(int n)
+{
+  mPrefetchDepth = n > 0 ? n : 0;
+  if (mPrefetchDepth == 0) {
+    stopPrefetcher();
+  } else {
+    ROOT::EnableThreadSafety(); // the prefetcher reads in parallel to the ROOT I/O of the calling thread
+  }
+}
+
+std::vector<o2::MCTrack>* MCKinematicsReader::takePrefetched(int source, int event) const
+{
+  // get the tracks of the event if they were read by the prefetcher, waiting if they are being read
+  const auto key = std::make_pair(source, event);
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  auto qit = std::find(mPrefetchQueue.begin(), mPrefetchQueue.end(), key);
+  if (qit != mPrefetchQueue.end()) { // not started yet, will be read by the caller
+    mPrefetchQueue.erase(qit);
+    return nullptr;
+  }
+  mPrefetchCond.wait(lock, [this, &key] { return mPrefetchInFlight != key; });
+  auto pit = mPrefetched.find(key);
+  if (pit == mPrefetched.end()) {
+    return nullptr;
+  }
+  auto tracks = pit->second;
+  mPrefetched.erase(pit);
+  return tracks;
+}
+
+void MCKinematicsReader::schedulePrefetch(int source, int event) const
+{
+  // request the events following the one being loaded, dropping the requests and prefetched events outside of this window
+  auto outside = [source, event, this](const std::pair<int, int>& key) {
+    return key.first != source || key.second <= event || key.second > event + mPrefetchDepth;
+  };
+  std::lock_guard<std::mutex> lock(mPrefetchMutex);
+  mPrefetchQueue.erase(std::remove_if(mPrefetchQueue.begin(), mPrefetchQueue.end(), outside), mPrefetchQueue.end());
+  for (auto it = mPrefetched.begin(); it != mPrefetched.end();) {
+    if (outside(it->first)) {
+      delete it->second;
+      it = mPrefetched.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  const int lastEvent = std::min(event + mPrefetchDepth, int(mTracks[source].size()) - 1);
+  for (int ev = event + 1; ev <= lastEvent; ev++) {
+    const auto key = std::make_pair(source, ev);
+    if (mTracks[source][ev] || mPrefetched.count(key) || mPrefetchInFlight == key ||
+        std::find(mPrefetchQueue.begin(), mPrefetchQueue.end(), key) != mPrefetchQueue.end()) {
+      continue;
+    }
+    mPrefetchQueue.push_back(key);
+  }
+  if (!mPrefetchThread.joinable()) {
+    mStopPrefetch = false;
+    mPrefetchThread = std::thread(&MCKinematicsReader::prefetcher, this);
+  }
+  mPrefetchCond.notify_all();
+}
+
+void MCKinematicsReader::prefetcher() const
+{
+  std::unique_lock<std::mutex> lock(mPrefetchMutex);
+  while (true) {
+    mPrefetchCond.wait(lock, [this] { return mStopPrefetch || !mPrefetchQueue.empty(); });
+    if (mStopPrefetch) {
+      break;
+    }
+    mPrefetchInFlight = mPrefetchQueue.front();
+    mPrefetchQueue.pop_front();
+    lock.unlock();
+    auto tracks = readTracks(mPrefetchInFlight.first, mPrefetchInFlight.second);
+    lock.lock();
+    mPrefetched[mPrefetchInFlight] = tracks;
+    mPrefetchInFlight = {-1, -1};
+    mPrefetchCond.notify_all();
+  }
+}
+
+void MCKinematicsReader::stopPrefetcher() const
+{
+  if (mPrefetchThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mPrefetchMutex);
+      mStopPrefetch = true;
+      mPrefetchQueue.clear();
+    }
+    mPrefetchCond.notify_all();
+    mPrefetchThread.join();
+  }
+  for (auto& p : mPrefetched) {
+    delete p.second;
   }
+  mPrefetched.clear();
 }
 
 void MCKinematicsReader::loadHeadersForSource(int source) const
 {
   auto chain = mInputChains[source];
   if (chain) {
+    std::lock_guard<std::mutex> lock(mChainMutex);
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCEventHeader.");
     if (br) {
@@ -111,6 +300,7 @@ void MCKinematicsReader::loadTrackRefsForSource(int source) const
 {
   auto chain = mInputChains[source];
   if (chain) {
+    std::lock_guard<std::mutex> lock(mChainMutex);
     // todo: get name from NameConfig
     auto br = chain->GetBranch("TrackRefs");
     if (br) {
@@ -147,6 +337,7 @@ bool MCKinematicsReader::initFromDigitContext(o2::steer::DigitizationContext con
 
   // load the kinematics information
   mTracks.resize(mInputChains.size());
+  mLastAccess.resize(mInputChains.size());
   mHeaders.resize(mInputChains.size());
   mIndexedTrackRefs.resize(mInputChains.size());
 
@@ -180,6 +371,7 @@ bool MCKinematicsReader::initFromKinematics(std::string_view name)
   mInputChains.emplace_back(new TChain("o2sim"));
   mInputChains.back()->AddFile(o2::base::NameConf::getMCKinematicsFileName(name.data()).c_str());
   mTracks.resize(1);
+  mLastAccess.resize(1);
   mHeaders.resize(1);
   mIndexedTrackRefs.resize(1);
   mInitialized = true;
@@ -0,0 +1,139 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MCKinematicsReader class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "Steer/MCKinematicsReader.h"
+#include "CommonUtils/NameConf.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace o2
+{
+namespace steer
+{
+
+constexpr int NEvents = 12;
+
+/// mockup kinematics with event i made of i+1 tracks, the pdg code encoding the event and track IDs
+int pdgCode(int event, int track) { return 1000 * event + track; }
+
+std::string makeKinematics()
+{
+  std::string prefix = "mckinereader" + std::to_string(getpid());
+  TFile file(o2::base::NameConf::getMCKinematicsFileName(prefix).c_str(), "RECREATE");
+  TTree tree("o2sim", "");
+  std::vector<o2::MCTrack> tracks, *tracksPtr = &tracks;
+  tree.Branch("MCTrack", &tracksPtr);
+  for (int event = 0; event < NEvents; event++) {
+    tracks.clear();
+    for (int track = 0; track <= event; track++) {
+      tracks.emplace_back(pdgCode(event, track), -1, -1, -1, -1, 0., 0., 1., 0., 0., 0., 0., 0);
+    }
+    tree.Fill();
+  }
+  tree.Write();
+  file.Close();
+  return prefix;
+}
+
+bool checkTracks(gsl::span<const o2::MCTrack> tracks, int event)
+{
+  if (int(tracks.size()) != event + 1) {
+    return false;
+  }
+  for (int track = 0; track <= event; track++) {
+    if (tracks[track].GetPdgCode() != pdgCode(event, track)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReaderTest)
+{
+  auto prefix = makeKinematics();
+
+  // plain access, all events kept
+  {
+    MCKinematicsReader reader(prefix, MCKinematicsReader::Mode::kMCKine);
+    BOOST_REQUIRE(reader.isInitialized());
+    for (int event = 0; event < NEvents; event++) {
+      BOOST_CHECK(checkTracks(reader.getTracks(event), event));
+    }
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), NEvents);
+    reader.releaseTracksForSourceAndEvent(0, 3);
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), NEvents - 1);
+    BOOST_CHECK(checkTracks(reader.getTracks(3), 3)); // read again
+  }
+
+  // bounded cache, the least recently accessed events are evicted
+  {
+    MCKinematicsReader reader(prefix, MCKinematicsReader::Mode::kMCKine);
+    reader.setMaxCachedEvents(3);
+    for (int event = 0; event < NEvents; event++) {
+      BOOST_CHECK(checkTracks(reader.getTracks(event), event));
+      BOOST_CHECK(reader.getNCachedEvents() <= 3);
+    }
+    // cached: 9, 10, 11. Touching 9 makes 10 the least recently used one
+    const auto* tracks9 = &reader.getTracks(9);
+    const auto* tracks11 = &reader.getTracks(11);
+    BOOST_CHECK(checkTracks(reader.getTracks(0), 0));
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), 3);
+    BOOST_CHECK_EQUAL(&reader.getTracks(9), tracks9); // still cached, not read again
+    BOOST_CHECK_EQUAL(&reader.getTracks(11), tracks11);
+    BOOST_CHECK(checkTracks(reader.getTracks(10), 10)); // was evicted, read again
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), 3);
+    reader.setMaxCachedEvents(1); // shrinking the limit evicts immediately
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), 1);
+    BOOST_CHECK(checkTracks(reader.getTracks(10), 10));
+  }
+
+  // background prefetch, also with jumps outside of the prefetched window
+  {
+    MCKinematicsReader reader(prefix, MCKinematicsReader::Mode::kMCKine);
+    reader.setMaxCachedEvents(2);
+    reader.setPrefetchDepth(3);
+    BOOST_CHECK_EQUAL(reader.getPrefetchDepth(), 3);
+    for (int event : {0, 1, 2, 3, 7, 8, 4, 11, 5, 6, 9, 10}) {
+      BOOST_CHECK(checkTracks(reader.getTracks(event), event));
+      BOOST_CHECK(reader.getNCachedEvents() <= 2);
+    }
+    reader.setPrefetchDepth(0);
+    BOOST_CHECK(checkTracks(reader.getTracks(1), 1));
+  }
+
+  // bulk access, mixing cached and not cached events
+  {
+    MCKinematicsReader reader(prefix, MCKinematicsReader::Mode::kMCKine);
+    reader.setPrefetchDepth(2);
+    const auto* tracks4 = &reader.getTracks(4);
+    std::vector<o2::MCTrack> storage;
+    auto spans = reader.getTracksForEvents(0, 2, NEvents + 5, storage); // the last event is limited to the available ones
+    BOOST_REQUIRE_EQUAL(spans.size(), NEvents - 2);
+    for (size_t i = 0; i < spans.size(); i++) {
+      BOOST_CHECK(checkTracks(spans[i], i + 2));
+    }
+    BOOST_CHECK_EQUAL(&reader.getTracks(4), tracks4); // the cached event is unchanged
+    BOOST_CHECK_EQUAL(reader.getNCachedEvents(), 1);  // the other events are not cached
+  }
+
+  std::remove(o2::base::NameConf::getMCKinematicsFileName(prefix).c_str());
+}
+
+} // namespace steer
+} // namespace o2
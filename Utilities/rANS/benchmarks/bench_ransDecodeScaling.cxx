@@ -71,6 +71,7 @@ void ransDecodeBenchmark(benchmark::State& st)
 
   using source_type = uint32_t;
   size_t max = utils::pow2(st.range(0));
+  const auto kernel = static_cast<DecoderKernel>(st.range(1));
 
   if (max != sourceMessage.getMax()) {
     sourceMessage = SourceMessageUniform<uint32_t>{MessageSize, max};
@@ -88,6 +89,11 @@ void ransDecodeBenchmark(benchmark::State& st)
   encodeBuffer.encodeBufferEnd = encoder.process(inputData.data(), inputData.data() + inputData.size(), encodeBuffer.buffer.data());
 
   auto decoder = makeDecoder<>::fromRenormed(renormedHistogram);
+  decoder.setDecoderKernel(kernel);
+  if (internal::getDecoderKernel(kernel, encoder.getNStreams()) != kernel) {
+    st.SkipWithError("Decoder kernel not supported by this CPU");
+    return;
+  }
 #ifdef ENABLE_VTUNE_PROFILER
   __itt_resume();
 #endif
@@ -105,6 +111,7 @@ void ransDecodeBenchmark(benchmark::State& st)
   const auto& datasetProperties = metrics.getDatasetProperties();
   st.SetItemsProcessed(static_cast<int64_t>(inputData.size()) * static_cast<int64_t>(st.iterations()));
   st.SetBytesProcessed(static_cast<int64_t>(inputData.size()) * sizeof(source_type) * static_cast<int64_t>(st.iterations()));
+  st.counters["DecoderKernel"] = static_cast<uint8_t>(kernel);
   st.counters["AlphabetRangeBits"] = datasetProperties.alphabetRangeBits;
   st.counters["nUsedAlphabetSymbols"] = datasetProperties.nUsedAlphabetSymbols;
   st.counters["SymbolTablePrecision"] = renormedHistogram.getRenormingBits();
@@ -117,6 +124,6 @@ void ransDecodeBenchmark(benchmark::State& st)
   st.counters["CompressionWRTEntropy"] = st.counters["CompressedSize"] / st.counters["LowerBound"];
 };
 
-BENCHMARK(ransDecodeBenchmark)->DenseRange(8, 27, 1);
+BENCHMARK(ransDecodeBenchmark)->ArgsProduct({benchmark::CreateDenseRange(8, 27, 1), {static_cast<int64_t>(DecoderKernel::Scalar), static_cast<int64_t>(DecoderKernel::SSE41), static_cast<int64_t>(DecoderKernel::AVX2)}});
 
 BENCHMARK_MAIN();
\ No newline at end of file
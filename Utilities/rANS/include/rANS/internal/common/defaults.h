@@ -31,6 +31,10 @@ enum class CoderTag : uint8_t { Compat,
                                 SSE,
                                 AVX2 };
 
+enum class DecoderKernel : uint8_t { Scalar,
+                                     SSE41,
+                                     AVX2 };
+
 using count_t = uint32_t;
 
 namespace defaults
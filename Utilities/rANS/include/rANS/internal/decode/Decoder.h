@@ -77,6 +77,19 @@ class Decoder
     return precision;
   };
 
+  [[nodiscard]] inline DecoderKernel getDecoderKernel() const noexcept
+  {
+    DecoderKernel kernel{};
+    std::visit([&kernel](auto&& decoder) { kernel = decoder.getDecoderKernel(); }, mImpl);
+    return kernel;
+  };
+
+  /// select the decoding kernel, by default the best one supported by the CPU is used
+  inline void setDecoderKernel(DecoderKernel kernel) noexcept
+  {
+    std::visit([kernel](auto&& decoder) { decoder.setDecoderKernel(kernel); }, mImpl);
+  };
+
   template <typename stream_IT, typename source_IT, typename literals_IT = std::nullptr_t>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd = nullptr) const
   {
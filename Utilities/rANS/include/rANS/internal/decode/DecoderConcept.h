@@ -16,12 +16,16 @@
 #ifndef RANS_INTERNAL_DECODE_DECODER_CONCEPT_H_
 #define RANS_INTERNAL_DECODE_DECODER_CONCEPT_H_
 
+#include <bit>
+#include <iterator>
+#include <memory>
 #include <fairlogger/Logger.h>
 #include <gsl/span>
 #include <stdexcept>
 
 #include "rANS/internal/common/utils.h"
 #include "rANS/internal/containers/RenormedHistogram.h"
+#include "rANS/internal/decode/SIMDDecoderImpl.h"
 
 namespace o2::rans
 {
@@ -49,6 +53,11 @@ class DecoderConcept
 
   [[nodiscard]] inline const symbolTable_type& getSymbolTable() const noexcept { return this->mSymbolTable; };
 
+  [[nodiscard]] inline DecoderKernel getDecoderKernel() const noexcept { return this->mDecoderKernel; };
+
+  // kernels not supported by the CPU are downgraded at decoding time
+  inline void setDecoderKernel(DecoderKernel kernel) noexcept { this->mDecoderKernel = kernel; };
+
   template <typename stream_IT, typename source_IT, typename literals_IT = std::nullptr_t, std::enable_if_t<utils::isCompatibleIter_v<typename symbolTable_T::source_type, source_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd = nullptr) const
   {
@@ -89,14 +98,41 @@ class DecoderConcept
         return std::make_tuple(symbol.first, decoder.advanceSymbol(inputIter, symbol.second));
       };
 
+      const size_t nLoops = messageLength / nStreams;
+      const size_t nLoopRemainder = messageLength % nStreams;
+
+      // interleaved states of contiguous streams are decoded in SIMD lanes if the CPU supports it
+      if constexpr (std::contiguous_iterator<stream_IT> && std::is_same_v<std::remove_cv_t<typename std::iterator_traits<stream_IT>::value_type>, stream_type>) {
+        using simdDecoder_type = internal::SIMDDecoderImpl<std::countr_zero(coder_type::getStreamingLowerBound())>;
+        const DecoderKernel kernel = internal::getDecoderKernel(this->mDecoderKernel, nStreams);
+
+        if (kernel != DecoderKernel::Scalar) {
+          simdDecoder_type decoder{this->mSymbolTable.getPrecision(), nStreams};
+          const stream_type* streamPosition = decoder.init(std::to_address(inputIter));
+          auto lookup = [&lookupSymbol](count_t cumulativeFrequency) {
+            const value_type symbol = lookupSymbol(cumulativeFrequency);
+#ifdef RANS_LOG_PROCESSED_DATA
+            arrayLogger << symbol.first;
+#endif
+            return symbol;
+          };
+          if (kernel == DecoderKernel::AVX2) {
+            decoder.template decode<DecoderKernel::AVX2>(streamPosition, outputIter, nLoops, nLoopRemainder, lookup);
+          } else {
+            decoder.template decode<DecoderKernel::SSE41>(streamPosition, outputIter, nLoops, nLoopRemainder, lookup);
+          }
+#ifdef RANS_LOG_PROCESSED_DATA
+          LOG(info) << "decoderOutput:" << arrayLogger;
+#endif
+          return;
+        }
+      }
+
       std::vector<coder_type> decoders{nStreams, coder_type{this->mSymbolTable.getPrecision()}};
       for (auto& decoder : decoders) {
         inputIter = decoder.init(inputIter);
       }
 
-      const size_t nLoops = messageLength / nStreams;
-      const size_t nLoopRemainder = messageLength % nStreams;
-
       for (size_t i = 0; i < nLoops; ++i) {
 #if defined(RANS_OPENMP)
 #pragma omp unroll partial(2)
@@ -124,6 +160,7 @@ class DecoderConcept
 
  protected:
   symbolTable_type mSymbolTable{};
+  DecoderKernel mDecoderKernel{DecoderKernel::AVX2};
 
   static_assert(coder_type::getNstreams() == 1, "implementation supports only single stream encoders");
 };
@@ -51,6 +51,8 @@ class DecoderImpl
 
   [[nodiscard]] inline static constexpr size_type getNstreams() noexcept { return N_STREAMS; };
 
+  [[nodiscard]] inline static constexpr state_type getStreamingLowerBound() noexcept { return LOWER_BOUND; };
+
  private:
   state_type mState{};
   size_type mSymbolTablePrecission{};
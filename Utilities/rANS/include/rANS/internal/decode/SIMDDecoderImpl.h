@@ -0,0 +1,283 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   SIMDDecoderImpl.h
+/// @brief  Decodes all interleaved rANS states of a message in SIMD lanes. Kernels for SSE4.1 and AVX2 are selected at runtime.
+
+#ifndef RANS_INTERNAL_DECODE_SIMDDECODERIMPL_H_
+#define RANS_INTERNAL_DECODE_SIMDDECODERIMPL_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "rANS/internal/common/defines.h"
+#include "rANS/internal/common/defaults.h"
+#include "rANS/internal/common/utils.h"
+
+#ifdef RANS_SIMD_DISPATCH
+#include <immintrin.h>
+#define RANS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define RANS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace o2::rans::internal
+{
+
+[[nodiscard]] inline DecoderKernel detectDecoderKernel() noexcept
+{
+#ifdef RANS_SIMD_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return DecoderKernel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return DecoderKernel::SSE41;
+  }
+#endif
+  return DecoderKernel::Scalar;
+};
+
+/// best kernel supported by the CPU we are running on, detected once per process
+[[nodiscard]] inline DecoderKernel getNativeDecoderKernel() noexcept
+{
+  static const DecoderKernel kernel = detectDecoderKernel();
+  return kernel;
+};
+
+[[nodiscard]] inline constexpr size_t getLanes(DecoderKernel kernel) noexcept
+{
+  switch (kernel) {
+    case DecoderKernel::AVX2:
+      return 4;
+    case DecoderKernel::SSE41:
+      return 2;
+    default:
+      return 1;
+  }
+};
+
+/// downgrade the requested kernel until it is supported by the CPU and the lanes fit the number of interleaved streams
+[[nodiscard]] inline DecoderKernel getDecoderKernel(DecoderKernel requested, size_t nStreams) noexcept
+{
+  DecoderKernel kernel = std::min(requested, getNativeDecoderKernel());
+  while (kernel != DecoderKernel::Scalar && (nStreams % getLanes(kernel) != 0)) {
+    kernel = static_cast<DecoderKernel>(static_cast<uint8_t>(kernel) - 1);
+  }
+  return kernel;
+};
+
+template <size_t LowerBound_V>
+class SIMDDecoderImpl
+{
+ public:
+  using stream_type = uint32_t;
+  using state_type = uint64_t;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  SIMDDecoderImpl(size_type symbolTablePrecision, size_type nStreams) : mStates(nStreams, 0), mSymbolTablePrecision{symbolTablePrecision} {};
+
+  // reads the states of all streams in the same order as nStreams consecutive DecoderImpl::init calls
+  const stream_type* init(const stream_type* inputIter);
+
+  // Decodes nRounds full rounds over all streams followed by a partial round over the first nRemainder streams.
+  // Symbol lookup (incl. literals) happens in stream order, state update and renormalization run in SIMD lanes.
+  template <DecoderKernel kernel_V, typename source_IT, typename lookup_T>
+  const stream_type* decode(const stream_type* inputIter, source_IT outputIter, size_type nRounds, size_type nRemainder, lookup_T&& lookup);
+
+ private:
+  std::vector<state_type> mStates{};
+  size_type mSymbolTablePrecision{};
+
+  template <typename source_IT, typename lookup_T>
+  const stream_type* decodeScalar(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, size_type nRemainder, lookup_T& lookup);
+
+#ifdef RANS_SIMD_DISPATCH
+  template <typename source_IT, typename lookup_T>
+  RANS_TARGET_SSE41 const stream_type* decodeSSE41(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, lookup_T& lookup);
+
+  template <typename source_IT, typename lookup_T>
+  RANS_TARGET_AVX2 const stream_type* decodeAVX2(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, lookup_T& lookup);
+#endif
+
+  // writes the decoded symbol of a stream to the output and returns its frequency (lower 32 Bits) and cumulative frequency (upper 32 Bits)
+  template <typename source_IT, typename lookup_T>
+  inline uint64_t lookupSymbol(size_type stream, source_IT& outputIter, lookup_T& lookup) const
+  {
+    const state_type mask = utils::pow2(mSymbolTablePrecision) - 1;
+    const auto [symbol, decoderSymbol] = lookup(static_cast<count_t>(mStates[stream] & mask));
+    *outputIter++ = symbol;
+    return static_cast<uint64_t>(decoderSymbol.getFrequency()) | (static_cast<uint64_t>(decoderSymbol.getCumulative()) << 32);
+  };
+
+  inline static constexpr state_type LOWER_BOUND = utils::pow2(LowerBound_V); // lower bound of our normalization interval
+
+  inline static constexpr state_type STREAM_BITS = utils::toBits<stream_type>();
+};
+
+template <size_t LowerBound_V>
+auto SIMDDecoderImpl<LowerBound_V>::init(const stream_type* inputIter) -> const stream_type*
+{
+  const stream_type* streamPosition = inputIter;
+  for (auto& state : mStates) {
+    state = static_cast<state_type>(*streamPosition) << 0;
+    --streamPosition;
+    state |= static_cast<state_type>(*streamPosition) << 32;
+    --streamPosition;
+  }
+  return streamPosition;
+};
+
+template <size_t LowerBound_V>
+template <DecoderKernel kernel_V, typename source_IT, typename lookup_T>
+auto SIMDDecoderImpl<LowerBound_V>::decode(const stream_type* inputIter, source_IT outputIter, size_type nRounds, size_type nRemainder, lookup_T&& lookup) -> const stream_type*
+{
+  const stream_type* streamPosition = inputIter;
+#ifdef RANS_SIMD_DISPATCH
+  if constexpr (kernel_V == DecoderKernel::AVX2) {
+    streamPosition = decodeAVX2(streamPosition, outputIter, nRounds, lookup);
+    nRounds = 0;
+  } else if constexpr (kernel_V == DecoderKernel::SSE41) {
+    streamPosition = decodeSSE41(streamPosition, outputIter, nRounds, lookup);
+    nRounds = 0;
+  }
+#endif
+  return decodeScalar(streamPosition, outputIter, nRounds, nRemainder, lookup);
+};
+
+template <size_t LowerBound_V>
+template <typename source_IT, typename lookup_T>
+auto SIMDDecoderImpl<LowerBound_V>::decodeScalar(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, size_type nRemainder, lookup_T& lookup) -> const stream_type*
+{
+  const stream_type* streamPosition = inputIter;
+  const state_type mask = utils::pow2(mSymbolTablePrecision) - 1;
+
+  auto decodeStream = [&, this](size_type stream) {
+    const uint64_t symbol = lookupSymbol(stream, outputIter, lookup);
+    state_type& state = mStates[stream];
+    state = (symbol & 0xFFFFFFFFu) * (state >> mSymbolTablePrecision) + (state & mask) - (symbol >> 32);
+    if (state < LOWER_BOUND) {
+      state = (state << STREAM_BITS) | *streamPosition;
+      --streamPosition;
+      assert(state >= LOWER_BOUND);
+    }
+  };
+
+  for (size_type i = 0; i < nRounds; ++i) {
+    for (size_type stream = 0; stream < mStates.size(); ++stream) {
+      decodeStream(stream);
+    }
+  }
+  for (size_type stream = 0; stream < nRemainder; ++stream) {
+    decodeStream(stream);
+  }
+  return streamPosition;
+};
+
+#ifdef RANS_SIMD_DISPATCH
+
+template <size_t LowerBound_V>
+template <typename source_IT, typename lookup_T>
+RANS_TARGET_SSE41 auto SIMDDecoderImpl<LowerBound_V>::decodeSSE41(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, lookup_T& lookup) -> const stream_type*
+{
+  constexpr size_type nLanes = 2;
+  assert(mStates.size() % nLanes == 0);
+
+  const stream_type* streamPosition = inputIter;
+  const __m128i mask = _mm_set1_epi64x(static_cast<int64_t>(utils::pow2(mSymbolTablePrecision) - 1));
+  const __m128i precision = _mm_cvtsi32_si128(static_cast<int>(mSymbolTablePrecision));
+  const __m128i zero = _mm_setzero_si128();
+
+  for (size_type i = 0; i < nRounds; ++i) {
+    for (size_type stream = 0; stream < mStates.size(); stream += nLanes) {
+      const uint64_t symbol0 = lookupSymbol(stream + 0, outputIter, lookup);
+      const uint64_t symbol1 = lookupSymbol(stream + 1, outputIter, lookup);
+      // frequency in the lower, cumulative frequency in the upper 32 Bits of each lane
+      const __m128i symbols = _mm_set_epi64x(symbol1, symbol0);
+
+      __m128i* statePtr = reinterpret_cast<__m128i*>(mStates.data() + stream);
+      const __m128i state = _mm_loadu_si128(statePtr);
+
+      // s, x = D(x); the 64 Bit product is composed of two 32x32 Bit multiplications
+      const __m128i quotient = _mm_srl_epi64(state, precision);
+      const __m128i productLow = _mm_mul_epu32(quotient, symbols);
+      const __m128i productHigh = _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(quotient, 32), symbols), 32);
+      __m128i newState = _mm_sub_epi64(_mm_add_epi64(_mm_add_epi64(productLow, productHigh), _mm_and_si128(state, mask)), _mm_srli_epi64(symbols, 32));
+
+      // renormalize: lanes read from the stream in stream order
+      const __m128i renormMask = _mm_cmpeq_epi64(_mm_srli_epi64(newState, LowerBound_V), zero);
+      const int renormBits = _mm_movemask_pd(_mm_castsi128_pd(renormMask));
+      if (renormBits) {
+        const uint64_t word0 = (renormBits & 0x1) ? *streamPosition-- : 0;
+        const uint64_t word1 = (renormBits & 0x2) ? *streamPosition-- : 0;
+        const __m128i renormed = _mm_or_si128(_mm_slli_epi64(newState, STREAM_BITS), _mm_set_epi64x(word1, word0));
+        newState = _mm_blendv_epi8(newState, renormed, renormMask);
+      }
+      _mm_storeu_si128(statePtr, newState);
+    }
+  }
+  return streamPosition;
+};
+
+template <size_t LowerBound_V>
+template <typename source_IT, typename lookup_T>
+RANS_TARGET_AVX2 auto SIMDDecoderImpl<LowerBound_V>::decodeAVX2(const stream_type* inputIter, source_IT& outputIter, size_type nRounds, lookup_T& lookup) -> const stream_type*
+{
+  constexpr size_type nLanes = 4;
+  assert(mStates.size() % nLanes == 0);
+
+  const stream_type* streamPosition = inputIter;
+  const __m256i mask = _mm256_set1_epi64x(static_cast<int64_t>(utils::pow2(mSymbolTablePrecision) - 1));
+  const __m128i precision = _mm_cvtsi32_si128(static_cast<int>(mSymbolTablePrecision));
+  const __m256i zero = _mm256_setzero_si256();
+
+  for (size_type i = 0; i < nRounds; ++i) {
+    for (size_type stream = 0; stream < mStates.size(); stream += nLanes) {
+      const uint64_t symbol0 = lookupSymbol(stream + 0, outputIter, lookup);
+      const uint64_t symbol1 = lookupSymbol(stream + 1, outputIter, lookup);
+      const uint64_t symbol2 = lookupSymbol(stream + 2, outputIter, lookup);
+      const uint64_t symbol3 = lookupSymbol(stream + 3, outputIter, lookup);
+      // frequency in the lower, cumulative frequency in the upper 32 Bits of each lane
+      const __m256i symbols = _mm256_set_epi64x(symbol3, symbol2, symbol1, symbol0);
+
+      __m256i* statePtr = reinterpret_cast<__m256i*>(mStates.data() + stream);
+      const __m256i state = _mm256_loadu_si256(statePtr);
+
+      // s, x = D(x); the 64 Bit product is composed of two 32x32 Bit multiplications
+      const __m256i quotient = _mm256_srl_epi64(state, precision);
+      const __m256i productLow = _mm256_mul_epu32(quotient, symbols);
+      const __m256i productHigh = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(quotient, 32), symbols), 32);
+      __m256i newState = _mm256_sub_epi64(_mm256_add_epi64(_mm256_add_epi64(productLow, productHigh), _mm256_and_si256(state, mask)), _mm256_srli_epi64(symbols, 32));
+
+      // renormalize: lanes read from the stream in stream order
+      const __m256i renormMask = _mm256_cmpeq_epi64(_mm256_srli_epi64(newState, LowerBound_V), zero);
+      const int renormBits = _mm256_movemask_pd(_mm256_castsi256_pd(renormMask));
+      if (renormBits) {
+        const uint64_t word0 = (renormBits & 0x1) ? *streamPosition-- : 0;
+        const uint64_t word1 = (renormBits & 0x2) ? *streamPosition-- : 0;
+        const uint64_t word2 = (renormBits & 0x4) ? *streamPosition-- : 0;
+        const uint64_t word3 = (renormBits & 0x8) ? *streamPosition-- : 0;
+        const __m256i renormed = _mm256_or_si256(_mm256_slli_epi64(newState, STREAM_BITS), _mm256_set_epi64x(word3, word2, word1, word0));
+        newState = _mm256_blendv_epi8(newState, renormed, renormMask);
+      }
+      _mm256_storeu_si256(statePtr, newState);
+    }
+  }
+  return streamPosition;
+};
+
+#endif /* RANS_SIMD_DISPATCH */
+
+} // namespace o2::rans::internal
+
+#endif /* RANS_INTERNAL_DECODE_SIMDDECODERIMPL_H_ */
@@ -22,6 +22,7 @@
 
 #include <vector>
 #include <cstring>
+#include <random>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/mp11.hpp>
@@ -144,6 +145,46 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, test_types, testCase_types)
   BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), encodeString.begin(), encodeString.end());
 };
 
+using decoderKernel_types = boost::mp11::mp_list<std::integral_constant<DecoderKernel, DecoderKernel::Scalar>,
+                                                  std::integral_constant<DecoderKernel, DecoderKernel::SSE41>,
+                                                  std::integral_constant<DecoderKernel, DecoderKernel::AVX2>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_decoderKernels, kernel_type, decoderKernel_types)
+{
+  using source_type = int16_t;
+  using stream_type = uint32_t;
+  constexpr DecoderKernel kernel = kernel_type::value;
+  constexpr size_t messageSize = (1ull << 16) + 7; // force a partial round at the end of the message
+
+  std::mt19937 mt(0);
+  std::binomial_distribution<int32_t> dist(1000, 0.5);
+  std::vector<source_type> message(messageSize);
+  std::generate(message.begin(), message.end(), [&]() { return static_cast<source_type>(dist(mt)); });
+
+  // build the dictionary from a subset of the message to create incompressible symbols
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.begin() + message.size() / 16), RansRenormingPrecision, RenormingPolicy::ForceIncompressible);
+  auto encoder = makeDenseEncoder<>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+  decoder.setDecoderKernel(kernel);
+  BOOST_CHECK(decoder.getDecoderKernel() == kernel);
+
+  std::vector<source_type> literals(message.size());
+  std::vector<stream_type> encodeBuffer(message.size());
+  auto [encodeBufferEnd, literalsEnd] = encoder.process(message.begin(), message.end(), encodeBuffer.begin(), literals.begin());
+  BOOST_CHECK(literalsEnd != literals.begin());
+
+  std::vector<source_type> decodeBuffer(message.size());
+  decoder.process(encodeBufferEnd, decodeBuffer.begin(), message.size(), encoder.getNStreams(), literalsEnd);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+
+  // streams of an encoder with fewer interleaved streams than SIMD lanes fall back to narrower kernels
+  auto compatEncoder = makeDenseEncoder<CoderTag::Compat>::fromRenormed(renormed);
+  auto [compatBufferEnd, compatLiteralsEnd] = compatEncoder.process(message.begin(), message.end(), encodeBuffer.begin(), literals.begin());
+  std::fill(decodeBuffer.begin(), decodeBuffer.end(), 0);
+  decoder.process(compatBufferEnd, decodeBuffer.begin(), message.size(), compatEncoder.getNStreams(), compatLiteralsEnd);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+};
+
 #ifndef RANS_SINGLE_STREAM
 BOOST_AUTO_TEST_CASE(test_NoSingleStream)
 {
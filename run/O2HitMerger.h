@@ -36,6 +36,7 @@
 #include <ctime>
 #include <TStopwatch.h>
 #include <sstream>
+#include <fstream>
 #include <cassert>
 #include "FairSystemInfo.h"
 
@@ -81,6 +82,8 @@
 #endif
 
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
 namespace o2
 {
@@ -159,6 +162,7 @@ class O2HitMerger : public fair::mq::Device
       // has to be after init of Detectors
       o2::utils::ShmManager::Instance().attachToGlobalSegment();
       initHitFiles(o2::conf::SimConfig::Instance().getOutPrefix());
+      initMergerArena();
     }
 
     // init pipe
@@ -412,6 +416,8 @@ class O2HitMerger : public fair::mq::Device
         if (mMergerIOThread.joinable()) {
           mMergerIOThread.join();
         }
+        LOG(info) << "Total hit merge/flush time per detector:" << formatMergeTimes(mDetectorMergeTime);
+        writeMergeTimes(o2::conf::SimConfig::Instance().getOutPrefix() + "_mergertimes.json");
 
         expectmore = false;
       }
@@ -429,6 +435,85 @@ class O2HitMerger : public fair::mq::Device
     return expectmore;
   }
 
+  void initMergerArena()
+  {
+    // the detectors write to their own trees and files, so that their hits can be merged and flushed concurrently
+    int nhittrees = 0;
+    for (int id = 0; id < mDetectorInstances.size(); ++id) {
+      nhittrees += mDetectorInstances[id] && mDetectorToTTreeMap[id];
+    }
+    int nthreads = std::min<int>(nhittrees, std::thread::hardware_concurrency());
+    if (auto env = getenv("ALICE_O2SIMMERGER_NTHREADS")) {
+      nthreads = atoi(env);
+    }
+    mDetectorMergeTime.resize(mDetectorInstances.size(), 0.);
+    mMergerThreads = std::max(nthreads, 1);
+    if (nthreads > 1) {
+      LOG(info) << "Merging and flushing the hits of " << nhittrees << " detectors with " << nthreads << " threads";
+      // no slot is reserved for the merger IO thread, which meanwhile treats the kinematics
+      mMergerArena = std::make_unique<tbb::task_arena>(nthreads, 0);
+    }
+  }
+
+  // Runs detTask(id) for all detectors having a hit tree and mainTask on the calling thread.
+  // The detector tasks are executed concurrently with mainTask when the merger arena exists,
+  // otherwise sequentially after it. Returns once all tasks are done.
+  template <typename DetTask, typename MainTask>
+  void runForHitTrees(DetTask&& detTask, MainTask&& mainTask)
+  {
+    if (!mMergerArena) {
+      mainTask();
+      for (int id = 0; id < mDetectorInstances.size(); ++id) {
+        if (mDetectorInstances[id] && mDetectorToTTreeMap[id]) {
+          detTask(id);
+        }
+      }
+      return;
+    }
+    tbb::task_group group;
+    mMergerArena->execute([&]() {
+      for (int id = 0; id < mDetectorInstances.size(); ++id) {
+        if (mDetectorInstances[id] && mDetectorToTTreeMap[id]) {
+          group.run([&detTask, id]() { detTask(id); });
+        }
+      }
+    });
+    mainTask();
+    mMergerArena->execute([&]() { group.wait(); });
+  }
+
+  std::string formatMergeTimes(std::vector<double> const& times) const
+  {
+    std::stringstream str;
+    for (int id = 0; id < times.size(); ++id) {
+      if (mDetectorInstances[id] && mDetectorToTTreeMap[id]) {
+        str << " " << o2::detectors::DetID::getName(id) << " " << times[id];
+      }
+    }
+    return str.str();
+  }
+
+  // summary of the merge/flush times, in seconds, for the monitoring of the simulation jobs
+  void writeMergeTimes(std::string const& filename) const
+  {
+    std::ofstream out(filename);
+    if (!out) {
+      LOG(warn) << "Cannot write the merge times to " << filename;
+      return;
+    }
+    out << "{\n  \"threads\": " << mMergerThreads << ",\n  \"events\": " << mNMergedEvents
+        << ",\n  \"kinematics\": " << mKinematicsMergeTime << ",\n  \"detectors\": {";
+    const char* sep = "";
+    for (int id = 0; id < mDetectorMergeTime.size(); ++id) {
+      if (mDetectorInstances[id] && mDetectorToTTreeMap[id]) {
+        out << sep << "\n    \"" << o2::detectors::DetID::getName(id) << "\": " << mDetectorMergeTime[id];
+        sep = ",";
+      }
+    }
+    out << "\n  }\n}\n";
+    LOG(info) << "Merge/flush times written to " << filename;
+  }
+
   void cleanEvent(int eventID)
   {
     // cleanup intermediate per-Event buffers
@@ -765,52 +850,32 @@ class O2HitMerger : public fair::mq::Device
         eventheader->putInfo("prims_total", prims);
       };
 
-      reorderAndMergeMCTracks(flusheventID, mOutTree, nprimaries, subevOrdered, mcheaderhook, eventheader);
-
-      if (mOutTree) {
-        // adjusting and merging track references
-        remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
-
-        // write MC event headers
-        {
-          auto headerbr = o2::base::getOrMakeBranch(*mOutTree, "MCEventHeader.", &eventheader);
-          headerbr->SetAddress(&eventheader);
-          headerbr->Fill();
-          headerbr->ResetAddress();
-        }
-
-        {
-          auto headerbr = o2::base::getOrMakeBranch(*mMCHeaderTree, "MCEventHeader.", &eventheader);
-          headerbr->SetAddress(&eventheader);
-          headerbr->Fill();
-          headerbr->ResetAddress();
-        }
-      }
-
       // c) do the merge procedure for all hits ... delegate this to detector specific functions
       // since they know about types; number of branches; etc.
       // this will also fix the trackIDs inside the hits
-      for (int id = 0; id < mDetectorInstances.size(); ++id) {
-        auto& det = mDetectorInstances[id];
-        if (det) {
-          auto hittree = mDetectorToTTreeMap[id];
-          if (hittree) {
-            det->mergeHitEntriesAndFlush(flusheventID, *hittree, trackoffsets, nprimaries, subevOrdered);
-            hittree->SetEntries(hittree->GetEntries() + 1);
-            LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
-          }
-        }
-      }
+      std::vector<double> mergeTimes(mDetectorInstances.size(), 0.);
+      auto mergeHits = [&](int id) {
+        TStopwatch dettimer;
+        auto hittree = mDetectorToTTreeMap[id];
+        mDetectorInstances[id]->mergeHitEntriesAndFlush(flusheventID, *hittree, trackoffsets, nprimaries, subevOrdered);
+        hittree->SetEntries(hittree->GetEntries() + 1);
+        LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
+        mergeTimes[id] = dettimer.RealTime();
+      };
 
-      // increase the entry count in the tree
-      if (mOutTree) {
-        mOutTree->SetEntries(mOutTree->GetEntries() + 1);
-        LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
-      }
-      if (mMCHeaderTree) {
-        mMCHeaderTree->SetEntries(mMCHeaderTree->GetEntries() + 1);
-        LOG(info) << "mc header outtree has file " << mMCHeaderTree->GetDirectory()->GetFile()->GetName();
+      // the kinematics is merged on this thread, in event order, while the hits are being merged
+      double kineTime = 0.;
+      runForHitTrees(mergeHits, [&]() {
+        TStopwatch kinetimer;
+        mergeKinematics(flusheventID, trackoffsets, nprimaries, subevOrdered, mcheaderhook, eventheader);
+        kineTime = kinetimer.RealTime();
+      });
+      for (int id = 0; id < mergeTimes.size(); ++id) {
+        mDetectorMergeTime[id] += mergeTimes[id];
       }
+      mKinematicsMergeTime += kineTime;
+      mNMergedEvents++;
+      LOG(info) << "Kinematics merge time for event " << flusheventID << ": " << kineTime << ", hit merge/flush time per detector:" << formatMergeTimes(mergeTimes);
 
       cleanEvent(flusheventID);
       LOG(info) << "Merge/flush for event " << flusheventID << " took " << timer.RealTime();
@@ -820,18 +885,58 @@ class O2HitMerger : public fair::mq::Device
     } // end while
     if (mWriteToDisc && mOutFile) {
       LOG(info) << "Writing TTrees";
-      mOutFile->Write("", TObject::kOverwrite);
-      for (int id = 0; id < mDetectorInstances.size(); ++id) {
-        auto& det = mDetectorInstances[id];
-        if (det && mDetectorOutFiles[id]) {
+      auto writeHits = [this](int id) {
+        if (mDetectorOutFiles[id]) {
           mDetectorOutFiles[id]->Write("", TObject::kOverwrite);
         }
+      };
+      auto writeKinematics = [this]() {
+        mOutFile->Write("", TObject::kOverwrite);
+        if (mMCHeaderOnlyOutFile) {
+          mMCHeaderOnlyOutFile->Write("", TObject::kOverwrite);
+        }
+      };
+      runForHitTrees(writeHits, writeKinematics);
+    }
+    return true;
+  }
+
+  // merge the kinematics, track references and event headers of the event (part b of mergeAndFlushData)
+  template <typename Hook>
+  void mergeKinematics(int flusheventID, std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevOrdered,
+                       Hook&& mcheaderhook, o2::dataformats::MCEventHeader* eventheader)
+  {
+    reorderAndMergeMCTracks(flusheventID, mOutTree, nprimaries, subevOrdered, mcheaderhook, eventheader);
+
+    if (mOutTree) {
+      // adjusting and merging track references
+      remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
+
+      // write MC event headers
+      {
+        auto headerbr = o2::base::getOrMakeBranch(*mOutTree, "MCEventHeader.", &eventheader);
+        headerbr->SetAddress(&eventheader);
+        headerbr->Fill();
+        headerbr->ResetAddress();
       }
-      if (mMCHeaderOnlyOutFile) {
-        mMCHeaderOnlyOutFile->Write("", TObject::kOverwrite);
+
+      {
+        auto headerbr = o2::base::getOrMakeBranch(*mMCHeaderTree, "MCEventHeader.", &eventheader);
+        headerbr->SetAddress(&eventheader);
+        headerbr->Fill();
+        headerbr->ResetAddress();
       }
     }
-    return true;
+
+    // increase the entry count in the tree
+    if (mOutTree) {
+      mOutTree->SetEntries(mOutTree->GetEntries() + 1);
+      LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
+    }
+    if (mMCHeaderTree) {
+      mMCHeaderTree->SetEntries(mMCHeaderTree->GetEntries() + 1);
+      LOG(info) << "mc header outtree has file " << mMCHeaderTree->GetDirectory()->GetFile()->GetName();
+    }
   }
 
   std::map<uint32_t, uint32_t> mPartsCheckSum; //! mapping event id -> part checksum used to detect when all info
@@ -851,6 +956,11 @@ class O2HitMerger : public fair::mq::Device
   // intermediate structures to collect data per event
   std::thread mMergerIOThread; //! a thread used to do hit merging and IO flushing asynchronously
   bool mergingInProgress = false;
+  std::unique_ptr<tbb::task_arena> mMergerArena; //! arena to merge and flush the hits of the detectors concurrently
+  std::vector<double> mDetectorMergeTime;        //! accumulated hit merge/flush time per detector
+  double mKinematicsMergeTime = 0.;              //! accumulated kinematics merge time
+  int mNMergedEvents = 0;                        //! number of events merged so far
+  int mMergerThreads = 1;                        //! number of threads merging the hits
 
   Hashtable<int, std::vector<std::vector<o2::MCTrack>*>> mMCTrackBuffer;         //! vector of sub-event track vectors; one per event
   Hashtable<int, std::vector<std::vector<o2::TrackReference>*>> mTrackRefBuffer; //!
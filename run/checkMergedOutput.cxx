@@ -0,0 +1,121 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+// Executable to check that the hit merger output does not depend on its threading
+// Compares entry by entry the kinematics, MC headers and hits trees of two simulations with the same seed
+
+#include "CommonUtils/NameConf.h"
+#include "DetectorsCommonDataFormats/DetectorNameConf.h"
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "TBufferFile.h"
+#include "TBranch.h"
+#include "TClass.h"
+#include "TFile.h"
+#include "TTree.h"
+#include <fairlogger/Logger.h>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace
+{
+// compare the serialized content of all object branches of the two trees
+bool compareTrees(TTree& tree1, TTree& tree2, std::string const& what)
+{
+  if (tree1.GetEntries() != tree2.GetEntries()) {
+    LOG(error) << what << ": " << tree1.GetEntries() << " vs " << tree2.GetEntries() << " entries";
+    return false;
+  }
+  bool same = true;
+  for (auto obj : *tree1.GetListOfBranches()) {
+    auto br1 = static_cast<TBranch*>(obj);
+    auto br2 = tree2.GetBranch(br1->GetName());
+    if (!br2) {
+      LOG(error) << what << ": branch " << br1->GetName() << " is missing";
+      same = false;
+      continue;
+    }
+    TClass* cl = nullptr;
+    EDataType type;
+    br1->GetExpectedType(cl, type);
+    if (!cl) {
+      LOG(warn) << what << ": branch " << br1->GetName() << " does not hold objects, not compared";
+      continue;
+    }
+    void* obj1 = cl->New();
+    void* obj2 = cl->New();
+    br1->SetAddress(&obj1);
+    br2->SetAddress(&obj2);
+    for (Long64_t entry = 0; entry < tree1.GetEntries(); ++entry) {
+      br1->GetEntry(entry);
+      br2->GetEntry(entry);
+      TBufferFile buf1(TBuffer::kWrite), buf2(TBuffer::kWrite);
+      buf1.WriteObjectAny(obj1, cl);
+      buf2.WriteObjectAny(obj2, cl);
+      if (buf1.Length() != buf2.Length() || std::memcmp(buf1.Buffer(), buf2.Buffer(), buf1.Length()) != 0) {
+        LOG(error) << what << ": entry " << entry << " of branch " << br1->GetName() << " differs";
+        same = false;
+        break;
+      }
+    }
+    br1->ResetAddress();
+    br2->ResetAddress();
+    cl->Destructor(obj1);
+    cl->Destructor(obj2);
+  }
+  LOG(info) << what << ": " << tree1.GetEntries() << " entries " << (same ? "identical" : "differ");
+  return same;
+}
+
+bool compareFiles(std::string const& name1, std::string const& name2)
+{
+  std::unique_ptr<TFile> file1(TFile::Open(name1.c_str()));
+  std::unique_ptr<TFile> file2(TFile::Open(name2.c_str()));
+  if (!file1 || file1->IsZombie() || !file2 || file2->IsZombie()) {
+    LOG(error) << "Cannot open " << name1 << " or " << name2;
+    return false;
+  }
+  auto tree1 = file1->Get<TTree>("o2sim");
+  auto tree2 = file2->Get<TTree>("o2sim");
+  if (!tree1 || !tree2) {
+    LOG(error) << "No o2sim tree in " << name1 << " or " << name2;
+    return false;
+  }
+  return compareTrees(*tree1, *tree2, name1 + " vs " + name2);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 3) {
+    LOG(error) << "Usage: " << argv[0] << " <prefix of the reference simulation> <prefix of the simulation to compare>";
+    return 1;
+  }
+  const std::string prefix1 = argv[1];
+  const std::string prefix2 = argv[2];
+
+  bool same = compareFiles(o2::base::NameConf::getMCKinematicsFileName(prefix1), o2::base::NameConf::getMCKinematicsFileName(prefix2));
+  same &= compareFiles(o2::base::NameConf::getMCHeadersFileName(prefix1), o2::base::NameConf::getMCHeadersFileName(prefix2));
+  int nhitfiles = 0;
+  for (int id = o2::detectors::DetID::First; id <= o2::detectors::DetID::Last; ++id) {
+    auto hitfile1 = o2::base::DetectorNameConf::getHitsFileName(id, prefix1);
+    if (std::filesystem::exists(hitfile1)) {
+      same &= compareFiles(hitfile1, o2::base::DetectorNameConf::getHitsFileName(id, prefix2));
+      nhitfiles++;
+    }
+  }
+  if (nhitfiles == 0) {
+    LOG(error) << "No hits file found for " << prefix1;
+    return 1;
+  }
+  return same ? 0 : 1;
+}